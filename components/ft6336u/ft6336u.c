@@ -4,7 +4,7 @@
 
 static const char *TAG = "FT6336U";
 static i2c_master_dev_handle_t g_dev_handle = NULL;
-static uint8_t g_rotation = 0;
+static const rm690b0_xform_t *volatile g_xform = NULL; // NULL: rotation 0, the display default
 
 // Registers
 #define FT6336U_REG_MODE        0x00
@@ -15,10 +15,6 @@ static uint8_t g_rotation = 0;
 #define FT6336U_REG_P1_YH       0x05
 #define FT6336U_REG_P1_YL       0x06
 
-// Screen Dimensions (Native Portrait)
-#define FT6336U_WIDTH_NATIVE  450
-#define FT6336U_HEIGHT_NATIVE 600
-
 esp_err_t ft6336u_init(i2c_master_bus_handle_t bus_handle) {
     if (g_dev_handle != NULL) return ESP_OK;
 
@@ -50,56 +46,25 @@ esp_err_t ft6336u_init(i2c_master_bus_handle_t bus_handle) {
 }
 
 void ft6336u_set_rotation(uint8_t rotation) {
-    g_rotation = rotation & 0x03; // Limit to 0-3
-    ESP_LOGI(TAG, "Touch Rotation set to %d", g_rotation);
+    ft6336u_set_transform(rm690b0_xform_get(rotation));
+    ESP_LOGI(TAG, "Touch Rotation set to %d", rotation & 0x03);
 }
 
-// Map raw coordinates to screen coordinates based on rotation
-// Assumes Hardware Native is Portrait (Rot 3 logic)
-static void apply_rotation(uint16_t *x, uint16_t *y) {
-    uint16_t raw_x = *x;
-    uint16_t raw_y = *y;
-    
-    // RM690B0 Orientations for FT6336U Coordinate Mapping
-    // Native (Rot 3 = Portrait USB Left): X(0-450), Y(0-600)
-
-    switch (g_rotation) {
-        case 3: // Native (USB Left) -> No Change
-            *x = raw_x;
-            *y = raw_y;
-            break;
-
-        case 0: // Landscape (USB Bottom) - 90 CW
-            // Old (0,0) Top-Left -> New Top-Right
-            // Old (0,600) Bottom-Left -> New Top-Left (0,0)
-            // Old (450,0) Top-Right -> New Bottom-Right
-            // Old (450,600) Bottom-Right -> New Bottom-Left
-            
-            // Map: (0,600) -> (0,0)
-            // New X = 600 - Old Y 
-            // Map: (0,0) -> (600,0)
-            // New Y = Old X
-            *x = FT6336U_HEIGHT_NATIVE - raw_y;
-            *y = raw_x;
-            break;
+void ft6336u_set_transform(const rm690b0_xform_t *xf) {
+    g_xform = xf;
+}
 
-        case 1: // Portrait (USB Right) - 180 CW from Native
-            // Old (0,0) -> New Bottom-Right (450, 600)
-            // New X = 450 - Old X
-            // New Y = 600 - Old Y
-            *x = FT6336U_WIDTH_NATIVE - raw_x;
-            *y = FT6336U_HEIGHT_NATIVE - raw_y;
-            break;
+// Map raw coordinates to screen coordinates: the controller reports in the
+// panel's native frame (rotation 3), the display's own transform maps it
+static void apply_rotation(uint16_t *x, uint16_t *y) {
+    const rm690b0_xform_t *xf = g_xform ? g_xform : rm690b0_xform_get(0);
 
-        case 2: // Landscape (USB Top) - 270 CW from Native (-90)
-            // Old (0,0) -> New Bottom-Left (0, 450)
-            // Old (450,0) -> New Top-Left (0,0)
-            // New Y = 450 - Old X
-            // New X = Old Y
-            *x = raw_y;
-            *y = FT6336U_WIDTH_NATIVE - raw_x;
-            break;
-    }
+    int32_t nx = (*x < RM_XFORM_NATIVE_W) ? *x : RM_XFORM_NATIVE_W - 1;
+    int32_t ny = (*y < RM_XFORM_NATIVE_H) ? *y : RM_XFORM_NATIVE_H - 1;
+    int32_t sx, sy;
+    rm690b0_xform_from_native(xf, nx, ny, &sx, &sy);
+    *x = (uint16_t)sx;
+    *y = (uint16_t)sy;
 }
 
 bool ft6336u_get_touch(uint16_t *x, uint16_t *y) {
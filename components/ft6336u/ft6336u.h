@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include "esp_err.h"
 #include "driver/i2c_master.h"
+#include "rm690b0_xform.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +33,12 @@ bool ft6336u_get_touch(uint16_t *x, uint16_t *y);
  */
 void ft6336u_set_rotation(uint8_t rotation);
 
+/**
+ * @brief Map touches with a display transform, e.g. from the display's
+ * rotation callback so both always use the same one
+ */
+void ft6336u_set_transform(const rm690b0_xform_t *xf);
+
 #ifdef __cplusplus
 }
 #endif
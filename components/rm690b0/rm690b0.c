@@ -1,5 +1,11 @@
 #include <stddef.h>
 #include "rm690b0.h"
+#include "rm690b0_bus.h"
+#include "rm690b0_bus_spi.h"
+#include "rm690b0_stream.h"
+#include "rm690b0_priv.h"
+#include "rm690b0_img.h"
+#include "rm690b0_dlist.h"
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
@@ -8,17 +14,27 @@
 #include "esp_log.h"
 #include "esp_rom_sys.h"
 #include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
 #include <string.h>
 
 static const char *TAG = "rm690b0";
 
 // --- Internal Global Config ---
 static rm690b0_config_t g_conf;
-static spi_device_handle_t spi_handle;
+static rm690b0_bus_t *s_bus;
+static rm690b0_pipe_t s_pipe;
+static rm690b0_stream_t s_stream;
+static rm690b0_pool_t s_pool;
 
-// --- Internal Transaction buffers ---
-DRAM_ATTR static uint8_t s_caset_data[4];
-DRAM_ATTR static uint8_t s_raset_data[4];
+// Persistent DMA scratch buffers: two for streaming overlap, one for callers
+#define RM690B0_POOL_BUFS       3
+#define RM690B0_POOL_ALIGN      64  // Cache line, also satisfies the 4-byte DMA alignment
+static uint16_t *s_pool_bufs[RM690B0_POOL_BUFS];
+
+// QSPI clock. Safe fallback to 40MHz (LilyGo runs 80MHz, panel write cycle is rated 20ns)
+#define RM690B0_SPI_CLOCK_HZ    (40 * 1000 * 1000)
+_Static_assert(RM690B0_SPI_CLOCK_HZ <= 50 * 1000 * 1000, "RM690B0 tSCYC(write) min is 20ns");
 
 // Current display dimensions 
 static uint16_t current_width = RM690B0_WIDTH;
@@ -26,80 +42,170 @@ static uint16_t current_height = RM690B0_HEIGHT;
 static uint16_t offset_x = 0;
 static uint16_t offset_y = 0;
 static uint8_t s_rotation = 0;
+static uint8_t s_madctl = 0;
+static rm690b0_rotation_cb_t s_rotation_cb;
+static void *s_rotation_ctx;
+
+// Interface format selected by the application; the stream holds the one on the wire
+static rm690b0_ifpf_t s_ifpf = RM_IFPF_RGB565;
+
+// MADCTL bits used by the scroll mapping
+#define RM_MADCTL_MY    0x80
+#define RM_MADCTL_MV    0x20
+
+// Vertical scroll area in screen rows of the current rotation (0 height = off)
+static uint16_t s_scroll_top = 0;
+static uint16_t s_scroll_height = 0;
+
+// Test pattern, recorded on first use in each rotation. While nothing else
+// has been written since it was played, GRAM still holds s_pattern_shown.
+// Scrolling and raw commands move or change what is shown without a burst.
+static rm690b0_dlist_t s_pattern[4];
+static int8_t s_pattern_shown = -1;
+static uint32_t s_pattern_bursts;
+
+// Helper: Finish queued pixel transfers and take the bus for a blocking sequence
+static esp_err_t rm_bus_begin(void) {
+    esp_err_t ret = rm_pipe_drain(&s_pipe, RM_BUS_WAIT_FOREVER);
+    if (ret != ESP_OK) return ret;
+    return s_bus->acquire(s_bus);
+}
 
 // Helper: Send Command (Variable CMD/ADDR phases for QSPI wrapper)
 static void rm_send_cmd(uint8_t cmd, const uint8_t *data, size_t len) {
     // Acquire bus to ensure atomic command sequence if needed
-    spi_device_acquire_bus(spi_handle, portMAX_DELAY);
-
-    spi_transaction_ext_t t = {0};
-    t.base.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR; // The QSPI wrapper uses this to send "02 00 CMD 00"
-    
-    // Command Phase: 1 byte Opcode (0x02)
-    t.base.cmd = 0x02;
-    t.command_bits = 8;
+    if (rm_bus_begin() != ESP_OK) return;
+
+    // The QSPI wrapper sends "02 00 CMD 00" followed by the parameters
+    rm690b0_bus_trans_t t = {
+        .flags = RM_BUS_FLAG_HEADER,
+        .opcode = RM_BUS_OP_CMD,
+        .cmd = cmd,
+        .tx_buffer = data,
+        .length = len,
+    };
+    s_bus->transmit(s_bus, &t);
 
-    // Address Phase: 3 bytes (00 CMD 00) -> 24 bits
-    t.base.addr = ((uint32_t)cmd) << 8; 
-    t.address_bits = 24;
+    s_bus->release(s_bus);
+}
 
-    t.base.length = len * 8;
-    t.base.tx_buffer = data;
+// Send rotation command
+void rm690b0_set_rotation(uint8_t rotation) {
+    const rm690b0_xform_t *xf = rm690b0_xform_get(rotation);
+    uint8_t madctl = xf->madctl;
+    s_rotation = xf->rotation;
+    current_width = xf->width;
+    current_height = xf->height;
+    offset_x = xf->offset_x;
+    offset_y = xf->offset_y;
+    ESP_LOGI(TAG, "Set Rotation %d: %dx%d (OffX:%d OffY:%d)", s_rotation, current_width, current_height, offset_x, offset_y);
+    s_madctl = madctl;
+    rm_send_cmd(0x36, &madctl, 1);
 
-    esp_err_t ret = spi_device_polling_transmit(spi_handle, (spi_transaction_t *)&t);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "SPI Transfer Error: %s", esp_err_to_name(ret));
+    // The scroll area is defined in panel rows, which no longer match
+    if (s_scroll_height) {
+        rm690b0_scroll_reset();
     }
-    
-    spi_device_release_bus(spi_handle);
+
+    // Touch and anything else in screen coordinates follows
+    if (s_rotation_cb) s_rotation_cb(xf, s_rotation_ctx);
 }
 
-// Send rotation command
-void rm690b0_set_rotation(uint8_t rotation) {
-    uint8_t madctl = 0;
-    s_rotation = rotation;
-    switch (rotation) {
-        case 0: // Landscape (USB Bottom) - Default
-            madctl = 0xA0; // MV, MY
-            current_width = 600;
-            current_height = 450;
-            offset_x = 0; 
-            offset_y = 16; 
-            break;
+const rm690b0_xform_t *rm690b0_get_xform(void) {
+    return rm690b0_xform_get(s_rotation);
+}
 
-        case 1: // Portrait (USB Right) - CCW 90
-            madctl = 0xC0; // MY, MX
-            current_width = 450; 
-            current_height = 600;
-            offset_x = 14; 
-            offset_y = 0; 
-            break;
-            
-        case 2: // Landscape (USB Top) - CCW 180
-            madctl = 0x60; // MV, MX
-            current_width = 600;
-            current_height = 450;
-            offset_x = 0; 
-            offset_y = 14;
-            break;
-            
-        case 3: // Portrait (USB Left) - CCW 270
-            madctl = 0x00; // Native
-            current_width = 450;
-            current_height = 600;
-            offset_x = 16; 
-            offset_y = 0;
-            break;
+void rm690b0_set_rotation_cb(rm690b0_rotation_cb_t cb, void *ctx) {
+    s_rotation_ctx = ctx;
+    s_rotation_cb = cb;
+}
+
+void rm690b0_set_tear_scanline(uint16_t line) {
+    uint8_t stesl[2] = { line >> 8, line & 0xFF };
+    rm_send_cmd(0x44, stesl, 2); // STESL
+    rm_send_cmd(0x35, (uint8_t[]){0x00}, 1); // TE ON (V-blank mode)
+}
+
+// --- Vertical Scroll ---
+//
+// VSCRDEF/VSCSAD work on native panel rows. Without MV those are the screen
+// rows of the current rotation (reversed when MY is set); with MV they run
+// along screen X, so there is no vertical hardware scroll in landscape.
+
+bool rm690b0_scroll_supported(void) {
+    return (s_madctl & RM_MADCTL_MV) == 0;
+}
+
+// Longer than the inline payload of a queued command: sent blocking after the batch
+static void rm_send_u16x3(uint8_t cmd, uint16_t a, uint16_t b, uint16_t c) {
+    uint8_t buf[6] = { a >> 8, a & 0xFF, b >> 8, b & 0xFF, c >> 8, c & 0xFF };
+    rm_send_cmd(cmd, buf, sizeof(buf));
+}
+
+esp_err_t rm690b0_scroll_area(uint16_t top, uint16_t height) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+    if (!rm690b0_scroll_supported()) return ESP_ERR_NOT_SUPPORTED;
+    if (height == 0 || top + height > current_height) return ESP_ERR_INVALID_ARG;
+
+    // Fixed areas in native rows; the row offset of the rotation sits above
+    uint16_t below = current_height - top - height;
+    uint16_t tfa = offset_y + ((s_madctl & RM_MADCTL_MY) ? below : top);
+    uint16_t bfa = (s_madctl & RM_MADCTL_MY) ? top : below;
+
+    rm_send_u16x3(0x33, tfa, height, bfa); // VSCRDEF
+    s_pattern_shown = -1;
+
+    s_scroll_top = top;
+    s_scroll_height = height;
+    return rm690b0_scroll_to(0);
+}
+
+esp_err_t rm690b0_scroll_to(uint16_t offset) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+    if (s_scroll_height == 0) return ESP_ERR_INVALID_STATE;
+
+    uint16_t h = s_scroll_height;
+    offset %= h;
+
+    // Screen row (top + k) shows what was drawn at row top + (offset + k) % h.
+    // With MY the panel rows run bottom-up, so the start address runs backwards.
+    uint16_t below = current_height - s_scroll_top - h;
+    uint16_t vsa;
+    if (s_madctl & RM_MADCTL_MY) {
+        vsa = offset_y + below + (h - offset) % h;
+    } else {
+        vsa = offset_y + s_scroll_top + offset;
     }
-    ESP_LOGI(TAG, "Set Rotation %d: %dx%d (OffX:%d OffY:%d)", rotation, current_width, current_height, offset_x, offset_y);
-    rm_send_cmd(0x36, &madctl, 1);
+
+    // Queued behind the pixels of the newly exposed line
+    uint8_t vscsad[2] = { vsa >> 8, vsa & 0xFF };
+    s_pattern_shown = -1;
+    return rm_pipe_cmd(&s_pipe, 0x37, vscsad, 2); // VSCSAD
+}
+
+void rm690b0_scroll_reset(void) {
+    if (!s_bus) return;
+    rm_send_u16x3(0x33, 0, RM690B0_HEIGHT, 0); // Whole panel scrolls, start 0: normal
+    rm_send_cmd(0x37, (uint8_t[]){0x00, 0x00}, 2);
+    s_pattern_shown = -1;
+    s_scroll_top = 0;
+    s_scroll_height = 0;
 }
 
 uint8_t rm690b0_get_rotation(void) {
     return s_rotation;
 }
 
-esp_err_t rm690b0_set_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
+uint16_t rm690b0_get_width(void) {
+    return current_width;
+}
+
+uint16_t rm690b0_get_height(void) {
+    return current_height;
+}
+
+void rm_drv_window_params(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+                          uint8_t caset[4], uint8_t raset[4]) {
     // Apply Rotation Offsets
     x1 += offset_x;
     x2 += offset_x;
@@ -110,83 +216,282 @@ esp_err_t rm690b0_set_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
     x1 &= ~1;
     x2 |= 1;
 
-    s_caset_data[0] = (x1 >> 8); s_caset_data[1] = (x1 & 0xFF);
-    s_caset_data[2] = (x2 >> 8); s_caset_data[3] = (x2 & 0xFF);
-    
-    s_raset_data[0] = (y1 >> 8); s_raset_data[1] = (y1 & 0xFF);
-    s_raset_data[2] = (y2 >> 8); s_raset_data[3] = (y2 & 0xFF);
+    caset[0] = x1 >> 8;
+    caset[1] = x1 & 0xFF;
+    caset[2] = x2 >> 8;
+    caset[3] = x2 & 0xFF;
+    raset[0] = y1 >> 8;
+    raset[1] = y1 & 0xFF;
+    raset[2] = y2 >> 8;
+    raset[3] = y2 & 0xFF;
+}
 
-    rm_send_cmd(0x2A, s_caset_data, 4); // CASET
-    rm_send_cmd(0x2B, s_raset_data, 4); // RASET
-    vTaskDelay(pdMS_TO_TICKS(1)); 
-    return ESP_OK;
+esp_err_t rm690b0_set_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+
+    uint8_t caset[4], raset[4];
+    rm_drv_window_params(x1, y1, x2, y2, caset, raset);
+
+    // Queued behind any pending burst and ahead of the next RAMWR, under the
+    // same bus acquisition. The datasheet only asks for tCSU/tCH (20ns)
+    // around CS, so no settle delay is needed between CASET/RASET and RAMWR.
+    esp_err_t ret = rm_pipe_cmd(&s_pipe, 0x2A, caset, 4); // CASET
+    if (ret == ESP_OK) ret = rm_pipe_cmd(&s_pipe, 0x2B, raset, 4); // RASET
+    return ret;
+}
+
+esp_err_t rm690b0_queue_cmd(uint8_t cmd, const uint8_t *data, size_t len) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+    s_pattern_shown = -1; // Unknown command, may touch GRAM or its mapping
+    return rm_pipe_cmd(&s_pipe, cmd, data, len);
+}
+
+esp_err_t rm_drv_use_ifpf(rm690b0_ifpf_t fmt) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+    if (fmt == s_stream.ifpf) return ESP_OK;
+
+    // Queued behind bursts still packed in the old format
+    uint8_t colmod = fmt;
+    esp_err_t ret = rm_pipe_cmd(&s_pipe, 0x3A, &colmod, 1); // COLMOD
+    if (ret == ESP_OK) s_stream.ifpf = fmt;
+    return ret;
 }
 
+esp_err_t rm690b0_set_interface_format(rm690b0_ifpf_t fmt) {
+    switch (fmt) {
+        case RM_IFPF_RGB565:
+        case RM_IFPF_RGB332:
+        case RM_IFPF_RGB111:
+        case RM_IFPF_GRAY8:
+            break;
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = rm_drv_use_ifpf(fmt);
+    if (ret == ESP_OK) s_ifpf = fmt;
+    return ret;
+}
+
+rm690b0_ifpf_t rm690b0_get_interface_format(void) {
+    return s_ifpf;
+}
+
+void rm690b0_get_ifpf_stats(rm690b0_ifpf_stats_t *stats) {
+    *stats = s_stream.ifpf_stats;
+}
 
 esp_err_t rm690b0_write_pixels(const uint16_t *data, size_t pixel_count) {
-    if (pixel_count == 0) return ESP_OK;
+    esp_err_t ret = rm690b0_write_pixels_async(data, pixel_count, NULL, NULL);
+    if (ret != ESP_OK) return ret;
+    return rm_pipe_drain(&s_pipe, RM_BUS_WAIT_FOREVER);
+}
 
-    size_t len_bytes = pixel_count * 2;
-    const size_t CHUNK_SIZE = 32 * 1024; 
-    size_t sent = 0;
-    
-    spi_device_acquire_bus(spi_handle, portMAX_DELAY);
-    
-    while (sent < len_bytes) {
-        size_t chunk = (len_bytes - sent > CHUNK_SIZE) ? CHUNK_SIZE : (len_bytes - sent);
-        
-        spi_transaction_ext_t t = {0};
-        t.base.flags = SPI_TRANS_MODE_QIO;
-
-        if (sent == 0) {
-            // First chunk: Send Write RAM command header
-            // 0x32 00 2C 00
-            t.base.flags |= SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR;
-            t.base.cmd = 0x32;
-            t.base.addr = 0x002C00;
-            t.command_bits = 8;
-            t.address_bits = 24;
-        } else {
-            // Subsequent chunks: Just data, but keep CS active from previous
-            t.command_bits = 0;
-            t.address_bits = 0;
-            t.base.flags |= SPI_TRANS_CS_KEEP_ACTIVE; 
-        }
+esp_err_t rm690b0_write_pixels_async(const uint16_t *data, size_t pixel_count,
+                                     rm690b0_done_cb_t done_cb, void *user_ctx) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
 
-        if (sent + chunk < len_bytes) {
-            t.base.flags |= SPI_TRANS_CS_KEEP_ACTIVE; 
-        }
-        
-        t.base.length = chunk * 8;
-        t.base.tx_buffer = ((uint8_t*)data) + sent;
+    rm690b0_source_t src;
+    rm690b0_source_linear(&src, data, pixel_count);
+    return rm_stream_run(&s_stream, &src, done_cb, user_ctx, NULL);
+}
+
+esp_err_t rm690b0_draw_source(uint16_t x, uint16_t y, uint16_t w, uint16_t h, rm690b0_source_t *src) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+    if (w == 0 || h == 0) return ESP_OK;
+
+    esp_err_t ret = rm690b0_set_window(x, y, x + w - 1, y + h - 1);
+    if (ret != ESP_OK) return ret;
+
+    bool zero_copy = false;
+    ret = rm_stream_run(&s_stream, src, NULL, NULL, &zero_copy);
+    if (ret != ESP_OK) {
+        rm_pipe_drain(&s_pipe, RM_BUS_WAIT_FOREVER);
+        return ret;
+    }
+    // Bounce-buffered data may stay in flight, caller memory may not
+    if (zero_copy) {
+        return rm_pipe_drain(&s_pipe, RM_BUS_WAIT_FOREVER);
+    }
+    return ESP_OK;
+}
+
+// Source columns for a blit widened to even X: edge pixels are repeated, the
+// neighbouring source column may belong to another sprite
+typedef struct {
+    const uint16_t *src;    // First pixel of the clipped source rectangle
+    size_t stride;
+    uint16_t pad_l;         // Widened columns on the left (0 or 1)
+    uint16_t w;             // Source columns
+} rm_blit_edge_t;
+
+static void blit_edge_gen(void *ctx, uint16_t x, uint16_t y, uint16_t n, uint16_t *dst) {
+    const rm_blit_edge_t *e = ctx;
+    const uint16_t *row = e->src + (size_t)y * e->stride;
+    for (uint16_t i = 0; i < n; i++) {
+        int32_t c = (int32_t)x + i - e->pad_l;
+        if (c < 0) c = 0;
+        else if (c >= e->w) c = e->w - 1;
+        dst[i] = row[c];
+    }
+}
+
+esp_err_t rm_drv_blit(const uint16_t *src_be, size_t stride, uint16_t sx, uint16_t sy,
+                      uint16_t w, uint16_t h, int32_t dx, int32_t dy, bool *zero_copy) {
+    if (zero_copy) *zero_copy = false;
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+
+    // Clip against the current rotation, moving the source origin along
+    int32_t x0 = dx, y0 = dy;
+    int32_t x1 = dx + w, y1 = dy + h;
+    if (x0 < 0) { sx += -x0; x0 = 0; }
+    if (y0 < 0) { sy += -y0; y0 = 0; }
+    if (x1 > current_width) x1 = current_width;
+    if (y1 > current_height) y1 = current_height;
+    if (x1 <= x0 || y1 <= y0) return ESP_OK;
+    w = x1 - x0;
+    h = y1 - y0;
+
+    // CASET takes column pairs: widen odd edges by repeating the edge pixel
+    const uint16_t *first = src_be + (size_t)sy * stride + sx;
+    uint16_t pad_l = x0 & 1;
+    uint16_t pad_r = x1 & 1;
+    uint16_t aw = w + pad_l + pad_r;
+
+    rm690b0_source_t src;
+    rm_blit_edge_t edge;
+    if (pad_l || pad_r) {
+        edge = (rm_blit_edge_t){ .src = first, .stride = stride, .pad_l = pad_l, .w = w };
+        rm690b0_source_generator(&src, blit_edge_gen, &edge, aw, h);
+    } else {
+        rm690b0_source_rect(&src, first - pad_l, stride, aw, h);
+        // Flash-mapped and PSRAM images are copied through the bounce buffers
+        if (!esp_ptr_dma_capable(first)) src.direct = NULL;
+    }
+
+    x0 -= pad_l;
+    esp_err_t ret = rm690b0_set_window(x0, y0, x0 + aw - 1, y1 - 1);
+    if (ret != ESP_OK) return ret;
+    return rm_stream_run(&s_stream, &src, NULL, NULL, zero_copy);
+}
+
+esp_err_t rm690b0_blit(const uint16_t *src_be, size_t stride, uint16_t sx, uint16_t sy,
+                       uint16_t w, uint16_t h, int16_t dx, int16_t dy) {
+    bool zero_copy = false;
+    esp_err_t ret = rm_drv_blit(src_be, stride, sx, sy, w, h, dx, dy, &zero_copy);
+    // Rows sent straight from the source must be on the wire before we return
+    if (ret != ESP_OK || zero_copy) {
+        esp_err_t wret = rm_pipe_drain(&s_pipe, RM_BUS_WAIT_FOREVER);
+        if (ret == ESP_OK) ret = wret;
+    }
+    return ret;
+}
+
+esp_err_t rm690b0_draw_bitmap(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data_be) {
+    return rm690b0_blit(data_be, w, 0, 0, w, h, x, y);
+}
+
+static size_t img_decode(void *ctx, uint16_t *dst, size_t max_pixels) {
+    return rm690b0_img_decode(ctx, dst, max_pixels);
+}
+
+esp_err_t rm690b0_draw_image(uint16_t x, uint16_t y, const void *file, size_t size) {
+    rm690b0_img_t img;
+    esp_err_t ret = rm690b0_img_open(&img, file, size);
+    if (ret != ESP_OK) return ret;
+    if ((x & 1) || (img.w & 1)) return ESP_ERR_INVALID_ARG;
+    if ((uint32_t)x + img.w > current_width || (uint32_t)y + img.h > current_height) {
+        return ESP_ERR_INVALID_SIZE;
+    }
 
-        spi_device_polling_transmit(spi_handle, (spi_transaction_t *)&t);
-        sent += chunk;
+    // Every pixel is decoded before rm_stream_run() returns; only pool buffers stay queued
+    rm690b0_img_dec_t dec;
+    rm690b0_img_dec_init(&dec, &img);
+    rm690b0_source_t src;
+    rm690b0_source_decoder(&src, img_decode, &dec, (size_t)img.w * img.h);
+    return rm690b0_draw_source(x, y, img.w, img.h, &src);
+}
+
+esp_err_t rm690b0_flush_wait(uint32_t timeout_ms) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+    return rm_pipe_drain(&s_pipe, timeout_ms);
+}
+
+esp_err_t rm690b0_dma_acquire(uint16_t **buf, size_t *pixels) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+
+    uint8_t i;
+    esp_err_t ret = rm_pool_acquire(&s_pool, &i);
+    if (ret != ESP_OK) return ret;
+    *buf = s_pool.buf[i];
+    if (pixels) *pixels = s_pool.pixels;
+    return ESP_OK;
+}
+
+esp_err_t rm690b0_dma_acquire_solid(uint16_t color, size_t count, const uint16_t **buf) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+
+    uint8_t i;
+    esp_err_t ret = rm_pool_acquire_solid(&s_pool, rm_color_be(color), count, &i);
+    if (ret != ESP_OK) return ret;
+    *buf = s_pool.buf[i];
+    return ESP_OK;
+}
+
+void rm690b0_dma_release(const uint16_t *buf) {
+    rm_pool_release(&s_pool, rm_pool_index(&s_pool, buf));
+}
+
+void rm690b0_get_pool_stats(rm690b0_pool_stats_t *stats) {
+    *stats = s_pool.stats;
+}
+
+rm690b0_bus_t *rm690b0_get_bus(void) {
+    return s_bus;
+}
+
+esp_err_t rm690b0_set_bus(rm690b0_bus_t *bus) {
+    if (s_bus) {
+        esp_err_t ret = rm_pipe_drain(&s_pipe, RM_BUS_WAIT_FOREVER);
+        if (ret != ESP_OK) return ret;
     }
-    spi_device_release_bus(spi_handle);
+    s_bus = bus;
+    rm_pipe_init(&s_pipe, bus, RM_BUS_QUEUE_DEPTH);
+    s_pattern_shown = -1;
     return ESP_OK;
 }
 
 esp_err_t rm690b0_init(const rm690b0_config_t *config) {
     g_conf = *config;
+    s_pattern_shown = -1; // GRAM does not survive a reset
     
     ESP_LOGI(TAG, "Initializing RM690B0 (LilyGo logic port)...");
 
-    spi_device_interface_config_t devcfg = {
-        .clock_speed_hz = 60 * 1000 * 1000, 
-        .mode = 0,
-        .spics_io_num = config->cs_io,
-        .queue_size = 10,
-        .flags = SPI_DEVICE_HALFDUPLEX,
-    };
-    // Safe fallback to 40MHz
-    devcfg.clock_speed_hz = 40 * 1000 * 1000; 
+    // 1. Bus backend (QSPI device). Keeps an attached backend, e.g. the recorder.
+    if (!s_bus) {
+        rm690b0_bus_t *bus = NULL;
+        esp_err_t ret = rm690b0_bus_spi_create(config->host_id, config->cs_io, RM690B0_SPI_CLOCK_HZ, &bus);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        rm690b0_set_bus(bus);
+    } else {
+        rm_pipe_drain(&s_pipe, RM_BUS_WAIT_FOREVER);
+    }
 
-    esp_err_t ret = spi_bus_add_device(config->host_id, &devcfg, &spi_handle);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to add SPI device");
-        return ret;
+    // Pool buffers are allocated once and survive re-init after light sleep
+    for (int i = 0; i < RM690B0_POOL_BUFS; i++) {
+        if (!s_pool_bufs[i]) {
+            s_pool_bufs[i] = heap_caps_aligned_alloc(RM690B0_POOL_ALIGN, RM_STREAM_CHUNK_PIXELS * 2,
+                                                     MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+            if (!s_pool_bufs[i]) {
+                ESP_LOGE(TAG, "OOM allocating DMA pool");
+                return ESP_ERR_NO_MEM;
+            }
+        }
     }
+    rm_pool_init(&s_pool, &s_pipe, s_pool_bufs, RM690B0_POOL_BUFS, RM_STREAM_CHUNK_PIXELS);
+    rm_stream_init(&s_stream, &s_pipe, &s_pool);
+    s_ifpf = RM_IFPF_RGB565;
 
     // 2. Hardware Reset
     if (config->rst_io >= 0) {
@@ -209,7 +514,7 @@ esp_err_t rm690b0_init(const rm690b0_config_t *config) {
     rm_send_cmd(0x5B, (uint8_t[]){0x2E}, 1);
     rm_send_cmd(0xFE, (uint8_t[]){0x00}, 1);
     
-    rm_send_cmd(0x3A, (uint8_t[]){0x55}, 1); // COLMOD 16bit
+    rm_send_cmd(0x3A, (uint8_t[]){RM_IFPF_RGB565}, 1); // COLMOD 16bit
     
     rm_send_cmd(0xC2, NULL, 0); 
     vTaskDelay(pdMS_TO_TICKS(10));
@@ -234,127 +539,128 @@ esp_err_t rm690b0_init(const rm690b0_config_t *config) {
     return ESP_OK;
 }
 
-esp_err_t rm690b0_fill_screen(uint16_t color) {
-    rm690b0_set_window(0, 0, current_width - 1, current_height - 1);
-    
-    size_t pixel_count = current_width * current_height;
-    size_t chunk_pixels = 8192; // 16KB buffer
-    
-    // Allocate buffer in DMA capable memory
-    uint16_t *buffer = heap_caps_malloc(chunk_pixels * 2, MALLOC_CAP_DMA);
-    if (!buffer) {
-        ESP_LOGE(TAG, "OOM in fill_screen");
-        return ESP_ERR_NO_MEM;
-    }
-    
-    uint16_t color_be = (color >> 8) | (color << 8);
-    for (size_t i = 0; i < chunk_pixels; i++) buffer[i] = color_be;
-    
-    size_t sent = 0;
-    spi_device_acquire_bus(spi_handle, portMAX_DELAY);
-    
-    while (sent < pixel_count) {
-        size_t pixels_to_send = (pixel_count - sent > chunk_pixels) ? chunk_pixels : (pixel_count - sent);
-        
-        spi_transaction_ext_t t = {0};
-        t.base.flags = SPI_TRANS_MODE_QIO;
-        
-        if (sent == 0) {
-            t.base.flags |= SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR;
-            t.base.cmd = 0x32; // WRRAM
-            t.base.addr = 0x002C00;
-            t.command_bits = 8;
-            t.address_bits = 24;
-        } else {
-            t.base.flags |= SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR;
-            t.command_bits = 0;
-            t.address_bits = 0;
-        }
-        
-        if (sent + pixels_to_send < pixel_count) {
-             t.base.flags |= SPI_TRANS_CS_KEEP_ACTIVE;
+rm690b0_stream_t *rm_drv_stream(void) {
+    return &s_stream;
+}
+
+rm690b0_pipe_t *rm_drv_pipe(void) {
+    return &s_pipe;
+}
+
+esp_err_t rm_drv_flush_areas(const rm690b0_area_t *areas, uint8_t count,
+                             const uint16_t *img, size_t stride, bool copy) {
+    if (!s_bus) return ESP_ERR_INVALID_STATE;
+
+    esp_err_t ret = ESP_OK;
+    for (uint8_t i = 0; i < count && ret == ESP_OK; i++) {
+        const rm690b0_area_t *a = &areas[i];
+        uint16_t w = a->x2 - a->x1 + 1;
+        uint16_t h = a->y2 - a->y1 + 1;
+
+        ret = rm690b0_set_window(a->x1, a->y1, a->x2, a->y2);
+        if (ret != ESP_OK) break;
+
+        rm690b0_source_t src;
+        rm690b0_source_rect(&src, img + (size_t)a->y1 * stride + a->x1, stride, w, h);
+        if (copy) {
+            src.direct = NULL;
         }
-        
-        t.base.length = pixels_to_send * 16; 
-        t.base.tx_buffer = buffer;
-        
-        spi_device_polling_transmit(spi_handle, (spi_transaction_t *)&t);
-        sent += pixels_to_send;
+        ret = rm_stream_run(&s_stream, &src, NULL, NULL, NULL);
     }
-    
-    spi_device_release_bus(spi_handle);
-    free(buffer);
+
+    // The image may be referenced zero-copy
+    esp_err_t wret = rm_pipe_drain(&s_pipe, RM_BUS_WAIT_FOREVER);
+    return (ret != ESP_OK) ? ret : wret;
+}
+
+esp_err_t rm690b0_flush_damage(rm690b0_damage_t *d, const uint16_t *fb, size_t stride) {
+    esp_err_t ret = rm_drv_flush_areas(d->areas, d->count, fb, stride, false);
+    rm_damage_reset(d);
+    return ret;
+}
+
+esp_err_t rm690b0_fill_screen(uint16_t color) {
+    rm690b0_source_t src;
+    rm690b0_source_solid(&src, color, (size_t)current_width * current_height);
+
+    esp_err_t ret = rm690b0_draw_source(0, 0, current_width, current_height, &src);
+    if (ret != ESP_OK) return ret;
+
+    ret = rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
     vTaskDelay(pdMS_TO_TICKS(10)); // Allow controller to recover after massive write
-    return ESP_OK;
+    return ret;
 }
 
 void rm690b0_draw_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
-    rm690b0_set_window(x, y, x + w - 1, y + h - 1);
-    
-    size_t count = w * h;
-    size_t chunk_max = 4096;
-    uint16_t *buf = heap_caps_malloc(chunk_max * 2, MALLOC_CAP_DMA);
-    if (!buf) return;
-    
-    uint16_t c = (color >> 8) | (color << 8);
-    for(int i=0; i<chunk_max; i++) buf[i] = c;
-    
-    size_t sent = 0;
-    spi_device_acquire_bus(spi_handle, portMAX_DELAY);
-    
-    while(sent < count) {
-        size_t n = (count - sent > chunk_max) ? chunk_max : (count - sent);
-        
-        spi_transaction_ext_t t = {0};
-        t.base.flags = SPI_TRANS_MODE_QIO;
-        
-        if (sent == 0) {
-            t.base.flags |= SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR;
-            t.base.cmd = 0x32;
-            t.base.addr = 0x002C00;
-            t.command_bits = 8;
-            t.address_bits = 24;
-        } else {
-            t.base.flags |= SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR;
-            t.command_bits = 0;
-            t.address_bits = 0;
-        }
-        
-        if (sent + n < count) t.base.flags |= SPI_TRANS_CS_KEEP_ACTIVE;
-        
-        t.base.length = n * 16;
-        t.base.tx_buffer = buf;
-        spi_device_polling_transmit(spi_handle, (spi_transaction_t*)&t);
-        
-        sent += n;
-    }
-    spi_device_release_bus(spi_handle);
-    free(buf);
+    rm690b0_source_t src;
+    rm690b0_source_solid(&src, color, (size_t)w * h);
+    rm690b0_draw_source(x, y, w, h, &src);
 }
 
-void rm690b0_run_test_pattern(void) {
-    ESP_LOGI(TAG, "Running Test Pattern (LilyGo Logic)");
+static esp_err_t record_test_pattern(rm690b0_dlist_t *dl) {
+    uint16_t w = current_width, h = current_height;
+    esp_err_t ret = rm690b0_dlist_begin(dl, w, h);
+    if (ret != ESP_OK) return ret;
 
-    // Test in current Rotation
-    // rm690b0_set_rotation(1); 
-    
     // Clear display black first
-    rm690b0_fill_screen(RM_COLOR_BLACK);
-    
+    rm690b0_dlist_fill_screen(dl, RM_COLOR_BLACK);
+
     // Top-Left RED
-    rm690b0_draw_rect(0, 0, 50, 50, RM_COLOR_RED);
-    
+    rm690b0_dlist_fill(dl, 0, 0, 50, 50, RM_COLOR_RED);
+
     // Top-Right GREEN
-    rm690b0_draw_rect(current_width - 50, 0, 50, 50, RM_COLOR_GREEN);
-    
+    rm690b0_dlist_fill(dl, w - 50, 0, 50, 50, RM_COLOR_GREEN);
+
     // Bottom-Right BLUE
-    rm690b0_draw_rect(current_width - 50, current_height - 50, 50, 50, RM_COLOR_BLUE);
-    
+    rm690b0_dlist_fill(dl, w - 50, h - 50, 50, 50, RM_COLOR_BLUE);
+
     // Bottom-Left WHITE
-    rm690b0_draw_rect(0, current_height - 50, 50, 50, RM_COLOR_WHITE);
-    
+    rm690b0_dlist_fill(dl, 0, h - 50, 50, 50, RM_COLOR_WHITE);
+
     // Center YELLOW
-    rm690b0_draw_rect((current_width/2)-25, (current_height/2)-25, 50, 50, RM_COLOR_YELLOW);
+    rm690b0_dlist_fill(dl, (w/2)-25, (h/2)-25, 50, 50, RM_COLOR_YELLOW);
+
+    return rm690b0_dlist_end(dl);
+}
+
+void rm690b0_run_test_pattern(void) {
+    ESP_LOGI(TAG, "Running Test Pattern (LilyGo Logic)");
+
+    // Test in current Rotation
+    // rm690b0_set_rotation(1); 
+
+    // Replayed as one prepared sequence: the black clear only around the
+    // squares, then the squares, each window encoded once per rotation
+    rm690b0_dlist_t *dl = &s_pattern[s_rotation & 3];
+    esp_err_t ret = dl->data ? ESP_OK : record_test_pattern(dl);
+
+    // Still showing it in another rotation: only what differs goes out, the
+    // black around the squares mostly stays
+    bool shown = s_pattern_shown >= 0 && s_pattern_bursts == s_pipe.bursts;
+    if (ret == ESP_OK && shown && s_pattern_shown != s_rotation) {
+        rm690b0_dlist_t delta = {0};
+        ret = rm690b0_dlist_delta(&delta, dl, rm690b0_get_xform(), &s_pattern[s_pattern_shown],
+                                  rm690b0_xform_get(s_pattern_shown));
+        if (ret == ESP_OK) ret = rm690b0_dlist_play(&delta);
+        rm690b0_dlist_free(&delta);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Test pattern delta failed (%s), replaying it", esp_err_to_name(ret));
+            ret = rm690b0_dlist_play(dl);
+        }
+    } else if (ret == ESP_OK && !(shown && s_pattern_shown == s_rotation)) {
+        ret = rm690b0_dlist_play(dl);
+    }
+    s_pattern_shown = (ret == ESP_OK) ? (int8_t)s_rotation : -1;
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Test pattern replay failed (%s), drawing it", esp_err_to_name(ret));
+        rm690b0_fill_screen(RM_COLOR_BLACK);
+        rm690b0_draw_rect(0, 0, 50, 50, RM_COLOR_RED);
+        rm690b0_draw_rect(current_width - 50, 0, 50, 50, RM_COLOR_GREEN);
+        rm690b0_draw_rect(current_width - 50, current_height - 50, 50, 50, RM_COLOR_BLUE);
+        rm690b0_draw_rect(0, current_height - 50, 50, 50, RM_COLOR_WHITE);
+        rm690b0_draw_rect((current_width/2)-25, (current_height/2)-25, 50, 50, RM_COLOR_YELLOW);
+    }
+    s_pattern_bursts = s_pipe.bursts;
 
     ESP_LOGI(TAG, "Test Pattern Drawn: Corners + Center");
 }
@@ -2,8 +2,13 @@
 #define RM690B0_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "esp_err.h"
 #include "driver/spi_master.h"
+#include "rm690b0_stream.h"
+#include "rm690b0_damage.h"
+#include "rm690b0_raster.h"
+#include "rm690b0_xform.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -45,37 +50,286 @@ typedef struct {
 esp_err_t rm690b0_init(const rm690b0_config_t *config);
 
 /**
- * @brief Set the active window for drawing
+ * @brief Set the active window for drawing.
+ *
+ * CASET/RASET are queued with the pixel pipeline rather than sent blocking, so a
+ * window followed by rm690b0_write_pixels()/rm690b0_draw_source() goes out as one
+ * bus acquisition without any scheduler sleep.
  */
 esp_err_t rm690b0_set_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
 
+/**
+ * @brief Queue a raw DCS command in the same batch as windows and pixel bursts.
+ *
+ * Commands, windows and bursts queued back to back share one bus acquisition
+ * until rm690b0_flush_wait() (or any blocking call) ends the batch.
+ * @param data Parameters; up to 4 bytes are copied, longer ones must stay valid
+ *             until rm690b0_flush_wait() returns
+ */
+esp_err_t rm690b0_queue_cmd(uint8_t cmd, const uint8_t *data, size_t len);
+
 /**
  * @brief Write raw pixel data to the display
  */
 esp_err_t rm690b0_write_pixels(const uint16_t *data, size_t pixel_count);
 
+/**
+ * @brief Completion callback for asynchronous pixel transfers.
+ * Runs in the SPI post-transfer ISR on hardware; keep it short and ISR-safe.
+ */
+typedef void (*rm690b0_done_cb_t)(void *user_ctx);
+
+/**
+ * @brief Queue raw pixel data for the window already set, without waiting for the wire.
+ *
+ * The burst is split into 32KB DMA transactions with at most 8 in flight. The call
+ * returns once the last chunk is queued; it only blocks while the in-flight limit is
+ * reached. Any other rm690b0 call waits for queued transfers before touching the bus.
+ *
+ * @param data Big-endian RGB565 pixels. Must stay valid until done_cb fires or
+ *             rm690b0_flush_wait() returns. DMA-capable memory avoids a bounce copy.
+ * @param pixel_count Number of pixels
+ * @param done_cb Optional, called when the last chunk has been sent
+ * @param user_ctx Passed to done_cb
+ */
+esp_err_t rm690b0_write_pixels_async(const uint16_t *data, size_t pixel_count,
+                                     rm690b0_done_cb_t done_cb, void *user_ctx);
+
+/**
+ * @brief Wait for queued pixel transfers to finish and release the bus
+ * @param timeout_ms Per-transaction timeout, UINT32_MAX to wait forever
+ */
+esp_err_t rm690b0_flush_wait(uint32_t timeout_ms);
+
+/**
+ * @brief Borrow a DMA-capable scratch buffer from the driver pool.
+ *
+ * Buffers are internal RAM, cache-line aligned and RM_STREAM_CHUNK_PIXELS long.
+ * Waits only if every free buffer is still referenced by queued transfers.
+ * The buffer may be queued with rm690b0_write_pixels_async() before release;
+ * the pool will not hand it out again until those transfers are done.
+ * @param[out] buf Buffer
+ * @param[out] pixels Optional, capacity in pixels
+ * @return ESP_ERR_NOT_FOUND if every buffer is borrowed
+ */
+esp_err_t rm690b0_dma_acquire(uint16_t **buf, size_t *pixels);
+
+/**
+ * @brief Borrow a read-only pool buffer prefilled with a solid color.
+ * Repeated requests for the same color reuse the filled buffer.
+ * @param color RGB565 (native endian)
+ * @param count Pixels needed, at most RM_STREAM_CHUNK_PIXELS
+ * @param[out] buf Big-endian pixels, must not be written
+ */
+esp_err_t rm690b0_dma_acquire_solid(uint16_t color, size_t count, const uint16_t **buf);
+
+/**
+ * @brief Return a buffer from rm690b0_dma_acquire()/rm690b0_dma_acquire_solid()
+ */
+void rm690b0_dma_release(const uint16_t *buf);
+
+/**
+ * @brief Pool hits, waits and high-water mark
+ */
+void rm690b0_get_pool_stats(rm690b0_pool_stats_t *stats);
+
+/**
+ * @brief Select the interface pixel format (COLMOD), queued in order with drawing.
+ *
+ * Every later burst is packed from big-endian RGB565 on the fly: RGB332 and
+ * Gray256 halve the bytes on the wire, RGB111 quarters them. Images drawn
+ * through the display server can override it per command (rm690b0_cmd_t.ifpf).
+ * rm690b0_init() selects RM_IFPF_RGB565.
+ */
+esp_err_t rm690b0_set_interface_format(rm690b0_ifpf_t fmt);
+
+/**
+ * @brief Interface format set with rm690b0_set_interface_format()
+ */
+rm690b0_ifpf_t rm690b0_get_interface_format(void);
+
+/**
+ * @brief Pixels packed and bytes saved by reduced interface formats
+ */
+void rm690b0_get_ifpf_stats(rm690b0_ifpf_stats_t *stats);
+
+/**
+ * @brief Stream a pixel source into the area (x, y, w, h).
+ *
+ * All drawing calls are wrappers around this. Sources filled into the driver's
+ * bounce buffers may still be in flight on return; zero-copy sources (linear
+ * buffers) are waited for. See rm690b0_stream.h for the available sources.
+ *
+ * x and w must be even: the panel window is widened to whole column pairs, so
+ * an odd edge would shift every row of the source by one pixel.
+ */
+esp_err_t rm690b0_draw_source(uint16_t x, uint16_t y, uint16_t w, uint16_t h, rm690b0_source_t *src);
+
+/**
+ * @brief Copy a sub-rectangle of a big-endian image to the screen.
+ *
+ * The destination is clipped to the current rotation (it may start off-screen).
+ * Rows are streamed from the source as they are: packed images and wide rows
+ * in DMA-capable RAM go out zero-copy and are waited for, anything else is
+ * copied into the pool buffers chunk by chunk, never into a packed temporary.
+ * The panel addresses columns in pairs, so an odd left or right edge widens
+ * the window by one column, filled with the edge pixel repeated: the screen
+ * column next to the destination is overwritten. Neighbouring source columns
+ * (the next sprite in a sheet) are never sent.
+ *
+ * @param src_be Image, big-endian RGB565
+ * @param stride Image row pitch in pixels
+ * @param sx, sy Top-left of the sub-rectangle in the image
+ * @param w, h Sub-rectangle size
+ * @param dx, dy Destination of (sx, sy) on screen
+ */
+esp_err_t rm690b0_blit(const uint16_t *src_be, size_t stride, uint16_t sx, uint16_t sy,
+                       uint16_t w, uint16_t h, int16_t dx, int16_t dy);
+
+/**
+ * @brief Draw a packed w x h big-endian bitmap at (x, y), clipped
+ */
+esp_err_t rm690b0_draw_bitmap(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data_be);
+
+/**
+ * @brief Draw an R5Q compressed image (rm690b0_img.h), decoded straight into
+ * the bounce buffers while earlier chunks are on the wire.
+ *
+ * The image is not clipped. The panel window takes column pairs, so x and the
+ * width must be even (tools/rm690b0_img pads odd widths).
+ * @param file Encoded file, may live in memory-mapped flash
+ * @return ESP_ERR_INVALID_ARG for odd x / width or a bad file,
+ *         ESP_ERR_INVALID_SIZE if it does not fit on screen
+ */
+esp_err_t rm690b0_draw_image(uint16_t x, uint16_t y, const void *file, size_t size);
+
+/**
+ * @brief Send every damaged area of a framebuffer in one pass, then reset the tracker.
+ * @param d Tracker filled with rm_damage_add() in current rotation coordinates
+ * @param fb Big-endian RGB565 framebuffer of the current rotation
+ * @param stride Framebuffer row pitch in pixels
+ */
+esp_err_t rm690b0_flush_damage(rm690b0_damage_t *d, const uint16_t *fb, size_t stride);
+
 /**
  * @brief Fill the screen with a solid color
  */
 esp_err_t rm690b0_fill_screen(uint16_t color);
 
 /**
- * @brief Draw a rectangle outline
+ * @brief Fill a rectangle (same as a solid rm690b0_draw_source()). For an
+ * outline use rm_shape_round_rect() with a thickness and rm690b0_draw_shape().
  */
 void rm690b0_draw_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
 
+/**
+ * How rm690b0_draw_shape() paints. The panel cannot be read back, so
+ * anti-aliased edges blend towards bg, and spans widened to the even columns
+ * the window needs are padded with bg: the shape should sit on a bg area.
+ * Draw into the framebuffer (rm690b0_fb_draw_shape()) to blend with what is there.
+ */
+typedef struct {
+    uint16_t color;         // RGB565
+    uint16_t bg;            // RGB565 background under the shape
+    bool aa;                // Anti-alias edges
+    bool opaque;            // Repaint the whole bounding box (bg around the shape) in one window
+} rm690b0_paint_t;
+
+typedef struct {
+    uint32_t shapes;
+    uint32_t spans;         // Spans out of the rasterizer
+    uint32_t windows;       // Panel windows opened for them
+} rm690b0_shape_stats_t;
+
+/**
+ * @brief Rasterize a shape (rm690b0_raster.h) straight to the panel, clipped.
+ *
+ * Spans are merged into windows: contiguous spans of a row share one window,
+ * and identical solid runs on consecutive rows grow into one rectangle, so a
+ * non anti-aliased rectangle or rounded rectangle body costs a handful of
+ * windows. With paint->opaque the shape costs exactly one window.
+ */
+esp_err_t rm690b0_draw_shape(const rm_shape_t *shape, const rm690b0_paint_t *paint);
+
+void rm690b0_get_shape_stats(rm690b0_shape_stats_t *stats);
+
 /**
  * @brief Set display rotation (MADCTL)
- * @param rotation 0: Portrait (USB Bottom), 1: Landscape (USB Right), 2: Inv Port, 3: Inv Land
+ * @param rotation 0: Landscape (USB Bottom), 1: Portrait (USB Right), 2: Landscape (USB Top),
+ * 3: Portrait (USB Left); see rm690b0_xform.h
  */
 void rm690b0_set_rotation(uint8_t rotation);
 
+/**
+ * @brief Transform of the current rotation: screen size, offsets, mapping to
+ * native panel (and touch) coordinates
+ */
+const rm690b0_xform_t *rm690b0_get_xform(void);
+
+typedef void (*rm690b0_rotation_cb_t)(const rm690b0_xform_t *xf, void *ctx);
+
+/**
+ * @brief Called from rm690b0_set_rotation() (and rm690b0_init()) with the new
+ * transform, on the task that changed it. The HAL keeps touch in step with it.
+ */
+void rm690b0_set_rotation_cb(rm690b0_rotation_cb_t cb, void *ctx);
+
 /**
  * @brief Get the current display rotation
  * @return rotation 0-3
  */
 uint8_t rm690b0_get_rotation(void);
 
+/**
+ * @brief True when the current rotation can scroll vertically in hardware.
+ * VSCRDEF/VSCSAD act on native panel rows, which are screen columns in the
+ * landscape rotations (0 and 2).
+ */
+bool rm690b0_scroll_supported(void);
+
+/**
+ * @brief Define a vertical scroll area (VSCRDEF 0x33) in screen rows.
+ *
+ * Rows above and below stay fixed. Rotation offsets and mirrored row order
+ * are handled internally. The scroll position is reset to 0.
+ * @param top First scrolling row
+ * @param height Number of scrolling rows
+ * @return ESP_ERR_NOT_SUPPORTED in landscape rotations
+ */
+esp_err_t rm690b0_scroll_area(uint16_t top, uint16_t height);
+
+/**
+ * @brief Set the scroll position (VSCSAD 0x37).
+ *
+ * Screen row top + k then shows what was drawn at row top + (offset + k) % height.
+ * Queued with pending pixel transfers, so a newly drawn line and the scroll
+ * that reveals it go out in one batch.
+ * @param offset Rows scrolled, taken modulo the area height
+ */
+esp_err_t rm690b0_scroll_to(uint16_t offset);
+
+/**
+ * @brief Leave scroll mode (called by rm690b0_set_rotation())
+ */
+void rm690b0_scroll_reset(void);
+
+/**
+ * @brief Fire TE when the panel scan reaches a given line (STESL 0x44).
+ * The line is in native panel rows and is not affected by rotation.
+ * @param line Scanline 0-599
+ */
+void rm690b0_set_tear_scanline(uint16_t line);
+
+/**
+ * @brief Width of the current rotation in pixels
+ */
+uint16_t rm690b0_get_width(void);
+
+/**
+ * @brief Height of the current rotation in pixels
+ */
+uint16_t rm690b0_get_height(void);
+
 /**
  * @brief Run the built-in test pattern sequence (blocking)
  */
@@ -0,0 +1,322 @@
+#include "rm690b0_asset.h"
+#include "rm690b0.h"
+#include "rm690b0_img.h"
+#include "esp_partition.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "rm690b0_asset";
+
+// A cached image: big-endian RGB565 in PSRAM. pack == NULL with mem set means
+// the pack was closed while the entry was pinned; it is freed on release.
+typedef struct {
+    const rm690b0_asset_pack_t *pack;
+    uint16_t id;
+    uint16_t refs;
+    uint32_t last_use;
+    size_t bytes;
+    uint16_t *mem;
+} cache_slot_t;
+
+static cache_slot_t s_slots[RM_ASSET_CACHE_SLOTS];
+static rm690b0_asset_cache_stats_t s_stats;
+static uint32_t s_clock;
+static SemaphoreHandle_t s_lock = NULL;
+
+static void cache_lock(void) {
+    if (s_lock) xSemaphoreTake(s_lock, portMAX_DELAY);
+}
+
+static void cache_unlock(void) {
+    if (s_lock) xSemaphoreGive(s_lock);
+}
+
+static void slot_free(cache_slot_t *sl) {
+    s_stats.bytes_used -= sl->bytes;
+    heap_caps_free(sl->mem);
+    memset(sl, 0, sizeof(*sl));
+}
+
+// --- Cache ---
+
+esp_err_t rm690b0_asset_cache_init(size_t budget_bytes) {
+    if (!s_lock) {
+        s_lock = xSemaphoreCreateMutex();
+        if (!s_lock) return ESP_ERR_NO_MEM;
+    }
+    cache_lock();
+    s_stats.budget = budget_bytes;
+    cache_unlock();
+    ESP_LOGI(TAG, "PSRAM asset cache: %u KB", (unsigned)(budget_bytes / 1024));
+    return ESP_OK;
+}
+
+void rm690b0_asset_cache_deinit(void) {
+    cache_lock();
+    for (int i = 0; i < RM_ASSET_CACHE_SLOTS; i++) {
+        if (!s_slots[i].mem) continue;
+        if (s_slots[i].refs) {
+            ESP_LOGW(TAG, "Freeing pinned asset %u", s_slots[i].id);
+        }
+        slot_free(&s_slots[i]);
+    }
+    s_stats.budget = 0;
+    cache_unlock();
+}
+
+void rm690b0_asset_cache_get_stats(rm690b0_asset_cache_stats_t *stats) {
+    cache_lock();
+    *stats = s_stats;
+    cache_unlock();
+}
+
+static cache_slot_t *cache_find(const rm690b0_asset_t *a) {
+    for (int i = 0; i < RM_ASSET_CACHE_SLOTS; i++) {
+        if (s_slots[i].mem && s_slots[i].pack == a->pack && s_slots[i].id == a->id) return &s_slots[i];
+    }
+    return NULL;
+}
+
+// Make room for `bytes`, evicting the least recently used unpinned entries
+static cache_slot_t *cache_reserve(size_t bytes) {
+    if (bytes > s_stats.budget) return NULL;
+    for (;;) {
+        cache_slot_t *empty = NULL, *lru = NULL;
+        for (int i = 0; i < RM_ASSET_CACHE_SLOTS; i++) {
+            cache_slot_t *sl = &s_slots[i];
+            if (!sl->mem) {
+                if (!empty) empty = sl;
+            } else if (sl->refs == 0 && (!lru || sl->last_use < lru->last_use)) {
+                lru = sl;
+            }
+        }
+        if (empty && s_stats.bytes_used + bytes <= s_stats.budget) return empty;
+        if (!lru) return NULL;
+        slot_free(lru);
+        s_stats.evictions++;
+    }
+}
+
+// Copy or decode an image into PSRAM
+static cache_slot_t *cache_promote(const rm690b0_asset_t *a) {
+    size_t bytes = (size_t)a->w * a->h * 2;
+    cache_slot_t *sl = cache_reserve(bytes);
+    uint16_t *mem = sl ? heap_caps_aligned_alloc(RM_ASSET_ALIGN, bytes, MALLOC_CAP_SPIRAM) : NULL;
+    if (!mem) {
+        s_stats.rejected++;
+        return NULL;
+    }
+
+    if (a->type == RM_ASSET_R5Q) {
+        rm690b0_img_t img;
+        rm690b0_img_dec_t dec;
+        size_t n = 0;
+        if (rm690b0_img_open(&img, a->data, a->size) == ESP_OK && img.w == a->w && img.h == a->h) {
+            rm690b0_img_dec_init(&dec, &img);
+            n = rm690b0_img_decode(&dec, mem, (size_t)a->w * a->h);
+        }
+        if (n != (size_t)a->w * a->h) {
+            ESP_LOGE(TAG, "Asset %u: corrupt R5Q payload", a->id);
+            heap_caps_free(mem);
+            return NULL;
+        }
+    } else {
+        memcpy(mem, a->data, bytes);
+    }
+
+    *sl = (cache_slot_t){ .pack = a->pack, .id = a->id, .bytes = bytes, .mem = mem };
+    s_stats.bytes_used += bytes;
+    s_stats.promotions++;
+    return sl;
+}
+
+// Pinned PSRAM copy of an image, promoting it when it is hot (or when forced).
+// NULL: draw from the pack instead.
+static const uint16_t *cache_pin(const rm690b0_asset_t *a, bool force) {
+    cache_lock();
+    cache_slot_t *sl = cache_find(a);
+    if (sl) {
+        s_stats.hits++;
+    } else {
+        s_stats.misses++;
+        uint8_t *uses = &a->pack->uses[a->id];
+        if (*uses < UINT8_MAX) (*uses)++;
+        if (force || a->type == RM_ASSET_R5Q || *uses >= RM_ASSET_PROMOTE_USES) {
+            sl = cache_promote(a);
+        }
+    }
+    const uint16_t *mem = NULL;
+    if (sl) {
+        sl->refs++;
+        sl->last_use = ++s_clock;
+        mem = sl->mem;
+    }
+    cache_unlock();
+    return mem;
+}
+
+static void cache_unpin(const void *mem) {
+    cache_lock();
+    for (int i = 0; i < RM_ASSET_CACHE_SLOTS; i++) {
+        cache_slot_t *sl = &s_slots[i];
+        if (sl->mem != mem) continue;
+        if (sl->refs) sl->refs--;
+        if (!sl->refs && !sl->pack) slot_free(sl);
+        break;
+    }
+    cache_unlock();
+}
+
+// --- Packs ---
+
+esp_err_t rm690b0_asset_pack_open_mem(rm690b0_asset_pack_t *pack, const void *data, size_t size) {
+    memset(pack, 0, sizeof(*pack));
+    const rm690b0_asset_header_t *hdr = data;
+    if (size < sizeof(*hdr)) return ESP_ERR_INVALID_SIZE;
+    if (memcmp(hdr->magic, RM_ASSET_MAGIC, 4) != 0 || hdr->version != 1) {
+        ESP_LOGE(TAG, "Not an asset pack");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (hdr->size > size || sizeof(*hdr) + (size_t)hdr->count * sizeof(rm690b0_asset_entry_t) > hdr->size) {
+        ESP_LOGE(TAG, "Asset pack truncated (%u of %u bytes)", (unsigned)size, (unsigned)hdr->size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    const rm690b0_asset_entry_t *index = (const rm690b0_asset_entry_t *)(hdr + 1);
+    for (uint16_t i = 0; i < hdr->count; i++) {
+        const rm690b0_asset_entry_t *e = &index[i];
+        if (e->offset > hdr->size || e->size > hdr->size - e->offset ||
+            (e->type == RM_ASSET_RGB565 && e->size < (size_t)e->w * e->h * 2)) {
+            ESP_LOGE(TAG, "Asset %u out of bounds", i);
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+
+    pack->uses = calloc(hdr->count ? hdr->count : 1, 1);
+    if (!pack->uses) return ESP_ERR_NO_MEM;
+    pack->base = data;
+    pack->size = hdr->size;
+    pack->count = hdr->count;
+    pack->index = index;
+    return ESP_OK;
+}
+
+esp_err_t rm690b0_asset_pack_open(rm690b0_asset_pack_t *pack, const char *label) {
+    if (!label) label = RM_ASSET_PARTITION;
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (!part) {
+        ESP_LOGE(TAG, "No partition '%s'", label);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Map only as much as the pack uses, MMU pages are shared with the app and PSRAM
+    rm690b0_asset_header_t hdr;
+    esp_err_t ret = esp_partition_read(part, 0, &hdr, sizeof(hdr));
+    if (ret != ESP_OK) return ret;
+    if (memcmp(hdr.magic, RM_ASSET_MAGIC, 4) != 0 || hdr.size > part->size) {
+        ESP_LOGE(TAG, "Partition '%s' holds no asset pack", label);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const void *ptr;
+    esp_partition_mmap_handle_t map;
+    ret = esp_partition_mmap(part, 0, hdr.size, ESP_PARTITION_MMAP_DATA, &ptr, &map);
+    if (ret != ESP_OK) return ret;
+
+    ret = rm690b0_asset_pack_open_mem(pack, ptr, hdr.size);
+    if (ret != ESP_OK) {
+        esp_partition_munmap(map);
+        return ret;
+    }
+    pack->map = map;
+    pack->mapped = true;
+    ESP_LOGI(TAG, "Asset pack '%s': %u assets, %u KB", label, pack->count, (unsigned)(hdr.size / 1024));
+    return ESP_OK;
+}
+
+void rm690b0_asset_pack_close(rm690b0_asset_pack_t *pack) {
+    cache_lock();
+    for (int i = 0; i < RM_ASSET_CACHE_SLOTS; i++) {
+        cache_slot_t *sl = &s_slots[i];
+        if (!sl->mem || sl->pack != pack) continue;
+        if (sl->refs) {
+            sl->pack = NULL; // Freed by the last release
+        } else {
+            slot_free(sl);
+        }
+    }
+    cache_unlock();
+
+    if (pack->mapped) esp_partition_munmap(pack->map);
+    free(pack->uses);
+    memset(pack, 0, sizeof(*pack));
+}
+
+esp_err_t rm690b0_asset_get(rm690b0_asset_pack_t *pack, uint16_t id, rm690b0_asset_t *asset) {
+    if (id >= pack->count) return ESP_ERR_NOT_FOUND;
+    const rm690b0_asset_entry_t *e = &pack->index[id];
+    *asset = (rm690b0_asset_t){
+        .pack = pack, .id = id, .type = e->type, .w = e->w, .h = e->h,
+        .data = pack->base + e->offset, .size = e->size,
+    };
+    return ESP_OK;
+}
+
+esp_err_t rm690b0_asset_find(rm690b0_asset_pack_t *pack, const char *name, rm690b0_asset_t *asset) {
+    int lo = 0, hi = (int)pack->count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int c = strncmp(name, pack->index[mid].name, RM_ASSET_NAME_LEN);
+        if (c == 0) return rm690b0_asset_get(pack, mid, asset);
+        if (c < 0) hi = mid - 1;
+        else lo = mid + 1;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+// --- Access and drawing ---
+
+static bool is_image(const rm690b0_asset_t *a) {
+    return a->type == RM_ASSET_RGB565 || a->type == RM_ASSET_R5Q;
+}
+
+const void *rm690b0_asset_acquire(const rm690b0_asset_t *asset) {
+    if (!is_image(asset)) return asset->data;
+    const uint16_t *px = cache_pin(asset, true);
+    // Raw images can always be read from the mapped pack
+    if (!px && asset->type == RM_ASSET_RGB565) return asset->data;
+    return px;
+}
+
+void rm690b0_asset_release(const rm690b0_asset_t *asset, const void *data) {
+    if (is_image(asset) && data) cache_unpin(data);
+}
+
+esp_err_t rm690b0_blit_asset(const rm690b0_asset_t *asset, uint16_t sx, uint16_t sy,
+                             uint16_t w, uint16_t h, int16_t dx, int16_t dy) {
+    if (!is_image(asset)) return ESP_ERR_INVALID_ARG;
+    if ((uint32_t)sx + w > asset->w || (uint32_t)sy + h > asset->h) return ESP_ERR_INVALID_ARG;
+
+    const uint16_t *px = cache_pin(asset, false);
+    if (px) {
+        // PSRAM rows go through the bounce buffers; nothing is decoded
+        esp_err_t ret = rm690b0_blit(px, asset->w, sx, sy, w, h, dx, dy);
+        cache_unpin(px);
+        return ret;
+    }
+    if (asset->type == RM_ASSET_RGB565) {
+        return rm690b0_blit((const uint16_t *)asset->data, asset->w, sx, sy, w, h, dx, dy);
+    }
+
+    // Compressed and not cacheable: only whole, on-screen images can be streamed
+    if (sx || sy || w != asset->w || h != asset->h || dx < 0 || dy < 0) return ESP_ERR_NO_MEM;
+    return rm690b0_draw_image(dx, dy, asset->data, asset->size);
+}
+
+esp_err_t rm690b0_draw_asset(const rm690b0_asset_t *asset, int16_t x, int16_t y) {
+    return rm690b0_blit_asset(asset, 0, 0, asset->w, asset->h, x, y);
+}
@@ -0,0 +1,165 @@
+#ifndef RM690B0_ASSET_H
+#define RM690B0_ASSET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Asset packs: icons, backgrounds and fonts in one flash partition.
+ *
+ * A pack is a 32-byte header, an index of 32-byte entries sorted by name, and
+ * the payloads, each starting on a RM_ASSET_ALIGN boundary. Images are stored
+ * either as big-endian RGB565 rows ready for the wire or as R5Q
+ * (rm690b0_img.h). tools/rm690b0_img packs them:
+ *
+ *   rm690b0_img pack assets.bin icon_wifi=wifi.ppm bg=bg.ppm:r5q font=font.bin
+ *
+ * The partition is memory-mapped, so raw images are blitted straight from
+ * flash. Assets drawn repeatedly are promoted into an LRU cache in PSRAM with a
+ * byte budget; compressed images are decoded once on promotion, after which
+ * draws neither decode nor copy anything but the DMA bounce.
+ */
+
+#define RM_ASSET_MAGIC          "RMA1"
+#define RM_ASSET_ALIGN          64      // Payload alignment: cache line and DMA burst
+#define RM_ASSET_NAME_LEN       16      // Including the terminating NUL
+#define RM_ASSET_PARTITION      "assets"
+
+// Uses before a raw image is copied to PSRAM. R5Q images are promoted on first use.
+#define RM_ASSET_PROMOTE_USES   2
+#define RM_ASSET_CACHE_SLOTS    32
+
+typedef enum {
+    RM_ASSET_RGB565 = 1,    // w * h big-endian RGB565, packed rows
+    RM_ASSET_R5Q    = 2,    // R5Q file, w and h repeated in the index
+    RM_ASSET_BLOB   = 3,    // Opaque bytes (fonts, tables)
+} rm690b0_asset_type_t;
+
+// On-flash layout, little-endian
+typedef struct {
+    char magic[4];
+    uint16_t version;       // 1
+    uint16_t count;
+    uint32_t size;          // Whole pack in bytes
+    uint32_t reserved[5];
+} rm690b0_asset_header_t;
+
+typedef struct {
+    char name[RM_ASSET_NAME_LEN];
+    uint8_t type;           // rm690b0_asset_type_t
+    uint8_t flags;
+    uint16_t w, h;
+    uint16_t reserved;
+    uint32_t offset;        // From the start of the pack
+    uint32_t size;
+} rm690b0_asset_entry_t;
+
+_Static_assert(sizeof(rm690b0_asset_header_t) == 32, "asset header layout");
+_Static_assert(sizeof(rm690b0_asset_entry_t) == 32, "asset index layout");
+
+typedef struct {
+    const uint8_t *base;
+    size_t size;
+    uint16_t count;
+    const rm690b0_asset_entry_t *index;
+    uint8_t *uses;          // Per asset, saturating, for promotion
+    uint32_t map;           // esp_partition_mmap_handle_t, when mapped
+    bool mapped;
+} rm690b0_asset_pack_t;
+
+/**
+ * Asset handle, a small value to copy around. Valid while the pack is open.
+ */
+typedef struct {
+    rm690b0_asset_pack_t *pack;
+    uint16_t id;            // Index entry
+    uint8_t type;
+    uint16_t w, h;
+    const uint8_t *data;    // Payload in the mapped pack
+    size_t size;
+} rm690b0_asset_t;
+
+typedef struct {
+    uint32_t hits;          // Draws / acquires served from PSRAM
+    uint32_t misses;        // Served from flash (or decoded while streaming)
+    uint32_t promotions;    // Assets copied or decoded into PSRAM
+    uint32_t evictions;
+    uint32_t rejected;      // Promotions that did not fit the budget
+    size_t bytes_used;
+    size_t budget;
+} rm690b0_asset_cache_stats_t;
+
+/**
+ * @brief Set up the PSRAM cache
+ * @param budget_bytes Cache size, 0 disables promotion
+ */
+esp_err_t rm690b0_asset_cache_init(size_t budget_bytes);
+
+/**
+ * @brief Free every cached asset. Pinned assets must have been released.
+ */
+void rm690b0_asset_cache_deinit(void);
+
+void rm690b0_asset_cache_get_stats(rm690b0_asset_cache_stats_t *stats);
+
+/**
+ * @brief Map a pack partition
+ * @param label Partition label, NULL for RM_ASSET_PARTITION
+ */
+esp_err_t rm690b0_asset_pack_open(rm690b0_asset_pack_t *pack, const char *label);
+
+/**
+ * @brief Use a pack already in memory (embedded array, test data)
+ */
+esp_err_t rm690b0_asset_pack_open_mem(rm690b0_asset_pack_t *pack, const void *data, size_t size);
+
+/**
+ * @brief Drop the pack's cached assets and unmap it
+ */
+void rm690b0_asset_pack_close(rm690b0_asset_pack_t *pack);
+
+/**
+ * @brief Look an asset up by name (binary search of the index)
+ */
+esp_err_t rm690b0_asset_find(rm690b0_asset_pack_t *pack, const char *name, rm690b0_asset_t *asset);
+
+/**
+ * @brief Asset by index position, for iterating a pack
+ */
+esp_err_t rm690b0_asset_get(rm690b0_asset_pack_t *pack, uint16_t id, rm690b0_asset_t *asset);
+
+/**
+ * @brief Pin an asset and get its bytes: big-endian RGB565 for images (R5Q is
+ * decoded into the cache), the payload for blobs. Counts as a use. Raw images
+ * that do not fit the cache are returned from the mapped pack.
+ * @return NULL if an R5Q image cannot be cached (no budget)
+ */
+const void *rm690b0_asset_acquire(const rm690b0_asset_t *asset);
+
+/**
+ * @brief Unpin what rm690b0_asset_acquire() returned
+ */
+void rm690b0_asset_release(const rm690b0_asset_t *asset, const void *data);
+
+/**
+ * @brief Draw a whole image asset at (x, y), clipped
+ */
+esp_err_t rm690b0_draw_asset(const rm690b0_asset_t *asset, int16_t x, int16_t y);
+
+/**
+ * @brief Blit a sub-rectangle of an image asset, see rm690b0_blit()
+ */
+esp_err_t rm690b0_blit_asset(const rm690b0_asset_t *asset, uint16_t sx, uint16_t sy,
+                             uint16_t w, uint16_t h, int16_t dx, int16_t dy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
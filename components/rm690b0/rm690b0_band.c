@@ -0,0 +1,338 @@
+#include "rm690b0_band.h"
+#include "rm690b0.h"
+#include "rm690b0_priv.h"
+#include "rm690b0_color.h"
+#include "rm690b0_sched.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "rm690b0_band";
+
+// Buffers are sized for the longest side of any rotation
+#define BAND_MAX_W          600
+// One band, one DMA transaction
+#define BAND_LIMIT_ROWS     (RM_BUS_CHUNK_BYTES / (2 * BAND_MAX_W))
+
+typedef struct {
+    uint16_t *buf[RM_BAND_MAX_BUFFERS];
+    uint32_t seq[RM_BAND_MAX_BUFFERS];  // Pipe sequence of the band last pushed from each buffer
+    uint8_t nbuf;
+    uint16_t max_rows, min_rows;
+    uint16_t rows;              // Current band height, landscape rows
+    uint16_t bg_be;
+    bool fixed;
+    const rm690b0_band_item_t *items;
+    size_t count;
+    rm690b0_band_render_fn_t render;
+    void *render_ctx;
+    SemaphoreHandle_t text_lock;    // The glyph atlas is shared by the workers
+    rm_raster_t raster[RM_SCHED_MAX_WORKERS + 1];
+    // Current draw, read by the workers
+    uint16_t w, height, y_end, band_rows;
+    int16_t y0;
+    rm690b0_band_timing_t timings[RM_BAND_MAX_BANDS];
+    int64_t queued_us[RM_BAND_MAX_BANDS];
+    volatile int64_t done_us[RM_BAND_MAX_BANDS];    // Set by the transfer ISR
+    size_t nbands;
+    rm690b0_band_stats_t stats;
+} band_ctx_t;
+
+static band_ctx_t s_band;
+
+static void band_done(void *arg) {
+    *(volatile int64_t *)arg = esp_timer_get_time();
+}
+
+// --- Rendering ---
+
+typedef struct {
+    rm_raster_canvas_t canvas;
+    int16_t y0;
+} band_canvas_t;
+
+static void band_span(void *ctx, int16_t x, int16_t y, uint16_t len, uint8_t alpha) {
+    band_canvas_t *c = ctx;
+    rm_raster_canvas_span(&c->canvas, x, y - c->y0, len, alpha);
+}
+
+// Intersect an item rectangle with the band, false when it misses
+static bool band_clip(const rm690b0_band_item_t *it, int32_t w, int32_t y0, int32_t y1,
+                      int32_t *x0, int32_t *r0, int32_t *x1, int32_t *r1) {
+    *x0 = (it->x > 0) ? it->x : 0;
+    *x1 = (it->x + it->w < w) ? it->x + it->w : w;
+    *r0 = (it->y > y0) ? it->y : y0;
+    *r1 = (it->y + it->h < y1) ? it->y + it->h : y1;
+    return *x0 < *x1 && *r0 < *r1;
+}
+
+static void band_render(uint16_t *buf, uint16_t w, uint16_t h, int16_t y0, uint16_t rows, rm_raster_t *raster) {
+    size_t n = (size_t)w * rows;
+    for (size_t i = 0; i < n; i++) buf[i] = s_band.bg_be;
+
+    int32_t y1 = y0 + rows;
+    for (size_t i = 0; i < s_band.count; i++) {
+        const rm690b0_band_item_t *it = &s_band.items[i];
+        int32_t x0, r0, x1, r1;
+        switch (it->op) {
+            case RM_BAND_FILL: {
+                if (!band_clip(it, w, y0, y1, &x0, &r0, &x1, &r1)) break;
+                uint16_t be = rm_color_be(it->color);
+                for (int32_t r = r0; r < r1; r++) {
+                    uint16_t *dst = buf + (size_t)(r - y0) * w;
+                    for (int32_t c = x0; c < x1; c++) dst[c] = be;
+                }
+                break;
+            }
+            case RM_BAND_BITMAP: {
+                if (!band_clip(it, w, y0, y1, &x0, &r0, &x1, &r1)) break;
+                const uint16_t *src = it->data;
+                for (int32_t r = r0; r < r1; r++) {
+                    memcpy(buf + (size_t)(r - y0) * w + x0,
+                           src + (size_t)(r - it->y) * it->stride + (x0 - it->x), (size_t)(x1 - x0) * 2);
+                }
+                break;
+            }
+            case RM_BAND_SHAPE: {
+                rm_raster_init(raster, w, h, it->aa);
+                rm_raster_set_clip(raster, 0, y0, w, y1);
+                band_canvas_t c = { { .px = buf, .stride = w, .color = it->color }, y0 };
+                rm_raster_fill(raster, it->data, band_span, &c);
+                break;
+            }
+            case RM_BAND_TEXT:
+                if (it->y >= y1) break;
+                xSemaphoreTake(s_band.text_lock, portMAX_DELAY);
+                rm690b0_text_draw_rows(it->style, it->x, it->y, it->data, buf, w, y0, rows);
+                xSemaphoreGive(s_band.text_lock);
+                break;
+            default:
+                break;
+        }
+    }
+    if (s_band.render) s_band.render(s_band.render_ctx, buf, w, (uint16_t)y0, rows);
+}
+
+// Band k of the current draw, on a worker or the calling task
+static void band_job(void *ctx, uint32_t k, uint8_t worker) {
+    uint16_t row = s_band.y0 + k * s_band.band_rows;
+    uint16_t n = (s_band.y_end - row < s_band.band_rows) ? s_band.y_end - row : s_band.band_rows;
+    uint16_t *buf = s_band.buf[k % s_band.nbuf];
+    rm690b0_ifpf_t ifpf = rm_drv_stream()->ifpf;
+
+    int64_t t1 = esp_timer_get_time();
+    band_render(buf, s_band.w, s_band.height, (int16_t)row, n, &s_band.raster[worker]);
+    if (ifpf != RM_IFPF_RGB565) rm_color_pack(ifpf, (uint8_t *)buf, buf, (size_t)s_band.w * n);
+    int64_t t2 = esp_timer_get_time();
+    s_band.timings[k] = (rm690b0_band_timing_t){ .y = row, .rows = n, .render_us = (uint32_t)(t2 - t1) };
+}
+
+// --- Adaptation ---
+
+// Renderer slower than the wire: the wire idles between bands, and taller
+// bands spread the per-band costs over more rows. Renderer well ahead: shorter
+// bands get the first rows out sooner at no loss of throughput.
+static void band_adapt(uint32_t render_us, uint32_t transmit_us, uint16_t limit) {
+    if (s_band.fixed || s_band.nbands < 4) return;
+    uint16_t step = s_band.rows / 4 ? s_band.rows / 4 : 1;
+    if (render_us > transmit_us && s_band.rows < limit) {
+        s_band.rows = (s_band.rows + step < limit) ? s_band.rows + step : limit;
+        s_band.stats.grows++;
+    } else if (render_us < transmit_us / 2 && s_band.rows > s_band.min_rows) {
+        s_band.rows = (s_band.rows - step > s_band.min_rows) ? s_band.rows - step : s_band.min_rows;
+        s_band.stats.shrinks++;
+    }
+}
+
+// --- API ---
+
+esp_err_t rm690b0_band_init(const rm690b0_band_config_t *config) {
+    if (!config) return ESP_ERR_INVALID_ARG;
+    rm690b0_band_deinit();
+
+    uint16_t max_rows = config->max_rows ? config->max_rows : RM_BAND_DEFAULT_ROWS;
+    uint16_t min_rows = config->min_rows ? config->min_rows : RM_BAND_MIN_ROWS;
+    if (max_rows > BAND_LIMIT_ROWS) {
+        ESP_LOGW(TAG, "Band height %u over one DMA transaction, using %u", max_rows, BAND_LIMIT_ROWS);
+        max_rows = BAND_LIMIT_ROWS;
+    }
+    // Few enough bands per frame for the timing table, in either rotation
+    uint16_t floor_rows = (BAND_MAX_W + RM_BAND_MAX_BANDS - 1) / RM_BAND_MAX_BANDS;
+    if (max_rows < floor_rows) {
+        ESP_LOGW(TAG, "Band height %u gives over %u bands per frame, using %u", max_rows, RM_BAND_MAX_BANDS, floor_rows);
+        max_rows = floor_rows;
+    }
+    if (min_rows < floor_rows) min_rows = floor_rows;
+    if (min_rows > max_rows) min_rows = max_rows;
+    // One band on the wire, one rendering per worker
+    uint8_t nbuf = config->buffers ? config->buffers : 2 + rm690b0_sched_workers();
+    if (nbuf < 2) nbuf = 2;
+    if (nbuf > RM_BAND_MAX_BUFFERS) nbuf = RM_BAND_MAX_BUFFERS;
+
+    s_band.text_lock = xSemaphoreCreateMutex();
+    if (!s_band.text_lock) return ESP_ERR_NO_MEM;
+    size_t bytes = (size_t)BAND_MAX_W * max_rows * 2;
+    for (int i = 0; i < nbuf; i++) {
+        s_band.buf[i] = heap_caps_aligned_alloc(16, bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!s_band.buf[i]) {
+            ESP_LOGE(TAG, "OOM allocating %u KB band buffers", (unsigned)(nbuf * bytes / 1024));
+            rm690b0_band_deinit();
+            return ESP_ERR_NO_MEM;
+        }
+        s_band.seq[i] = 0;
+    }
+    s_band.nbuf = nbuf;
+    s_band.max_rows = max_rows;
+    s_band.min_rows = min_rows;
+    s_band.rows = max_rows;
+    s_band.bg_be = rm_color_be(config->bg);
+    s_band.fixed = config->fixed;
+    memset(&s_band.stats, 0, sizeof(s_band.stats));
+    ESP_LOGI(TAG, "Band buffers: %u x %u rows, %u KB", nbuf, max_rows, (unsigned)(nbuf * bytes / 1024));
+    return ESP_OK;
+}
+
+void rm690b0_band_deinit(void) {
+    for (int i = 0; i < RM_BAND_MAX_BUFFERS; i++) {
+        heap_caps_free(s_band.buf[i]);
+        s_band.buf[i] = NULL;
+    }
+    s_band.nbuf = 0;
+    if (s_band.text_lock) vSemaphoreDelete(s_band.text_lock);
+    s_band.text_lock = NULL;
+}
+
+void rm690b0_band_set_list(const rm690b0_band_item_t *items, size_t count) {
+    s_band.items = items;
+    s_band.count = items ? count : 0;
+}
+
+void rm690b0_band_set_render(rm690b0_band_render_fn_t fn, void *ctx) {
+    s_band.render = fn;
+    s_band.render_ctx = ctx;
+}
+
+esp_err_t rm690b0_band_draw(uint16_t y, uint16_t h) {
+    if (!s_band.buf[0]) return ESP_ERR_INVALID_STATE;
+    uint16_t w = rm690b0_get_width(), height = rm690b0_get_height();
+    if (y >= height) return ESP_ERR_INVALID_ARG;
+    if (h > height - y) h = height - y;
+    if (h == 0) return ESP_OK;
+
+    // Portrait rows are shorter: the same buffers hold more of them
+    uint16_t limit = (uint16_t)((size_t)BAND_MAX_W * s_band.max_rows / w);
+    if (limit > RM_BUS_CHUNK_BYTES / (2 * w)) limit = RM_BUS_CHUNK_BYTES / (2 * w);
+    uint16_t rows = (uint16_t)((size_t)s_band.rows * BAND_MAX_W / w);
+    if (rows > limit) rows = limit;
+    if (rows < s_band.min_rows) rows = s_band.min_rows;
+    // The timing table holds RM_BAND_MAX_BANDS bands
+    if ((h + rows - 1) / rows > RM_BAND_MAX_BANDS) rows = (h + RM_BAND_MAX_BANDS - 1) / RM_BAND_MAX_BANDS;
+    if (rows > limit) return ESP_ERR_INVALID_SIZE;
+
+    rm690b0_stream_t *stream = rm_drv_stream();
+    rm690b0_pipe_t *pipe = rm_drv_pipe();
+    size_t nb = (h + rows - 1) / rows;
+    uint8_t nbuf = s_band.nbuf;
+    s_band.w = w;
+    s_band.height = height;
+    s_band.y0 = y;
+    s_band.y_end = y + h;
+    s_band.band_rows = rows;
+
+    // With workers, up to nbuf - 1 bands render while one is on the wire; band
+    // k may start once band k - nbuf, the last one out of its buffer, is sent
+    uint8_t workers = rm690b0_sched_workers();
+    bool par = workers > 0 && rm690b0_sched_begin(band_job, NULL) == ESP_OK;
+    if (par) {
+        for (size_t k = 0; k < nb && k < nbuf; k++) rm690b0_sched_submit(k);
+    }
+
+    int64_t t_start = esp_timer_get_time();
+    esp_err_t ret = rm690b0_set_window(0, y, w - 1, y + h - 1);
+    size_t k = 0;
+    for (; k < nb && ret == ESP_OK; k++) {
+        uint8_t b = k % nbuf;
+        int64_t t0 = esp_timer_get_time();
+        if (par) {
+            // Band k - 1 is queued behind band k - 2: the buffer of k - 2 can
+            // take band k - 2 + nbuf once it is sent
+            size_t next = k - 2 + nbuf;
+            if (k >= 2 && next < nb) {
+                ret = rm_pipe_wait_seq(pipe, s_band.seq[(k - 2) % nbuf]);
+                if (ret != ESP_OK) break;
+                rm690b0_sched_submit(next);
+            }
+            rm690b0_sched_wait(k);
+        } else {
+            if (k >= nbuf) ret = rm_pipe_wait_seq(pipe, s_band.seq[b]);
+            if (ret != ESP_OK) break;
+            band_job(NULL, k, 0);
+        }
+        int64_t t1 = esp_timer_get_time();
+        rm690b0_band_timing_t *t = &s_band.timings[k];
+        t->wait_us = (uint32_t)(t1 - t0) - (par ? 0 : t->render_us);
+
+        size_t px = (size_t)w * t->rows;
+        size_t bytes = rm_ifpf_bytes(stream->ifpf, px);
+        if (stream->ifpf != RM_IFPF_RGB565) {
+            stream->ifpf_stats.pixels_packed += px;
+            stream->ifpf_stats.bytes_sent += bytes;
+            stream->ifpf_stats.bytes_saved += px * 2 - bytes;
+        }
+        if (k > 0 && s_band.done_us[k - 1] != 0) s_band.stats.dma_idle++;
+        s_band.queued_us[k] = t1;
+        s_band.done_us[k] = 0;
+        ret = rm_pipe_push(pipe, s_band.buf[b], bytes, k + 1 == nb, band_done, (void *)&s_band.done_us[k], &s_band.seq[b]);
+    }
+    if (par) rm690b0_sched_end();
+    esp_err_t dret = rm_pipe_drain(pipe, RM_BUS_WAIT_FOREVER);
+    if (ret == ESP_OK) ret = dret;
+    s_band.nbands = k;
+
+    // A band is on the wire from when it was queued or the one before it was
+    // done, whichever is later
+    uint32_t render = 0, transmit = 0, wait = 0;
+    for (size_t i = 0; i < s_band.nbands; i++) {
+        rm690b0_band_timing_t *t = &s_band.timings[i];
+        int64_t start = s_band.queued_us[i];
+        if (i > 0 && s_band.done_us[i - 1] > start) start = s_band.done_us[i - 1];
+        t->transmit_us = (s_band.done_us[i] > start) ? (uint32_t)(s_band.done_us[i] - start) : 0;
+        render += t->render_us;
+        transmit += t->transmit_us;
+        wait += t->wait_us;
+    }
+
+    rm690b0_band_stats_t *st = &s_band.stats;
+    st->frames++;
+    st->bands += k;
+    st->frame_us = (uint32_t)(esp_timer_get_time() - t_start);
+    st->render_us = render;
+    st->transmit_us = transmit;
+    st->wait_us = wait;
+    st->parallel = par ? workers : 0;
+    if (ret == ESP_OK && h == height) {
+        // Bands rendering at once share the render time
+        uint32_t lanes = (par && workers < nbuf - 1) ? workers : (par ? nbuf - 1u : 1u);
+        // Heights are kept in landscape rows so a rotation keeps the memory use
+        band_adapt(render / lanes, transmit, s_band.max_rows);
+    }
+    st->rows = s_band.rows;
+    st->buffer_rows = limit;
+    return ret;
+}
+
+esp_err_t rm690b0_band_frame(void) {
+    return rm690b0_band_draw(0, rm690b0_get_height());
+}
+
+void rm690b0_band_get_stats(rm690b0_band_stats_t *stats) {
+    *stats = s_band.stats;
+}
+
+const rm690b0_band_timing_t *rm690b0_band_get_timings(size_t *count) {
+    *count = s_band.nbands;
+    return s_band.timings;
+}
@@ -0,0 +1,146 @@
+#ifndef RM690B0_BAND_H
+#define RM690B0_BAND_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "rm690b0_raster.h"
+#include "rm690b0_text.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Band renderer: full-screen updates without a framebuffer.
+ *
+ * The screen is rendered in horizontal bands of full width into two band
+ * buffers in internal DMA-capable RAM. While one band is on the wire the
+ * next one is rendered into the other buffer; the bands of a frame go out as
+ * one window and one RAMWR burst, top to bottom. Each band is cleared to the
+ * background, then the display list is drawn into it (every item clipped to
+ * the band), then the render callback runs for anything else.
+ *
+ * Memory is fixed at init: 2 x 600 x max_rows pixels (57 KB for 24 rows)
+ * without workers, against 540 KB of PSRAM for rm690b0_fb.h. Band height
+ * adapts between frames to the measured render and transmit times: per-band
+ * costs (walking the display list, one DMA transaction) are amortized by
+ * taller bands while the renderer is the bottleneck, and bands shrink while
+ * it has time to spare, so the first rows leave sooner. Bands never exceed
+ * one DMA transaction.
+ *
+ * With rm690b0_sched.h workers running, bands render in parallel into more
+ * buffers while the calling task sends them in order, top to bottom. The
+ * result is the same whatever the number of workers: every band is rendered
+ * from the display list alone. Text items take a lock, the glyph atlas is
+ * shared; the render callback then runs on the workers, for different bands
+ * at once.
+ *
+ * To race the panel scan, start frames right after a TE edge
+ * (ws_241_vsync_wait()). Like the other draw calls, use from the task that
+ * owns the display.
+ */
+
+#define RM_BAND_DEFAULT_ROWS    24      // Band buffer height in landscape
+#define RM_BAND_MIN_ROWS        8
+#define RM_BAND_MAX_BANDS       80      // Bands per draw at the smallest height
+#define RM_BAND_MAX_BUFFERS     6
+
+typedef enum {
+    RM_BAND_FILL,           // Rectangle x, y, w, h of color
+    RM_BAND_BITMAP,         // Big-endian RGB565 at x, y, w x h, row pitch stride
+    RM_BAND_SHAPE,          // rm_shape_t in data, color, aa
+    RM_BAND_TEXT,           // UTF-8 in data at x, y with style
+} rm690b0_band_op_t;
+
+typedef struct {
+    uint8_t op;             // rm690b0_band_op_t
+    bool aa;
+    int16_t x, y;
+    uint16_t w, h;
+    uint16_t color;         // RGB565 (native endian)
+    const void *data;
+    size_t stride;          // Pixels
+    const rm690b0_text_style_t *style;
+} rm690b0_band_item_t;
+
+/**
+ * @brief Draw into a band after the display list. Runs on the workers when
+ * rm690b0_sched.h is started.
+ * @param band_be Screen row y, column 0; rows rows of stride pixels
+ */
+typedef void (*rm690b0_band_render_fn_t)(void *ctx, uint16_t *band_be, size_t stride,
+                                         uint16_t y, uint16_t rows);
+
+typedef struct {
+    uint16_t max_rows;      // Band buffer height, 0: RM_BAND_DEFAULT_ROWS; raised to 600 / RM_BAND_MAX_BANDS
+    uint16_t min_rows;      // Lower bound of the adaptation, 0: RM_BAND_MIN_ROWS
+    uint16_t bg;            // Band background, RGB565 (native endian)
+    bool fixed;             // Keep max_rows, do not adapt
+    uint8_t buffers;        // Band buffers, 0: 2 plus one per running rm690b0_sched.h worker
+} rm690b0_band_config_t;
+
+typedef struct {
+    uint16_t y, rows;
+    uint32_t render_us;     // Clear, display list and callback
+    uint32_t transmit_us;   // On the wire: from queued (or the previous band done) to done
+    uint32_t wait_us;       // Sending task blocked for a buffer or, with workers, for the band
+} rm690b0_band_timing_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t bands;
+    uint32_t dma_idle;      // Bands queued after the wire had already gone idle
+    uint32_t grows, shrinks; // Band height adaptations
+    uint16_t rows;          // Current band height
+    uint16_t buffer_rows;   // Band buffer height in the current rotation
+    uint8_t parallel;       // Workers that rendered the last draw, 0: the calling task
+    // Last frame
+    uint32_t frame_us;
+    uint32_t render_us, transmit_us, wait_us;
+} rm690b0_band_stats_t;
+
+/**
+ * @brief Allocate the band buffers. Start rm690b0_sched.h first to size
+ * them for its workers.
+ */
+esp_err_t rm690b0_band_init(const rm690b0_band_config_t *config);
+
+void rm690b0_band_deinit(void);
+
+/**
+ * @brief Display list drawn into every band, in order. Kept referenced, with
+ * everything it points to, until replaced.
+ */
+void rm690b0_band_set_list(const rm690b0_band_item_t *items, size_t count);
+
+/**
+ * @brief Callback run for every band after the display list, NULL: none
+ */
+void rm690b0_band_set_render(rm690b0_band_render_fn_t fn, void *ctx);
+
+/**
+ * @brief Render and send rows y .. y + h - 1, full width. Blocks until the
+ * last band is on the panel.
+ */
+esp_err_t rm690b0_band_draw(uint16_t y, uint16_t h);
+
+/**
+ * @brief rm690b0_band_draw() of the whole screen
+ */
+esp_err_t rm690b0_band_frame(void);
+
+void rm690b0_band_get_stats(rm690b0_band_stats_t *stats);
+
+/**
+ * @brief Per-band timings of the last draw
+ * @param[out] count Bands
+ */
+const rm690b0_band_timing_t *rm690b0_band_get_timings(size_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,166 @@
+#include "rm690b0_bus.h"
+#include <string.h>
+
+void rm_pipe_init(rm690b0_pipe_t *p, rm690b0_bus_t *bus, uint8_t depth) {
+    if (depth < 1) depth = 1;
+    if (depth > RM_BUS_QUEUE_DEPTH) depth = RM_BUS_QUEUE_DEPTH;
+
+    p->bus = bus;
+    p->depth = depth;
+    p->inflight = 0;
+    p->held = false;
+    p->in_burst = false;
+    p->chunks = 0;
+    p->reaped = 0;
+    p->stalls = 0;
+    p->bursts = 0;
+}
+
+static esp_err_t pipe_reap_one(rm690b0_pipe_t *p, uint32_t timeout_ms) {
+    esp_err_t ret = p->bus->reap(p->bus, timeout_ms);
+    if (ret != ESP_OK) return ret;
+    p->inflight--;
+    p->reaped++;
+    return ESP_OK;
+}
+
+// Queue one transaction, reaping the oldest one first if the pipe is full
+static esp_err_t pipe_submit(rm690b0_pipe_t *p, const rm690b0_bus_trans_t *t) {
+    if (p->inflight >= p->depth) {
+        p->stalls++;
+        esp_err_t ret = pipe_reap_one(p, RM_BUS_WAIT_FOREVER);
+        if (ret != ESP_OK) return ret;
+    }
+
+    esp_err_t ret = p->bus->queue(p->bus, t);
+    if (ret != ESP_OK) return ret;
+    p->inflight++;
+    p->chunks++;
+    return ESP_OK;
+}
+
+// CS_KEEP_ACTIVE needs the bus acquired for the whole sequence
+static esp_err_t pipe_hold(rm690b0_pipe_t *p) {
+    if (!p->held) {
+        esp_err_t ret = p->bus->acquire(p->bus);
+        if (ret != ESP_OK) return ret;
+        p->held = true;
+    }
+    return ESP_OK;
+}
+
+esp_err_t rm_pipe_cmd(rm690b0_pipe_t *p, uint8_t cmd, const uint8_t *data, size_t len) {
+    if (!p->bus) return ESP_ERR_INVALID_ARG;
+    if (p->in_burst) return ESP_ERR_INVALID_STATE;
+
+    esp_err_t ret = pipe_hold(p);
+    if (ret != ESP_OK) return ret;
+
+    rm690b0_bus_trans_t t = {
+        .flags = RM_BUS_FLAG_HEADER,
+        .opcode = RM_BUS_OP_CMD,
+        .cmd = cmd,
+        .length = len,
+    };
+
+    if (len <= sizeof(t.inline_data)) {
+        t.flags |= RM_BUS_FLAG_INLINE;
+        if (len) memcpy(t.inline_data, data, len);
+    } else {
+        t.tx_buffer = data;
+    }
+
+    return pipe_submit(p, &t);
+}
+
+esp_err_t rm_pipe_push(rm690b0_pipe_t *p, const void *data, size_t len, bool last,
+                       rm690b0_bus_done_cb_t done_cb, void *done_arg, uint32_t *seq) {
+    if (!p->bus || !data || len == 0) return ESP_ERR_INVALID_ARG;
+
+    esp_err_t ret = pipe_hold(p);
+    if (ret != ESP_OK) return ret;
+
+    rm690b0_bus_trans_t t = {
+        .flags = RM_BUS_FLAG_QIO,
+        .tx_buffer = data,
+        .length = len,
+        .done_cb = done_cb,
+        .done_arg = done_arg,
+    };
+
+    if (!p->in_burst) {
+        // First chunk: Write RAM header 0x32 00 2C 00
+        t.flags |= RM_BUS_FLAG_HEADER;
+        t.opcode = RM_BUS_OP_PIXELS;
+        t.cmd = RM_CMD_RAMWR;
+    }
+    if (!last) {
+        t.flags |= RM_BUS_FLAG_KEEP_CS;
+    }
+
+    ret = pipe_submit(p, &t);
+    if (ret != ESP_OK) return ret;
+
+    if (!p->in_burst) p->bursts++;
+    p->in_burst = !last;
+    if (seq) *seq = p->chunks;
+    return ESP_OK;
+}
+
+esp_err_t rm_pipe_write(rm690b0_pipe_t *p, const void *data, size_t len,
+                        rm690b0_bus_done_cb_t done_cb, void *done_arg) {
+    if (len == 0) return ESP_OK;
+
+    size_t sent = 0;
+    while (sent < len) {
+        size_t chunk = (len - sent > RM_BUS_CHUNK_BYTES) ? RM_BUS_CHUNK_BYTES : (len - sent);
+        bool last = (sent + chunk == len);
+
+        esp_err_t ret = rm_pipe_push(p, (const uint8_t *)data + sent, chunk, last,
+                                     last ? done_cb : NULL, done_arg, NULL);
+        if (ret != ESP_OK) return ret;
+        sent += chunk;
+    }
+    return ESP_OK;
+}
+
+esp_err_t rm_pipe_wait_seq(rm690b0_pipe_t *p, uint32_t seq) {
+    // Sequence numbers wrap, compare by distance
+    while (p->inflight > 0 && (int32_t)(p->reaped - seq) < 0) {
+        esp_err_t ret = pipe_reap_one(p, RM_BUS_WAIT_FOREVER);
+        if (ret != ESP_OK) return ret;
+    }
+    return ESP_OK;
+}
+
+// An empty continuation without KEEP_CS ends a burst cut short by an error:
+// CS goes high and no pixel is written
+static esp_err_t pipe_close_burst(rm690b0_pipe_t *p) {
+    rm690b0_bus_trans_t t = {
+        .flags = RM_BUS_FLAG_QIO,
+    };
+
+    esp_err_t ret = pipe_submit(p, &t);
+    if (ret != ESP_OK) return ret;
+    p->in_burst = false;
+    return ESP_OK;
+}
+
+esp_err_t rm_pipe_drain(rm690b0_pipe_t *p, uint32_t timeout_ms) {
+    if (p->in_burst) {
+        esp_err_t ret = pipe_close_burst(p);
+        if (ret != ESP_OK) return ret;
+    }
+
+    while (p->inflight > 0) {
+        esp_err_t ret = pipe_reap_one(p, timeout_ms);
+        if (ret != ESP_OK) return ret;
+    }
+
+    // CS is released by now, the bus can go
+    if (p->held) {
+        p->bus->release(p->bus);
+        p->held = false;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,166 @@
+#ifndef RM690B0_BUS_H
+#define RM690B0_BUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bus layer between the RM690B0 driver and the wire.
+ *
+ * The driver describes every transfer with an rm690b0_bus_trans_t and hands it
+ * to an rm690b0_bus_t backend. The ESP-IDF QSPI backend (rm690b0_bus_spi.c) maps
+ * descriptors onto spi_transaction_ext_t, the recording backend
+ * (rm690b0_bus_record.c) only logs them so chunking and CS handling can be
+ * checked on a Linux host. This header and rm690b0_bus.c do not depend on
+ * ESP-IDF drivers or FreeRTOS.
+ */
+
+// QSPI wrapper opcodes (first byte on the wire)
+#define RM_BUS_OP_CMD           0x02 // 1-line write: 02 00 CMD 00 [params]
+#define RM_BUS_OP_PIXELS        0x32 // 4-line write: 32 00 2C 00 [pixels]
+
+// DCS command used for pixel bursts
+#define RM_CMD_RAMWR            0x2C
+
+// Transaction flags
+#define RM_BUS_FLAG_HEADER      (1u << 0) // Send opcode + 24-bit address (00 CMD 00) before data
+#define RM_BUS_FLAG_QIO         (1u << 1) // Data phase on 4 lines
+#define RM_BUS_FLAG_KEEP_CS     (1u << 2) // Keep CS asserted after this transaction
+#define RM_BUS_FLAG_INLINE      (1u << 3) // Payload (<= 4 bytes) carried in inline_data
+
+// Max transactions in flight. Must stay below the SPI device queue_size.
+#define RM_BUS_QUEUE_DEPTH      8
+
+// Bytes per queued pixel transaction
+#define RM_BUS_CHUNK_BYTES      (32 * 1024)
+
+// Timeout value meaning "block until done"
+#define RM_BUS_WAIT_FOREVER     UINT32_MAX
+
+/**
+ * @brief Completion callback for a transaction.
+ * On the QSPI backend this runs from the SPI post-transfer ISR.
+ */
+typedef void (*rm690b0_bus_done_cb_t)(void *arg);
+
+typedef struct {
+    uint32_t flags;                 // RM_BUS_FLAG_*
+    uint8_t opcode;                 // RM_BUS_OP_* (used with RM_BUS_FLAG_HEADER)
+    uint8_t cmd;                    // DCS command placed in the address phase
+    const void *tx_buffer;          // Payload, may be NULL when length is 0
+    uint8_t inline_data[4];         // Payload with RM_BUS_FLAG_INLINE, copied with the descriptor
+    size_t length;                  // Payload length in bytes
+    rm690b0_bus_done_cb_t done_cb;  // Optional, fired when this transaction completes
+    void *done_arg;
+} rm690b0_bus_trans_t;
+
+typedef struct rm690b0_bus rm690b0_bus_t;
+
+/**
+ * Backend operations. Queued transactions complete in submission order.
+ * queue() copies the descriptor, the payload must stay valid until reaped.
+ */
+struct rm690b0_bus {
+    esp_err_t (*acquire)(rm690b0_bus_t *bus);
+    void (*release)(rm690b0_bus_t *bus);
+    esp_err_t (*transmit)(rm690b0_bus_t *bus, const rm690b0_bus_trans_t *t);
+    esp_err_t (*queue)(rm690b0_bus_t *bus, const rm690b0_bus_trans_t *t);
+    esp_err_t (*reap)(rm690b0_bus_t *bus, uint32_t timeout_ms);
+};
+
+/**
+ * Queued pixel pipeline state. One per display.
+ * The bus stays acquired from the first queued chunk until rm_pipe_drain().
+ */
+typedef struct {
+    rm690b0_bus_t *bus;
+    uint8_t depth;          // In-flight limit (<= RM_BUS_QUEUE_DEPTH)
+    uint8_t inflight;
+    bool held;              // Bus acquired by the pipeline
+    bool in_burst;          // Last push kept CS asserted, next push continues the RAMWR burst
+    uint32_t chunks;        // Total chunks queued (sequence number of the last one)
+    uint32_t reaped;        // Total chunks completed
+    uint32_t stalls;        // Times a submit had to wait for a free slot
+    uint32_t bursts;        // RAMWR bursts started: GRAM may have changed when this moves
+} rm690b0_pipe_t;
+
+/**
+ * @brief Reset a pipeline and bind it to a backend
+ * @param depth In-flight limit, clamped to 1..RM_BUS_QUEUE_DEPTH
+ */
+void rm_pipe_init(rm690b0_pipe_t *p, rm690b0_bus_t *bus, uint8_t depth);
+
+/**
+ * @brief Queue a RAMWR burst split into RM_BUS_CHUNK_BYTES transactions.
+ *
+ * Returns once every chunk is queued. Blocks only while the in-flight limit is
+ * reached. CS stays asserted across the chunks of one burst.
+ *
+ * @param data Big-endian RGB565 pixels, must stay valid until done_cb fires
+ * @param len Payload length in bytes
+ * @param done_cb Optional, fired when the last chunk completes
+ */
+esp_err_t rm_pipe_write(rm690b0_pipe_t *p, const void *data, size_t len,
+                        rm690b0_bus_done_cb_t done_cb, void *done_arg);
+
+/**
+ * @brief Queue one transaction of a RAMWR burst.
+ *
+ * The first push after a completed burst carries the 0x32 00 2C 00 header, the
+ * following ones are continuations with CS held. Acquires the bus if needed.
+ *
+ * @param data Big-endian RGB565 pixels, must stay valid until the chunk is reaped
+ * @param len Bytes, at most what the SPI bus max_transfer_sz allows
+ * @param last Ends the burst (CS released after this chunk)
+ * @param done_cb Optional, fired when this chunk completes
+ * @param[out] seq Optional, sequence number to pass to rm_pipe_wait_seq()
+ */
+esp_err_t rm_pipe_push(rm690b0_pipe_t *p, const void *data, size_t len, bool last,
+                       rm690b0_bus_done_cb_t done_cb, void *done_arg, uint32_t *seq);
+
+/**
+ * @brief Queue a DCS command (02 00 CMD 00 [params]) between pixel bursts.
+ *
+ * Shares the bus acquisition with surrounding bursts, so CASET + RASET + RAMWR
+ * go out back to back without releasing the bus. Parameters of up to 4 bytes
+ * are copied; longer ones must stay valid until the pipe is drained.
+ *
+ * @return ESP_ERR_INVALID_STATE while a pixel burst is still open
+ */
+esp_err_t rm_pipe_cmd(rm690b0_pipe_t *p, uint8_t cmd, const uint8_t *data, size_t len);
+
+/**
+ * @brief Block until the chunk with sequence number seq has completed.
+ * Used to recycle a buffer that was handed to rm_pipe_push().
+ */
+esp_err_t rm_pipe_wait_seq(rm690b0_pipe_t *p, uint32_t seq);
+
+/**
+ * @brief Wait for all queued chunks and release the bus.
+ * A burst left open by an error is closed first with an empty transfer that
+ * releases CS, so the panel never sees the next header inside a RAMWR.
+ */
+esp_err_t rm_pipe_drain(rm690b0_pipe_t *p, uint32_t timeout_ms);
+
+/**
+ * @brief Backend currently used by the rm690b0 driver (NULL before init)
+ */
+rm690b0_bus_t *rm690b0_get_bus(void);
+
+/**
+ * @brief Replace the backend used by the rm690b0 driver.
+ * Pending transfers are drained first. Used to attach the recording backend.
+ */
+esp_err_t rm690b0_set_bus(rm690b0_bus_t *bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
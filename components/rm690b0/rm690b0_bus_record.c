@@ -0,0 +1,119 @@
+#include "rm690b0_bus_record.h"
+#include <string.h>
+
+/*
+ * Violations counted:
+ * - transfer while the bus is not acquired
+ * - KEEP_CS transfer outside an acquired bus
+ * - continuation (no header) that does not follow a KEEP_CS transfer
+ * - header transfer while CS is still held by the previous one
+ * - blocking transfer while queued ones are in flight
+ * - queue overflow, reap on an empty queue, release with transfers in flight
+ */
+
+static void rec_log(rm690b0_bus_record_t *r, rm690b0_rec_event_t ev, const rm690b0_bus_trans_t *t) {
+    uint32_t seq = r->seq++;
+    if (!r->log || r->count >= r->capacity) return;
+
+    rm690b0_rec_entry_t *e = &r->log[r->count++];
+    e->event = ev;
+    e->seq = seq;
+    if (t) {
+        e->trans = *t;
+    } else {
+        memset(&e->trans, 0, sizeof(e->trans));
+    }
+}
+
+// Track CS across a transfer as it would go out on the wire
+static void rec_wire(rm690b0_bus_record_t *r, const rm690b0_bus_trans_t *t) {
+    bool header = (t->flags & RM_BUS_FLAG_HEADER) != 0;
+    bool keep = (t->flags & RM_BUS_FLAG_KEEP_CS) != 0;
+
+    if (!r->held) r->violations++;
+    if (header && r->cs_active) r->violations++;
+    if (!header && !r->cs_active) r->violations++;
+
+    r->cs_active = keep;
+    r->bytes += t->length;
+}
+
+static esp_err_t rec_acquire(rm690b0_bus_t *bus) {
+    rm690b0_bus_record_t *r = (rm690b0_bus_record_t *)bus;
+    if (r->held) {
+        r->violations++;
+        return ESP_ERR_INVALID_STATE;
+    }
+    r->held = true;
+    rec_log(r, RM_REC_ACQUIRE, NULL);
+    return ESP_OK;
+}
+
+static void rec_release(rm690b0_bus_t *bus) {
+    rm690b0_bus_record_t *r = (rm690b0_bus_record_t *)bus;
+    if (!r->held || r->inflight > 0 || r->cs_active) r->violations++;
+    r->held = false;
+    rec_log(r, RM_REC_RELEASE, NULL);
+}
+
+static esp_err_t rec_transmit(rm690b0_bus_t *bus, const rm690b0_bus_trans_t *t) {
+    rm690b0_bus_record_t *r = (rm690b0_bus_record_t *)bus;
+    if (r->inflight > 0) r->violations++;
+
+    rec_wire(r, t);
+    rec_log(r, RM_REC_TRANSMIT, t);
+    if (t->done_cb) t->done_cb(t->done_arg);
+    return ESP_OK;
+}
+
+static esp_err_t rec_queue(rm690b0_bus_t *bus, const rm690b0_bus_trans_t *t) {
+    rm690b0_bus_record_t *r = (rm690b0_bus_record_t *)bus;
+    if (r->inflight >= RM_BUS_QUEUE_DEPTH) {
+        r->violations++;
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    rec_wire(r, t);
+    r->pending[(r->head + r->inflight) % RM_BUS_QUEUE_DEPTH] = *t;
+    r->inflight++;
+    if (r->inflight > r->max_inflight) r->max_inflight = r->inflight;
+    rec_log(r, RM_REC_QUEUE, t);
+    return ESP_OK;
+}
+
+static esp_err_t rec_reap(rm690b0_bus_t *bus, uint32_t timeout_ms) {
+    rm690b0_bus_record_t *r = (rm690b0_bus_record_t *)bus;
+    (void)timeout_ms;
+    if (r->inflight == 0) {
+        r->violations++;
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    rm690b0_bus_trans_t t = r->pending[r->head];
+    r->head = (r->head + 1) % RM_BUS_QUEUE_DEPTH;
+    r->inflight--;
+    rec_log(r, RM_REC_REAP, &t);
+    if (t.done_cb) t.done_cb(t.done_arg);
+    return ESP_OK;
+}
+
+rm690b0_bus_t *rm690b0_bus_record_init(rm690b0_bus_record_t *rec, rm690b0_rec_entry_t *log, size_t capacity) {
+    memset(rec, 0, sizeof(*rec));
+    rec->log = log;
+    rec->capacity = log ? capacity : 0;
+
+    rec->base.acquire = rec_acquire;
+    rec->base.release = rec_release;
+    rec->base.transmit = rec_transmit;
+    rec->base.queue = rec_queue;
+    rec->base.reap = rec_reap;
+    return &rec->base;
+}
+
+void rm690b0_bus_record_clear(rm690b0_bus_record_t *rec) {
+    rec->count = 0;
+    rec->seq = 0;
+    rec->bytes = 0;
+    rec->violations = 0;
+    rec->max_inflight = rec->inflight;
+}
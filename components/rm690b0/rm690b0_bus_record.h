@@ -0,0 +1,67 @@
+#ifndef RM690B0_BUS_RECORD_H
+#define RM690B0_BUS_RECORD_H
+
+#include "rm690b0_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Recording backend. Logs every bus event instead of touching hardware so the
+ * transaction stream (chunk boundaries, CS_KEEP_ACTIVE, ordering, completion
+ * callbacks) can be inspected on a Linux host. Queued transactions complete
+ * when reaped, in FIFO order.
+ */
+
+typedef enum {
+    RM_REC_ACQUIRE,
+    RM_REC_RELEASE,
+    RM_REC_TRANSMIT,    // Blocking transfer
+    RM_REC_QUEUE,       // Queued transfer
+    RM_REC_REAP,        // Oldest queued transfer completed
+} rm690b0_rec_event_t;
+
+typedef struct {
+    rm690b0_rec_event_t event;
+    uint32_t seq;               // Event index since init
+    rm690b0_bus_trans_t trans;  // Descriptor (for TRANSMIT/QUEUE/REAP)
+} rm690b0_rec_entry_t;
+
+typedef struct {
+    rm690b0_bus_t base;
+    rm690b0_rec_entry_t *log;
+    size_t capacity;
+    size_t count;               // Entries stored (saturates at capacity)
+    uint32_t seq;
+    // Queue model
+    rm690b0_bus_trans_t pending[RM_BUS_QUEUE_DEPTH];
+    uint8_t head;
+    uint8_t inflight;
+    uint8_t max_inflight;       // High-water mark of queued transfers
+    bool held;
+    bool cs_active;             // Previous transfer ended with KEEP_CS
+    // Totals
+    size_t bytes;
+    uint32_t violations;        // Protocol errors, see rm690b0_bus_record.c
+} rm690b0_bus_record_t;
+
+/**
+ * @brief Initialize a recording backend
+ * @param rec Backend state (caller owned)
+ * @param log Entry storage, may be NULL to only collect totals
+ * @param capacity Number of entries in log
+ * @return Backend handle for rm690b0_set_bus() / rm_pipe_init()
+ */
+rm690b0_bus_t *rm690b0_bus_record_init(rm690b0_bus_record_t *rec, rm690b0_rec_entry_t *log, size_t capacity);
+
+/**
+ * @brief Clear the log and totals, keep the bus state
+ */
+void rm690b0_bus_record_clear(rm690b0_bus_record_t *rec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,338 @@
+#include "rm690b0_bus_sim.h"
+#include <string.h>
+
+/*
+ * Violations counted:
+ * - the same bus protocol errors as rm690b0_bus_record.c
+ * - unknown opcode, pixel data outside a RAMWR burst
+ * - a burst ending on half a pixel
+ * - command parameters shorter than the command needs
+ */
+
+#define MADCTL_MY   0x80
+#define MADCTL_MX   0x40
+#define MADCTL_MV   0x20
+
+static uint16_t be16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void sim_command(rm690b0_bus_sim_t *s, uint8_t cmd, const uint8_t *d, size_t len) {
+    s->stats.commands++;
+    s->in_ramwr = false;
+
+    switch (cmd) {
+        case 0x11: s->sleep_out = true; break;
+        case 0x10: s->sleep_out = false; break;
+        case 0x28: s->display_on = false; break;
+        case 0x29: s->display_on = true; break;
+        case 0x13: // Normal mode also ends scrolling
+            s->vs_tfa = 0;
+            s->vs_vsa = RM_SIM_GRAM_H;
+            s->vs_bfa = 0;
+            s->vs_ssa = 0;
+            break;
+        case 0x2A: // CASET
+            if (len < 4) { s->stats.violations++; break; }
+            s->xs = be16(d);
+            s->xe = be16(d + 2);
+            break;
+        case 0x2B: // RASET
+            if (len < 4) { s->stats.violations++; break; }
+            s->ys = be16(d);
+            s->ye = be16(d + 2);
+            break;
+        case 0x33: // VSCRDEF
+            if (len < 6) { s->stats.violations++; break; }
+            s->vs_tfa = be16(d);
+            s->vs_vsa = be16(d + 2);
+            s->vs_bfa = be16(d + 4);
+            break;
+        case 0x36: // MADCTL
+            if (len < 1) { s->stats.violations++; break; }
+            s->madctl = d[0];
+            break;
+        case 0x37: // VSCSAD
+            if (len < 2) { s->stats.violations++; break; }
+            s->vs_ssa = be16(d);
+            break;
+        case 0x3A: // COLMOD
+            if (len < 1) { s->stats.violations++; break; }
+            s->colmod = d[0];
+            break;
+        default:
+            break;
+    }
+}
+
+// Store one pixel at the cursor and advance it through the window
+static void sim_pixel(rm690b0_bus_sim_t *s, uint16_t px) {
+    if (s->cy > s->ye) {
+        s->stats.clipped++;
+        return;
+    }
+
+    uint16_t col, row;
+    if (s->madctl & MADCTL_MV) {
+        col = s->cy;
+        row = s->cx;
+    } else {
+        col = s->cx;
+        row = s->cy;
+    }
+    if (s->madctl & MADCTL_MX) col = RM_SIM_GRAM_W - 1 - col;
+    if (s->madctl & MADCTL_MY) row = RM_SIM_GRAM_H - 1 - row;
+
+    if (col < RM_SIM_GRAM_W && row < RM_SIM_GRAM_H) {
+        s->gram[(size_t)row * RM_SIM_GRAM_W + col] = px;
+        s->stats.pixels++;
+    } else {
+        s->stats.clipped++;
+    }
+
+    if (++s->cx > s->xe) {
+        s->cx = s->xs;
+        s->cy++;
+    }
+}
+
+// Reduced interface formats, expanded to RGB565 as the panel would
+static uint16_t sim_rgb332(uint8_t v) {
+    uint32_t r = ((v >> 5) * 31 + 3) / 7, g = (((v >> 2) & 7) * 63 + 3) / 7, b = ((v & 3) * 31 + 1) / 3;
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static uint16_t sim_gray8(uint8_t v) {
+    return (uint16_t)(((v >> 3) << 11) | ((v >> 2) << 5) | (v >> 3));
+}
+
+static uint16_t sim_rgb111(uint8_t v) {
+    return (uint16_t)(((v & 4) ? 0xF800 : 0) | ((v & 2) ? 0x07E0 : 0) | ((v & 1) ? 0x001F : 0));
+}
+
+static void sim_pixels(rm690b0_bus_sim_t *s, const uint8_t *d, size_t len) {
+    if (!s->in_ramwr) {
+        s->stats.violations++;
+        return;
+    }
+    // IFPF, COLMOD[2:0]: byte-sized formats never leave a partial pixel behind
+    switch (s->colmod & 0x07) {
+        case 0x1:
+            for (size_t i = 0; i < len; i++) sim_pixel(s, sim_gray8(d[i]));
+            return;
+        case 0x2:
+            for (size_t i = 0; i < len; i++) sim_pixel(s, sim_rgb332(d[i]));
+            return;
+        case 0x3:
+            for (size_t i = 0; i < len; i++) {
+                sim_pixel(s, sim_rgb111(d[i] >> 4));
+                sim_pixel(s, sim_rgb111(d[i] & 0x0F));
+            }
+            return;
+        default:
+            break;
+    }
+    size_t i = 0;
+    if (s->has_byte && len > 0) {
+        sim_pixel(s, (uint16_t)((s->byte << 8) | d[0]));
+        s->has_byte = false;
+        i = 1;
+    }
+    for (; i + 2 <= len; i += 2) {
+        sim_pixel(s, be16(d + i));
+    }
+    if (i < len) {
+        s->byte = d[i];
+        s->has_byte = true;
+    }
+}
+
+// Wire cost: 8-bit opcode and 24-bit address on one line, data on 1 or 4 lines,
+// plus one clock of CS setup and hold around every transaction
+static void sim_cost(rm690b0_bus_sim_t *s, const rm690b0_bus_trans_t *t) {
+    bool header = (t->flags & RM_BUS_FLAG_HEADER) != 0;
+    uint32_t lines = (t->flags & RM_BUS_FLAG_QIO) ? 4 : 1;
+    uint64_t clocks = 2 + (header ? 32 : 0) + ((uint64_t)t->length * 8 + lines - 1) / lines;
+    uint64_t ns = clocks * 1000000000ull / s->clock_hz;
+
+    s->stats.transactions++;
+    s->stats.bytes += t->length + (header ? 4 : 0);
+    s->stats.wire_ns += ns;
+    s->stats.busy_ns += ns + s->setup_ns;
+}
+
+// Decode one transfer as the panel sees it
+static void sim_decode(rm690b0_bus_sim_t *s, const rm690b0_bus_trans_t *t) {
+    const uint8_t *d = (t->flags & RM_BUS_FLAG_INLINE) ? t->inline_data : t->tx_buffer;
+
+    if (t->flags & RM_BUS_FLAG_HEADER) {
+        if (s->has_byte) {
+            s->stats.violations++;
+            s->has_byte = false;
+        }
+        if (t->opcode == RM_BUS_OP_CMD) {
+            sim_command(s, t->cmd, d, t->length);
+        } else if (t->opcode == RM_BUS_OP_PIXELS && (t->cmd == RM_CMD_RAMWR || t->cmd == 0x3C)) {
+            s->stats.bursts++;
+            if (t->cmd == RM_CMD_RAMWR) {
+                s->cx = s->xs;
+                s->cy = s->ys;
+            }
+            s->in_ramwr = true;
+            sim_pixels(s, d, t->length);
+        } else {
+            s->stats.violations++;
+        }
+    } else {
+        // Continuation of the previous transfer (CS held)
+        sim_pixels(s, d, t->length);
+    }
+
+    if (!(t->flags & RM_BUS_FLAG_KEEP_CS)) {
+        if (s->has_byte) {
+            s->stats.violations++;
+            s->has_byte = false;
+        }
+    }
+}
+
+static void sim_wire(rm690b0_bus_sim_t *s, const rm690b0_bus_trans_t *t) {
+    bool header = (t->flags & RM_BUS_FLAG_HEADER) != 0;
+
+    if (!s->held) s->stats.violations++;
+    if (header && s->cs_active) s->stats.violations++;
+    if (!header && !s->cs_active) s->stats.violations++;
+    s->cs_active = (t->flags & RM_BUS_FLAG_KEEP_CS) != 0;
+    sim_cost(s, t);
+}
+
+static esp_err_t sim_acquire(rm690b0_bus_t *bus) {
+    rm690b0_bus_sim_t *s = (rm690b0_bus_sim_t *)bus;
+    if (s->held) {
+        s->stats.violations++;
+        return ESP_ERR_INVALID_STATE;
+    }
+    s->held = true;
+    return ESP_OK;
+}
+
+static void sim_release(rm690b0_bus_t *bus) {
+    rm690b0_bus_sim_t *s = (rm690b0_bus_sim_t *)bus;
+    if (!s->held || s->inflight > 0 || s->cs_active) s->stats.violations++;
+    s->held = false;
+}
+
+static esp_err_t sim_transmit(rm690b0_bus_t *bus, const rm690b0_bus_trans_t *t) {
+    rm690b0_bus_sim_t *s = (rm690b0_bus_sim_t *)bus;
+    if (s->inflight > 0) s->stats.violations++;
+
+    sim_wire(s, t);
+    sim_decode(s, t);
+    if (t->done_cb) t->done_cb(t->done_arg);
+    return ESP_OK;
+}
+
+static esp_err_t sim_queue(rm690b0_bus_t *bus, const rm690b0_bus_trans_t *t) {
+    rm690b0_bus_sim_t *s = (rm690b0_bus_sim_t *)bus;
+    if (s->inflight >= RM_BUS_QUEUE_DEPTH) {
+        s->stats.violations++;
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    sim_wire(s, t);
+    s->pending[(s->head + s->inflight) % RM_BUS_QUEUE_DEPTH] = *t;
+    s->inflight++;
+    return ESP_OK;
+}
+
+static esp_err_t sim_reap(rm690b0_bus_t *bus, uint32_t timeout_ms) {
+    rm690b0_bus_sim_t *s = (rm690b0_bus_sim_t *)bus;
+    (void)timeout_ms;
+    if (s->inflight == 0) {
+        s->stats.violations++;
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // The payload is read now, as late as the DMA could read it
+    rm690b0_bus_trans_t t = s->pending[s->head];
+    s->head = (s->head + 1) % RM_BUS_QUEUE_DEPTH;
+    s->inflight--;
+    sim_decode(s, &t);
+    if (t.done_cb) t.done_cb(t.done_arg);
+    return ESP_OK;
+}
+
+rm690b0_bus_t *rm690b0_bus_sim_init(rm690b0_bus_sim_t *sim, uint16_t *gram, uint32_t clock_hz) {
+    memset(sim, 0, sizeof(*sim));
+    sim->gram = gram;
+    sim->clock_hz = clock_hz ? clock_hz : 40000000;
+    memset(gram, 0, (size_t)RM_SIM_GRAM_W * RM_SIM_GRAM_H * 2);
+
+    sim->colmod = 0x77;     // Reset default (24-bit)
+    sim->xe = RM_SIM_GRAM_W - 1;
+    sim->ye = RM_SIM_GRAM_H - 1;
+    sim->vs_vsa = RM_SIM_GRAM_H;
+
+    sim->base.acquire = sim_acquire;
+    sim->base.release = sim_release;
+    sim->base.transmit = sim_transmit;
+    sim->base.queue = sim_queue;
+    sim->base.reap = sim_reap;
+    return &sim->base;
+}
+
+void rm690b0_bus_sim_clear_stats(rm690b0_bus_sim_t *sim) {
+    memset(&sim->stats, 0, sizeof(sim->stats));
+}
+
+void rm690b0_bus_sim_size(const rm690b0_bus_sim_t *sim, uint16_t *w, uint16_t *h) {
+    bool mv = (sim->madctl & MADCTL_MV) != 0;
+    *w = mv ? RM_SIM_PANEL_H : RM_SIM_PANEL_W;
+    *h = mv ? RM_SIM_PANEL_W : RM_SIM_PANEL_H;
+}
+
+uint16_t rm690b0_bus_sim_pixel(const rm690b0_bus_sim_t *sim, uint16_t x, uint16_t y) {
+    if (!sim->display_on) return 0;
+
+    // Visible panel position of the screen pixel
+    uint16_t col, row;
+    if (sim->madctl & MADCTL_MV) {
+        col = y;
+        row = x;
+    } else {
+        col = x;
+        row = y;
+    }
+    if (sim->madctl & MADCTL_MX) col = RM_SIM_PANEL_W - 1 - col;
+    if (sim->madctl & MADCTL_MY) row = RM_SIM_PANEL_H - 1 - row;
+    col += RM_SIM_VISIBLE_X;
+
+    // Scan row -> GRAM row inside the scroll area
+    uint16_t tfa = sim->vs_tfa, vsa = sim->vs_vsa;
+    if (vsa > 0 && row >= tfa && row < tfa + vsa) {
+        int k = ((int)sim->vs_ssa - tfa + (row - tfa)) % vsa;
+        if (k < 0) k += vsa;
+        row = tfa + (uint16_t)k;
+    }
+    if (col >= RM_SIM_GRAM_W || row >= RM_SIM_GRAM_H) return 0;
+    return sim->gram[(size_t)row * RM_SIM_GRAM_W + col];
+}
+
+int rm690b0_bus_sim_write_ppm(const rm690b0_bus_sim_t *sim, FILE *f) {
+    uint16_t w, h;
+    rm690b0_bus_sim_size(sim, &w, &h);
+    if (fprintf(f, "P6\n%u %u\n255\n", w, h) < 0) return -1;
+
+    for (uint16_t y = 0; y < h; y++) {
+        for (uint16_t x = 0; x < w; x++) {
+            uint16_t c = rm690b0_bus_sim_pixel(sim, x, y);
+            uint8_t rgb[3] = {
+                (uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+                (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+                (uint8_t)((c & 0x1F) * 255 / 31),
+            };
+            if (fwrite(rgb, 1, 3, f) != 3) return -1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#ifndef RM690B0_BUS_SIM_H
+#define RM690B0_BUS_SIM_H
+
+#include <stdio.h>
+#include "rm690b0_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Simulated panel backend. Decodes the QSPI wrapper framing
+ * (02 00 CMD 00 [params] / 32 00 2C 00 [pixels]) and models the parts of the
+ * RM690B0 the driver relies on: MADCTL, CASET/RASET windows, GRAM writes,
+ * vertical scroll and display on/off. Every transfer is also costed on the
+ * wire at a given SPI clock.
+ *
+ * Queued transfers are decoded when they are reaped, so a buffer recycled
+ * before its chunk completed shows up as corrupted pixels.
+ *
+ * Host only: rm690b0_bus_sim.c is built by tools/rm690b0_sim, not by the
+ * component.
+ */
+
+// GRAM: 480 native columns (450 visible starting at column 16) x 600 rows
+#define RM_SIM_GRAM_W       480
+#define RM_SIM_GRAM_H       600
+#define RM_SIM_VISIBLE_X    16
+#define RM_SIM_PANEL_W      450
+#define RM_SIM_PANEL_H      600
+
+typedef struct {
+    uint32_t transactions;  // Transfers on the wire
+    uint32_t commands;      // 0x02 headers
+    uint32_t bursts;        // RAMWR headers
+    uint64_t bytes;         // Bytes on the wire, headers included
+    uint64_t pixels;        // Pixels written to GRAM
+    uint64_t clipped;       // Pixels written past the window end or outside GRAM
+    uint64_t wire_ns;       // SPI clock time
+    uint64_t busy_ns;       // wire_ns plus per-transaction setup
+    uint32_t violations;    // Framing and protocol errors
+} rm690b0_sim_stats_t;
+
+typedef struct {
+    rm690b0_bus_t base;
+    uint32_t clock_hz;
+    uint32_t setup_ns;          // Per-transaction overhead added to busy_ns
+    uint16_t *gram;             // RM_SIM_GRAM_W x RM_SIM_GRAM_H, native order
+    // Panel registers
+    uint8_t madctl;
+    uint8_t colmod;
+    bool display_on;
+    bool sleep_out;
+    uint16_t xs, xe, ys, ye;    // Window as sent (logical)
+    uint16_t cx, cy;            // Write cursor
+    uint16_t vs_tfa, vs_vsa, vs_bfa, vs_ssa;
+    // Decoder state
+    bool in_ramwr;
+    bool has_byte;              // Pixel split across transfers
+    uint8_t byte;
+    // Bus model
+    rm690b0_bus_trans_t pending[RM_BUS_QUEUE_DEPTH];
+    uint8_t head;
+    uint8_t inflight;
+    bool held;
+    bool cs_active;
+    rm690b0_sim_stats_t stats;
+} rm690b0_bus_sim_t;
+
+/**
+ * @brief Initialize a simulated panel in its reset state
+ * @param gram RM_SIM_GRAM_W * RM_SIM_GRAM_H pixels (caller owned)
+ * @param clock_hz SPI clock used for the wire time estimate
+ * @return Backend handle for rm690b0_set_bus()
+ */
+rm690b0_bus_t *rm690b0_bus_sim_init(rm690b0_bus_sim_t *sim, uint16_t *gram, uint32_t clock_hz);
+
+/**
+ * @brief Reset the statistics, keep the panel state
+ */
+void rm690b0_bus_sim_clear_stats(rm690b0_bus_sim_t *sim);
+
+/**
+ * @brief Displayed pixel in screen coordinates of the current MADCTL, with
+ * scrolling applied. Returns RGB565 (native endian), black while display is off.
+ */
+uint16_t rm690b0_bus_sim_pixel(const rm690b0_bus_sim_t *sim, uint16_t x, uint16_t y);
+
+/**
+ * @brief Screen size for the current MADCTL (600x450 when MV is set)
+ */
+void rm690b0_bus_sim_size(const rm690b0_bus_sim_t *sim, uint16_t *w, uint16_t *h);
+
+/**
+ * @brief Write what the panel shows as a binary PPM (P6), upright for the
+ * current rotation
+ * @return 0 on success
+ */
+int rm690b0_bus_sim_write_ppm(const rm690b0_bus_sim_t *sim, FILE *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
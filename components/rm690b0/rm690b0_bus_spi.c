@@ -0,0 +1,151 @@
+#include "rm690b0_bus_spi.h"
+#include "driver/spi_master.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "rm690b0_bus";
+
+typedef struct {
+    rm690b0_bus_t base;
+    spi_device_handle_t dev;
+    // Queued transactions must stay alive until reaped
+    spi_transaction_ext_t slots[RM_BUS_QUEUE_DEPTH];
+    rm690b0_bus_trans_t descs[RM_BUS_QUEUE_DEPTH];
+    uint8_t head;   // Next slot to fill
+    uint8_t count;  // Slots in flight
+} rm_bus_spi_t;
+
+static rm_bus_spi_t s_spi_bus;
+
+static TickType_t to_ticks(uint32_t timeout_ms) {
+    return (timeout_ms == RM_BUS_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+}
+
+// Translate a bus descriptor into the QSPI wrapper framing
+static void fill_trans(spi_transaction_ext_t *t, const rm690b0_bus_trans_t *d) {
+    *t = (spi_transaction_ext_t){0};
+    t->base.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR;
+
+    if (d->flags & RM_BUS_FLAG_QIO) t->base.flags |= SPI_TRANS_MODE_QIO;
+    if (d->flags & RM_BUS_FLAG_KEEP_CS) t->base.flags |= SPI_TRANS_CS_KEEP_ACTIVE;
+
+    if (d->flags & RM_BUS_FLAG_HEADER) {
+        // Command Phase: 1 byte opcode, Address Phase: 00 CMD 00
+        t->base.cmd = d->opcode;
+        t->base.addr = ((uint32_t)d->cmd) << 8;
+        t->command_bits = 8;
+        t->address_bits = 24;
+    } else {
+        // Continuation: data only
+        t->command_bits = 0;
+        t->address_bits = 0;
+    }
+
+    t->base.length = d->length * 8;
+    if (d->flags & RM_BUS_FLAG_INLINE) {
+        t->base.flags |= SPI_TRANS_USE_TXDATA;
+        memcpy(t->base.tx_data, d->inline_data, sizeof(t->base.tx_data));
+    } else {
+        t->base.tx_buffer = d->tx_buffer;
+    }
+}
+
+// Runs in ISR context after every transaction of this device
+static void IRAM_ATTR spi_post_cb(spi_transaction_t *t) {
+    const rm690b0_bus_trans_t *d = t->user;
+    if (d && d->done_cb) {
+        d->done_cb(d->done_arg);
+    }
+}
+
+static esp_err_t spi_acquire(rm690b0_bus_t *bus) {
+    rm_bus_spi_t *b = (rm_bus_spi_t *)bus;
+    return spi_device_acquire_bus(b->dev, portMAX_DELAY);
+}
+
+static void spi_release(rm690b0_bus_t *bus) {
+    rm_bus_spi_t *b = (rm_bus_spi_t *)bus;
+    spi_device_release_bus(b->dev);
+}
+
+static esp_err_t spi_transmit(rm690b0_bus_t *bus, const rm690b0_bus_trans_t *d) {
+    rm_bus_spi_t *b = (rm_bus_spi_t *)bus;
+    spi_transaction_ext_t t;
+    fill_trans(&t, d);
+
+    esp_err_t ret = spi_device_polling_transmit(b->dev, (spi_transaction_t *)&t);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "SPI Transfer Error: %s", esp_err_to_name(ret));
+    } else if (d->done_cb) {
+        d->done_cb(d->done_arg);
+    }
+    return ret;
+}
+
+static esp_err_t spi_queue(rm690b0_bus_t *bus, const rm690b0_bus_trans_t *d) {
+    rm_bus_spi_t *b = (rm_bus_spi_t *)bus;
+    if (b->count >= RM_BUS_QUEUE_DEPTH) return ESP_ERR_INVALID_STATE;
+
+    uint8_t i = b->head;
+    b->descs[i] = *d;
+    fill_trans(&b->slots[i], d);
+    b->slots[i].base.user = &b->descs[i];
+
+    esp_err_t ret = spi_device_queue_trans(b->dev, (spi_transaction_t *)&b->slots[i], portMAX_DELAY);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Queue Error: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    b->head = (i + 1) % RM_BUS_QUEUE_DEPTH;
+    b->count++;
+    return ESP_OK;
+}
+
+static esp_err_t spi_reap(rm690b0_bus_t *bus, uint32_t timeout_ms) {
+    rm_bus_spi_t *b = (rm_bus_spi_t *)bus;
+    if (b->count == 0) return ESP_ERR_INVALID_STATE;
+
+    spi_transaction_t *done = NULL;
+    esp_err_t ret = spi_device_get_trans_result(b->dev, &done, to_ticks(timeout_ms));
+    if (ret != ESP_OK) return ret;
+    b->count--;
+    return ESP_OK;
+}
+
+esp_err_t rm690b0_bus_spi_create(spi_host_device_t host_id, int cs_io, int clock_hz, rm690b0_bus_t **out) {
+    rm_bus_spi_t *b = &s_spi_bus;
+
+    // Re-init after light sleep reuses the device already on the bus
+    if (b->dev == NULL) {
+        spi_device_interface_config_t devcfg = {
+            .clock_speed_hz = clock_hz,
+            .mode = 0,
+            .spics_io_num = cs_io,
+            // One bit-cycle of CS setup/hold covers tCSU/tCH (20ns) up to 50MHz
+            .cs_ena_pretrans = 1,
+            .cs_ena_posttrans = 1,
+            .queue_size = RM_BUS_QUEUE_DEPTH + 2,
+            .flags = SPI_DEVICE_HALFDUPLEX,
+            .post_cb = spi_post_cb,
+        };
+
+        esp_err_t ret = spi_bus_add_device(host_id, &devcfg, &b->dev);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to add SPI device");
+            return ret;
+        }
+    }
+
+    b->base.acquire = spi_acquire;
+    b->base.release = spi_release;
+    b->base.transmit = spi_transmit;
+    b->base.queue = spi_queue;
+    b->base.reap = spi_reap;
+    b->head = 0;
+    b->count = 0;
+
+    *out = &b->base;
+    return ESP_OK;
+}
@@ -0,0 +1,27 @@
+#ifndef RM690B0_BUS_SPI_H
+#define RM690B0_BUS_SPI_H
+
+#include "rm690b0_bus.h"
+#include "driver/spi_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create the ESP-IDF QSPI backend.
+ * Adds the panel as a device on an already initialized SPI bus. Calling it
+ * again reuses the existing device.
+ * @param host_id SPI host the bus was initialized on
+ * @param cs_io Chip select GPIO
+ * @param clock_hz SPI clock
+ * @param[out] out Backend handle
+ * @return ESP_OK on success
+ */
+esp_err_t rm690b0_bus_spi_create(spi_host_device_t host_id, int cs_io, int clock_hz, rm690b0_bus_t **out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
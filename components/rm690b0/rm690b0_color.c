@@ -0,0 +1,317 @@
+#include "rm690b0_color.h"
+#include "sdkconfig.h"
+#include <string.h>
+
+#if CONFIG_IDF_TARGET_ESP32S3
+// rm690b0_color_pie.S: 16 pixels per block, both pointers 16-byte aligned
+void rm_color_swap16_pie(uint16_t *dst, const uint16_t *src, size_t blocks);
+#define RM_COLOR_PIE_ALIGN  16
+#define RM_COLOR_PIE_BLOCK  16
+#endif
+
+// 4x4 ordered dither thresholds (Bayer), 0..15
+static const uint8_t s_bayer4[16] = {
+     0,  8,  2, 10,
+    12,  4, 14,  6,
+     3, 11,  1,  9,
+    15,  7, 13,  5,
+};
+
+static inline uint16_t pack_be565(uint32_t r, uint32_t g, uint32_t b) {
+    uint16_t c = (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+    return rm_color_be(c);
+}
+
+// Add the threshold for the bits lost by truncation, saturating at 255
+static inline uint32_t dither_add(uint32_t v, uint32_t d) {
+    v += d;
+    return (v > 255) ? 255 : v;
+}
+
+size_t rm_pixfmt_bpp(rm690b0_pixfmt_t fmt) {
+    switch (fmt) {
+        case RM_PIXFMT_RGB888:   return 3;
+        case RM_PIXFMT_ARGB8888: return 4;
+        case RM_PIXFMT_GRAY8:    return 1;
+        default:                 return 2;
+    }
+}
+
+// --- Scalar references ---
+
+void rm_color_swap16_ref(uint16_t *dst, const uint16_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = rm_color_be(src[i]);
+}
+
+static uint16_t ref_pixel(uint32_t r, uint32_t g, uint32_t b, uint16_t x, uint16_t y, bool dither) {
+    if (dither) {
+        uint32_t d = s_bayer4[((y & 3) << 2) | (x & 3)];
+        r = dither_add(r, d >> 1);
+        g = dither_add(g, d >> 2);
+        b = dither_add(b, d >> 1);
+    }
+    return pack_be565(r, g, b);
+}
+
+void rm_color_rgb888_to_be565_ref(uint16_t *dst, const uint8_t *src, size_t n,
+                                  uint16_t x, uint16_t y, bool dither) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = ref_pixel(src[3 * i], src[3 * i + 1], src[3 * i + 2], x + i, y, dither);
+    }
+}
+
+void rm_color_argb8888_to_be565_ref(uint16_t *dst, const uint32_t *src, size_t n,
+                                    uint16_t x, uint16_t y, bool dither) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t p = src[i];
+        dst[i] = ref_pixel((p >> 16) & 0xFF, (p >> 8) & 0xFF, p & 0xFF, x + i, y, dither);
+    }
+}
+
+void rm_color_gray8_to_be565_ref(uint16_t *dst, const uint8_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = pack_be565(src[i], src[i], src[i]);
+    }
+}
+
+static uint16_t blend_ref(uint16_t s_be, uint16_t d_be, uint32_t a) {
+    uint32_t s = rm_color_be(s_be), d = rm_color_be(d_be);
+    uint32_t r = ((s >> 11) * a + (d >> 11) * (32 - a)) >> 5;
+    uint32_t g = (((s >> 5) & 0x3F) * a + ((d >> 5) & 0x3F) * (32 - a)) >> 5;
+    uint32_t b = ((s & 0x1F) * a + (d & 0x1F) * (32 - a)) >> 5;
+    return rm_color_be((uint16_t)((r << 11) | (g << 5) | b));
+}
+
+void rm_color_blend_be565_ref(uint16_t *dst, const uint16_t *src, size_t n, uint8_t alpha) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = blend_ref(src[i], dst[i], (alpha + 4u) >> 3);
+    }
+}
+
+void rm_color_blend_be565_a8_ref(uint16_t *dst, const uint16_t *src, const uint8_t *mask,
+                                 size_t n, uint8_t alpha) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t a8 = (mask[i] * (alpha + 1u)) >> 8;
+        dst[i] = blend_ref(src[i], dst[i], (a8 + 4) >> 3);
+    }
+}
+
+// --- Fast paths ---
+
+// Two pixels per 32-bit word
+static void swap16_words(uint16_t *dst, const uint16_t *src, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        uint32_t w;
+        memcpy(&w, src + i, 4);
+        w = ((w & 0x00FF00FFu) << 8) | ((w >> 8) & 0x00FF00FFu);
+        memcpy(dst + i, &w, 4);
+    }
+    if (i < n) dst[i] = rm_color_be(src[i]);
+}
+
+void rm_color_swap16(uint16_t *dst, const uint16_t *src, size_t n) {
+#if CONFIG_IDF_TARGET_ESP32S3
+    // Scalar head until dst is aligned; the vector loop needs src aligned too
+    while (n > 0 && ((uintptr_t)dst & (RM_COLOR_PIE_ALIGN - 1))) {
+        *dst++ = rm_color_be(*src++);
+        n--;
+    }
+    if (n >= RM_COLOR_PIE_BLOCK && ((uintptr_t)src & (RM_COLOR_PIE_ALIGN - 1)) == 0) {
+        size_t blocks = n / RM_COLOR_PIE_BLOCK;
+        rm_color_swap16_pie(dst, src, blocks);
+        dst += blocks * RM_COLOR_PIE_BLOCK;
+        src += blocks * RM_COLOR_PIE_BLOCK;
+        n -= blocks * RM_COLOR_PIE_BLOCK;
+    }
+#endif
+    swap16_words(dst, src, n);
+}
+
+void rm_color_rgb888_to_be565(uint16_t *dst, const uint8_t *src, size_t n,
+                              uint16_t x, uint16_t y, bool dither) {
+    if (!dither) {
+        for (size_t i = 0; i < n; i++, src += 3) {
+            dst[i] = pack_be565(src[0], src[1], src[2]);
+        }
+        return;
+    }
+
+    const uint8_t *row = &s_bayer4[(y & 3) << 2];
+    for (size_t i = 0; i < n; i++, src += 3) {
+        uint32_t d = row[(x + i) & 3];
+        dst[i] = pack_be565(dither_add(src[0], d >> 1), dither_add(src[1], d >> 2),
+                            dither_add(src[2], d >> 1));
+    }
+}
+
+void rm_color_argb8888_to_be565(uint16_t *dst, const uint32_t *src, size_t n,
+                                uint16_t x, uint16_t y, bool dither) {
+    if (!dither) {
+        for (size_t i = 0; i < n; i++) {
+            uint32_t p = src[i];
+            // Pick the top bits of each channel in place
+            uint16_t c = (uint16_t)(((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F));
+            dst[i] = rm_color_be(c);
+        }
+        return;
+    }
+
+    const uint8_t *row = &s_bayer4[(y & 3) << 2];
+    for (size_t i = 0; i < n; i++) {
+        uint32_t p = src[i];
+        uint32_t d = row[(x + i) & 3];
+        dst[i] = pack_be565(dither_add((p >> 16) & 0xFF, d >> 1), dither_add((p >> 8) & 0xFF, d >> 2),
+                            dither_add(p & 0xFF, d >> 1));
+    }
+}
+
+void rm_color_gray8_to_be565(uint16_t *dst, const uint8_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t g5 = src[i] >> 3;
+        uint32_t g6 = src[i] >> 2;
+        dst[i] = rm_color_be((uint16_t)((g5 << 11) | (g6 << 5) | g5));
+    }
+}
+
+// --- Blending ---
+
+// Green in the top half, red and blue below, each with room for a 5-bit weight
+static inline uint32_t blend_spread(uint16_t be) {
+    uint32_t c = rm_color_be(be);
+    return (c | (c << 16)) & 0x07E0F81F;
+}
+
+// s * a + d * (32 - a) per channel, regrouped so one multiply does all three;
+// the intermediate fields borrow from each other but the sum is exact
+static inline uint16_t blend_px(uint16_t s_be, uint16_t d_be, uint32_t a) {
+    uint32_t s = blend_spread(s_be), d = blend_spread(d_be);
+    uint32_t m = (((s - d) * a + (d << 5)) >> 5) & 0x07E0F81F;
+    return rm_color_be((uint16_t)(m | (m >> 16)));
+}
+
+void rm_color_blend_be565(uint16_t *dst, const uint16_t *src, size_t n, uint8_t alpha) {
+    uint32_t a = (alpha + 4u) >> 3;
+    if (a == 0) return;
+    if (a == 32) {
+        memmove(dst, src, n * 2);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) dst[i] = blend_px(src[i], dst[i], a);
+}
+
+void rm_color_blend_be565_a8(uint16_t *dst, const uint16_t *src, const uint8_t *mask,
+                             size_t n, uint8_t alpha) {
+    uint32_t scale = alpha + 1u;
+    size_t i = 0;
+    while (i < n) {
+        // Masks are mostly runs of 0 or 255: test four at a time
+        if (i + 4 <= n) {
+            uint32_t m4;
+            memcpy(&m4, mask + i, 4);
+            if (m4 == 0) {
+                i += 4;
+                continue;
+            }
+            if (m4 == 0xFFFFFFFFu && scale == 256) {
+                memcpy(dst + i, src + i, 8);
+                i += 4;
+                continue;
+            }
+        }
+        uint32_t a = (((mask[i] * scale) >> 8) + 4) >> 3;
+        if (a == 32) {
+            dst[i] = src[i];
+        } else if (a != 0) {
+            dst[i] = blend_px(src[i], dst[i], a);
+        }
+        i++;
+    }
+}
+
+// --- Interface format packing ---
+// Every kernel reads pixel i before writing byte i (or i / 2), so packing in
+// place over the source is safe.
+
+size_t rm_ifpf_bytes(rm690b0_ifpf_t ifpf, size_t n) {
+    switch (ifpf) {
+        case RM_IFPF_GRAY8:
+        case RM_IFPF_RGB332: return n;
+        case RM_IFPF_RGB111: return (n + 1) / 2;
+        default:             return n * 2;
+    }
+}
+
+void rm_color_be565_to_rgb332(uint8_t *dst, const uint16_t *src_be, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t c = rm_color_be(src_be[i]);
+        // Nearest level: x * (levels - 1) / max, as multiply-shift
+        uint32_t r3 = ((c >> 11) * 58 + 128) >> 8;
+        uint32_t g3 = (((c >> 5) & 0x3F) * 29 + 128) >> 8;
+        uint32_t b2 = ((c & 0x1F) * 25 + 128) >> 8;
+        dst[i] = (uint8_t)((r3 << 5) | (g3 << 2) | b2);
+    }
+}
+
+void rm_color_be565_to_gray8(uint8_t *dst, const uint16_t *src_be, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t c = rm_color_be(src_be[i]);
+        uint32_t r5 = c >> 11, g6 = (c >> 5) & 0x3F, b5 = c & 0x1F;
+        uint32_t r = (r5 << 3) | (r5 >> 2);
+        uint32_t g = (g6 << 2) | (g6 >> 4);
+        uint32_t b = (b5 << 3) | (b5 >> 2);
+        dst[i] = (uint8_t)((77 * r + 150 * g + 29 * b) >> 8); // BT.601 luma
+    }
+}
+
+static inline uint8_t rgb111(uint16_t be) {
+    uint32_t c = rm_color_be(be);
+    return (uint8_t)(((c >> 13) & 4) | ((c >> 9) & 2) | ((c >> 4) & 1));
+}
+
+void rm_color_be565_to_rgb111(uint8_t *dst, const uint16_t *src_be, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        dst[i / 2] = (uint8_t)((rgb111(src_be[i]) << 4) | rgb111(src_be[i + 1]));
+    }
+    if (i < n) dst[i / 2] = (uint8_t)(rgb111(src_be[i]) << 4);
+}
+
+size_t rm_color_pack(rm690b0_ifpf_t ifpf, uint8_t *dst, const uint16_t *src_be, size_t n) {
+    switch (ifpf) {
+        case RM_IFPF_RGB332:
+            rm_color_be565_to_rgb332(dst, src_be, n);
+            break;
+        case RM_IFPF_GRAY8:
+            rm_color_be565_to_gray8(dst, src_be, n);
+            break;
+        case RM_IFPF_RGB111:
+            rm_color_be565_to_rgb111(dst, src_be, n);
+            break;
+        default:
+            if ((const void *)dst != (const void *)src_be) memmove(dst, src_be, n * 2);
+            break;
+    }
+    return rm_ifpf_bytes(ifpf, n);
+}
+
+void rm_color_convert(rm690b0_pixfmt_t fmt, uint16_t *dst, const void *src, size_t n,
+                      uint16_t x, uint16_t y, bool dither) {
+    switch (fmt) {
+        case RM_PIXFMT_RGB565_LE:
+            rm_color_swap16(dst, src, n);
+            break;
+        case RM_PIXFMT_RGB888:
+            rm_color_rgb888_to_be565(dst, src, n, x, y, dither);
+            break;
+        case RM_PIXFMT_ARGB8888:
+            rm_color_argb8888_to_be565(dst, src, n, x, y, dither);
+            break;
+        case RM_PIXFMT_GRAY8:
+            rm_color_gray8_to_be565(dst, src, n);
+            break;
+        default:
+            memcpy(dst, src, n * 2);
+            break;
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef RM690B0_COLOR_H
+#define RM690B0_COLOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Pixel conversion kernels. Every kernel produces the big-endian RGB565 the
+ * panel expects.
+ *
+ * Only the byte swap is vectorized: on the ESP32-S3 it runs on the 128-bit
+ * PIE unit for 16-byte aligned runs. The RGB888, ARGB8888 and gray8
+ * conversions are per-pixel scalar code on every target (packed 24-bit input
+ * has no PIE shuffle to split it into lanes). The blend kernels work on all three channels of a pixel with one 32-bit
+ * multiply and skip transparent and opaque mask runs four pixels at a time.
+ * The *_ref() functions are plain per-pixel reference versions, kept for
+ * bit-exact comparison on a host.
+ */
+
+typedef enum {
+    RM_PIXFMT_RGB565_BE = 0,    // Panel order, sent as is
+    RM_PIXFMT_RGB565_LE,        // Native uint16_t RGB565
+    RM_PIXFMT_RGB888,           // 3 bytes per pixel: R, G, B
+    RM_PIXFMT_ARGB8888,         // Native uint32_t 0xAARRGGBB, alpha ignored
+    RM_PIXFMT_GRAY8,            // 1 byte luminance
+} rm690b0_pixfmt_t;
+
+/**
+ * Interface pixel formats on the wire (COLMOD 3Ah, VIPF and IFPF fields both
+ * set). The QUAD-SPI interface accepts RGB888/666/565, RGB332, RGB111 and
+ * Gray256; the panel expands everything to its internal 24-bit GRAM.
+ */
+typedef enum {
+    RM_IFPF_GRAY8  = 0x11,      // 8 bpp luminance
+    RM_IFPF_RGB332 = 0x22,      // 8 bpp, RRRGGGBB
+    RM_IFPF_RGB111 = 0x33,      // 4 bpp, 0RGB, two pixels per byte (first in the high nibble)
+    RM_IFPF_RGB565 = 0x55,      // 16 bpp, big-endian
+} rm690b0_ifpf_t;
+
+/**
+ * @brief Swap one RGB565 value between native and panel byte order
+ */
+static inline uint16_t rm_color_be(uint16_t c) {
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+/**
+ * @brief Bytes per pixel of a format
+ */
+size_t rm_pixfmt_bpp(rm690b0_pixfmt_t fmt);
+
+/**
+ * @brief Byte swap n RGB565 pixels. dst may equal src (in place).
+ */
+void rm_color_swap16(uint16_t *dst, const uint16_t *src, size_t n);
+
+/**
+ * @brief Wire bytes for n pixels in an interface format
+ */
+size_t rm_ifpf_bytes(rm690b0_ifpf_t ifpf, size_t n);
+
+/**
+ * @brief Pack big-endian RGB565 into an interface format, rounding each
+ * channel to the nearest level (RGB111: thresholded at half scale).
+ * dst may equal src (in place); an odd RGB111 count leaves the last low nibble 0.
+ * @return Bytes written, rm_ifpf_bytes(ifpf, n)
+ */
+size_t rm_color_pack(rm690b0_ifpf_t ifpf, uint8_t *dst, const uint16_t *src_be, size_t n);
+void rm_color_be565_to_rgb332(uint8_t *dst, const uint16_t *src_be, size_t n);
+void rm_color_be565_to_gray8(uint8_t *dst, const uint16_t *src_be, size_t n);
+void rm_color_be565_to_rgb111(uint8_t *dst, const uint16_t *src_be, size_t n);
+
+/**
+ * @brief RGB888 to big-endian RGB565
+ * @param x, y Screen position of the first pixel (phase of the dither matrix)
+ * @param dither Apply 4x4 ordered dithering before truncation
+ */
+void rm_color_rgb888_to_be565(uint16_t *dst, const uint8_t *src, size_t n,
+                              uint16_t x, uint16_t y, bool dither);
+
+/**
+ * @brief ARGB8888 to big-endian RGB565 (alpha is dropped)
+ */
+void rm_color_argb8888_to_be565(uint16_t *dst, const uint32_t *src, size_t n,
+                                uint16_t x, uint16_t y, bool dither);
+
+/**
+ * @brief 8-bit grayscale to big-endian RGB565
+ */
+void rm_color_gray8_to_be565(uint16_t *dst, const uint8_t *src, size_t n);
+
+/**
+ * @brief Convert one row segment of any format to big-endian RGB565
+ */
+void rm_color_convert(rm690b0_pixfmt_t fmt, uint16_t *dst, const void *src, size_t n,
+                      uint16_t x, uint16_t y, bool dither);
+
+/**
+ * @brief Blend big-endian RGB565 src over dst (in place) at a constant opacity.
+ * Channels are weighted in 1/32 steps, (alpha + 4) >> 3, and truncated.
+ */
+void rm_color_blend_be565(uint16_t *dst, const uint16_t *src, size_t n, uint8_t alpha);
+
+/**
+ * @brief Same with a per-pixel A8 mask: pixel opacity is mask * (alpha + 1) >> 8
+ */
+void rm_color_blend_be565_a8(uint16_t *dst, const uint16_t *src, const uint8_t *mask,
+                             size_t n, uint8_t alpha);
+
+// Scalar references
+void rm_color_swap16_ref(uint16_t *dst, const uint16_t *src, size_t n);
+void rm_color_rgb888_to_be565_ref(uint16_t *dst, const uint8_t *src, size_t n,
+                                  uint16_t x, uint16_t y, bool dither);
+void rm_color_argb8888_to_be565_ref(uint16_t *dst, const uint32_t *src, size_t n,
+                                    uint16_t x, uint16_t y, bool dither);
+void rm_color_gray8_to_be565_ref(uint16_t *dst, const uint8_t *src, size_t n);
+void rm_color_blend_be565_ref(uint16_t *dst, const uint16_t *src, size_t n, uint8_t alpha);
+void rm_color_blend_be565_a8_ref(uint16_t *dst, const uint16_t *src, const uint8_t *mask,
+                                 size_t n, uint8_t alpha);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,184 @@
+#include "rm690b0_console.h"
+#include "rm690b0.h"
+#include "rm690b0_font.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdarg.h>
+
+static const char *TAG = "rm690b0_console";
+
+#define CONSOLE_TAB     4
+
+typedef struct {
+    const uint8_t *glyph;
+    uint16_t fg_be;
+    uint16_t bg_be;
+} glyph_ctx_t;
+
+static rm690b0_console_config_t s_conf;
+static bool s_ready = false;
+static bool s_hw_scroll;
+static uint16_t s_cols;
+static uint16_t s_rows;
+static uint16_t s_height;   // s_rows * RM_FONT8X16_H
+static uint16_t s_col;
+static uint16_t s_row;      // Visible line of the cursor
+static uint16_t s_scroll;   // Current scroll offset in rows
+static bool s_wrapped;      // Wrap mode: lines below the cursor hold old text
+static rm690b0_console_stats_t s_stats;
+
+static void glyph_gen(void *ctx, uint16_t x, uint16_t y, uint16_t n, uint16_t *dst) {
+    const glyph_ctx_t *g = ctx;
+    uint8_t bits = g->glyph[y];
+    for (uint16_t i = 0; i < n; i++) {
+        dst[i] = (bits & (0x80 >> (x + i))) ? g->fg_be : g->bg_be;
+    }
+}
+
+// Screen row where visible line `line` is stored at the current scroll offset
+static uint16_t line_y(uint16_t line) {
+    return s_conf.top + (s_scroll + line * RM_FONT8X16_H) % s_height;
+}
+
+static void clear_line(uint16_t line) {
+    uint16_t w = s_cols * RM_FONT8X16_W;
+    rm690b0_source_t src;
+    rm690b0_source_solid(&src, s_conf.bg, (size_t)w * RM_FONT8X16_H);
+    rm690b0_draw_source(0, line_y(line), w, RM_FONT8X16_H, &src);
+    s_stats.pixels += (uint32_t)w * RM_FONT8X16_H;
+}
+
+static void draw_char(char c) {
+    if (c < RM_FONT8X16_FIRST || c > RM_FONT8X16_LAST) c = '?';
+
+    glyph_ctx_t g = {
+        .glyph = rm_font8x16[c - RM_FONT8X16_FIRST],
+        .fg_be = rm_color_be(s_conf.fg),
+        .bg_be = rm_color_be(s_conf.bg),
+    };
+    rm690b0_source_t src;
+    rm690b0_source_generator(&src, glyph_gen, &g, RM_FONT8X16_W, RM_FONT8X16_H);
+    // Generator sources are copied into pool buffers, g may go out of scope
+    rm690b0_draw_source(s_col * RM_FONT8X16_W, line_y(s_row), RM_FONT8X16_W, RM_FONT8X16_H, &src);
+
+    s_stats.chars++;
+    s_stats.pixels += RM_FONT8X16_W * RM_FONT8X16_H;
+}
+
+static void new_line(void) {
+    s_col = 0;
+    s_stats.lines++;
+
+    if (s_row + 1 < s_rows) {
+        s_row++;
+        if (s_wrapped) {
+            // Clear the old text of the new line and keep a blank line below it
+            clear_line(s_row);
+            if (s_row + 1 < s_rows) clear_line(s_row + 1);
+        }
+        return;
+    }
+
+    if (s_hw_scroll) {
+        // The top line's rows become the new bottom line: clear them, then
+        // move the scroll pointer in the same batch
+        s_scroll = (s_scroll + RM_FONT8X16_H) % s_height;
+        clear_line(s_rows - 1);
+        rm690b0_scroll_to(s_scroll);
+        s_stats.hw_scrolls++;
+    } else {
+        s_row = 0;
+        s_wrapped = true;
+        clear_line(0);
+        if (s_rows > 1) clear_line(1);
+        s_stats.wraps++;
+    }
+}
+
+esp_err_t rm690b0_console_init(const rm690b0_console_config_t *config) {
+    uint16_t w = rm690b0_get_width();
+    uint16_t h = rm690b0_get_height();
+    if (config->top >= h) return ESP_ERR_INVALID_ARG;
+
+    s_conf = *config;
+    uint16_t avail = h - s_conf.top;
+    if (s_conf.height == 0 || s_conf.height > avail) s_conf.height = avail;
+
+    s_cols = w / RM_FONT8X16_W;
+    s_rows = s_conf.height / RM_FONT8X16_H;
+    if (s_rows == 0) return ESP_ERR_INVALID_ARG;
+    s_height = s_rows * RM_FONT8X16_H;
+    s_col = 0;
+    s_row = 0;
+    s_scroll = 0;
+
+    s_hw_scroll = false;
+    if (rm690b0_scroll_supported()) {
+        s_hw_scroll = (rm690b0_scroll_area(s_conf.top, s_height) == ESP_OK);
+    } else {
+        rm690b0_scroll_reset();
+    }
+
+    s_ready = true;
+    rm690b0_console_clear();
+    ESP_LOGI(TAG, "Console %dx%d at row %d (%s)", s_cols, s_rows, s_conf.top,
+             s_hw_scroll ? "hw scroll" : "wrap");
+    return ESP_OK;
+}
+
+void rm690b0_console_clear(void) {
+    if (!s_ready) return;
+
+    s_col = 0;
+    s_row = 0;
+    s_scroll = 0;
+    s_wrapped = false;
+    if (s_hw_scroll) rm690b0_scroll_to(0);
+
+    rm690b0_source_t src;
+    uint16_t w = s_cols * RM_FONT8X16_W;
+    rm690b0_source_solid(&src, s_conf.bg, (size_t)w * s_height);
+    rm690b0_draw_source(0, s_conf.top, w, s_height, &src);
+    s_stats.pixels += (uint32_t)w * s_height;
+}
+
+void rm690b0_console_write(const char *text) {
+    if (!s_ready) return;
+
+    for (; *text; text++) {
+        char c = *text;
+        switch (c) {
+            case '\n':
+                new_line();
+                break;
+            case '\r':
+                s_col = 0;
+                break;
+            case '\t':
+                do {
+                    draw_char(' ');
+                    s_col++;
+                } while (s_col % CONSOLE_TAB && s_col < s_cols);
+                break;
+            default:
+                draw_char(c);
+                s_col++;
+                break;
+        }
+        if (s_col >= s_cols) new_line();
+    }
+}
+
+int rm690b0_console_printf(const char *fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    rm690b0_console_write(buf);
+    return n;
+}
+
+void rm690b0_console_get_stats(rm690b0_console_stats_t *stats) {
+    *stats = s_stats;
+}
@@ -0,0 +1,66 @@
+#ifndef RM690B0_CONSOLE_H
+#define RM690B0_CONSOLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Text console on a band of screen rows, 8x16 font.
+ *
+ * New lines are drawn into the row band that just scrolled out and revealed
+ * with the hardware scroll pointer, so a scroll costs one text line of pixels.
+ * In landscape rotations, where the panel cannot scroll vertically, the cursor
+ * wraps to the top instead and the line below it is cleared as a marker.
+ */
+
+typedef struct {
+    uint16_t top;       // First screen row of the console
+    uint16_t height;    // Rows, rounded down to whole text lines. 0 = to the bottom
+    uint16_t fg;        // RGB565 text color
+    uint16_t bg;        // RGB565 background
+} rm690b0_console_config_t;
+
+typedef struct {
+    uint32_t chars;         // Glyphs drawn
+    uint32_t lines;         // Line feeds
+    uint32_t hw_scrolls;    // Line feeds handled by moving the scroll pointer
+    uint32_t wraps;         // Line feeds handled by wrapping to the top
+    uint32_t pixels;        // Pixels sent, glyphs and line clears
+} rm690b0_console_stats_t;
+
+/**
+ * @brief Clear the console area and set up scrolling for the current rotation.
+ * Call again after rm690b0_set_rotation().
+ */
+esp_err_t rm690b0_console_init(const rm690b0_console_config_t *config);
+
+/**
+ * @brief Write text. Handles '\n', '\r', '\t' and wraps long lines.
+ */
+void rm690b0_console_write(const char *text);
+
+/**
+ * @brief printf to the console
+ */
+int rm690b0_console_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Clear the console and home the cursor
+ */
+void rm690b0_console_clear(void);
+
+/**
+ * @brief Rendering statistics
+ */
+void rm690b0_console_get_stats(rm690b0_console_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
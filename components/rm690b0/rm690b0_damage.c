@@ -0,0 +1,128 @@
+#include "rm690b0_damage.h"
+
+static uint32_t area_px(const rm690b0_area_t *a) {
+    return (uint32_t)(a->x2 - a->x1 + 1) * (uint32_t)(a->y2 - a->y1 + 1);
+}
+
+static rm690b0_area_t area_union(const rm690b0_area_t *a, const rm690b0_area_t *b) {
+    rm690b0_area_t u = {
+        .x1 = (a->x1 < b->x1) ? a->x1 : b->x1,
+        .y1 = (a->y1 < b->y1) ? a->y1 : b->y1,
+        .x2 = (a->x2 > b->x2) ? a->x2 : b->x2,
+        .y2 = (a->y2 > b->y2) ? a->y2 : b->y2,
+    };
+    return u;
+}
+
+static bool area_contains(const rm690b0_area_t *outer, const rm690b0_area_t *inner) {
+    return inner->x1 >= outer->x1 && inner->x2 <= outer->x2 &&
+           inner->y1 >= outer->y1 && inner->y2 <= outer->y2;
+}
+
+// Wire cost saved by sending a and b as their bounding box (may be negative)
+static int64_t merge_gain(const rm690b0_damage_t *d, const rm690b0_area_t *a, const rm690b0_area_t *b) {
+    rm690b0_area_t u = area_union(a, b);
+    int64_t separate = 2 * (int64_t)d->setup_cost + area_px(a) + area_px(b);
+    int64_t merged = (int64_t)d->setup_cost + area_px(&u);
+    return separate - merged;
+}
+
+static void remove_at(rm690b0_damage_t *d, uint8_t idx) {
+    for (uint8_t k = idx; k + 1 < d->count; k++) {
+        d->areas[k] = d->areas[k + 1];
+    }
+    d->count--;
+}
+
+// Best pair by gain; ties go to the lowest (i, j) so the result is deterministic
+static bool best_pair(const rm690b0_damage_t *d, uint8_t *bi, uint8_t *bj, int64_t *bgain) {
+    bool found = false;
+    for (uint8_t i = 0; i < d->count; i++) {
+        for (uint8_t j = i + 1; j < d->count; j++) {
+            int64_t g = merge_gain(d, &d->areas[i], &d->areas[j]);
+            if (!found || g > *bgain) {
+                found = true;
+                *bi = i;
+                *bj = j;
+                *bgain = g;
+            }
+        }
+    }
+    return found;
+}
+
+static void merge_pair(rm690b0_damage_t *d, uint8_t i, uint8_t j) {
+    d->areas[i] = area_union(&d->areas[i], &d->areas[j]);
+    remove_at(d, j);
+    d->merges++;
+}
+
+// Merge while any pair pays off
+static void coalesce(rm690b0_damage_t *d) {
+    uint8_t i, j;
+    int64_t gain;
+    while (best_pair(d, &i, &j, &gain) && gain >= 0) {
+        merge_pair(d, i, j);
+    }
+}
+
+void rm_damage_init(rm690b0_damage_t *d, uint16_t width, uint16_t height, uint32_t setup_cost) {
+    d->count = 0;
+    d->width = width;
+    d->height = height;
+    d->setup_cost = setup_cost ? setup_cost : RM_DAMAGE_SETUP_COST_PX;
+    d->added = 0;
+    d->merges = 0;
+    d->forced = 0;
+}
+
+void rm_damage_reset(rm690b0_damage_t *d) {
+    d->count = 0;
+}
+
+void rm_damage_add(rm690b0_damage_t *d, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    if (w == 0 || h == 0 || x >= d->width || y >= d->height) return;
+    d->added++;
+
+    uint32_t x2 = (uint32_t)x + w - 1;
+    uint32_t y2 = (uint32_t)y + h - 1;
+    if (x2 >= d->width) x2 = d->width - 1;
+    if (y2 >= d->height) y2 = d->height - 1;
+
+    rm690b0_area_t a = {
+        .x1 = x & ~1,
+        .y1 = y,
+        .x2 = (uint16_t)(x2 | 1),
+        .y2 = (uint16_t)y2,
+    };
+    // Odd frame widths cannot round up past the last column
+    if (a.x2 >= d->width) a.x2 = d->width - 1;
+
+    for (uint8_t k = 0; k < d->count; k++) {
+        if (area_contains(&d->areas[k], &a)) return;
+    }
+
+    if (d->count == RM_DAMAGE_MAX_AREAS) {
+        // Full: make room with the cheapest merge even if it does not pay off
+        uint8_t i, j;
+        int64_t gain;
+        best_pair(d, &i, &j, &gain);
+        merge_pair(d, i, j);
+        d->forced++;
+    }
+
+    d->areas[d->count++] = a;
+    coalesce(d);
+}
+
+void rm_damage_add_all(rm690b0_damage_t *d) {
+    rm_damage_add(d, 0, 0, d->width, d->height);
+}
+
+size_t rm_damage_pixels(const rm690b0_damage_t *d) {
+    size_t total = 0;
+    for (uint8_t k = 0; k < d->count; k++) {
+        total += area_px(&d->areas[k]);
+    }
+    return total;
+}
@@ -0,0 +1,80 @@
+#ifndef RM690B0_DAMAGE_H
+#define RM690B0_DAMAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Damage-region tracker.
+ *
+ * Collects dirty rectangles for one frame and coalesces them into as few
+ * CASET/RASET windows as the cost model allows. Merging two areas into their
+ * bounding box pays off when the extra pixels sent cost less than one window
+ * setup. Areas are kept even-X aligned (x1 even, x2 odd), matching
+ * rm690b0_set_window(); the rotation offsets are all even so alignment before
+ * the offset is the same as after.
+ *
+ * Pure C and deterministic: the same sequence of rm_damage_add() calls always
+ * produces the same list.
+ */
+
+#define RM_DAMAGE_MAX_AREAS         32
+
+// One window setup (CASET + RASET + RAMWR header and transaction overhead),
+// expressed in pixels worth of QSPI wire time
+#define RM_DAMAGE_SETUP_COST_PX     512
+
+typedef struct {
+    uint16_t x1, y1, x2, y2; // Inclusive
+} rm690b0_area_t;
+
+typedef struct {
+    rm690b0_area_t areas[RM_DAMAGE_MAX_AREAS];
+    uint8_t count;
+    uint16_t width, height;     // Clip bounds (current rotation)
+    uint32_t setup_cost;        // Pixels per window setup
+    // Statistics since rm_damage_init()
+    uint32_t added;             // Rectangles submitted
+    uint32_t merges;            // Pair merges performed
+    uint32_t forced;            // Merges forced by a full list
+} rm690b0_damage_t;
+
+/**
+ * @brief Initialize a tracker
+ * @param width Frame width in pixels
+ * @param height Frame height in pixels
+ * @param setup_cost Pixels per window setup, 0 for RM_DAMAGE_SETUP_COST_PX
+ */
+void rm_damage_init(rm690b0_damage_t *d, uint16_t width, uint16_t height, uint32_t setup_cost);
+
+/**
+ * @brief Drop all areas (start a new frame). Statistics are kept.
+ */
+void rm_damage_reset(rm690b0_damage_t *d);
+
+/**
+ * @brief Mark a rectangle dirty. Clipped to the frame, aligned to even X and
+ * merged with existing areas when the cost model says so.
+ */
+void rm_damage_add(rm690b0_damage_t *d, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+/**
+ * @brief Mark the whole frame dirty
+ */
+void rm_damage_add_all(rm690b0_damage_t *d);
+
+/**
+ * @brief Pixels covered by the current area list (what a flush sends)
+ */
+size_t rm_damage_pixels(const rm690b0_damage_t *d);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
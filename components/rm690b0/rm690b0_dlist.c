@@ -0,0 +1,583 @@
+#include "rm690b0_dlist.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define DLIST_VERSION       1
+#define DLIST_FILL_BYTES    11      // op, x, y, w, h, color
+#define DLIST_BITMAP_BYTES  13      // op, x, y, w, h, offset
+#define DLIST_WORK          64      // Pieces in flight while cutting one op
+#define DLIST_MERGE_MAX     512     // Ops beyond which fills are not merged
+
+// Recorded op: clipped, on even columns
+typedef struct rm_dlist_rec {
+    uint8_t op;
+    uint16_t x, y, w, h;
+    uint16_t color;
+    size_t px;              // Bitmaps: first pixel in dl->px
+    size_t stride;
+} dlist_rec_t;
+
+typedef struct {
+    int32_t x0, y0, x1, y1;
+} drect_t;
+
+// Op of the optimized list: a recorded op or a visible part of one
+typedef struct {
+    drect_t r;
+    uint32_t order;         // Position: its recorded op, or the later of two merged fills
+    uint32_t src;           // Recorded op
+    bool exact;             // Nothing drawn later overlaps it
+    bool dead;
+} dlist_piece_t;
+
+static inline void put16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xff;
+    p[1] = v >> 8;
+}
+
+static inline void put32(uint8_t *p, uint32_t v) {
+    put16(p, v & 0xffff);
+    put16(p + 2, v >> 16);
+}
+
+static inline uint16_t get16(const uint8_t *p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static inline uint32_t get32(const uint8_t *p) {
+    return get16(p) | (uint32_t)get16(p + 2) << 16;
+}
+
+static void dlist_reset(rm690b0_dlist_t *dl) {
+    free(dl->rec);
+    free(dl->px);
+    free(dl->owned);
+    dl->rec = NULL;
+    dl->px = NULL;
+    dl->owned = NULL;
+    dl->rec_count = dl->rec_cap = dl->px_count = dl->px_cap = 0;
+    dl->data = NULL;
+    dl->size = 0;
+    dl->recording = false;
+}
+
+// --- Recording ---
+
+esp_err_t rm690b0_dlist_begin(rm690b0_dlist_t *dl, uint16_t width, uint16_t height) {
+    if (!dl || width == 0 || height == 0 || (width & 1)) return ESP_ERR_INVALID_ARG;
+    rm690b0_dlist_free(dl);
+    dl->width = width;
+    dl->height = height;
+    dl->recording = true;
+    dl->rec_error = ESP_OK;
+    return ESP_OK;
+}
+
+// Clip to the screen and widen to even columns; false when nothing is left
+static bool dlist_clip(const rm690b0_dlist_t *dl, int32_t x, int32_t y, int32_t w, int32_t h, drect_t *r) {
+    r->x0 = (x > 0) ? x : 0;
+    r->y0 = (y > 0) ? y : 0;
+    r->x1 = (x + w < dl->width) ? x + w : dl->width;
+    r->y1 = (y + h < dl->height) ? y + h : dl->height;
+    if (r->x0 >= r->x1 || r->y0 >= r->y1) return false;
+    r->x0 &= ~1;
+    r->x1 = (r->x1 + 1) & ~1;
+    return true;
+}
+
+static dlist_rec_t *dlist_add(rm690b0_dlist_t *dl, uint8_t op, const drect_t *r) {
+    if (dl->rec_count == dl->rec_cap) {
+        size_t cap = dl->rec_cap ? dl->rec_cap * 2 : 16;
+        dlist_rec_t *rec = realloc(dl->rec, cap * sizeof(*rec));
+        if (!rec) {
+            dl->rec_error = ESP_ERR_NO_MEM;
+            return NULL;
+        }
+        dl->rec = rec;
+        dl->rec_cap = cap;
+    }
+    dlist_rec_t *e = &dl->rec[dl->rec_count++];
+    *e = (dlist_rec_t){
+        .op = op, .x = (uint16_t)r->x0, .y = (uint16_t)r->y0,
+        .w = (uint16_t)(r->x1 - r->x0), .h = (uint16_t)(r->y1 - r->y0),
+    };
+    dl->stats.recorded++;
+    dl->stats.pixels_recorded += (uint32_t)e->w * e->h;
+    return e;
+}
+
+esp_err_t rm690b0_dlist_fill(rm690b0_dlist_t *dl, int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    if (!dl->recording) return ESP_ERR_INVALID_STATE;
+    drect_t r;
+    if (!dlist_clip(dl, x, y, w, h, &r)) return ESP_OK;
+    dlist_rec_t *e = dlist_add(dl, RM_DLIST_OP_FILL, &r);
+    if (!e) return ESP_ERR_NO_MEM;
+    e->color = color;
+    return ESP_OK;
+}
+
+esp_err_t rm690b0_dlist_fill_screen(rm690b0_dlist_t *dl, uint16_t color) {
+    return rm690b0_dlist_fill(dl, 0, 0, dl->width, dl->height, color);
+}
+
+esp_err_t rm690b0_dlist_bitmap(rm690b0_dlist_t *dl, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                               const uint16_t *data_be, size_t stride) {
+    if (!dl->recording) return ESP_ERR_INVALID_STATE;
+    if (!data_be) return ESP_ERR_INVALID_ARG;
+    drect_t r;
+    if (!dlist_clip(dl, x, y, w, h, &r)) return ESP_OK;
+
+    size_t n = (size_t)(r.x1 - r.x0) * (r.y1 - r.y0);
+    if (dl->px_count + n > dl->px_cap) {
+        size_t cap = dl->px_cap ? dl->px_cap : 4096;
+        while (cap < dl->px_count + n) cap *= 2;
+        uint16_t *px = realloc(dl->px, cap * 2);
+        if (!px) {
+            dl->rec_error = ESP_ERR_NO_MEM;
+            return ESP_ERR_NO_MEM;
+        }
+        dl->px = px;
+        dl->px_cap = cap;
+    }
+    dlist_rec_t *e = dlist_add(dl, RM_DLIST_OP_BITMAP, &r);
+    if (!e) return ESP_ERR_NO_MEM;
+    e->px = dl->px_count;
+    e->stride = e->w;
+
+    // The visible part, with the source's edge column repeated into a widened one
+    uint16_t *dst = dl->px + dl->px_count;
+    for (int32_t row = r.y0; row < r.y1; row++) {
+        const uint16_t *src = data_be + (size_t)(row - y) * stride;
+        for (int32_t col = r.x0; col < r.x1; col++) {
+            int32_t c = col - x;
+            if (c < 0) c = 0;
+            if (c >= w) c = w - 1;
+            *dst++ = src[c];
+        }
+    }
+    dl->px_count += n;
+    return ESP_OK;
+}
+
+// --- Optimization ---
+
+static inline bool rect_overlap(const drect_t *a, const drect_t *b) {
+    return a->x0 < b->x1 && b->x0 < a->x1 && a->y0 < b->y1 && b->y0 < a->y1;
+}
+
+static inline int64_t rect_area(const drect_t *r) {
+    return (int64_t)(r->x1 - r->x0) * (r->y1 - r->y0);
+}
+
+// Cut c out of the n pieces in p (room for DLIST_WORK), -1 when they would not fit
+static int rect_subtract(drect_t *p, int n, const drect_t *c) {
+    drect_t out[DLIST_WORK];
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        const drect_t *a = &p[i];
+        if (!rect_overlap(a, c)) {
+            if (m == DLIST_WORK) return -1;
+            out[m++] = *a;
+            continue;
+        }
+        // Full-width bands above and below c, then the sides between them
+        int32_t y0 = (a->y0 > c->y0) ? a->y0 : c->y0, y1 = (a->y1 < c->y1) ? a->y1 : c->y1;
+        drect_t parts[4] = {
+            { a->x0, a->y0, a->x1, y0 },
+            { a->x0, y1, a->x1, a->y1 },
+            { a->x0, y0, (c->x0 > a->x0) ? c->x0 : a->x0, y1 },
+            { (c->x1 < a->x1) ? c->x1 : a->x1, y0, a->x1, y1 },
+        };
+        for (int k = 0; k < 4; k++) {
+            if (parts[k].x0 >= parts[k].x1 || parts[k].y0 >= parts[k].y1) continue;
+            if (m == DLIST_WORK) return -1;
+            out[m++] = parts[k];
+        }
+    }
+    memcpy(p, out, m * sizeof(*p));
+    return m;
+}
+
+// Touching fills of one color that together form a rectangle
+static bool piece_merge(dlist_piece_t *a, const dlist_piece_t *b) {
+    drect_t *r = &a->r;
+    const drect_t *s = &b->r;
+    if (r->y0 == s->y0 && r->y1 == s->y1 && (r->x1 == s->x0 || s->x1 == r->x0)) {
+        r->x0 = (r->x0 < s->x0) ? r->x0 : s->x0;
+        r->x1 = (r->x1 > s->x1) ? r->x1 : s->x1;
+    } else if (r->x0 == s->x0 && r->x1 == s->x1 && (r->y1 == s->y0 || s->y1 == r->y0)) {
+        r->y0 = (r->y0 < s->y0) ? r->y0 : s->y0;
+        r->y1 = (r->y1 > s->y1) ? r->y1 : s->y1;
+    } else {
+        return false;
+    }
+    // Both are final pixels, so the merged fill may go where the later one was
+    if (b->order > a->order) a->order = b->order;
+    return true;
+}
+
+static int piece_cmp(const void *a, const void *b) {
+    const dlist_piece_t *pa = a, *pb = b;
+    if (pa->order != pb->order) return (pa->order < pb->order) ? -1 : 1;
+    // Parts of one op in scan order
+    if (pa->r.y0 != pb->r.y0) return (pa->r.y0 < pb->r.y0) ? -1 : 1;
+    return (pa->r.x0 < pb->r.x0) ? -1 : (pa->r.x0 > pb->r.x0);
+}
+
+// Visible parts of every op, back to front. NULL on allocation failure.
+static dlist_piece_t *dlist_optimize(rm690b0_dlist_t *dl, size_t *count) {
+    size_t cap = dl->rec_count + 16, n = 0;
+    dlist_piece_t *pieces = malloc(cap * sizeof(*pieces));
+    if (!pieces) return NULL;
+
+    drect_t work[DLIST_WORK];
+    for (size_t i = dl->rec_count; i-- > 0;) {
+        const dlist_rec_t *e = &dl->rec[i];
+        drect_t whole = { e->x, e->y, e->x + e->w, e->y + e->h };
+        work[0] = whole;
+        int m = 1;
+        bool covered = false;
+        for (size_t k = i + 1; k < dl->rec_count && m > 0; k++) {
+            const dlist_rec_t *c = &dl->rec[k];
+            drect_t cr = { c->x, c->y, c->x + c->w, c->y + c->h };
+            if (!rect_overlap(&whole, &cr)) continue;
+            covered = true;
+            m = rect_subtract(work, m, &cr);
+        }
+        if (m == 0) {
+            dl->stats.dropped++;
+            continue;
+        }
+        // Cut it when the hidden pixels outweigh the extra windows, else
+        // send it whole and let the later ops draw over it
+        int64_t visible = 0;
+        for (int k = 0; k < m; k++) visible += rect_area(&work[k]);
+        bool cut = covered && m <= RM_DLIST_MAX_PIECES &&
+                   (rect_area(&whole) - visible) * 2 > (int64_t)(m - 1) * RM_DLIST_WINDOW_COST;
+        if (!cut) {
+            work[0] = whole;
+            m = 1;
+        } else {
+            dl->stats.split++;
+        }
+
+        if (n + m > cap) {
+            cap = (n + m) * 2;
+            dlist_piece_t *grown = realloc(pieces, cap * sizeof(*pieces));
+            if (!grown) {
+                free(pieces);
+                return NULL;
+            }
+            pieces = grown;
+        }
+        for (int k = 0; k < m; k++) {
+            pieces[n++] = (dlist_piece_t){
+                .r = work[k], .order = (uint32_t)i, .src = (uint32_t)i, .exact = !covered || cut,
+            };
+        }
+    }
+
+    // Merge exact fills of one color until nothing changes
+    if (n <= DLIST_MERGE_MAX) {
+        bool again = true;
+        while (again) {
+            again = false;
+            for (size_t a = 0; a < n; a++) {
+                dlist_piece_t *pa = &pieces[a];
+                if (pa->dead || !pa->exact || dl->rec[pa->src].op != RM_DLIST_OP_FILL) continue;
+                for (size_t b = a + 1; b < n; b++) {
+                    dlist_piece_t *pb = &pieces[b];
+                    if (pb->dead || !pb->exact || dl->rec[pb->src].op != RM_DLIST_OP_FILL ||
+                        dl->rec[pb->src].color != dl->rec[pa->src].color) {
+                        continue;
+                    }
+                    if (piece_merge(pa, pb)) {
+                        pb->dead = true;
+                        dl->stats.merged++;
+                        again = true;
+                    }
+                }
+            }
+        }
+    }
+    size_t live = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!pieces[i].dead) pieces[live++] = pieces[i];
+    }
+    qsort(pieces, live, sizeof(*pieces), piece_cmp);
+    *count = live;
+    return pieces;
+}
+
+// --- Re-presenting in another rotation ---
+
+// A final visible part of a list item
+typedef struct {
+    drect_t r;
+    rm690b0_dlist_item_t it;
+} dlist_vis_t;
+
+// Every item cut down to what no later item covers: disjoint pieces that are
+// exactly what the list leaves on screen. NULL with *err set on failure.
+static dlist_vis_t *dlist_flatten(const rm690b0_dlist_t *dl, size_t *count, esp_err_t *err) {
+    size_t n = 0, pos = 0;
+    rm690b0_dlist_item_t it;
+    while (rm690b0_dlist_next(dl, &pos, &it)) n++;
+    rm690b0_dlist_item_t *items = malloc((n ? n : 1) * sizeof(*items));
+    size_t cap = n + 16, m = 0;
+    dlist_vis_t *vis = malloc(cap * sizeof(*vis));
+    *err = (items && vis) ? ESP_OK : ESP_ERR_NO_MEM;
+    pos = 0;
+    for (size_t i = 0; *err == ESP_OK && i < n; i++) rm690b0_dlist_next(dl, &pos, &items[i]);
+
+    drect_t work[DLIST_WORK];
+    for (size_t i = n; *err == ESP_OK && i-- > 0;) {
+        const rm690b0_dlist_item_t *e = &items[i];
+        work[0] = (drect_t){ e->x, e->y, e->x + e->w, e->y + e->h };
+        int k = 1;
+        for (size_t j = i + 1; j < n && k > 0; j++) {
+            drect_t c = { items[j].x, items[j].y, items[j].x + items[j].w, items[j].y + items[j].h };
+            k = rect_subtract(work, k, &c);
+        }
+        if (k < 0) {
+            *err = ESP_ERR_NOT_SUPPORTED;
+            break;
+        }
+        if (m + k > cap) {
+            cap = (m + k) * 2;
+            dlist_vis_t *grown = realloc(vis, cap * sizeof(*vis));
+            if (!grown) {
+                *err = ESP_ERR_NO_MEM;
+                break;
+            }
+            vis = grown;
+        }
+        for (int p = 0; p < k; p++) vis[m++] = (dlist_vis_t){ .r = work[p], .it = *e };
+    }
+    free(items);
+    if (*err != ESP_OK) {
+        free(vis);
+        return NULL;
+    }
+    *count = m;
+    return vis;
+}
+
+esp_err_t rm690b0_dlist_delta(rm690b0_dlist_t *delta, const rm690b0_dlist_t *next, const rm690b0_xform_t *next_xf,
+                              const rm690b0_dlist_t *shown, const rm690b0_xform_t *shown_xf) {
+    if (!delta || delta == next || delta == shown) return ESP_ERR_INVALID_ARG;
+    if (!next->data || !shown->data) return ESP_ERR_INVALID_STATE;
+    if (next->width != next_xf->width || next->height != next_xf->height ||
+        shown->width != shown_xf->width || shown->height != shown_xf->height) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t nn = 0, ns = 0;
+    esp_err_t ret;
+    dlist_vis_t *nv = dlist_flatten(next, &nn, &ret);
+    if (!nv) return ret;
+    dlist_vis_t *sv = dlist_flatten(shown, &ns, &ret);
+    if (!sv) {
+        free(nv);
+        return ret;
+    }
+
+    // Fills on the panel, in next's coordinates, shrunk to the even columns
+    // they cover completely
+    size_t nf = 0;
+    for (size_t i = 0; i < ns; i++) {
+        if (sv[i].it.op != RM_DLIST_OP_FILL) continue;
+        drect_t r = sv[i].r;
+        rm690b0_xform_map_rect(shown_xf, next_xf, &r.x0, &r.y0, &r.x1, &r.y1);
+        r.x0 = (r.x0 + 1) & ~1;
+        r.x1 &= ~1;
+        if (r.x0 >= r.x1) continue;
+        sv[nf] = sv[i];
+        sv[nf++].r = r;
+    }
+
+    ret = rm690b0_dlist_begin(delta, next->width, next->height);
+    drect_t work[DLIST_WORK];
+    for (size_t i = 0; i < nn && ret == ESP_OK; i++) {
+        const dlist_vis_t *v = &nv[i];
+        int32_t w = v->r.x1 - v->r.x0, h = v->r.y1 - v->r.y0;
+        if (v->it.op == RM_DLIST_OP_BITMAP) {
+            const uint16_t *px = v->it.data_be + (size_t)(v->r.y0 - v->it.y) * v->it.w + (v->r.x0 - v->it.x);
+            ret = rm690b0_dlist_bitmap(delta, v->r.x0, v->r.y0, w, h, px, v->it.w);
+            continue;
+        }
+        // What the panel already shows in this color need not go out again
+        work[0] = v->r;
+        int k = 1;
+        for (size_t j = 0; j < nf && k > 0; j++) {
+            if (sv[j].it.color != v->it.color || !rect_overlap(&v->r, &sv[j].r)) continue;
+            k = rect_subtract(work, k, &sv[j].r);
+            if (k < 0) {
+                work[0] = v->r;
+                k = 1;
+                break;
+            }
+        }
+        for (int p = 0; p < k && ret == ESP_OK; p++) {
+            const drect_t *r = &work[p];
+            ret = rm690b0_dlist_fill(delta, r->x0, r->y0, r->x1 - r->x0, r->y1 - r->y0, v->it.color);
+        }
+    }
+    free(nv);
+    free(sv);
+    if (ret == ESP_OK) return rm690b0_dlist_end(delta);
+    rm690b0_dlist_free(delta);
+    return ret;
+}
+
+// --- Serialization ---
+
+esp_err_t rm690b0_dlist_end(rm690b0_dlist_t *dl) {
+    if (!dl->recording) return ESP_ERR_INVALID_STATE;
+    esp_err_t ret = dl->rec_error;
+
+    size_t n = 0;
+    dlist_piece_t *pieces = (ret == ESP_OK) ? dlist_optimize(dl, &n) : NULL;
+    if (ret == ESP_OK && !pieces && dl->rec_count) ret = ESP_ERR_NO_MEM;
+
+    size_t code = 1, px = 0;
+    for (size_t i = 0; i < n; i++) {
+        const drect_t *r = &pieces[i].r;
+        bool bitmap = dl->rec[pieces[i].src].op == RM_DLIST_OP_BITMAP;
+        code += bitmap ? DLIST_BITMAP_BYTES : DLIST_FILL_BYTES;
+        if (bitmap) px += (size_t)rect_area(r);
+    }
+    size_t data_off = (sizeof(rm690b0_dlist_header_t) + code + RM_DLIST_ALIGN - 1) & ~(size_t)(RM_DLIST_ALIGN - 1);
+    size_t size = data_off + px * 2;
+    uint8_t *buf = (ret == ESP_OK) ? calloc(1, size) : NULL;
+    if (ret == ESP_OK && !buf) ret = ESP_ERR_NO_MEM;
+
+    if (ret == ESP_OK) {
+        // rm690b0_dlist_header_t, little-endian whatever the host
+        memcpy(buf, RM_DLIST_MAGIC, 4);
+        put16(buf + 4, DLIST_VERSION);
+        put16(buf + 6, dl->width);
+        put16(buf + 8, dl->height);
+        put16(buf + 10, (uint16_t)n);
+        put32(buf + 12, (uint32_t)code);
+        put32(buf + 16, (uint32_t)size);
+
+        uint8_t *p = buf + sizeof(rm690b0_dlist_header_t);
+        uint16_t *dst = (uint16_t *)(buf + data_off);
+        dl->stats.pixels = 0;
+        for (size_t i = 0; i < n; i++) {
+            const drect_t *r = &pieces[i].r;
+            const dlist_rec_t *e = &dl->rec[pieces[i].src];
+            uint16_t w = (uint16_t)(r->x1 - r->x0), h = (uint16_t)(r->y1 - r->y0);
+            *p = e->op;
+            put16(p + 1, (uint16_t)r->x0);
+            put16(p + 3, (uint16_t)r->y0);
+            put16(p + 5, w);
+            put16(p + 7, h);
+            if (e->op == RM_DLIST_OP_FILL) {
+                put16(p + 9, e->color);
+                p += DLIST_FILL_BYTES;
+            } else {
+                put32(p + 9, (uint32_t)((uint8_t *)dst - buf));
+                p += DLIST_BITMAP_BYTES;
+                const uint16_t *src = dl->px + e->px + (size_t)(r->y0 - e->y) * e->stride + (r->x0 - e->x);
+                for (uint16_t row = 0; row < h; row++) {
+                    memcpy(dst, src + (size_t)row * e->stride, (size_t)w * 2);
+                    dst += w;
+                }
+            }
+            dl->stats.pixels += (uint32_t)w * h;
+        }
+        *p = RM_DLIST_OP_END;
+    }
+    free(pieces);
+
+    rm690b0_dlist_stats_t stats = dl->stats;
+    dlist_reset(dl);
+    if (ret != ESP_OK) {
+        free(buf);
+        return ret;
+    }
+    dl->owned = buf;
+    dl->data = buf;
+    dl->size = size;
+    dl->stats = stats;
+    dl->stats.ops = (uint16_t)n;
+    return ESP_OK;
+}
+
+esp_err_t rm690b0_dlist_load(rm690b0_dlist_t *dl, const void *data, size_t size) {
+    const uint8_t *b = data;
+    if (!dl || !b || size < sizeof(rm690b0_dlist_header_t) + 1) return ESP_ERR_INVALID_ARG;
+    uint16_t width = get16(b + 6), height = get16(b + 8);
+    uint32_t code = get32(b + 12);
+    if (memcmp(b, RM_DLIST_MAGIC, 4) != 0 || get16(b + 4) != DLIST_VERSION || get32(b + 16) > size ||
+        code == 0 || code > size - sizeof(rm690b0_dlist_header_t)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Every op must be on screen, on even columns, and its pixels in the list
+    const uint8_t *p = b + sizeof(rm690b0_dlist_header_t), *end = p + code;
+    uint16_t ops = 0;
+    while (p < end && *p != RM_DLIST_OP_END) {
+        size_t len = (*p == RM_DLIST_OP_FILL) ? DLIST_FILL_BYTES : (*p == RM_DLIST_OP_BITMAP) ? DLIST_BITMAP_BYTES : 0;
+        if (len == 0 || p + len > end) return ESP_ERR_INVALID_ARG;
+        uint32_t x = get16(p + 1), y = get16(p + 3), w = get16(p + 5), h = get16(p + 7);
+        if (w == 0 || h == 0 || x + w > width || y + h > height || ((x | w) & 1)) return ESP_ERR_INVALID_ARG;
+        if (*p == RM_DLIST_OP_BITMAP) {
+            uint32_t off = get32(p + 9);
+            if ((off & 1) || off > size || (uint64_t)w * h * 2 > size - off) return ESP_ERR_INVALID_ARG;
+        }
+        p += len;
+        ops++;
+    }
+    if (p >= end || ops != get16(b + 10)) return ESP_ERR_INVALID_ARG;
+
+    rm690b0_dlist_free(dl);
+    dl->data = b;
+    dl->size = size;
+    dl->width = width;
+    dl->height = height;
+    dl->stats.ops = ops;
+    size_t pos = 0;
+    rm690b0_dlist_item_t it;
+    while (rm690b0_dlist_next(dl, &pos, &it)) dl->stats.pixels += (uint32_t)it.w * it.h;
+    return ESP_OK;
+}
+
+const void *rm690b0_dlist_data(const rm690b0_dlist_t *dl, size_t *size) {
+    *size = dl->size;
+    return dl->data;
+}
+
+bool rm690b0_dlist_next(const rm690b0_dlist_t *dl, size_t *pos, rm690b0_dlist_item_t *item) {
+    if (!dl->data) return false;
+    const uint8_t *p = dl->data + sizeof(rm690b0_dlist_header_t) + *pos;
+    if (*p == RM_DLIST_OP_END) return false;
+    item->op = *p;
+    item->x = get16(p + 1);
+    item->y = get16(p + 3);
+    item->w = get16(p + 5);
+    item->h = get16(p + 7);
+    if (*p == RM_DLIST_OP_FILL) {
+        item->color = get16(p + 9);
+        item->data_be = NULL;
+        *pos += DLIST_FILL_BYTES;
+    } else {
+        item->color = 0;
+        item->data_be = (const uint16_t *)(dl->data + get32(p + 9));
+        *pos += DLIST_BITMAP_BYTES;
+    }
+    return true;
+}
+
+void rm690b0_dlist_free(rm690b0_dlist_t *dl) {
+    if (dl->unprepare) dl->unprepare(dl);
+    dl->unprepare = NULL;
+    dlist_reset(dl);
+    memset(&dl->stats, 0, sizeof(dl->stats));
+}
+
+void rm690b0_dlist_get_stats(const rm690b0_dlist_t *dl, rm690b0_dlist_stats_t *stats) {
+    *stats = dl->stats;
+}
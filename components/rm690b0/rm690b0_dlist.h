@@ -0,0 +1,186 @@
+#ifndef RM690B0_DLIST_H
+#define RM690B0_DLIST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "rm690b0_xform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Retained display lists for static screens.
+ *
+ * Drawing calls are recorded once, optimized and kept as compact bytecode;
+ * showing the screen again replays it as a prebuilt transaction sequence. At
+ * the end of recording, primitives that later ones cover completely are
+ * dropped, partly covered ones are cut down to their visible parts when the
+ * pixels saved outweigh the extra windows, and touching fills of one color
+ * are merged into one window. Every pixel then goes out once.
+ *
+ * The first replay in a rotation and interface format encodes the CASET and
+ * RASET parameters of every window and fills one DMA-capable buffer per fill
+ * color in internal RAM, shared by all lists; later replays only queue those.
+ * Bitmaps are stored in the list and sent from there.
+ *
+ * The bytecode is position-independent and little-endian, so lists can be
+ * built offline (tools/rm690b0_img dlist), stored as an asset blob or an
+ * embedded array and replayed from flash with rm690b0_dlist_load().
+ *
+ * Lists are recorded for one screen size. Rectangles are clipped to it and
+ * widened to even columns like every window the panel takes (x even, width
+ * even): fills cover the widened window, bitmaps repeat their edge column.
+ * This file and rm690b0_dlist.c do not depend on the driver; replay is in
+ * rm690b0_dlist_play.c. Like the other draw calls, use from the task that
+ * owns the display.
+ */
+
+#define RM_DLIST_MAGIC          "RMD1"
+#define RM_DLIST_ALIGN          4       // Bitmap data alignment in the list
+#define RM_DLIST_MAX_PIECES     32      // Visible parts an op may be cut into
+#define RM_DLIST_WINDOW_COST    256     // Wire bytes one more window is worth (CASET, RASET, RAMWR, setup)
+#define RM_DLIST_SOLID_PIXELS   2048    // Pre-filled buffer per fill color
+#define RM_DLIST_SOLID_SLOTS    16      // Fill colors across all prepared lists
+
+typedef enum {
+    RM_DLIST_OP_END     = 0,
+    RM_DLIST_OP_FILL    = 1,    // x, y, w, h (u16), color (u16 RGB565)
+    RM_DLIST_OP_BITMAP  = 2,    // x, y, w, h (u16), offset (u32) of w x h big-endian RGB565
+} rm690b0_dlist_op_t;
+
+// Serialized list: this header, the bytecode, then bitmap data; little-endian
+typedef struct {
+    char magic[4];
+    uint16_t version;       // 1
+    uint16_t width, height; // Screen the list was recorded for
+    uint16_t ops;
+    uint32_t code_size;     // Bytecode bytes, OP_END included
+    uint32_t size;          // Whole list
+} rm690b0_dlist_header_t;
+
+_Static_assert(sizeof(rm690b0_dlist_header_t) == 20, "display list header layout");
+
+typedef struct {
+    uint8_t op;             // rm690b0_dlist_op_t
+    uint16_t x, y, w, h;
+    uint16_t color;         // Fills, RGB565 (native endian)
+    const uint16_t *data_be; // Bitmaps, w x h packed rows
+} rm690b0_dlist_item_t;
+
+typedef struct {
+    uint16_t recorded;      // Ops recorded
+    uint16_t ops;           // Ops in the list
+    uint16_t dropped;       // Covered by later ops
+    uint16_t split;         // Cut down to their visible parts
+    uint16_t merged;        // Fills joined with a neighbour
+    uint32_t pixels_recorded; // Area of the recorded ops, on screen
+    uint32_t pixels;        // Area a replay sends
+    uint32_t plays;
+    uint32_t prepares;      // Replays that had to encode windows and fill buffers first
+    uint32_t play_us;       // Last replay, until on the panel
+} rm690b0_dlist_stats_t;
+
+struct rm_dlist_rec;
+struct rm_dlist_cmd;
+
+typedef struct {
+    // Serialized list
+    const uint8_t *data;
+    size_t size;
+    uint8_t *owned;         // Recorded lists own their bytes
+    uint16_t width, height;
+
+    // Recording
+    struct rm_dlist_rec *rec;
+    size_t rec_count, rec_cap;
+    uint16_t *px;           // Copied bitmaps
+    size_t px_count, px_cap;
+    bool recording;
+    esp_err_t rec_error;
+
+    // Replay, prepared for one rotation and interface format
+    struct rm_dlist_cmd *cmds;
+    size_t ncmds;
+    bool prepared;
+    uint8_t prep_rotation, prep_ifpf;
+    void (*unprepare)(void *dl);    // Set by the replay side, run by rm690b0_dlist_free()
+
+    rm690b0_dlist_stats_t stats;
+} rm690b0_dlist_t;
+
+/**
+ * @brief Start recording a list for a width x height screen. Frees what dl held.
+ */
+esp_err_t rm690b0_dlist_begin(rm690b0_dlist_t *dl, uint16_t width, uint16_t height);
+
+esp_err_t rm690b0_dlist_fill(rm690b0_dlist_t *dl, int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color);
+
+esp_err_t rm690b0_dlist_fill_screen(rm690b0_dlist_t *dl, uint16_t color);
+
+/**
+ * @brief Record a bitmap; the visible part is copied into the list
+ * @param stride Row pitch in pixels
+ */
+esp_err_t rm690b0_dlist_bitmap(rm690b0_dlist_t *dl, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                               const uint16_t *data_be, size_t stride);
+
+/**
+ * @brief Optimize and serialize what was recorded
+ * @return The first recording error (ESP_ERR_NO_MEM), the list is then empty
+ */
+esp_err_t rm690b0_dlist_end(rm690b0_dlist_t *dl);
+
+/**
+ * @brief Use a serialized list in place: flash, an asset blob, an array. Kept
+ * referenced until rm690b0_dlist_free().
+ * @return ESP_ERR_INVALID_ARG if it is not a valid list
+ */
+esp_err_t rm690b0_dlist_load(rm690b0_dlist_t *dl, const void *data, size_t size);
+
+/**
+ * @brief The serialized list, to save or embed
+ */
+const void *rm690b0_dlist_data(const rm690b0_dlist_t *dl, size_t *size);
+
+/**
+ * @brief Walk the ops of a list
+ * @param pos 0 to start, advanced past the op
+ * @return false after the last op
+ */
+bool rm690b0_dlist_next(const rm690b0_dlist_t *dl, size_t *pos, rm690b0_dlist_item_t *item);
+
+/**
+ * @brief Record into delta what turns a panel showing shown, drawn in
+ * shown_xf's rotation, into one showing next in next_xf's. Both are flattened
+ * to their visible parts; fills the panel already shows in the same color are
+ * left out, bitmaps always go out. Playing delta after switching to next_xf's
+ * rotation leaves the panel as playing next would.
+ * @return ESP_ERR_INVALID_SIZE if a list does not match its rotation's size,
+ * ESP_ERR_NOT_SUPPORTED if a list overlaps itself too much to flatten
+ */
+esp_err_t rm690b0_dlist_delta(rm690b0_dlist_t *delta, const rm690b0_dlist_t *next, const rm690b0_xform_t *next_xf,
+                              const rm690b0_dlist_t *shown, const rm690b0_xform_t *shown_xf);
+
+/**
+ * @brief Replay the list, blocking until it is on the panel
+ * @return ESP_ERR_INVALID_SIZE if it was recorded for another screen size
+ * (rotation), ESP_ERR_NO_MEM if the fill buffers cannot be allocated
+ */
+esp_err_t rm690b0_dlist_play(rm690b0_dlist_t *dl);
+
+/**
+ * @brief Free the list and its replay state; the shared fill buffers stay
+ * while other lists use their colors
+ */
+void rm690b0_dlist_free(rm690b0_dlist_t *dl);
+
+void rm690b0_dlist_get_stats(const rm690b0_dlist_t *dl, rm690b0_dlist_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
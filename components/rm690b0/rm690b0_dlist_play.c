@@ -0,0 +1,174 @@
+#include "rm690b0_dlist.h"
+#include "rm690b0.h"
+#include "rm690b0_priv.h"
+#include "rm690b0_color.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "rm690b0_dlist";
+
+// One prepared op: its window on the wire and where its pixels come from
+typedef struct rm_dlist_cmd {
+    uint8_t caset[4], raset[4];
+    const uint16_t *data;   // Fills: the shared solid buffer, bitmaps: the pixels in the list
+    uint32_t pixels;
+    int8_t slot;            // Solid buffer slot, -1 for bitmaps
+} dlist_cmd_t;
+
+// Pre-filled fill buffers, packed in the interface format, shared by all prepared lists
+typedef struct {
+    uint16_t *buf;
+    uint16_t color;
+    uint8_t ifpf;
+    uint16_t refs;
+} dlist_solid_t;
+
+static dlist_solid_t s_solid[RM_DLIST_SOLID_SLOTS];
+
+static int solid_acquire(uint16_t color, rm690b0_ifpf_t ifpf) {
+    int free_slot = -1;
+    for (int i = 0; i < RM_DLIST_SOLID_SLOTS; i++) {
+        dlist_solid_t *s = &s_solid[i];
+        if (s->refs && s->color == color && s->ifpf == ifpf) {
+            s->refs++;
+            return i;
+        }
+        if (!s->refs && free_slot < 0) free_slot = i;
+    }
+    if (free_slot < 0) return -1;
+
+    dlist_solid_t *s = &s_solid[free_slot];
+    s->buf = heap_caps_aligned_alloc(16, RM_DLIST_SOLID_PIXELS * 2, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!s->buf) return -1;
+    uint16_t be = rm_color_be(color);
+    for (int k = 0; k < RM_DLIST_SOLID_PIXELS; k++) s->buf[k] = be;
+    rm_color_pack(ifpf, (uint8_t *)s->buf, s->buf, RM_DLIST_SOLID_PIXELS);
+    s->color = color;
+    s->ifpf = ifpf;
+    s->refs = 1;
+    return free_slot;
+}
+
+static void solid_release(int i) {
+    dlist_solid_t *s = &s_solid[i];
+    if (--s->refs == 0) {
+        heap_caps_free(s->buf);
+        s->buf = NULL;
+    }
+}
+
+static void dlist_release(dlist_cmd_t *cmds, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (cmds[i].slot >= 0) solid_release(cmds[i].slot);
+    }
+    free(cmds);
+}
+
+static void dlist_unprepare(void *arg) {
+    rm690b0_dlist_t *dl = arg;
+    dlist_release(dl->cmds, dl->ncmds);
+    dl->cmds = NULL;
+    dl->ncmds = 0;
+    dl->prepared = false;
+}
+
+// Encode every window and take the fill buffers for the current rotation and
+// format. The old buffers are released after, so colors in both are kept.
+static esp_err_t dlist_prepare(rm690b0_dlist_t *dl, uint8_t rotation, rm690b0_ifpf_t ifpf) {
+    size_t n = 0, pos = 0;
+    rm690b0_dlist_item_t it;
+    while (rm690b0_dlist_next(dl, &pos, &it)) n++;
+    dlist_cmd_t *cmds = calloc(n ? n : 1, sizeof(dlist_cmd_t));
+    if (!cmds) return ESP_ERR_NO_MEM;
+
+    pos = 0;
+    for (size_t i = 0; rm690b0_dlist_next(dl, &pos, &it); i++) {
+        dlist_cmd_t *c = &cmds[i];
+        rm_drv_window_params(it.x, it.y, it.x + it.w - 1, it.y + it.h - 1, c->caset, c->raset);
+        c->pixels = (uint32_t)it.w * it.h;
+        c->slot = -1;
+        if (it.op == RM_DLIST_OP_BITMAP) {
+            c->data = it.data_be;
+            continue;
+        }
+        int slot = solid_acquire(it.color, ifpf);
+        if (slot < 0) {
+            ESP_LOGE(TAG, "No fill buffer for color 0x%04x", it.color);
+            dlist_release(cmds, i);
+            return ESP_ERR_NO_MEM;
+        }
+        c->slot = (int8_t)slot;
+        c->data = s_solid[slot].buf;
+    }
+
+    dlist_unprepare(dl);
+    dl->cmds = cmds;
+    dl->ncmds = n;
+    dl->unprepare = dlist_unprepare;
+    dl->prepared = true;
+    dl->prep_rotation = rotation;
+    dl->prep_ifpf = ifpf;
+    dl->stats.prepares++;
+    return ESP_OK;
+}
+
+// A fill: its pre-filled buffer queued once per chunk, one burst
+static esp_err_t dlist_send_fill(rm690b0_stream_t *s, const dlist_cmd_t *c) {
+    rm690b0_pipe_t *pipe = rm_drv_pipe();
+    uint32_t left = c->pixels;
+    while (left > 0) {
+        uint32_t n = (left < RM_DLIST_SOLID_PIXELS) ? left : RM_DLIST_SOLID_PIXELS;
+        size_t bytes = rm_ifpf_bytes(s->ifpf, n);
+        left -= n;
+        if (s->ifpf != RM_IFPF_RGB565) {
+            s->ifpf_stats.pixels_packed += n;
+            s->ifpf_stats.bytes_sent += bytes;
+            s->ifpf_stats.bytes_saved += n * 2 - bytes;
+        }
+        esp_err_t ret = rm_pipe_push(pipe, c->data, bytes, left == 0, NULL, NULL, NULL);
+        if (ret != ESP_OK) return ret;
+    }
+    return ESP_OK;
+}
+
+esp_err_t rm690b0_dlist_play(rm690b0_dlist_t *dl) {
+    if (!rm690b0_get_bus()) return ESP_ERR_INVALID_STATE;
+    if (!dl->data) return ESP_ERR_INVALID_STATE;
+    if (dl->width != rm690b0_get_width() || dl->height != rm690b0_get_height()) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    rm690b0_stream_t *s = rm_drv_stream();
+    uint8_t rotation = rm690b0_get_rotation();
+    if (!dl->prepared || dl->prep_rotation != rotation || dl->prep_ifpf != s->ifpf) {
+        esp_err_t ret = dlist_prepare(dl, rotation, s->ifpf);
+        if (ret != ESP_OK) return ret;
+    }
+
+    rm690b0_pipe_t *pipe = rm_drv_pipe();
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < dl->ncmds && ret == ESP_OK; i++) {
+        const dlist_cmd_t *c = &dl->cmds[i];
+        ret = rm_pipe_cmd(pipe, 0x2A, c->caset, 4); // CASET
+        if (ret == ESP_OK) ret = rm_pipe_cmd(pipe, 0x2B, c->raset, 4); // RASET
+        if (ret != ESP_OK) break;
+        if (c->slot >= 0) {
+            ret = dlist_send_fill(s, c);
+        } else {
+            rm690b0_source_t src;
+            rm690b0_source_linear(&src, c->data, c->pixels);
+            ret = rm_stream_run(s, &src, NULL, NULL, NULL);
+        }
+    }
+    // Bitmaps may be sent straight from the list, which the caller may free next
+    esp_err_t wret = rm_pipe_drain(pipe, RM_BUS_WAIT_FOREVER);
+    if (ret == ESP_OK) ret = wret;
+
+    dl->stats.plays++;
+    dl->stats.play_us = (uint32_t)(esp_timer_get_time() - t0);
+    return ret;
+}
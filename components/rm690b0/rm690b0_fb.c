@@ -0,0 +1,479 @@
+#include "rm690b0_fb.h"
+#include "rm690b0.h"
+#include "rm690b0_priv.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "rm690b0_fb";
+
+// Longest side of any rotation
+#define FB_MAX_ROWS     600
+#define FB_ROW_CLEAN    0xFFFF
+#define FB_MAX_TILES    ((RM690B0_WIDTH / RM_FB_TILE) * (RM690B0_HEIGHT / RM_FB_TILE))
+#define FB_MAX_SEGS     (FB_MAX_TILES * RM_FB_TILE)     // Tile rows: RM_FB_TILE pixels each
+
+static uint16_t *s_fb;
+static uint16_t s_width;
+static uint16_t s_height;
+static uint8_t s_rotation;
+
+// Per-row dirty span [x1, x2]; x1 == FB_ROW_CLEAN when the row is clean
+static uint16_t s_dirty_x1[FB_MAX_ROWS];
+static uint16_t s_dirty_x2[FB_MAX_ROWS];
+
+static rm690b0_damage_t s_damage;
+static rm690b0_fb_stats_t s_stats;
+
+// Delta mode: hash of each tile as last sent, row-major in the current layout
+static bool s_delta;
+static uint32_t s_tile_hash[FB_MAX_TILES];
+static bool s_tile_known[FB_MAX_TILES];
+
+// One tile of pixels for rotation, word aligned so pairs hash and turn as words
+static uint16_t s_tile_px[RM_FB_TILE * RM_FB_TILE] __attribute__((aligned(4)));
+// Elements already moved while the canvas is permuted in place
+static uint32_t s_moved[(FB_MAX_SEGS + 31) / 32];
+
+static void fb_layout(void) {
+    // Tiles move around with the layout; a plain clear keeps the hashes
+    if (s_rotation != rm690b0_get_rotation()) memset(s_tile_known, 0, sizeof(s_tile_known));
+    s_width = rm690b0_get_width();
+    s_height = rm690b0_get_height();
+    s_rotation = rm690b0_get_rotation();
+    rm_damage_init(&s_damage, s_width, s_height, 0);
+}
+
+// Clip (x, y, w, h) to the canvas, false when nothing is left
+static bool fb_clip(uint16_t *x, uint16_t *y, uint16_t *w, uint16_t *h) {
+    if (*x >= s_width || *y >= s_height || *w == 0 || *h == 0) return false;
+    if (*w > s_width - *x) *w = s_width - *x;
+    if (*h > s_height - *y) *h = s_height - *y;
+    return true;
+}
+
+static void fb_dirty(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    uint16_t x2 = x + w - 1;
+    for (uint16_t r = y; r < y + h; r++) {
+        if (s_dirty_x1[r] == FB_ROW_CLEAN) {
+            s_dirty_x1[r] = x;
+            s_dirty_x2[r] = x2;
+        } else {
+            if (x < s_dirty_x1[r]) s_dirty_x1[r] = x;
+            if (x2 > s_dirty_x2[r]) s_dirty_x2[r] = x2;
+        }
+    }
+}
+
+esp_err_t rm690b0_fb_init(void) {
+    if (!s_fb) {
+        // Sized for either orientation
+        s_fb = heap_caps_malloc((size_t)RM690B0_WIDTH * RM690B0_HEIGHT * 2, MALLOC_CAP_SPIRAM);
+        if (!s_fb) {
+            ESP_LOGE(TAG, "OOM allocating framebuffer in PSRAM");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    s_stats = (rm690b0_fb_stats_t){0};
+    memset(s_tile_known, 0, sizeof(s_tile_known));
+    return rm690b0_fb_clear(RM_COLOR_BLACK);
+}
+
+void rm690b0_fb_deinit(void) {
+    heap_caps_free(s_fb);
+    s_fb = NULL;
+}
+
+uint16_t *rm690b0_fb_get(size_t *stride) {
+    if (stride) *stride = s_width;
+    return s_fb;
+}
+
+void rm690b0_fb_mark_dirty(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    if (!s_fb || !fb_clip(&x, &y, &w, &h)) return;
+    fb_dirty(x, y, w, h);
+}
+
+void rm690b0_fb_mark_all(void) {
+    if (!s_fb) return;
+    fb_dirty(0, 0, s_width, s_height);
+}
+
+esp_err_t rm690b0_fb_clear(uint16_t color) {
+    if (!s_fb) return ESP_ERR_INVALID_STATE;
+
+    fb_layout();
+    memset(s_dirty_x1, 0xFF, sizeof(s_dirty_x1));
+
+    uint16_t be = rm_color_be(color);
+    size_t n = (size_t)s_width * s_height;
+    for (size_t i = 0; i < n; i++) {
+        s_fb[i] = be;
+    }
+    fb_dirty(0, 0, s_width, s_height);
+    return ESP_OK;
+}
+
+void rm690b0_fb_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    if (!s_fb || !fb_clip(&x, &y, &w, &h)) return;
+
+    uint16_t be = rm_color_be(color);
+    for (uint16_t r = 0; r < h; r++) {
+        uint16_t *dst = s_fb + (size_t)(y + r) * s_width + x;
+        for (uint16_t c = 0; c < w; c++) {
+            dst[c] = be;
+        }
+    }
+    fb_dirty(x, y, w, h);
+}
+
+void rm690b0_fb_write(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data_be, size_t stride) {
+    uint16_t cw = w, ch = h;
+    if (!s_fb || !fb_clip(&x, &y, &cw, &ch)) return;
+
+    for (uint16_t r = 0; r < ch; r++) {
+        memcpy(s_fb + (size_t)(y + r) * s_width + x, data_be + (size_t)r * stride, (size_t)cw * 2);
+    }
+    fb_dirty(x, y, cw, ch);
+}
+
+static void fb_span(void *ctx, int16_t x, int16_t y, uint16_t len, uint8_t alpha) {
+    rm_raster_canvas_span(ctx, x, y, len, alpha);
+    fb_dirty(x, y, len, 1);
+}
+
+void rm690b0_fb_draw_shape(const rm_shape_t *shape, uint16_t color, bool aa) {
+    static rm_raster_t raster;
+    if (!s_fb) return;
+    rm_raster_init(&raster, s_width, s_height, aa);
+    rm_raster_canvas_t canvas = { .px = s_fb, .stride = s_width, .color = color };
+    rm_raster_fill(&raster, shape, fb_span, &canvas);
+}
+
+// --- Delta mode ---
+
+static inline uint32_t rotl32(uint32_t x, int r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline uint32_t murmur_mix(uint32_t hash, uint32_t k) {
+    k *= 0xCC9E2D51u;
+    k = rotl32(k, 15) * 0x1B873593u;
+    return rotl32(hash ^ k, 13) * 5 + 0xE6546B64u;
+}
+
+// MurmurHash3 (x86_32) over the rows of a tile, a pixel pair per 32-bit word.
+// Words are read with memcpy, which compiles to one load, without reading the
+// uint16 canvas through a uint32 pointer.
+static uint32_t fb_tile_hash(const uint16_t *px, size_t stride, uint16_t w, uint16_t h) {
+    uint32_t hash = 0x9747B28Cu;
+    for (uint16_t r = 0; r < h; r++) {
+        const uint16_t *p = px + (size_t)r * stride;
+        uint16_t i = 0;
+        for (; i + 2 <= w; i += 2) {
+            uint32_t k;
+            memcpy(&k, p + i, 4);
+            hash = murmur_mix(hash, k);
+        }
+        if (i < w) hash = murmur_mix(hash, p[i]);
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    return hash ^ (hash >> 16);
+}
+
+// Hash one tile, true when it differs from what GRAM holds
+static bool fb_tile_changed(uint16_t tx, uint16_t ty, uint16_t tiles_x) {
+    uint16_t x = tx * RM_FB_TILE, y = ty * RM_FB_TILE;
+    uint16_t w = (s_width - x < RM_FB_TILE) ? s_width - x : RM_FB_TILE;
+    uint16_t h = (s_height - y < RM_FB_TILE) ? s_height - y : RM_FB_TILE;
+    size_t i = (size_t)ty * tiles_x + tx;
+
+    uint32_t hash = fb_tile_hash(s_fb + (size_t)y * s_width + x, s_width, w, h);
+    s_stats.tiles_hashed++;
+    if (s_tile_known[i] && s_tile_hash[i] == hash) {
+        s_stats.tiles_skipped++;
+        s_stats.bytes_saved += (uint32_t)w * h * 2;
+        return false;
+    }
+    s_tile_hash[i] = hash;
+    s_tile_known[i] = true;
+    return true;
+}
+
+static esp_err_t fb_flush_delta(void) {
+    uint16_t tiles_x = (s_width + RM_FB_TILE - 1) / RM_FB_TILE;
+    uint16_t tiles_y = (s_height + RM_FB_TILE - 1) / RM_FB_TILE;
+    rm690b0_area_t areas[RM_DAMAGE_MAX_AREAS];
+    uint8_t count = 0;
+    uint32_t pixels = 0, windows = 0;
+    esp_err_t ret = ESP_OK;
+
+    for (uint16_t ty = 0; ty < tiles_y && ret == ESP_OK; ty++) {
+        // Columns dirty in any row of the tile row
+        uint16_t y1 = ty * RM_FB_TILE;
+        uint16_t y2 = (y1 + RM_FB_TILE < s_height) ? y1 + RM_FB_TILE - 1 : s_height - 1;
+        uint16_t x1 = FB_ROW_CLEAN, x2 = 0;
+        for (uint16_t r = y1; r <= y2; r++) {
+            if (s_dirty_x1[r] == FB_ROW_CLEAN) continue;
+            if (s_dirty_x1[r] < x1) x1 = s_dirty_x1[r];
+            if (s_dirty_x2[r] > x2) x2 = s_dirty_x2[r];
+            s_dirty_x1[r] = FB_ROW_CLEAN;
+        }
+        if (x1 == FB_ROW_CLEAN) continue;
+
+        uint16_t tx = x1 / RM_FB_TILE;
+        uint16_t tx_end = x2 / RM_FB_TILE;
+        while (tx <= tx_end) {
+            if (!fb_tile_changed(tx, ty, tiles_x)) {
+                tx++;
+                continue;
+            }
+            uint16_t run = tx++;
+            while (tx <= tx_end && fb_tile_changed(tx, ty, tiles_x)) tx++;
+
+            rm690b0_area_t a = {
+                .x1 = run * RM_FB_TILE, .y1 = y1,
+                .x2 = ((tx * RM_FB_TILE < s_width) ? tx * RM_FB_TILE : s_width) - 1, .y2 = y2,
+            };
+            pixels += (uint32_t)(a.x2 - a.x1 + 1) * (a.y2 - a.y1 + 1);
+
+            // Same columns right above: grow that window instead
+            bool joined = false;
+            for (uint8_t i = 0; i < count; i++) {
+                if (areas[i].x1 == a.x1 && areas[i].x2 == a.x2 && areas[i].y2 + 1 == a.y1) {
+                    areas[i].y2 = a.y2;
+                    joined = true;
+                    break;
+                }
+            }
+            if (joined) continue;
+
+            if (count == RM_DAMAGE_MAX_AREAS) {
+                ret = rm_drv_flush_areas(areas, count, s_fb, s_width, true);
+                windows += count;
+                count = 0;
+                if (ret != ESP_OK) break;
+            }
+            areas[count++] = a;
+        }
+    }
+
+    if (ret == ESP_OK && count > 0) {
+        ret = rm_drv_flush_areas(areas, count, s_fb, s_width, true);
+        windows += count;
+    }
+    if (windows > 0) {
+        s_stats.flushes++;
+        s_stats.pixels_sent += pixels;
+        s_stats.areas_sent += windows;
+    }
+    return ret;
+}
+
+void rm690b0_fb_set_delta(bool enable) {
+    s_delta = enable;
+    memset(s_tile_known, 0, sizeof(s_tile_known));
+}
+
+esp_err_t rm690b0_fb_flush(void) {
+    if (!s_fb) return ESP_ERR_INVALID_STATE;
+    if (s_rotation != rm690b0_get_rotation()) {
+        ESP_LOGW(TAG, "Rotation changed, call rm690b0_fb_clear() first");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_delta) return fb_flush_delta();
+
+    // Runs of dirty rows become rectangles; the damage tracker merges them
+    // further when one window is cheaper than several.
+    uint32_t rows = 0;
+    uint16_t r = 0;
+    while (r < s_height) {
+        if (s_dirty_x1[r] == FB_ROW_CLEAN) {
+            r++;
+            continue;
+        }
+        uint16_t y1 = r;
+        uint16_t x1 = s_dirty_x1[r];
+        uint16_t x2 = s_dirty_x2[r];
+        while (r < s_height && s_dirty_x1[r] != FB_ROW_CLEAN) {
+            if (s_dirty_x1[r] < x1) x1 = s_dirty_x1[r];
+            if (s_dirty_x2[r] > x2) x2 = s_dirty_x2[r];
+            s_dirty_x1[r] = FB_ROW_CLEAN;
+            r++;
+        }
+        rows += r - y1;
+        rm_damage_add(&s_damage, x1, y1, x2 - x1 + 1, r - y1);
+    }
+    if (s_damage.count == 0) return ESP_OK;
+
+    s_stats.flushes++;
+    s_stats.rows_sent += rows;
+    s_stats.pixels_sent += rm_damage_pixels(&s_damage);
+    s_stats.areas_sent += s_damage.count;
+
+    // PSRAM is always copied through the internal bounce buffers
+    esp_err_t ret = rm_drv_flush_areas(s_damage.areas, s_damage.count, s_fb, s_width, true);
+    rm_damage_reset(&s_damage);
+    return ret;
+}
+
+// --- Rotation ---
+
+// Any dirty row of the tile dirty within its columns: the canvas is ahead of GRAM
+static bool fb_tile_dirty(uint16_t tx, uint16_t ty) {
+    uint16_t x1 = tx * RM_FB_TILE, x2 = x1 + RM_FB_TILE - 1;
+    for (uint16_t r = ty * RM_FB_TILE; r < (ty + 1) * RM_FB_TILE && r < s_height; r++) {
+        if (s_dirty_x1[r] != FB_ROW_CLEAN && s_dirty_x1[r] <= x2 && s_dirty_x2[r] >= x1) return true;
+    }
+    return false;
+}
+
+// The old tile (jx, jy) in from's layout under the centre of tile (tx, ty) in to's
+static void fb_tile_src(const rm690b0_xform_t *from, const rm690b0_xform_t *to,
+                        uint16_t tx, uint16_t ty, uint16_t *jx, uint16_t *jy) {
+    int32_t nx, ny, ox, oy;
+    rm690b0_xform_to_native(to, tx * RM_FB_TILE + RM_FB_TILE / 2, ty * RM_FB_TILE + RM_FB_TILE / 2, &nx, &ny);
+    rm690b0_xform_from_native(from, nx, ny, &ox, &oy);
+    *jx = ox / RM_FB_TILE;
+    *jy = oy / RM_FB_TILE;
+}
+
+// Tile hashes of what GRAM shows in to's layout, from the canvas still laid
+// out for from. Both sides are multiples of the tile, so every new tile is an
+// old one turned by turns.
+static void fb_remap_tiles(const rm690b0_xform_t *from, const rm690b0_xform_t *to, uint8_t turns) {
+    static uint32_t hash[FB_MAX_TILES];
+    static bool known[FB_MAX_TILES];
+
+    uint16_t from_tiles_x = from->width / RM_FB_TILE;
+    uint16_t tiles_x = to->width / RM_FB_TILE, tiles_y = to->height / RM_FB_TILE;
+    for (uint16_t ty = 0; ty < tiles_y; ty++) {
+        for (uint16_t tx = 0; tx < tiles_x; tx++) {
+            uint16_t jx, jy;
+            fb_tile_src(from, to, tx, ty, &jx, &jy);
+            size_t i = (size_t)ty * tiles_x + tx, j = (size_t)jy * from_tiles_x + jx;
+
+            known[i] = s_tile_known[j] && !fb_tile_dirty(jx, jy);
+            if (!known[i]) continue;
+            const uint16_t *src = s_fb + (size_t)jy * RM_FB_TILE * s_width + jx * RM_FB_TILE;
+            rm_xform_rotate(s_tile_px, RM_FB_TILE, src, s_width, RM_FB_TILE, RM_FB_TILE, turns);
+            hash[i] = fb_tile_hash(s_tile_px, RM_FB_TILE, RM_FB_TILE, RM_FB_TILE);
+        }
+    }
+    memcpy(s_tile_hash, hash, sizeof(hash));
+    memcpy(s_tile_known, known, sizeof(known));
+}
+
+// Turning the canvas in place: its rows are cut into segments of one tile row,
+// regrouped so each tile is contiguous, the tiles are moved and turned, and the
+// segments are laid out again as rows of the new width.
+typedef struct {
+    uint16_t tiles_x;                       // Canvas width in tiles (segment passes)
+    const rm690b0_xform_t *from, *to;       // Tile pass
+} fb_turn_t;
+
+typedef size_t (*fb_src_fn)(size_t d, const fb_turn_t *t);
+
+// Segment d of tile-major order from the row-major canvas
+static size_t fb_src_to_tiles(size_t d, const fb_turn_t *t) {
+    size_t tile = d / RM_FB_TILE, r = d % RM_FB_TILE;
+    return ((tile / t->tiles_x) * RM_FB_TILE + r) * t->tiles_x + tile % t->tiles_x;
+}
+
+// Segment d of the row-major canvas from tile-major order
+static size_t fb_src_from_tiles(size_t d, const fb_turn_t *t) {
+    size_t y = d / t->tiles_x, tx = d % t->tiles_x;
+    return ((y / RM_FB_TILE) * t->tiles_x + tx) * RM_FB_TILE + y % RM_FB_TILE;
+}
+
+// Tile d in to's tile order from from's
+static size_t fb_src_tile(size_t d, const fb_turn_t *t) {
+    uint16_t tiles_x = t->to->width / RM_FB_TILE, jx, jy;
+    fb_tile_src(t->from, t->to, d % tiles_x, d / tiles_x, &jx, &jy);
+    return (size_t)jy * (t->from->width / RM_FB_TILE) + jx;
+}
+
+// Element d (len pixels) takes element src(d), turned by turns when the
+// elements are tiles. Each cycle is followed once, its first element held in
+// the tile scratch.
+static void fb_permute(size_t n, size_t len, fb_src_fn src, const fb_turn_t *t, uint8_t turns) {
+    memset(s_moved, 0, sizeof(s_moved));
+    for (size_t d0 = 0; d0 < n; d0++) {
+        if (s_moved[d0 / 32] & (1u << (d0 % 32))) continue;
+        memcpy(s_tile_px, s_fb + d0 * len, len * 2);
+        for (size_t d = d0;;) {
+            s_moved[d / 32] |= 1u << (d % 32);
+            size_t j = src(d, t);
+            const uint16_t *p = (j == d0) ? s_tile_px : s_fb + j * len;
+            if (turns) {
+                rm_xform_rotate(s_fb + d * len, RM_FB_TILE, p, RM_FB_TILE, RM_FB_TILE, RM_FB_TILE, turns);
+            } else {
+                memcpy(s_fb + d * len, p, len * 2);
+            }
+            if (j == d0) break;
+            d = j;
+        }
+    }
+}
+
+static void fb_turn(const rm690b0_xform_t *from, const rm690b0_xform_t *to, uint8_t turns) {
+    size_t tiles = (size_t)(from->width / RM_FB_TILE) * (from->height / RM_FB_TILE);
+    fb_turn_t t = { .tiles_x = from->width / RM_FB_TILE, .from = from, .to = to };
+    fb_permute(tiles * RM_FB_TILE, RM_FB_TILE, fb_src_to_tiles, &t, 0);
+    fb_permute(tiles, RM_FB_TILE * RM_FB_TILE, fb_src_tile, &t, turns);
+    t.tiles_x = to->width / RM_FB_TILE;
+    fb_permute(tiles * RM_FB_TILE, RM_FB_TILE, fb_src_from_tiles, &t, 0);
+}
+
+esp_err_t rm690b0_fb_rotate(uint8_t rotation, bool upright) {
+    if (!s_fb) return ESP_ERR_INVALID_STATE;
+    if (s_rotation != rm690b0_get_rotation()) return ESP_ERR_INVALID_STATE;
+
+    const rm690b0_xform_t *from = rm690b0_xform_get(s_rotation), *to = rm690b0_xform_get(rotation);
+    uint8_t turns = rm690b0_xform_turns(from, to);
+    if (upright && from->width != to->width) return ESP_ERR_INVALID_SIZE;
+
+    // What GRAM shows is the old canvas turned, either way. Upright, the
+    // canvas does not turn, so only tiles that look the same turned (plain
+    // backgrounds) still match it.
+    if (s_delta) {
+        fb_remap_tiles(from, to, turns);
+    } else {
+        memset(s_tile_known, 0, sizeof(s_tile_known));
+    }
+
+    // Kept on the panel: the canvas turns with the coordinates, in place
+    if (!upright && turns) fb_turn(from, to, turns);
+
+    // Bounding box of the dirty rows, in the new layout
+    int32_t x0 = s_width, y0 = s_height, x1 = 0, y1 = 0;
+    for (uint16_t r = 0; r < s_height; r++) {
+        if (s_dirty_x1[r] == FB_ROW_CLEAN) continue;
+        if (s_dirty_x1[r] < x0) x0 = s_dirty_x1[r];
+        if (s_dirty_x2[r] + 1 > x1) x1 = s_dirty_x2[r] + 1;
+        if (r < y0) y0 = r;
+        y1 = r + 1;
+    }
+    if (x0 < x1 && !upright) rm690b0_xform_map_rect(from, to, &x0, &y0, &x1, &y1);
+
+    rm690b0_set_rotation(rotation);
+    s_width = to->width;
+    s_height = to->height;
+    s_rotation = to->rotation;
+    rm_damage_init(&s_damage, s_width, s_height, 0);
+    memset(s_dirty_x1, 0xFF, sizeof(s_dirty_x1));
+
+    if (upright && turns) {
+        fb_dirty(0, 0, s_width, s_height);
+    } else if (x0 < x1) {
+        fb_dirty(x0, y0, x1 - x0, y1 - y0);
+    }
+    return ESP_OK;
+}
+
+void rm690b0_fb_get_stats(rm690b0_fb_stats_t *stats) {
+    *stats = s_stats;
+}
@@ -0,0 +1,141 @@
+#ifndef RM690B0_FB_H
+#define RM690B0_FB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "rm690b0_raster.h"
+#include "rm690b0_xform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Optional full framebuffer.
+ *
+ * The canvas (600x450 RGB565, 540KB) lives in PSRAM. Drawing only touches
+ * memory and marks the affected rows dirty; rm690b0_fb_flush() sends the dirty
+ * spans through the driver's internal-RAM DMA bounce buffers (PSRAM is never
+ * handed to the SPI DMA directly).
+ *
+ * Pixels are stored big-endian, laid out for the rotation that was current at
+ * rm690b0_fb_init()/rm690b0_fb_clear().
+ *
+ * Delta mode (rm690b0_fb_set_delta()) is for apps that redraw much more than
+ * actually changes. The canvas is cut into RM_FB_TILE x RM_FB_TILE tiles, and
+ * each tile keeps a hash of what was last sent to GRAM. A flush hashes the
+ * tiles under the dirty rows and sends only those whose hash changed; runs of
+ * changed tiles in a tile row go out as one window, and runs with the same
+ * columns in consecutive tile rows are joined. Hashing reads the dirty part of
+ * the canvas once more from PSRAM, which is still far cheaper than sending it.
+ */
+
+#define RM_FB_TILE      30      // Delta tile side, divides both 600 and 450
+
+typedef struct {
+    uint32_t flushes;       // rm690b0_fb_flush() calls that sent something
+    uint32_t rows_sent;     // Dirty rows sent (row mode)
+    uint32_t pixels_sent;   // Pixels sent, including span merging overhead
+    uint32_t areas_sent;    // Windows opened
+    uint32_t tiles_hashed;  // Delta mode: tiles under dirty rows
+    uint32_t tiles_skipped; // Delta mode: unchanged since they were last sent
+    uint32_t bytes_saved;   // Delta mode: RGB565 bytes of the skipped tiles
+} rm690b0_fb_stats_t;
+
+/**
+ * @brief Allocate the canvas in PSRAM and lay it out for the current rotation.
+ * The canvas starts black and fully dirty.
+ */
+esp_err_t rm690b0_fb_init(void);
+
+/**
+ * @brief Free the canvas
+ */
+void rm690b0_fb_deinit(void);
+
+/**
+ * @brief Canvas pointer (big-endian RGB565), NULL when not initialized
+ * @param[out] stride Optional, row pitch in pixels
+ */
+uint16_t *rm690b0_fb_get(size_t *stride);
+
+/**
+ * @brief Mark an area dirty after writing to the canvas directly
+ */
+void rm690b0_fb_mark_dirty(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+/**
+ * @brief Mark the whole canvas dirty
+ */
+void rm690b0_fb_mark_all(void);
+
+/**
+ * @brief Re-lay the canvas for the current rotation and fill it with a color.
+ * Call after rm690b0_set_rotation(); marks everything dirty.
+ * @param color RGB565 (native endian)
+ */
+esp_err_t rm690b0_fb_clear(uint16_t color);
+
+/**
+ * @brief Change the rotation without redrawing the canvas.
+ *
+ * upright false: the content stays where it is on the panel and the canvas is
+ * turned into the new coordinates in place, a tile at a time. GRAM already
+ * holds it, so nothing is sent; only what was dirty stays dirty.
+ *
+ * upright true: the content keeps its screen coordinates and turns with the
+ * screen, which only fits for the same size (180 degrees). Everything is
+ * marked dirty; a delta flush then skips the tiles the turn leaves as they
+ * were.
+ *
+ * @return ESP_ERR_INVALID_SIZE for upright to another size
+ */
+esp_err_t rm690b0_fb_rotate(uint8_t rotation, bool upright);
+
+/**
+ * @brief Fill a rectangle on the canvas (clipped)
+ * @param color RGB565 (native endian)
+ */
+void rm690b0_fb_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+
+/**
+ * @brief Copy a big-endian image onto the canvas (clipped)
+ * @param stride Source row pitch in pixels
+ */
+void rm690b0_fb_write(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data_be, size_t stride);
+
+/**
+ * @brief Rasterize a shape (rm690b0_raster.h) onto the canvas, anti-aliased
+ * edges blended with the pixels underneath. Marks only the covered spans dirty.
+ * @param color RGB565
+ */
+void rm690b0_fb_draw_shape(const rm_shape_t *shape, uint16_t color, bool aa);
+
+/**
+ * @brief Send dirty rows to the panel and clear the dirty state.
+ * Blocks until the transfer is on the panel.
+ * @return ESP_ERR_INVALID_STATE if the rotation changed since the canvas was laid out
+ */
+esp_err_t rm690b0_fb_flush(void);
+
+/**
+ * @brief Switch between row mode (default) and tile-hash delta mode.
+ *
+ * Either way the tile hashes are forgotten, so the next delta flush sends
+ * every dirty tile. Call it again after drawing to the panel outside the
+ * framebuffer, whose hashes no longer match GRAM then.
+ */
+void rm690b0_fb_set_delta(bool enable);
+
+/**
+ * @brief Flush statistics
+ */
+void rm690b0_fb_get_stats(rm690b0_fb_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
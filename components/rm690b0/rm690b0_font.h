@@ -0,0 +1,25 @@
+#ifndef RM690B0_FONT_H
+#define RM690B0_FONT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RM_FONT8X16_W       8
+#define RM_FONT8X16_H       16
+#define RM_FONT8X16_FIRST   0x20
+#define RM_FONT8X16_LAST    0x7E
+
+/**
+ * 1-bit 8x16 font, one byte per row, MSB is the leftmost pixel.
+ * Index with (c - RM_FONT8X16_FIRST).
+ */
+extern const uint8_t rm_font8x16[RM_FONT8X16_LAST - RM_FONT8X16_FIRST + 1][RM_FONT8X16_H];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+#include "rm690b0_font.h"
+
+/*
+ * 8x16 console font, ASCII 0x20-0x7E. One byte per row, MSB = leftmost pixel.
+ * Rasterized from DejaVu Sans Mono Bold at 14px without anti-aliasing
+ * (Bitstream Vera / DejaVu font license).
+ */
+const uint8_t rm_font8x16[95][16] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // space
+    {0x00, 0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00}, // '!'
+    {0x00, 0x00, 0x66, 0x66, 0x66, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '"'
+    {0x00, 0x00, 0x12, 0x12, 0x16, 0x7F, 0x34, 0x24, 0xFE, 0x68, 0x48, 0x48, 0x00, 0x00, 0x00, 0x00}, // '#'
+    {0x00, 0x08, 0x08, 0x3E, 0x6A, 0x68, 0x7C, 0x1E, 0x0B, 0x0B, 0x6B, 0x3E, 0x08, 0x08, 0x00, 0x00}, // '$'
+    {0x00, 0x00, 0x60, 0x90, 0x90, 0x63, 0x0C, 0x30, 0xC6, 0x09, 0x09, 0x06, 0x00, 0x00, 0x00, 0x00}, // '%'
+    {0x00, 0x00, 0x1C, 0x30, 0x30, 0x10, 0x38, 0x7B, 0x6F, 0x6F, 0x66, 0x3F, 0x00, 0x00, 0x00, 0x00}, // '&'
+    {0x00, 0x00, 0x18, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '''
+    {0x00, 0x06, 0x0C, 0x0C, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x0C, 0x0C, 0x06, 0x00, 0x00, 0x00}, // '('
+    {0x00, 0x30, 0x18, 0x18, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x18, 0x18, 0x30, 0x00, 0x00, 0x00}, // ')'
+    {0x00, 0x00, 0x08, 0x6B, 0x3E, 0x3E, 0x6B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '*'
+    {0x00, 0x00, 0x00, 0x18, 0x18, 0x18, 0xFF, 0xFF, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00}, // '+'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x10, 0x20, 0x00, 0x00, 0x00}, // ','
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3C, 0x3C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '-'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00}, // '.'
+    {0x00, 0x00, 0x03, 0x06, 0x06, 0x06, 0x0C, 0x0C, 0x18, 0x18, 0x30, 0x30, 0x30, 0x60, 0x00, 0x00}, // '/'
+    {0x00, 0x00, 0x1C, 0x36, 0x63, 0x63, 0x6B, 0x6B, 0x63, 0x63, 0x36, 0x1C, 0x00, 0x00, 0x00, 0x00}, // '0'
+    {0x00, 0x00, 0x1C, 0x2C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, 0x00, 0x00, 0x00, 0x00}, // '1'
+    {0x00, 0x00, 0x3E, 0x43, 0x03, 0x03, 0x06, 0x0E, 0x1C, 0x38, 0x70, 0x7F, 0x00, 0x00, 0x00, 0x00}, // '2'
+    {0x00, 0x00, 0x3E, 0x43, 0x03, 0x03, 0x1C, 0x07, 0x03, 0x03, 0x47, 0x3E, 0x00, 0x00, 0x00, 0x00}, // '3'
+    {0x00, 0x00, 0x06, 0x0E, 0x1E, 0x36, 0x26, 0x66, 0x7F, 0x06, 0x06, 0x06, 0x00, 0x00, 0x00, 0x00}, // '4'
+    {0x00, 0x00, 0x7E, 0x60, 0x60, 0x7C, 0x46, 0x03, 0x03, 0x03, 0x46, 0x3C, 0x00, 0x00, 0x00, 0x00}, // '5'
+    {0x00, 0x00, 0x1C, 0x32, 0x60, 0x7E, 0x63, 0x63, 0x63, 0x63, 0x23, 0x1E, 0x00, 0x00, 0x00, 0x00}, // '6'
+    {0x00, 0x00, 0x7F, 0x03, 0x07, 0x06, 0x0E, 0x0C, 0x0C, 0x18, 0x18, 0x30, 0x00, 0x00, 0x00, 0x00}, // '7'
+    {0x00, 0x00, 0x3E, 0x63, 0x63, 0x63, 0x1C, 0x63, 0x63, 0x63, 0x63, 0x3E, 0x00, 0x00, 0x00, 0x00}, // '8'
+    {0x00, 0x00, 0x3C, 0x62, 0x63, 0x63, 0x63, 0x63, 0x3F, 0x03, 0x26, 0x1C, 0x00, 0x00, 0x00, 0x00}, // '9'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00}, // ':'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x10, 0x20, 0x00, 0x00, 0x00}, // ';'
+    {0x00, 0x00, 0x00, 0x00, 0x01, 0x0F, 0x3C, 0x60, 0x3C, 0x0F, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, // '<'
+    {0x00, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '='
+    {0x00, 0x00, 0x00, 0x00, 0x40, 0x78, 0x1E, 0x03, 0x1E, 0x78, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00}, // '>'
+    {0x00, 0x00, 0x1E, 0x23, 0x03, 0x06, 0x0C, 0x18, 0x18, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00}, // '?'
+    {0x00, 0x00, 0x1E, 0x63, 0x41, 0x9F, 0xB3, 0xA1, 0xA1, 0xB3, 0x9F, 0x40, 0x21, 0x1F, 0x00, 0x00}, // '@'
+    {0x00, 0x00, 0x1C, 0x1C, 0x1C, 0x14, 0x36, 0x36, 0x3E, 0x36, 0x63, 0x63, 0x00, 0x00, 0x00, 0x00}, // 'A'
+    {0x00, 0x00, 0x7E, 0x63, 0x63, 0x63, 0x7C, 0x63, 0x63, 0x63, 0x63, 0x7E, 0x00, 0x00, 0x00, 0x00}, // 'B'
+    {0x00, 0x00, 0x1E, 0x31, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x31, 0x1E, 0x00, 0x00, 0x00, 0x00}, // 'C'
+    {0x00, 0x00, 0x7C, 0x66, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x66, 0x7C, 0x00, 0x00, 0x00, 0x00}, // 'D'
+    {0x00, 0x00, 0x7F, 0x60, 0x60, 0x60, 0x7E, 0x60, 0x60, 0x60, 0x60, 0x7F, 0x00, 0x00, 0x00, 0x00}, // 'E'
+    {0x00, 0x00, 0x7F, 0x60, 0x60, 0x60, 0x7E, 0x60, 0x60, 0x60, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00}, // 'F'
+    {0x00, 0x00, 0x1E, 0x31, 0x60, 0x60, 0x60, 0x67, 0x63, 0x63, 0x33, 0x1F, 0x00, 0x00, 0x00, 0x00}, // 'G'
+    {0x00, 0x00, 0x63, 0x63, 0x63, 0x63, 0x7F, 0x63, 0x63, 0x63, 0x63, 0x63, 0x00, 0x00, 0x00, 0x00}, // 'H'
+    {0x00, 0x00, 0x7E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x7E, 0x00, 0x00, 0x00, 0x00}, // 'I'
+    {0x00, 0x00, 0x0F, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x43, 0x3E, 0x00, 0x00, 0x00, 0x00}, // 'J'
+    {0x00, 0x00, 0x63, 0x66, 0x6C, 0x7C, 0x7C, 0x7C, 0x6E, 0x66, 0x63, 0x63, 0x00, 0x00, 0x00, 0x00}, // 'K'
+    {0x00, 0x00, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x7F, 0x00, 0x00, 0x00, 0x00}, // 'L'
+    {0x00, 0x00, 0x77, 0x77, 0x77, 0x77, 0x7F, 0x6B, 0x63, 0x63, 0x63, 0x63, 0x00, 0x00, 0x00, 0x00}, // 'M'
+    {0x00, 0x00, 0x73, 0x73, 0x73, 0x7B, 0x6B, 0x6B, 0x6F, 0x67, 0x67, 0x67, 0x00, 0x00, 0x00, 0x00}, // 'N'
+    {0x00, 0x00, 0x1C, 0x36, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x36, 0x1C, 0x00, 0x00, 0x00, 0x00}, // 'O'
+    {0x00, 0x00, 0x7E, 0x63, 0x63, 0x63, 0x63, 0x7E, 0x60, 0x60, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00}, // 'P'
+    {0x00, 0x00, 0x1C, 0x36, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x36, 0x1E, 0x06, 0x02, 0x00, 0x00}, // 'Q'
+    {0x00, 0x00, 0x7E, 0x63, 0x63, 0x63, 0x63, 0x7C, 0x66, 0x63, 0x63, 0x61, 0x00, 0x00, 0x00, 0x00}, // 'R'
+    {0x00, 0x00, 0x3E, 0x61, 0x60, 0x60, 0x7C, 0x1E, 0x07, 0x03, 0x43, 0x3E, 0x00, 0x00, 0x00, 0x00}, // 'S'
+    {0x00, 0x00, 0xFF, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00}, // 'T'
+    {0x00, 0x00, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x3E, 0x00, 0x00, 0x00, 0x00}, // 'U'
+    {0x00, 0x00, 0x63, 0x63, 0x36, 0x36, 0x36, 0x36, 0x36, 0x14, 0x1C, 0x1C, 0x00, 0x00, 0x00, 0x00}, // 'V'
+    {0x00, 0x00, 0xC3, 0xC3, 0xC3, 0xDB, 0x5B, 0x5A, 0x7E, 0x66, 0x66, 0x66, 0x00, 0x00, 0x00, 0x00}, // 'W'
+    {0x00, 0x00, 0x63, 0x36, 0x36, 0x1C, 0x1C, 0x1C, 0x1C, 0x36, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00}, // 'X'
+    {0x00, 0x00, 0xC3, 0x66, 0x66, 0x3C, 0x3C, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00}, // 'Y'
+    {0x00, 0x00, 0x7F, 0x03, 0x06, 0x0E, 0x0C, 0x18, 0x38, 0x30, 0x60, 0x7F, 0x00, 0x00, 0x00, 0x00}, // 'Z'
+    {0x00, 0x1E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1E, 0x00, 0x00, 0x00}, // '['
+    {0x00, 0x00, 0x60, 0x20, 0x30, 0x10, 0x18, 0x18, 0x0C, 0x0C, 0x04, 0x06, 0x02, 0x03, 0x00, 0x00}, // 'backslash'
+    {0x00, 0x3C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x3C, 0x00, 0x00, 0x00}, // ']'
+    {0x00, 0x00, 0x18, 0x3C, 0x66, 0xC3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '^'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00}, // '_'
+    {0x60, 0x30, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '`'
+    {0x00, 0x00, 0x00, 0x00, 0x1C, 0x26, 0x06, 0x3E, 0x66, 0x66, 0x66, 0x3E, 0x00, 0x00, 0x00, 0x00}, // 'a'
+    {0x00, 0x60, 0x60, 0x60, 0x7C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x7C, 0x00, 0x00, 0x00, 0x00}, // 'b'
+    {0x00, 0x00, 0x00, 0x00, 0x1C, 0x32, 0x60, 0x60, 0x60, 0x60, 0x32, 0x1C, 0x00, 0x00, 0x00, 0x00}, // 'c'
+    {0x00, 0x06, 0x06, 0x06, 0x3E, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3E, 0x00, 0x00, 0x00, 0x00}, // 'd'
+    {0x00, 0x00, 0x00, 0x00, 0x3C, 0x26, 0x66, 0x7E, 0x60, 0x60, 0x32, 0x3C, 0x00, 0x00, 0x00, 0x00}, // 'e'
+    {0x00, 0x0E, 0x18, 0x18, 0x7E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00}, // 'f'
+    {0x00, 0x00, 0x00, 0x00, 0x3E, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x3C, 0x00}, // 'g'
+    {0x00, 0x60, 0x60, 0x60, 0x7C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x00, 0x00, 0x00, 0x00}, // 'h'
+    {0x00, 0x18, 0x18, 0x00, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFE, 0x00, 0x00, 0x00, 0x00}, // 'i'
+    {0x00, 0x0C, 0x0C, 0x00, 0x3C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x78, 0x00}, // 'j'
+    {0x00, 0x60, 0x60, 0x60, 0x64, 0x6C, 0x78, 0x78, 0x78, 0x6C, 0x6C, 0x66, 0x00, 0x00, 0x00, 0x00}, // 'k'
+    {0x00, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x0F, 0x00, 0x00, 0x00, 0x00}, // 'l'
+    {0x00, 0x00, 0x00, 0x00, 0xFF, 0xDB, 0xDB, 0xDB, 0xDB, 0xDB, 0xDB, 0xDB, 0x00, 0x00, 0x00, 0x00}, // 'm'
+    {0x00, 0x00, 0x00, 0x00, 0x7C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x00, 0x00, 0x00, 0x00}, // 'n'
+    {0x00, 0x00, 0x00, 0x00, 0x3C, 0x24, 0x66, 0x66, 0x66, 0x66, 0x24, 0x3C, 0x00, 0x00, 0x00, 0x00}, // 'o'
+    {0x00, 0x00, 0x00, 0x00, 0x7C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x7C, 0x60, 0x60, 0x60, 0x00}, // 'p'
+    {0x00, 0x00, 0x00, 0x00, 0x3E, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x06, 0x00}, // 'q'
+    {0x00, 0x00, 0x00, 0x00, 0x3F, 0x38, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00}, // 'r'
+    {0x00, 0x00, 0x00, 0x00, 0x3C, 0x62, 0x60, 0x78, 0x1E, 0x06, 0x46, 0x3C, 0x00, 0x00, 0x00, 0x00}, // 's'
+    {0x00, 0x00, 0x18, 0x18, 0x7F, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x0F, 0x00, 0x00, 0x00, 0x00}, // 't'
+    {0x00, 0x00, 0x00, 0x00, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3E, 0x00, 0x00, 0x00, 0x00}, // 'u'
+    {0x00, 0x00, 0x00, 0x00, 0x66, 0x66, 0x66, 0x24, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00}, // 'v'
+    {0x00, 0x00, 0x00, 0x00, 0xC3, 0xC3, 0xDB, 0x5A, 0x5A, 0x5A, 0x66, 0x66, 0x00, 0x00, 0x00, 0x00}, // 'w'
+    {0x00, 0x00, 0x00, 0x00, 0x66, 0x3C, 0x3C, 0x18, 0x18, 0x3C, 0x3C, 0x66, 0x00, 0x00, 0x00, 0x00}, // 'x'
+    {0x00, 0x00, 0x00, 0x00, 0x66, 0x66, 0x2C, 0x3C, 0x3C, 0x38, 0x18, 0x18, 0x18, 0x30, 0x70, 0x00}, // 'y'
+    {0x00, 0x00, 0x00, 0x00, 0x7E, 0x06, 0x0C, 0x1C, 0x38, 0x30, 0x60, 0x7E, 0x00, 0x00, 0x00, 0x00}, // 'z'
+    {0x00, 0x0E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x60, 0x18, 0x18, 0x18, 0x18, 0x18, 0x0E, 0x00, 0x00}, // '{'
+    {0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00}, // '|'
+    {0x00, 0x70, 0x18, 0x18, 0x18, 0x18, 0x18, 0x06, 0x18, 0x18, 0x18, 0x18, 0x18, 0x70, 0x00, 0x00}, // '}'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x39, 0x7F, 0x46, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '~'
+};
@@ -0,0 +1,194 @@
+#include "rm690b0_img.h"
+#include "rm690b0_color.h"
+#include <string.h>
+
+#define OP_INDEX    0x00
+#define OP_DIFF     0x40
+#define OP_LUMA     0x80
+#define OP_RUN      0xC0
+#define OP_RGB      0xFE
+#define OP_LRUN     0xFF
+#define OP_MASK     0xC0
+
+#define RUN_MAX     62          // Short run, 0xC0..0xFD
+#define LRUN_MAX    65536
+
+static inline uint32_t img_hash(uint32_t c) {
+    return ((c >> 11) * 3 + ((c >> 5) & 0x3F) * 5 + (c & 0x1F) * 7) & 63;
+}
+
+// Sign-extend a channel difference wrapped to `bits`
+static inline int32_t wrap(int32_t d, int bits) {
+    int32_t half = 1 << (bits - 1);
+    return ((d + half) & ((1 << bits) - 1)) - half;
+}
+
+esp_err_t rm690b0_img_open(rm690b0_img_t *img, const void *file, size_t size) {
+    const uint8_t *f = file;
+    if (size < RM_IMG_HEADER_SIZE) return ESP_ERR_INVALID_SIZE;
+    if (memcmp(f, RM_IMG_MAGIC, 4) != 0) return ESP_ERR_INVALID_ARG;
+
+    uint32_t len = f[8] | (f[9] << 8) | ((uint32_t)f[10] << 16) | ((uint32_t)f[11] << 24);
+    if (len > size - RM_IMG_HEADER_SIZE) return ESP_ERR_INVALID_SIZE;
+
+    img->w = f[4] | (f[5] << 8);
+    img->h = f[6] | (f[7] << 8);
+    img->ops = f + RM_IMG_HEADER_SIZE;
+    img->len = len;
+    return ESP_OK;
+}
+
+void rm690b0_img_dec_init(rm690b0_img_dec_t *dec, const rm690b0_img_t *img) {
+    memset(dec, 0, sizeof(*dec));
+    dec->p = img->ops;
+    dec->end = img->ops + img->len;
+    dec->left = (size_t)img->w * img->h;
+}
+
+size_t rm690b0_img_decode(rm690b0_img_dec_t *dec, uint16_t *dst_be, size_t max_pixels) {
+    size_t n = (dec->left < max_pixels) ? dec->left : max_pixels;
+    const uint8_t *p = dec->p, *end = dec->end;
+    uint32_t run = dec->run;
+    uint32_t px = dec->prev;
+    uint16_t be = rm_color_be(px);
+    size_t out = 0;
+
+    while (out < n) {
+        if (run) {
+            size_t k = (run < n - out) ? run : n - out;
+            for (size_t i = 0; i < k; i++) dst_be[out + i] = be;
+            out += k;
+            run -= k;
+            continue;
+        }
+        if (p >= end) break;
+
+        uint32_t op = *p++;
+        if (op < OP_DIFF) {
+            px = dec->index[op];
+        } else if (op < OP_LUMA) {
+            uint32_t r = ((px >> 11) + ((op >> 4) & 3) - 2) & 0x1F;
+            uint32_t g = (((px >> 5) & 0x3F) + ((op >> 2) & 3) - 2) & 0x3F;
+            uint32_t b = ((px & 0x1F) + (op & 3) - 2) & 0x1F;
+            px = (r << 11) | (g << 5) | b;
+            dec->index[img_hash(px)] = (uint16_t)px;
+        } else if (op < OP_RUN) {
+            if (p >= end) break;
+            uint32_t rb = *p++;
+            int32_t dg = (int32_t)(op & 0x3F) - 32;
+            int32_t half = dg >> 1;
+            uint32_t r = ((px >> 11) + half + (int32_t)(rb >> 4) - 8) & 0x1F;
+            uint32_t g = (((px >> 5) & 0x3F) + dg) & 0x3F;
+            uint32_t b = ((px & 0x1F) + half + (int32_t)(rb & 0x0F) - 8) & 0x1F;
+            px = (r << 11) | (g << 5) | b;
+            dec->index[img_hash(px)] = (uint16_t)px;
+        } else if (op < OP_RGB) {
+            run = (op & 0x3F) + 1;
+            continue;
+        } else {
+            if (end - p < 2) break;
+            uint32_t v = ((uint32_t)p[0] << 8) | p[1];
+            p += 2;
+            if (op == OP_LRUN) {
+                run = v + 1;
+                continue;
+            }
+            px = v;
+            dec->index[img_hash(px)] = (uint16_t)px;
+        }
+        be = rm_color_be(px);
+        dst_be[out++] = be;
+    }
+
+    dec->p = p;
+    dec->run = run;
+    dec->prev = (uint16_t)px;
+    dec->left -= out;
+    return out;
+}
+
+// --- Encoder ---
+
+typedef struct {
+    uint8_t *p, *end;
+    bool overflow;
+} img_out_t;
+
+static void put(img_out_t *o, const uint8_t *b, size_t n) {
+    if ((size_t)(o->end - o->p) < n) {
+        o->overflow = true;
+        return;
+    }
+    memcpy(o->p, b, n);
+    o->p += n;
+}
+
+static void put_run(img_out_t *o, uint32_t run) {
+    while (run > 0) {
+        if (run <= RUN_MAX) {
+            put(o, (uint8_t[]){ OP_RUN | (run - 1) }, 1);
+            return;
+        }
+        uint32_t k = (run < LRUN_MAX) ? run : LRUN_MAX;
+        put(o, (uint8_t[]){ OP_LRUN, (k - 1) >> 8, (k - 1) & 0xFF }, 3);
+        run -= k;
+    }
+}
+
+size_t rm690b0_img_encode(const uint16_t *src_be, size_t stride, uint16_t w, uint16_t h,
+                          uint8_t *out, size_t cap) {
+    if (cap < RM_IMG_HEADER_SIZE) return 0;
+    img_out_t o = { .p = out + RM_IMG_HEADER_SIZE, .end = out + cap };
+
+    uint16_t index[64] = {0};
+    uint32_t prev = 0, run = 0;
+    for (uint32_t y = 0; y < h && !o.overflow; y++) {
+        const uint16_t *row = src_be + (size_t)y * stride;
+        for (uint32_t x = 0; x < w; x++) {
+            uint32_t px = rm_color_be(row[x]);
+            if (px == prev) {
+                run++;
+                continue;
+            }
+            put_run(&o, run);
+            run = 0;
+
+            uint32_t h6 = img_hash(px);
+            if (index[h6] == px) {
+                put(&o, (uint8_t[]){ OP_INDEX | h6 }, 1);
+                prev = px;
+                continue;
+            }
+            index[h6] = (uint16_t)px;
+
+            int32_t dr = wrap((int32_t)(px >> 11) - (int32_t)(prev >> 11), 5);
+            int32_t dg = wrap((int32_t)((px >> 5) & 0x3F) - (int32_t)((prev >> 5) & 0x3F), 6);
+            int32_t db = wrap((int32_t)(px & 0x1F) - (int32_t)(prev & 0x1F), 5);
+            int32_t dr_dg = wrap(dr - (dg >> 1), 5);
+            int32_t db_dg = wrap(db - (dg >> 1), 5);
+
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                put(&o, (uint8_t[]){ OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2) }, 1);
+            } else if (dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+                put(&o, (uint8_t[]){ OP_LUMA | (dg + 32), (dr_dg + 8) << 4 | (db_dg + 8) }, 2);
+            } else {
+                put(&o, (uint8_t[]){ OP_RGB, px >> 8, px & 0xFF }, 3);
+            }
+            prev = px;
+        }
+    }
+    put_run(&o, run);
+    if (o.overflow) return 0;
+
+    size_t len = o.p - (out + RM_IMG_HEADER_SIZE);
+    memcpy(out, RM_IMG_MAGIC, 4);
+    out[4] = w & 0xFF;
+    out[5] = w >> 8;
+    out[6] = h & 0xFF;
+    out[7] = h >> 8;
+    out[8] = len & 0xFF;
+    out[9] = (len >> 8) & 0xFF;
+    out[10] = (len >> 16) & 0xFF;
+    out[11] = (len >> 24) & 0xFF;
+    return o.p - out;
+}
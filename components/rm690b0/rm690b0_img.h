@@ -0,0 +1,91 @@
+#ifndef RM690B0_IMG_H
+#define RM690B0_IMG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Lossless RGB565 image codec ("R5Q", QOI-style).
+ *
+ * Each pixel is coded against the previous one and a 64-entry table of
+ * recently seen colors, one op per pixel or run:
+ *
+ *   00iiiiii              INDEX  color from table slot i
+ *   01rrggbb              DIFF   r, g, b each moved by -2..1 (565 units)
+ *   10gggggg rrrrbbbb     LUMA   g moved by -32..31, r and b by g/2 + -8..7
+ *   11nnnnnn              RUN    previous color repeated n + 1 times (n < 62)
+ *   11111110 hi lo        RGB    literal big-endian RGB565
+ *   11111111 hi lo        LRUN   previous color repeated (hi << 8 | lo) + 1 times
+ *
+ * Channels wrap (mod 32 / 64 / 32). The decoder is incremental: it writes as
+ * many pixels as the caller has room for and resumes where it stopped, so an
+ * image of any size streams straight from memory-mapped flash into the
+ * driver's bounce buffers with only rm690b0_img_dec_t (~150 bytes) of state.
+ *
+ * File layout: "R5Q1", width and height (u16 little-endian), op stream length
+ * (u32 little-endian), op stream. tools/rm690b0_img encodes PPM files.
+ */
+
+#define RM_IMG_MAGIC        "R5Q1"
+#define RM_IMG_HEADER_SIZE  12
+
+// Worst case file size: every pixel a literal
+#define RM_IMG_MAX_SIZE(w, h)   (RM_IMG_HEADER_SIZE + (size_t)(w) * (h) * 3)
+
+typedef struct {
+    uint16_t w, h;
+    const uint8_t *ops;     // Op stream, inside the file
+    size_t len;             // Op stream bytes
+} rm690b0_img_t;
+
+/**
+ * Decoder state. Holds no pointer into the output, only into the op stream.
+ */
+typedef struct {
+    const uint8_t *p, *end;
+    size_t left;            // Pixels not yet written
+    uint32_t run;           // Repeats of prev still owed
+    uint16_t prev;          // Native RGB565
+    uint16_t index[64];
+} rm690b0_img_dec_t;
+
+/**
+ * @brief Check the header of an encoded image
+ * @param file Encoded file, e.g. an embedded array or a mapped flash partition
+ * @return ESP_ERR_INVALID_ARG on a bad magic, ESP_ERR_INVALID_SIZE if truncated
+ */
+esp_err_t rm690b0_img_open(rm690b0_img_t *img, const void *file, size_t size);
+
+/**
+ * @brief Start decoding from the first pixel
+ */
+void rm690b0_img_dec_init(rm690b0_img_dec_t *dec, const rm690b0_img_t *img);
+
+/**
+ * @brief Decode the next pixels in row-major order
+ * @param[out] dst_be Big-endian RGB565 output
+ * @return Pixels written; fewer than max_pixels only at the end of the image
+ * or of a truncated op stream
+ */
+size_t rm690b0_img_decode(rm690b0_img_dec_t *dec, uint16_t *dst_be, size_t max_pixels);
+
+/**
+ * @brief Encode a big-endian RGB565 image
+ * @param stride Source row pitch in pixels
+ * @param out Output, RM_IMG_MAX_SIZE(w, h) bytes always suffice
+ * @return File size, 0 if it did not fit into cap
+ */
+size_t rm690b0_img_encode(const uint16_t *src_be, size_t stride, uint16_t w, uint16_t h,
+                          uint8_t *out, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
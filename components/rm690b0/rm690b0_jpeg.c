@@ -0,0 +1,491 @@
+#include "rm690b0_jpeg.h"
+#include "rm690b0_color.h"
+#include <string.h>
+
+// Natural position of the k-th coefficient in zigzag order, padded for
+// corrupt runs past 63
+static const uint8_t s_zigzag[64 + 16] = {
+     0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63,
+};
+
+// Annex K.3 tables, for streams without DHT: code counts per length 1..16, then values
+static const uint8_t s_std_dc_lum[16 + 12] = {
+    0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+};
+static const uint8_t s_std_dc_chr[16 + 12] = {
+    0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+};
+static const uint8_t s_std_ac_lum[16 + 162] = {
+    0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d,
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+    0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+    0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+    0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+    0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa,
+};
+static const uint8_t s_std_ac_chr[16 + 162] = {
+    0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77,
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+    0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+    0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+    0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+    0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+    0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+    0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa,
+};
+
+static inline uint16_t rd16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline uint8_t clamp8(int32_t v) {
+    return (v < 0) ? 0 : (v > 255) ? 255 : (uint8_t)v;
+}
+
+// --- Huffman tables ---
+
+// counts: 16 code counts, then the values. false if the table is malformed.
+static bool huff_build(rm690b0_jpeg_huff_t *h, const uint8_t *counts, size_t avail) {
+    size_t total = 0;
+    for (int i = 0; i < 16; i++) total += counts[i];
+    if (total > 256 || total > avail) return false;
+    memcpy(h->vals, counts + 16, total);
+    memset(h->fast, 0, sizeof(h->fast));
+
+    int32_t code = 0;
+    size_t k = 0;
+    for (int len = 1; len <= 16; len++) {
+        h->valptr[len] = (int32_t)k - code;
+        for (int i = 0; i < counts[len - 1]; i++, k++, code++) {
+            if (code >= (1 << len)) return false;   // Over-subscribed
+            if (len <= 9) {
+                // Every 9-bit prefix starting with this code
+                int32_t shift = 9 - len;
+                for (int32_t j = 0; j < (1 << shift); j++) {
+                    h->fast[(code << shift) | j] = (uint16_t)((len << 8) | h->vals[k]);
+                }
+            }
+        }
+        h->maxcode[len] = counts[len - 1] ? code - 1 : -1;
+        code <<= 1;
+    }
+    h->maxcode[17] = INT32_MAX;
+    h->present = true;
+    return true;
+}
+
+// --- Entropy decoding ---
+
+static void bits_fill(rm690b0_jpeg_t *j) {
+    while (j->nbits <= 24) {
+        uint32_t b = 0;
+        if (!j->marker && j->p < j->end) {
+            b = *j->p;
+            if (b == 0xFF) {
+                uint8_t next = (j->p + 1 < j->end) ? j->p[1] : 0xD9;
+                if (next == 0x00) {
+                    j->p += 2;
+                } else {
+                    j->marker = true;   // Left in place for the restart logic
+                    b = 0;
+                }
+            } else {
+                j->p++;
+            }
+        }
+        j->bits |= b << (24 - j->nbits);
+        j->nbits += 8;
+    }
+}
+
+static inline uint32_t bits_get(rm690b0_jpeg_t *j, int n) {
+    if (j->nbits < n) bits_fill(j);
+    uint32_t v = j->bits >> (32 - n);
+    j->bits <<= n;
+    j->nbits -= n;
+    return v;
+}
+
+// n bits as a signed coefficient (F.12)
+static inline int32_t bits_extend(rm690b0_jpeg_t *j, int n) {
+    if (n == 0) return 0;
+    int32_t v = (int32_t)bits_get(j, n);
+    return (v < (1 << (n - 1))) ? v - (1 << n) + 1 : v;
+}
+
+static int huff_decode(rm690b0_jpeg_t *j, const rm690b0_jpeg_huff_t *h) {
+    if (j->nbits < 16) bits_fill(j);
+    uint16_t f = h->fast[j->bits >> 23];
+    if (f) {
+        j->bits <<= f >> 8;
+        j->nbits -= f >> 8;
+        return f & 0xFF;
+    }
+    uint32_t peek = j->bits >> 16;
+    for (int len = 10; len <= 16; len++) {
+        int32_t code = (int32_t)(peek >> (16 - len));
+        if (code <= h->maxcode[len]) {
+            j->bits <<= len;
+            j->nbits -= len;
+            return h->vals[(h->valptr[len] + code) & 0xFF];
+        }
+    }
+    j->error = true;
+    j->bits <<= 16;
+    j->nbits -= 16;
+    return 0;
+}
+
+// Skip to just past the next RSTn marker and start a new interval
+static void restart(rm690b0_jpeg_t *j) {
+    j->bits = 0;
+    j->nbits = 0;
+    j->marker = false;
+    while (j->p + 1 < j->end && !(j->p[0] == 0xFF && j->p[1] >= 0xD0 && j->p[1] <= 0xD7)) j->p++;
+    if (j->p + 1 < j->end) j->p += 2;
+    else j->error = true;
+    for (int c = 0; c < j->ncomp; c++) j->comp[c].dc = 0;
+    j->mcus_left = j->restart;
+}
+
+// --- IDCT ---
+
+// Integer IDCT in the style of libjpeg's jidctint: 12-bit constants, columns
+// then rows, output level-shifted and clamped
+#define FIX(x)      ((int32_t)((x) * 4096 + 0.5))
+#define IDCT_1D(s0, s1, s2, s3, s4, s5, s6, s7)                 \
+    int32_t t0, t1, t2, t3, p1, p2, p3, p4, p5, x0, x1, x2, x3; \
+    p2 = s2;                                                    \
+    p3 = s6;                                                    \
+    p1 = (p2 + p3) * FIX(0.5411961);                            \
+    t2 = p1 + p3 * FIX(-1.847759065);                           \
+    t3 = p1 + p2 * FIX(0.765366865);                            \
+    p2 = s0;                                                    \
+    p3 = s4;                                                    \
+    t0 = (p2 + p3) * 4096;                                      \
+    t1 = (p2 - p3) * 4096;                                      \
+    x0 = t0 + t3;                                               \
+    x3 = t0 - t3;                                               \
+    x1 = t1 + t2;                                               \
+    x2 = t1 - t2;                                               \
+    t0 = s7;                                                    \
+    t1 = s5;                                                    \
+    t2 = s3;                                                    \
+    t3 = s1;                                                    \
+    p3 = t0 + t2;                                               \
+    p4 = t1 + t3;                                               \
+    p1 = t0 + t3;                                               \
+    p2 = t1 + t2;                                               \
+    p5 = (p3 + p4) * FIX(1.175875602);                          \
+    t0 = t0 * FIX(0.298631336);                                 \
+    t1 = t1 * FIX(2.053119869);                                 \
+    t2 = t2 * FIX(3.072711026);                                 \
+    t3 = t3 * FIX(1.501321110);                                 \
+    p1 = p5 + p1 * FIX(-0.899976223);                           \
+    p2 = p5 + p2 * FIX(-2.562915447);                           \
+    p3 = p3 * FIX(-1.961570560);                                \
+    p4 = p4 * FIX(-0.390180644);                                \
+    t3 += p1 + p4;                                              \
+    t2 += p2 + p3;                                              \
+    t1 += p2 + p4;                                              \
+    t0 += p1 + p3;
+
+static void idct_block(const int32_t *in, uint8_t *out, size_t stride) {
+    int32_t tmp[64];
+    for (int i = 0; i < 8; i++) {
+        const int32_t *d = in + i;
+        int32_t *v = tmp + i;
+        if (!d[8] && !d[16] && !d[24] && !d[32] && !d[40] && !d[48] && !d[56]) {
+            int32_t dc = d[0] * 4;
+            for (int r = 0; r < 8; r++) v[r * 8] = dc;
+            continue;
+        }
+        IDCT_1D(d[0], d[8], d[16], d[24], d[32], d[40], d[48], d[56])
+        x0 += 512; x1 += 512; x2 += 512; x3 += 512;
+        v[0]  = (x0 + t3) >> 10;
+        v[56] = (x0 - t3) >> 10;
+        v[8]  = (x1 + t2) >> 10;
+        v[48] = (x1 - t2) >> 10;
+        v[16] = (x2 + t1) >> 10;
+        v[40] = (x2 - t1) >> 10;
+        v[24] = (x3 + t0) >> 10;
+        v[32] = (x3 - t0) >> 10;
+    }
+    for (int i = 0; i < 8; i++, out += stride) {
+        const int32_t *v = tmp + i * 8;
+        IDCT_1D(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7])
+        // Rounding and the +128 level shift folded into one bias
+        x0 += 65536 + (128 << 17); x1 += 65536 + (128 << 17);
+        x2 += 65536 + (128 << 17); x3 += 65536 + (128 << 17);
+        out[0] = clamp8((x0 + t3) >> 17);
+        out[7] = clamp8((x0 - t3) >> 17);
+        out[1] = clamp8((x1 + t2) >> 17);
+        out[6] = clamp8((x1 - t2) >> 17);
+        out[2] = clamp8((x2 + t1) >> 17);
+        out[5] = clamp8((x2 - t1) >> 17);
+        out[3] = clamp8((x3 + t0) >> 17);
+        out[4] = clamp8((x3 - t0) >> 17);
+    }
+}
+
+static void decode_block(rm690b0_jpeg_t *j, rm690b0_jpeg_comp_t *c, uint8_t *out, size_t stride) {
+    int32_t coef[64];
+    memset(coef, 0, sizeof(coef));
+    const uint16_t *q = j->qt[c->tq];
+
+    int t = huff_decode(j, &j->huff[0][c->td]);
+    c->dc += bits_extend(j, t > 11 ? 11 : t);
+    coef[0] = c->dc * q[0];
+
+    const rm690b0_jpeg_huff_t *ac = &j->huff[1][c->ta];
+    for (int k = 1; k < 64;) {
+        int rs = huff_decode(j, ac);
+        int r = rs >> 4, s = rs & 15;
+        if (s == 0) {
+            if (r != 15) break;     // EOB
+            k += 16;
+            continue;
+        }
+        k += r;
+        if (k > 63) {
+            j->error = true;
+            break;
+        }
+        coef[s_zigzag[k]] = bits_extend(j, s) * q[k];
+        k++;
+    }
+    idct_block(coef, out, stride);
+}
+
+// --- Colour ---
+
+static inline uint16_t ycc_be565(int32_t y, int32_t cb, int32_t cr) {
+    cb -= 128;
+    cr -= 128;
+    uint32_t r = clamp8(y + ((91881 * cr + 32768) >> 16));
+    uint32_t g = clamp8(y + ((-22554 * cb - 46802 * cr + 32768) >> 16));
+    uint32_t b = clamp8(y + ((116130 * cb + 32768) >> 16));
+    return rm_color_be((uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)));
+}
+
+// Write the visible part of the MCU at (mx, my) pixels
+static void mcu_output(rm690b0_jpeg_t *j, uint16_t *dst, size_t stride, uint32_t mx, uint32_t my) {
+    uint32_t w = (mx + j->mcu_w <= j->w) ? j->mcu_w : j->w - mx;
+    uint32_t h = (my + j->mcu_h <= j->h) ? j->mcu_h : j->h - my;
+    dst += mx;
+    if (j->ncomp == 1) {
+        for (uint32_t y = 0; y < h; y++, dst += stride) {
+            const uint8_t *src = j->planes[0] + y * 8;
+            for (uint32_t x = 0; x < w; x++) {
+                uint32_t v = src[x];
+                dst[x] = rm_color_be((uint16_t)(((v >> 3) << 11) | ((v >> 2) << 5) | (v >> 3)));
+            }
+        }
+        return;
+    }
+    // Chroma sample of luma column x: x * h_c / hmax, a shift for 1 or 2
+    const rm690b0_jpeg_comp_t *cy = &j->comp[0], *cb = &j->comp[1], *cr = &j->comp[2];
+    uint32_t yw = 8 * cy->h, bw = 8 * cb->h, rw = 8 * cr->h;
+    int ysx = (cy->h < j->hmax), bsx = (cb->h < j->hmax), rsx = (cr->h < j->hmax);
+    int ysy = (cy->v < j->vmax), bsy = (cb->v < j->vmax), rsy = (cr->v < j->vmax);
+    for (uint32_t y = 0; y < h; y++, dst += stride) {
+        const uint8_t *py = j->planes[0] + (y >> ysy) * yw;
+        const uint8_t *pb = j->planes[1] + (y >> bsy) * bw;
+        const uint8_t *pr = j->planes[2] + (y >> rsy) * rw;
+        for (uint32_t x = 0; x < w; x++) dst[x] = ycc_be565(py[x >> ysx], pb[x >> bsx], pr[x >> rsx]);
+    }
+}
+
+// --- API ---
+
+esp_err_t rm690b0_jpeg_find(const void *data, size_t size, size_t *start, size_t *len) {
+    const uint8_t *d = data, *end = d + size;
+    const uint8_t *p = d;
+    // SOI
+    for (;;) {
+        p = memchr(p, 0xFF, end - p);
+        if (!p || p + 1 >= end) return ESP_ERR_NOT_FOUND;
+        if (p[1] == 0xD8) break;
+        p++;
+    }
+    const uint8_t *soi = p;
+    p += 2;
+    // Marker segments until SOS, then entropy data until a marker other than RSTn
+    bool scan = false;
+    while (p + 1 < end) {
+        if (scan) {
+            p = memchr(p, 0xFF, end - p);
+            if (!p || p + 1 >= end) return ESP_ERR_NOT_FOUND;
+            uint8_t m = p[1];
+            if (m == 0x00 || (m >= 0xD0 && m <= 0xD7)) {
+                p += 2;
+                continue;
+            }
+            scan = false;
+        }
+        if (p[0] != 0xFF) return ESP_ERR_NOT_FOUND;
+        uint8_t m = p[1];
+        if (m == 0xFF) {
+            p++;            // Fill byte
+            continue;
+        }
+        if (m == 0xD9) {
+            *start = soi - d;
+            *len = p + 2 - soi;
+            return ESP_OK;
+        }
+        if (m == 0xD8 || p + 4 > end) return ESP_ERR_NOT_FOUND;
+        uint16_t seg = rd16(p + 2);
+        if (seg < 2) return ESP_ERR_NOT_FOUND;
+        scan = (m == 0xDA);
+        p += 2 + seg;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t rm690b0_jpeg_open(rm690b0_jpeg_t *j, const void *data, size_t size) {
+    const uint8_t *p = data, *end = p + size;
+    if (size < 4 || p[0] != 0xFF || p[1] != 0xD8) return ESP_ERR_INVALID_ARG;
+    p += 2;
+
+    memset(j, 0, offsetof(rm690b0_jpeg_t, planes));
+    bool frame = false;
+    for (;;) {
+        while (p < end && *p == 0xFF && p + 1 < end && p[1] == 0xFF) p++;
+        if (p + 4 > end || p[0] != 0xFF) return ESP_ERR_INVALID_ARG;
+        uint8_t m = p[1];
+        uint16_t seg = rd16(p + 2);
+        const uint8_t *s = p + 4, *s_end = p + 2 + seg;
+        if (seg < 2 || s_end > end) return ESP_ERR_INVALID_ARG;
+
+        switch (m) {
+            case 0xC0:
+            case 0xC1: {
+                if (seg < 8 || s[0] != 8) return ESP_ERR_NOT_SUPPORTED;
+                j->h = rd16(s + 1);
+                j->w = rd16(s + 3);
+                j->ncomp = s[5];
+                if (j->w == 0 || j->h == 0) return ESP_ERR_INVALID_ARG;
+                if (j->w > RM_JPEG_MAX_W || j->h > RM_JPEG_MAX_H) return ESP_ERR_INVALID_SIZE;
+                if ((j->ncomp != 1 && j->ncomp != 3) || seg < 8 + 3 * j->ncomp) return ESP_ERR_NOT_SUPPORTED;
+                j->hmax = j->vmax = 1;
+                for (int c = 0; c < j->ncomp; c++) {
+                    rm690b0_jpeg_comp_t *cp = &j->comp[c];
+                    cp->id = s[6 + 3 * c];
+                    cp->h = s[7 + 3 * c] >> 4;
+                    cp->v = s[7 + 3 * c] & 15;
+                    cp->tq = s[8 + 3 * c] & 3;
+                    if (cp->h < 1 || cp->h > 2 || cp->v < 1 || cp->v > 2) return ESP_ERR_NOT_SUPPORTED;
+                    if (cp->h > j->hmax) j->hmax = cp->h;
+                    if (cp->v > j->vmax) j->vmax = cp->v;
+                }
+                if (j->ncomp == 1) j->comp[0].h = j->comp[0].v = j->hmax = j->vmax = 1;
+                j->mcu_w = 8 * j->hmax;
+                j->mcu_h = 8 * j->vmax;
+                j->mcus_x = (j->w + j->mcu_w - 1) / j->mcu_w;
+                j->mcus_y = (j->h + j->mcu_h - 1) / j->mcu_h;
+                frame = true;
+                break;
+            }
+            case 0xC4:
+                while (s + 17 <= s_end) {
+                    uint8_t tc = s[0] >> 4, th = s[0] & 15;
+                    if (tc > 1 || th > 1) return ESP_ERR_NOT_SUPPORTED;
+                    if (!huff_build(&j->huff[tc][th], s + 1, s_end - s - 17)) return ESP_ERR_INVALID_ARG;
+                    size_t n = 0;
+                    for (int i = 0; i < 16; i++) n += s[1 + i];
+                    s += 17 + n;
+                }
+                if (s != s_end) return ESP_ERR_INVALID_ARG;    // Truncated table
+                break;
+            case 0xDB:
+                while (s < s_end) {
+                    uint8_t pq = s[0] >> 4, tq = s[0] & 3;
+                    size_t n = pq ? 128 : 64;
+                    if (s + 1 + n > s_end) return ESP_ERR_INVALID_ARG;
+                    for (int k = 0; k < 64; k++) j->qt[tq][k] = pq ? rd16(s + 1 + 2 * k) : s[1 + k];
+                    s += 1 + n;
+                }
+                break;
+            case 0xDD:
+                if (seg < 4) return ESP_ERR_INVALID_ARG;
+                j->restart = rd16(s);
+                break;
+            case 0xDA: {
+                if (!frame || seg < 6 || s[0] != j->ncomp || seg < 6 + 2 * j->ncomp) {
+                    return frame ? ESP_ERR_NOT_SUPPORTED : ESP_ERR_INVALID_ARG;
+                }
+                for (int i = 0; i < j->ncomp; i++) {
+                    uint8_t id = s[1 + 2 * i], t = s[2 + 2 * i];
+                    int c = 0;
+                    while (c < j->ncomp && j->comp[c].id != id) c++;
+                    if (c == j->ncomp) return ESP_ERR_INVALID_ARG;
+                    j->comp[c].td = (t >> 4) & 1;
+                    j->comp[c].ta = t & 1;
+                }
+                // Tables the stream left out: the standard ones
+                if (!j->huff[0][0].present) huff_build(&j->huff[0][0], s_std_dc_lum, 12);
+                if (!j->huff[0][1].present) huff_build(&j->huff[0][1], s_std_dc_chr, 12);
+                if (!j->huff[1][0].present) huff_build(&j->huff[1][0], s_std_ac_lum, 162);
+                if (!j->huff[1][1].present) huff_build(&j->huff[1][1], s_std_ac_chr, 162);
+                j->p = s_end;
+                j->end = end;
+                j->mcus_left = j->restart;
+                return ESP_OK;
+            }
+            case 0xC2: case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+            case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+                return ESP_ERR_NOT_SUPPORTED;   // Progressive, lossless, arithmetic
+            case 0xD9:
+                return ESP_ERR_INVALID_ARG;
+            default:
+                break;      // APPn, COM
+        }
+        p = s_end;
+    }
+}
+
+uint16_t rm690b0_jpeg_decode_rows(rm690b0_jpeg_t *j, uint16_t *dst_be, size_t stride) {
+    if (j->row >= j->mcus_y) return 0;
+    uint32_t my = (uint32_t)j->row * j->mcu_h;
+    for (uint32_t mx = 0; mx < j->mcus_x; mx++) {
+        if (j->restart) {
+            if (j->mcus_left == 0) restart(j);
+            j->mcus_left--;
+        }
+        for (int c = 0; c < j->ncomp; c++) {
+            rm690b0_jpeg_comp_t *cp = &j->comp[c];
+            size_t pw = 8 * cp->h;
+            for (int by = 0; by < cp->v; by++) {
+                for (int bx = 0; bx < cp->h; bx++) {
+                    decode_block(j, cp, j->planes[c] + by * 8 * pw + bx * 8, pw);
+                }
+            }
+        }
+        mcu_output(j, dst_be, stride, mx * j->mcu_w, my);
+    }
+    j->row++;
+    return (my + j->mcu_h <= j->h) ? j->mcu_h : (uint16_t)(j->h - my);
+}
+
+esp_err_t rm690b0_jpeg_decode(rm690b0_jpeg_t *j, uint16_t *dst_be, size_t stride) {
+    uint16_t rows;
+    while ((rows = rm690b0_jpeg_decode_rows(j, dst_be, stride)) > 0) dst_be += (size_t)rows * stride;
+    return j->error ? ESP_ERR_INVALID_RESPONSE : ESP_OK;
+}
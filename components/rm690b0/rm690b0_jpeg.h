@@ -0,0 +1,101 @@
+#ifndef RM690B0_JPEG_H
+#define RM690B0_JPEG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Baseline JPEG decoder, one MCU row at a time.
+ *
+ * Decodes sequential Huffman JPEG (SOF0/SOF1, 8-bit) with one component
+ * (grayscale) or three (YCbCr 4:4:4, 4:2:2, 4:2:0), restart markers, and the
+ * standard Huffman tables for streams that leave them out (AVI-style MJPEG).
+ * Output is big-endian RGB565, chroma upsampled by replication, straight
+ * into the caller's rows: a band buffer, a framebuffer. All state is in
+ * rm690b0_jpeg_t (about 7 KB, no allocation), and the code is portable C,
+ * so the host simulator benchmarks exactly what runs on the device.
+ */
+
+#define RM_JPEG_MAX_W       1024    // Widest image
+#define RM_JPEG_MAX_H       1024
+
+typedef struct {
+    uint16_t fast[1 << 9];  // Codes of up to 9 bits: length << 8 | value, 0: longer
+    int32_t maxcode[18];    // Largest code of each length, -1: none
+    int32_t valptr[17];     // Index into vals of the first code of each length, minus that code
+    uint8_t vals[256];
+    bool present;
+} rm690b0_jpeg_huff_t;
+
+typedef struct {
+    uint8_t id, h, v;       // Sampling factors
+    uint8_t tq, td, ta;     // Quantization, DC and AC table
+    int32_t dc;             // DC prediction
+} rm690b0_jpeg_comp_t;
+
+typedef struct {
+    uint16_t w, h;
+    uint8_t ncomp;
+    uint8_t hmax, vmax;
+    uint16_t mcu_w, mcu_h;  // MCU size in pixels
+    uint16_t mcus_x, mcus_y;
+    uint16_t restart;       // MCUs per restart interval, 0: none
+    uint16_t row;           // Next MCU row
+    bool error;             // Corrupt entropy data seen; output is still bounded
+
+    rm690b0_jpeg_comp_t comp[3];
+    uint16_t qt[4][64];     // Zigzag order
+    rm690b0_jpeg_huff_t huff[2][2];     // [DC, AC][table]
+
+    // Entropy decoder
+    const uint8_t *p, *end;
+    uint32_t bits;          // MSB first
+    int32_t nbits;
+    bool marker;            // Stopped at a marker: feeding zeros
+    uint32_t mcus_left;     // Until the next restart marker
+
+    uint8_t planes[3][256]; // One MCU, per component, up to 2x2 blocks
+} rm690b0_jpeg_t;
+
+/**
+ * @brief Find the next JPEG (SOI .. EOI) in a stream of them (MJPEG)
+ * @param[out] start Offset of its SOI
+ * @param[out] len Bytes up to and including its EOI
+ * @return ESP_ERR_NOT_FOUND when no complete image follows
+ */
+esp_err_t rm690b0_jpeg_find(const void *data, size_t size, size_t *start, size_t *len);
+
+/**
+ * @brief Parse the headers up to the first scan
+ * @return ESP_ERR_NOT_SUPPORTED for progressive, arithmetic, 12-bit or
+ * non-interleaved colour images, ESP_ERR_INVALID_SIZE for images over
+ * RM_JPEG_MAX_W x RM_JPEG_MAX_H, ESP_ERR_INVALID_ARG for anything malformed
+ */
+esp_err_t rm690b0_jpeg_open(rm690b0_jpeg_t *jpeg, const void *data, size_t size);
+
+/**
+ * @brief Decode the next MCU row
+ * @param dst_be Top-left of the row's pixels, w columns by up to mcu_h rows
+ * @param stride Row pitch in pixels
+ * @return Rows written (mcu_h, fewer for the last row), 0 once all are done
+ */
+uint16_t rm690b0_jpeg_decode_rows(rm690b0_jpeg_t *jpeg, uint16_t *dst_be, size_t stride);
+
+/**
+ * @brief Decode the whole image
+ * @return ESP_ERR_INVALID_RESPONSE if the entropy data was corrupt (the
+ * image is decoded anyway, with garbage from there on)
+ */
+esp_err_t rm690b0_jpeg_decode(rm690b0_jpeg_t *jpeg, uint16_t *dst_be, size_t stride);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
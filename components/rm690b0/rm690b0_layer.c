@@ -0,0 +1,308 @@
+#include "rm690b0_layer.h"
+#include "rm690b0.h"
+#include "rm690b0_color.h"
+#include "rm690b0_damage.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "rm690b0_layer";
+
+#define LAYER_MAX_W         640     // Longest side of any rotation and then some
+#define LAYER_TILES_X       (LAYER_MAX_W / RM_LAYER_TILE_W + 1)
+
+struct rm690b0_layer {
+    uint16_t *px;           // PSRAM, w * h, mask behind it
+    uint8_t *mask;
+    int16_t x, y;
+    uint16_t w, h;
+    uint8_t alpha;
+    uint8_t z;
+    bool visible;
+};
+
+// Layers a tile of the current band has to visit, bottom first
+typedef struct {
+    int16_t x0, x1;         // Columns of the tile inside the area, x1 exclusive
+    bool bg;                // Starts from the background color
+    uint8_t count;
+    rm690b0_layer_t *list[RM_LAYER_MAX];
+} layer_tile_t;
+
+typedef struct {
+    const rm690b0_area_t *area;
+    int32_t band;           // Band the tiles were built for, -1: none yet
+    uint8_t ntiles;
+    layer_tile_t tiles[LAYER_TILES_X];
+} layer_compose_t;
+
+typedef struct {
+    bool ready;
+    uint16_t bg_be;
+    rm690b0_damage_t damage;
+    rm690b0_layer_t *stack[RM_LAYER_MAX];   // Bottom first
+    uint8_t count;
+    layer_compose_t compose;
+    rm690b0_layer_stats_t stats;
+} layer_ctx_t;
+
+static layer_ctx_t s_lc;
+
+// Clip a screen rectangle of any sign to the frame before marking it
+static void damage_rect(int32_t x, int32_t y, int32_t w, int32_t h) {
+    int32_t x1 = x + w, y1 = y + h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x1 > s_lc.damage.width) x1 = s_lc.damage.width;
+    if (y1 > s_lc.damage.height) y1 = s_lc.damage.height;
+    if (x >= x1 || y >= y1) return;
+    rm_damage_add(&s_lc.damage, (uint16_t)x, (uint16_t)y, (uint16_t)(x1 - x), (uint16_t)(y1 - y));
+}
+
+static void damage_layer(const rm690b0_layer_t *l) {
+    if (l->visible) damage_rect(l->x, l->y, l->w, l->h);
+}
+
+// --- Composition ---
+
+static bool layer_covers(const rm690b0_layer_t *l, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    return l->alpha == 255 && !l->mask &&
+           l->x <= x0 && l->x + l->w >= x1 && l->y <= y0 && l->y + l->h >= y1;
+}
+
+static void build_band(layer_compose_t *c, int32_t band) {
+    const rm690b0_area_t *a = c->area;
+    int32_t y0 = band * RM_LAYER_TILE_H;
+    int32_t y1 = y0 + RM_LAYER_TILE_H;
+    if (y0 < a->y1) y0 = a->y1;
+    if (y1 > a->y2 + 1) y1 = a->y2 + 1;
+
+    c->band = band;
+    c->ntiles = 0;
+    for (int32_t tx = a->x1 / RM_LAYER_TILE_W; tx <= a->x2 / RM_LAYER_TILE_W; tx++) {
+        layer_tile_t *t = &c->tiles[c->ntiles++];
+        int32_t x0 = tx * RM_LAYER_TILE_W;
+        int32_t x1 = x0 + RM_LAYER_TILE_W;
+        if (x0 < a->x1) x0 = a->x1;
+        if (x1 > a->x2 + 1) x1 = a->x2 + 1;
+        t->x0 = (int16_t)x0;
+        t->x1 = (int16_t)x1;
+        t->bg = true;
+        t->count = 0;
+
+        for (uint8_t i = 0; i < s_lc.count; i++) {
+            rm690b0_layer_t *l = s_lc.stack[i];
+            if (!l->visible || l->alpha == 0) continue;
+            if (l->x >= x1 || l->x + l->w <= x0 || l->y >= y1 || l->y + l->h <= y0) continue;
+            if (layer_covers(l, x0, y0, x1, y1)) {
+                // Everything below is hidden
+                s_lc.stats.culled += t->count;
+                t->count = 0;
+                t->bg = false;
+            }
+            t->list[t->count++] = l;
+        }
+    }
+    s_lc.stats.tiles += c->ntiles;
+}
+
+static void compose_tile(const layer_tile_t *t, int32_t ay, int32_t x0, int32_t x1, uint16_t *dst) {
+    if (t->bg) {
+        for (int32_t i = 0; i < x1 - x0; i++) dst[i] = s_lc.bg_be;
+    }
+    for (uint8_t i = 0; i < t->count; i++) {
+        const rm690b0_layer_t *l = t->list[i];
+        if (ay < l->y || ay >= l->y + l->h) continue;
+        int32_t c0 = (l->x > x0) ? l->x : x0;
+        int32_t c1 = (l->x + l->w < x1) ? l->x + l->w : x1;
+        if (c0 >= c1) continue;
+
+        size_t off = (size_t)(ay - l->y) * l->w + (size_t)(c0 - l->x);
+        size_t n = (size_t)(c1 - c0);
+        uint16_t *d = dst + (c0 - x0);
+        if (l->mask) {
+            rm_color_blend_be565_a8(d, l->px + off, l->mask + off, n, l->alpha);
+        } else {
+            rm_color_blend_be565(d, l->px + off, n, l->alpha);
+        }
+        s_lc.stats.layer_pixels += n;
+    }
+}
+
+// Row segments of one damaged area, composed tile by tile into the bounce buffer
+static void compose_gen(void *ctx, uint16_t x, uint16_t y, uint16_t n, uint16_t *dst) {
+    layer_compose_t *c = ctx;
+    int32_t ay = c->area->y1 + y;
+    int32_t band = ay / RM_LAYER_TILE_H;
+    if (band != c->band) build_band(c, band);
+
+    int32_t sx = c->area->x1 + x;
+    int32_t ex = sx + n;
+    for (uint8_t i = 0; i < c->ntiles; i++) {
+        const layer_tile_t *t = &c->tiles[i];
+        int32_t x0 = (t->x0 > sx) ? t->x0 : sx;
+        int32_t x1 = (t->x1 < ex) ? t->x1 : ex;
+        if (x0 < x1) compose_tile(t, ay, x0, x1, dst + (x0 - sx));
+    }
+}
+
+esp_err_t rm690b0_layers_compose(void) {
+    if (!s_lc.ready) return ESP_ERR_INVALID_STATE;
+
+    uint16_t width = rm690b0_get_width(), height = rm690b0_get_height();
+    if (width != s_lc.damage.width || height != s_lc.damage.height) {
+        rm_damage_init(&s_lc.damage, width, height, 0);
+        rm_damage_add_all(&s_lc.damage);
+    }
+    if (s_lc.damage.count == 0) return ESP_OK;
+
+    esp_err_t err = ESP_OK;
+    layer_compose_t *c = &s_lc.compose;
+    for (uint8_t i = 0; i < s_lc.damage.count && err == ESP_OK; i++) {
+        const rm690b0_area_t *a = &s_lc.damage.areas[i];
+        uint16_t w = a->x2 - a->x1 + 1, h = a->y2 - a->y1 + 1;
+        c->area = a;
+        c->band = -1;
+        rm690b0_source_t src;
+        rm690b0_source_generator(&src, compose_gen, c, w, h);
+        err = rm690b0_draw_source(a->x1, a->y1, w, h, &src);
+        s_lc.stats.areas++;
+        s_lc.stats.pixels += (uint32_t)w * h;
+    }
+    s_lc.stats.composes++;
+    rm_damage_reset(&s_lc.damage);
+    return err;
+}
+
+// --- Stack ---
+
+esp_err_t rm690b0_layers_init(uint16_t bg) {
+    rm690b0_layers_deinit();
+    s_lc.bg_be = rm_color_be(bg);
+    rm_damage_init(&s_lc.damage, rm690b0_get_width(), rm690b0_get_height(), 0);
+    rm_damage_add_all(&s_lc.damage);
+    memset(&s_lc.stats, 0, sizeof(s_lc.stats));
+    s_lc.ready = true;
+    return ESP_OK;
+}
+
+void rm690b0_layers_deinit(void) {
+    while (s_lc.count > 0) rm690b0_layer_destroy(s_lc.stack[s_lc.count - 1]);
+    s_lc.ready = false;
+}
+
+void rm690b0_layers_set_background(uint16_t bg) {
+    s_lc.bg_be = rm_color_be(bg);
+    rm_damage_add_all(&s_lc.damage);
+}
+
+void rm690b0_layers_mark_dirty(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    damage_rect(x, y, w, h);
+}
+
+void rm690b0_layers_get_stats(rm690b0_layer_stats_t *stats) {
+    *stats = s_lc.stats;
+}
+
+esp_err_t rm690b0_layer_create(const rm690b0_layer_config_t *config, rm690b0_layer_t **layer) {
+    if (!config || !layer || config->w == 0 || config->h == 0) return ESP_ERR_INVALID_ARG;
+    if (!s_lc.ready) return ESP_ERR_INVALID_STATE;
+    if (s_lc.count == RM_LAYER_MAX) return ESP_ERR_NO_MEM;
+
+    size_t pixels = (size_t)config->w * config->h;
+    size_t bytes = pixels * 2 + (config->mask ? pixels : 0);
+    rm690b0_layer_t *l = heap_caps_malloc(sizeof(*l), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    uint16_t *px = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+    if (!l || !px) {
+        ESP_LOGE(TAG, "OOM allocating %ux%u layer", config->w, config->h);
+        heap_caps_free(l);
+        heap_caps_free(px);
+        return ESP_ERR_NO_MEM;
+    }
+    memset(px, 0, bytes);
+    *l = (rm690b0_layer_t){
+        .px = px,
+        .mask = config->mask ? (uint8_t *)(px + pixels) : NULL,
+        .x = config->x, .y = config->y, .w = config->w, .h = config->h,
+        .alpha = config->alpha, .z = config->z, .visible = true,
+    };
+
+    // Above every layer with the same or a lower z
+    uint8_t pos = s_lc.count;
+    while (pos > 0 && s_lc.stack[pos - 1]->z > l->z) {
+        s_lc.stack[pos] = s_lc.stack[pos - 1];
+        pos--;
+    }
+    s_lc.stack[pos] = l;
+    s_lc.count++;
+
+    damage_layer(l);
+    *layer = l;
+    return ESP_OK;
+}
+
+void rm690b0_layer_destroy(rm690b0_layer_t *layer) {
+    if (!layer) return;
+    for (uint8_t i = 0; i < s_lc.count; i++) {
+        if (s_lc.stack[i] != layer) continue;
+        memmove(&s_lc.stack[i], &s_lc.stack[i + 1], (s_lc.count - i - 1) * sizeof(s_lc.stack[0]));
+        s_lc.count--;
+        break;
+    }
+    damage_layer(layer);
+    heap_caps_free(layer->px);
+    heap_caps_free(layer);
+}
+
+uint16_t *rm690b0_layer_pixels(rm690b0_layer_t *layer, size_t *stride) {
+    if (stride) *stride = layer->w;
+    return layer->px;
+}
+
+uint8_t *rm690b0_layer_mask(rm690b0_layer_t *layer) {
+    return layer->mask;
+}
+
+void rm690b0_layer_mark_dirty(rm690b0_layer_t *layer, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    if (!layer->visible) return;
+    if (x >= layer->w || y >= layer->h) return;
+    if (w > layer->w - x) w = layer->w - x;
+    if (h > layer->h - y) h = layer->h - y;
+    damage_rect(layer->x + x, layer->y + y, w, h);
+}
+
+void rm690b0_layer_fill(rm690b0_layer_t *layer, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                        uint16_t color, uint8_t coverage) {
+    if (x >= layer->w || y >= layer->h) return;
+    if (w > layer->w - x) w = layer->w - x;
+    if (h > layer->h - y) h = layer->h - y;
+
+    uint16_t be = rm_color_be(color);
+    for (uint16_t r = 0; r < h; r++) {
+        size_t off = (size_t)(y + r) * layer->w + x;
+        for (uint16_t i = 0; i < w; i++) layer->px[off + i] = be;
+        if (layer->mask) memset(layer->mask + off, coverage, w);
+    }
+    rm690b0_layer_mark_dirty(layer, x, y, w, h);
+}
+
+void rm690b0_layer_move(rm690b0_layer_t *layer, int16_t x, int16_t y) {
+    if (layer->x == x && layer->y == y) return;
+    damage_layer(layer);
+    layer->x = x;
+    layer->y = y;
+    damage_layer(layer);
+}
+
+void rm690b0_layer_set_alpha(rm690b0_layer_t *layer, uint8_t alpha) {
+    if (layer->alpha == alpha) return;
+    layer->alpha = alpha;
+    damage_layer(layer);
+}
+
+void rm690b0_layer_set_visible(rm690b0_layer_t *layer, bool visible) {
+    if (layer->visible == visible) return;
+    layer->visible = true;
+    damage_layer(layer);
+    layer->visible = visible;
+}
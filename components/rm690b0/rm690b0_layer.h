@@ -0,0 +1,136 @@
+#ifndef RM690B0_LAYER_H
+#define RM690B0_LAYER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Layer compositor.
+ *
+ * Layers are big-endian RGB565 bitmaps in PSRAM, placed anywhere on the
+ * screen (partly or fully off it) and stacked over a background color. Each
+ * has a constant opacity and, optionally, an A8 mask for per-pixel alpha.
+ *
+ * Nothing is drawn until rm690b0_layers_compose(): changes only mark screen
+ * areas dirty in a damage tracker (rm690b0_damage.h), and compose streams
+ * each dirty area as one window. Rows are composed straight into the
+ * driver's bounce buffers, bottom layer first, tile by tile: every
+ * RM_LAYER_TILE_W x RM_LAYER_TILE_H tile only visits the layers that
+ * overlap it, starting at the topmost one that covers it opaquely. Moving a
+ * layer marks its old and new bounds, so a toast or cursor costs about
+ * twice its own size, whatever lies underneath.
+ *
+ * Coordinates are screen pixels in the rotation current at compose time; a
+ * rotation change marks the whole screen dirty. Use from the task that owns
+ * the display, like the other draw calls.
+ */
+
+#define RM_LAYER_MAX        8       // Layers at once
+#define RM_LAYER_TILE_W     64      // Culling tile, columns
+#define RM_LAYER_TILE_H     16      // Culling tile, rows
+
+typedef struct rm690b0_layer rm690b0_layer_t;
+
+typedef struct {
+    int16_t x, y;           // Top-left on screen
+    uint16_t w, h;
+    uint8_t alpha;          // Layer opacity, 255: opaque
+    bool mask;              // Allocate an A8 mask (starts transparent)
+    uint8_t z;              // Higher on top; equal z: created later on top
+} rm690b0_layer_config_t;
+
+typedef struct {
+    uint32_t composes;      // rm690b0_layers_compose() calls that sent something
+    uint32_t areas;         // Windows opened
+    uint32_t pixels;        // Pixels sent
+    uint32_t tiles;         // Tiles composed
+    uint32_t culled;        // Layers skipped in a tile, hidden under an opaque one
+    uint32_t layer_pixels;  // Layer pixels copied or blended
+} rm690b0_layer_stats_t;
+
+/**
+ * @brief Start the compositor with an empty stack; marks the whole screen dirty
+ * @param bg Background color, RGB565 (native endian)
+ */
+esp_err_t rm690b0_layers_init(uint16_t bg);
+
+/**
+ * @brief Destroy every layer
+ */
+void rm690b0_layers_deinit(void);
+
+/**
+ * @brief Change the background color (marks the whole screen dirty)
+ */
+void rm690b0_layers_set_background(uint16_t bg);
+
+/**
+ * @brief Mark a screen area dirty, e.g. after drawing over it directly
+ */
+void rm690b0_layers_mark_dirty(int16_t x, int16_t y, uint16_t w, uint16_t h);
+
+/**
+ * @brief Send the dirty areas, composed, and start a new frame
+ */
+esp_err_t rm690b0_layers_compose(void);
+
+/**
+ * @brief Statistics since rm690b0_layers_init()
+ */
+void rm690b0_layers_get_stats(rm690b0_layer_stats_t *stats);
+
+/**
+ * @brief Allocate a layer in PSRAM. Pixels start black, the mask transparent.
+ * @return ESP_ERR_NO_MEM when out of PSRAM or RM_LAYER_MAX is reached
+ */
+esp_err_t rm690b0_layer_create(const rm690b0_layer_config_t *config, rm690b0_layer_t **layer);
+
+/**
+ * @brief Remove a layer from the stack and free it
+ */
+void rm690b0_layer_destroy(rm690b0_layer_t *layer);
+
+/**
+ * @brief Pixel buffer (big-endian RGB565). Call rm690b0_layer_mark_dirty() after writing.
+ * @param[out] stride Optional, row pitch in pixels
+ */
+uint16_t *rm690b0_layer_pixels(rm690b0_layer_t *layer, size_t *stride);
+
+/**
+ * @brief A8 mask, same pitch as the pixels; NULL without one
+ */
+uint8_t *rm690b0_layer_mask(rm690b0_layer_t *layer);
+
+/**
+ * @brief Mark an area of the layer dirty, in layer coordinates
+ */
+void rm690b0_layer_mark_dirty(rm690b0_layer_t *layer, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+/**
+ * @brief Fill a rectangle of the layer (clipped) and mark it dirty
+ * @param color RGB565 (native endian)
+ * @param coverage Mask value written alongside, ignored without a mask
+ */
+void rm690b0_layer_fill(rm690b0_layer_t *layer, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                        uint16_t color, uint8_t coverage);
+
+/**
+ * @brief Move a layer; its old and new bounds become dirty
+ */
+void rm690b0_layer_move(rm690b0_layer_t *layer, int16_t x, int16_t y);
+
+void rm690b0_layer_set_alpha(rm690b0_layer_t *layer, uint8_t alpha);
+
+void rm690b0_layer_set_visible(rm690b0_layer_t *layer, bool visible);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,415 @@
+#include "rm690b0_play.h"
+#include "rm690b0.h"
+#include "rm690b0_priv.h"
+#include "rm690b0_color.h"
+#include "rm690b0_jpeg.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "rm690b0_play";
+
+// Band buffers are sized for the longest side of any rotation
+#define PLAY_MAX_W          600
+#define PLAY_STACK          4096
+
+typedef struct {
+    uint16_t *buf;
+    uint32_t frame;             // Stream position, for pacing
+    uint16_t x, y, w, h;        // Frame window, w even
+    uint16_t rows;
+    bool first, last;
+    bool end;                   // No band: the decoder has finished
+    uint32_t decode_us;         // Whole frame, on its last band
+    uint32_t seq;               // Pipe sequence once pushed
+    int64_t queued_us;
+    volatile int64_t done_us;   // Set by the transfer ISR
+} play_band_t;
+
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t end;                 // Past the last frame, once a pass has found it
+    esp_partition_mmap_handle_t map;
+    bool mapped;
+
+    rm690b0_play_config_t config;
+    int64_t t0, t_end, period_us;
+    uint16_t screen_w, screen_h;
+    rm690b0_jpeg_t jpeg;        // Decoder task only
+
+    // Ring: the decoder fills band filled % N, the sender frees band freed % N
+    play_band_t bands[RM_PLAY_BUFFERS];
+    atomic_uint filled, freed;
+    TaskHandle_t sender, decoder;
+    volatile bool stop;
+    atomic_bool decoding;
+
+    SemaphoreHandle_t stats_lock;
+    rm690b0_play_stats_t stats;
+    uint64_t decode_sum, transmit_sum, wait_sum;
+} play_ctx_t;
+
+static play_ctx_t s_play;
+
+static void band_done(void *arg) {
+    *(volatile int64_t *)arg = esp_timer_get_time();
+}
+
+static void stats_add(uint32_t *counter) {
+    xSemaphoreTake(s_play.stats_lock, portMAX_DELAY);
+    (*counter)++;
+    xSemaphoreGive(s_play.stats_lock);
+}
+
+// --- Decoder task: read and decode stages ---
+
+// Next free band, NULL once stopped
+static play_band_t *band_get(void) {
+    while (atomic_load(&s_play.filled) - atomic_load(&s_play.freed) >= RM_PLAY_BUFFERS) {
+        if (s_play.stop) return NULL;
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    return s_play.stop ? NULL : &s_play.bands[atomic_load(&s_play.filled) % RM_PLAY_BUFFERS];
+}
+
+static void band_put(void) {
+    atomic_fetch_add(&s_play.filled, 1);
+    xTaskNotifyGive(s_play.sender);
+}
+
+// Decode one frame into bands; false once stopped
+static bool decode_frame(uint32_t frame, int64_t t_start) {
+    rm690b0_jpeg_t *j = &s_play.jpeg;
+    const rm690b0_play_config_t *cfg = &s_play.config;
+    // Odd widths go out with the last column repeated: windows end on odd columns
+    uint16_t w = (j->w + 1) & ~1u;
+    int32_t x = (cfg->x == RM_PLAY_CENTER) ? (s_play.screen_w - w) / 2 : cfg->x;
+    int32_t y = (cfg->y == RM_PLAY_CENTER) ? (s_play.screen_h - j->h) / 2 : cfg->y;
+    x &= ~1;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x + w > s_play.screen_w) x = s_play.screen_w - w;
+    if (y + j->h > s_play.screen_h) y = s_play.screen_h - j->h;
+    rm690b0_ifpf_t ifpf = rm_drv_stream()->ifpf;
+
+    uint32_t decode_us = (uint32_t)(esp_timer_get_time() - t_start);
+    for (uint16_t row = 0; row < j->h;) {
+        play_band_t *b = band_get();
+        if (!b) return false;
+        int64_t t1 = esp_timer_get_time();
+        // Whole MCU rows: 16 for 4:2:0, two of 8 otherwise
+        uint16_t rows = 0;
+        while (row + rows < j->h && rows + j->mcu_h <= RM_PLAY_BAND_ROWS) {
+            rows += rm690b0_jpeg_decode_rows(j, b->buf + (size_t)rows * w, w);
+        }
+        if (w != j->w) {
+            for (uint16_t r = 0; r < rows; r++) b->buf[(size_t)r * w + j->w] = b->buf[(size_t)r * w + j->w - 1];
+        }
+        if (ifpf != RM_IFPF_RGB565) rm_color_pack(ifpf, (uint8_t *)b->buf, b->buf, (size_t)w * rows);
+
+        b->frame = frame;
+        b->x = (uint16_t)x;
+        b->y = (uint16_t)y;
+        b->w = w;
+        b->h = j->h;
+        b->rows = rows;
+        b->first = row == 0;
+        row += rows;
+        b->last = row >= j->h;
+        b->end = false;
+        decode_us += (uint32_t)(esp_timer_get_time() - t1);
+        b->decode_us = decode_us;
+        band_put();
+    }
+    if (j->error) stats_add(&s_play.stats.errors);
+    return true;
+}
+
+static void decoder_task(void *arg) {
+    const rm690b0_play_config_t *cfg = &s_play.config;
+    size_t off = 0;
+    uint32_t frame = 0, good = 0;
+
+    while (!s_play.stop) {
+        int64_t t_start = esp_timer_get_time();
+        size_t limit = s_play.end ? s_play.end : s_play.size;
+        size_t start, len;
+        if (off >= limit || rm690b0_jpeg_find(s_play.data + off, limit - off, &start, &len) != ESP_OK) {
+            // End of a pass; the rest of a partition is not rescanned. A pass
+            // of bad frames only ends the run.
+            if (good == 0) break;
+            if (!s_play.end) s_play.end = off;
+            xSemaphoreTake(s_play.stats_lock, portMAX_DELAY);
+            uint32_t loops = ++s_play.stats.loops;
+            xSemaphoreGive(s_play.stats_lock);
+            if (cfg->loops && loops >= cfg->loops) break;
+            off = 0;
+            good = 0;
+            continue;
+        }
+        const uint8_t *jpg = s_play.data + off + start;
+        off += start + len;
+        uint32_t i = frame++;
+
+        // Already time for the next frame: this one would only delay it
+        if (cfg->drop && s_play.period_us && t_start > s_play.t0 + (int64_t)(i + 1) * s_play.period_us) {
+            good++;
+            stats_add(&s_play.stats.dropped);
+            continue;
+        }
+        esp_err_t ret = rm690b0_jpeg_open(&s_play.jpeg, jpg, len);
+        if (ret != ESP_OK || s_play.jpeg.w > s_play.screen_w || s_play.jpeg.h > s_play.screen_h) {
+            if (ret == ESP_OK) ESP_LOGW(TAG, "Frame %u is %ux%u, over the screen", (unsigned)i, s_play.jpeg.w, s_play.jpeg.h);
+            stats_add(&s_play.stats.bad);
+            continue;
+        }
+        good++;
+        if (!decode_frame(i, t_start)) break;
+    }
+
+    // Tell the sender there is nothing more
+    play_band_t *b = band_get();
+    if (b) {
+        b->end = true;
+        band_put();
+    }
+    atomic_store(&s_play.decoding, false);
+    xTaskNotifyGive(s_play.sender);
+    vTaskDelete(NULL);
+}
+
+// --- Sending task: transmit stage ---
+
+// Next decoded band, NULL once the decoder has finished
+static play_band_t *band_next(uint32_t n, uint32_t *wait_us) {
+    int64_t t0 = esp_timer_get_time();
+    while (atomic_load(&s_play.filled) == n) {
+        if (!atomic_load(&s_play.decoding)) return NULL;
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    *wait_us += (uint32_t)(esp_timer_get_time() - t0);
+    play_band_t *b = &s_play.bands[n % RM_PLAY_BUFFERS];
+    return b->end ? NULL : b;
+}
+
+// Bands up to n - 1 are on the panel: hand their buffers back
+static void band_free(uint32_t n) {
+    atomic_store(&s_play.freed, n);
+    xTaskNotifyGive(s_play.decoder);
+}
+
+// Wait until frame is due
+static void frame_pace(uint32_t frame) {
+    if (!s_play.period_us) return;
+    int64_t due = s_play.t0 + (int64_t)frame * s_play.period_us;
+    for (int64_t now = esp_timer_get_time(); now < due && !s_play.stop; now = esp_timer_get_time()) {
+        TickType_t ticks = pdMS_TO_TICKS((due - now) / 1000);
+        ulTaskNotifyTake(pdTRUE, ticks ? ticks : 1);
+    }
+}
+
+// Wire time of band k, once it is done: from when it was queued or the band
+// before it was done, whichever is later
+static uint32_t band_wire_us(uint32_t k, int64_t *last_done) {
+    play_band_t *b = &s_play.bands[k % RM_PLAY_BUFFERS];
+    int64_t start = (b->queued_us > *last_done) ? b->queued_us : *last_done;
+    *last_done = b->done_us;
+    return (b->done_us > start) ? (uint32_t)(b->done_us - start) : 0;
+}
+
+static esp_err_t play_send(void) {
+    rm690b0_stream_t *stream = rm_drv_stream();
+    rm690b0_pipe_t *pipe = rm_drv_pipe();
+    esp_err_t ret = ESP_OK;
+    uint32_t n = 0, wait_us = 0, transmit_us = 0;
+    int64_t last_done = 0;
+
+    play_band_t *b;
+    while (ret == ESP_OK && !s_play.stop && (b = band_next(n, &wait_us)) != NULL) {
+        if (b->first) {
+            frame_pace(b->frame);
+            ret = rm690b0_set_window(b->x, b->y, b->x + b->w - 1, b->y + b->h - 1);
+            if (ret != ESP_OK) break;
+            wait_us = 0;
+            transmit_us = 0;
+            last_done = 0;
+        }
+        size_t px = (size_t)b->w * b->rows;
+        size_t bytes = rm_ifpf_bytes(stream->ifpf, px);
+        if (stream->ifpf != RM_IFPF_RGB565) {
+            stream->ifpf_stats.pixels_packed += px;
+            stream->ifpf_stats.bytes_sent += bytes;
+            stream->ifpf_stats.bytes_saved += px * 2 - bytes;
+        }
+        b->queued_us = esp_timer_get_time();
+        b->done_us = 0;
+        ret = rm_pipe_push(pipe, b->buf, bytes, b->last, band_done, (void *)&b->done_us, &b->seq);
+        if (ret != ESP_OK) break;
+
+        // With this band queued behind it, the one before can finish while
+        // the decoder gets its buffer back
+        if (!b->first) {
+            ret = rm_pipe_wait_seq(pipe, s_play.bands[(n - 1) % RM_PLAY_BUFFERS].seq);
+            transmit_us += band_wire_us(n - 1, &last_done);
+            band_free(n);
+        }
+        n++;
+        if (!b->last || ret != ESP_OK) continue;
+
+        ret = rm_pipe_drain(pipe, RM_BUS_WAIT_FOREVER);
+        transmit_us += band_wire_us(n - 1, &last_done);
+        band_free(n);
+
+        xSemaphoreTake(s_play.stats_lock, portMAX_DELAY);
+        s_play.stats.frames++;
+        s_play.stats.w = b->w;
+        s_play.stats.h = b->h;
+        s_play.decode_sum += b->decode_us;
+        s_play.transmit_sum += transmit_us;
+        s_play.wait_sum += wait_us;
+        xSemaphoreGive(s_play.stats_lock);
+    }
+    esp_err_t dret = rm_pipe_drain(pipe, RM_BUS_WAIT_FOREVER);
+    return (ret == ESP_OK) ? dret : ret;
+}
+
+// --- API ---
+
+esp_err_t rm690b0_play_open_mem(const void *data, size_t size) {
+    if (!data || size == 0) return ESP_ERR_INVALID_ARG;
+    rm690b0_play_close();
+    s_play.data = data;
+    s_play.size = size;
+    return ESP_OK;
+}
+
+esp_err_t rm690b0_play_open_partition(const char *label) {
+    if (!label) label = RM_PLAY_PARTITION;
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (!part) {
+        ESP_LOGE(TAG, "No partition '%s'", label);
+        return ESP_ERR_NOT_FOUND;
+    }
+    // The stream is read where it lies: the flash cache fetches each frame as
+    // the decoder walks it, no copy
+    const void *ptr;
+    esp_partition_mmap_handle_t map;
+    esp_err_t ret = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &ptr, &map);
+    if (ret != ESP_OK) return ret;
+    ret = rm690b0_play_open_mem(ptr, part->size);
+    if (ret != ESP_OK) {
+        esp_partition_munmap(map);
+        return ret;
+    }
+    s_play.map = map;
+    s_play.mapped = true;
+    ESP_LOGI(TAG, "Video partition '%s': %u KB", label, (unsigned)(part->size / 1024));
+    return ESP_OK;
+}
+
+void rm690b0_play_close(void) {
+    if (s_play.mapped) esp_partition_munmap(s_play.map);
+    s_play.mapped = false;
+    s_play.data = NULL;
+    s_play.size = 0;
+    s_play.end = 0;
+}
+
+esp_err_t rm690b0_play_run(const rm690b0_play_config_t *config) {
+    if (!config) return ESP_ERR_INVALID_ARG;
+    if (!s_play.data || !rm_drv_pipe()) return ESP_ERR_INVALID_STATE;
+
+    if (!s_play.stats_lock) {
+        s_play.stats_lock = xSemaphoreCreateMutex();
+        if (!s_play.stats_lock) return ESP_ERR_NO_MEM;
+    }
+    size_t bytes = (size_t)PLAY_MAX_W * RM_PLAY_BAND_ROWS * 2;
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < RM_PLAY_BUFFERS && ret == ESP_OK; i++) {
+        s_play.bands[i].buf = heap_caps_aligned_alloc(16, bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!s_play.bands[i].buf) {
+            ESP_LOGE(TAG, "OOM allocating %u KB band buffers", (unsigned)(RM_PLAY_BUFFERS * bytes / 1024));
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+
+    if (ret == ESP_OK) {
+        s_play.config = *config;
+        s_play.screen_w = rm690b0_get_width();
+        s_play.screen_h = rm690b0_get_height();
+        s_play.period_us = config->fps ? 1000000 / config->fps : 0;
+        s_play.stop = false;
+        s_play.sender = xTaskGetCurrentTaskHandle();
+        atomic_store(&s_play.filled, 0);
+        atomic_store(&s_play.freed, 0);
+        atomic_store(&s_play.decoding, true);
+        memset(&s_play.stats, 0, sizeof(s_play.stats));
+        s_play.decode_sum = s_play.transmit_sum = s_play.wait_sum = 0;
+        s_play.t0 = esp_timer_get_time();
+        s_play.t_end = 0;
+
+        uint8_t prio = config->priority ? config->priority : 5;
+        if (xTaskCreatePinnedToCore(decoder_task, "rm_play", PLAY_STACK, NULL, prio, &s_play.decoder,
+                                    config->decode_core % portNUM_PROCESSORS) != pdPASS) {
+            atomic_store(&s_play.decoding, false);
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+
+    if (ret == ESP_OK) {
+        ret = play_send();
+        // Let the decoder see the stop and exit before the buffers go
+        s_play.stop = true;
+        xTaskNotifyGive(s_play.decoder);
+        while (atomic_load(&s_play.decoding)) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+        xSemaphoreTake(s_play.stats_lock, portMAX_DELAY);
+        s_play.t_end = esp_timer_get_time();
+        xSemaphoreGive(s_play.stats_lock);
+        if (ret == ESP_OK && s_play.stats.frames == 0) ret = ESP_ERR_NOT_FOUND;
+
+        rm690b0_play_stats_t st;
+        rm690b0_play_get_stats(&st);
+        ESP_LOGI(TAG, "%u frames, %u dropped, %u bad: decode %u us, transmit %u us, %.1f fps",
+                 (unsigned)st.frames, (unsigned)st.dropped, (unsigned)st.bad,
+                 (unsigned)st.decode_us, (unsigned)st.transmit_us, st.fps);
+    }
+
+    for (int i = 0; i < RM_PLAY_BUFFERS; i++) {
+        heap_caps_free(s_play.bands[i].buf);
+        s_play.bands[i].buf = NULL;
+    }
+    return ret;
+}
+
+void rm690b0_play_stop(void) {
+    s_play.stop = true;
+    if (atomic_load(&s_play.decoding)) {
+        xTaskNotifyGive(s_play.decoder);
+        xTaskNotifyGive(s_play.sender);
+    }
+}
+
+void rm690b0_play_get_stats(rm690b0_play_stats_t *stats) {
+    if (!s_play.stats_lock) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    xSemaphoreTake(s_play.stats_lock, portMAX_DELAY);
+    *stats = s_play.stats;
+    uint32_t n = stats->frames;
+    if (n) {
+        stats->decode_us = (uint32_t)(s_play.decode_sum / n);
+        stats->transmit_us = (uint32_t)(s_play.transmit_sum / n);
+        stats->wait_us = (uint32_t)(s_play.wait_sum / n);
+        int64_t elapsed = (s_play.t_end ? s_play.t_end : esp_timer_get_time()) - s_play.t0;
+        stats->fps = elapsed > 0 ? (float)n * 1e6f / (float)elapsed : 0.0f;
+    }
+    xSemaphoreGive(s_play.stats_lock);
+}
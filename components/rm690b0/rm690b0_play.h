@@ -0,0 +1,100 @@
+#ifndef RM690B0_PLAY_H
+#define RM690B0_PLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * MJPEG playback: concatenated baseline JPEGs (rm690b0_jpeg.h), as written by
+ *
+ *   ffmpeg -i in.mp4 -vf scale=600:450 -c:v mjpeg -q:v 5 -f mjpeg out.mjpeg
+ *
+ * and flashed to a data partition, or embedded in the app.
+ *
+ * Three stages overlap. The stream is memory-mapped, so reading is the flash
+ * cache filling behind the decoder as it walks the next frame. A decoder task
+ * on its own core turns MCU rows into bands in internal DMA-capable RAM, a
+ * ring of RM_PLAY_BUFFERS; the calling task sends each band as soon as it is
+ * decoded, the bands of a frame as one window and one RAMWR burst, and hands
+ * the buffer back once the band after it is on the wire. A 600x450 4:2:0 frame
+ * never exists whole anywhere: the ring is 4 x 600 x 16 pixels (75 KB).
+ *
+ * With a frame rate, frame i is shown at i / fps from the start. A decoder
+ * that falls behind by a whole frame skips frames (drop) rather than slowing
+ * the video down. Frames must fit the screen; they are centered unless placed.
+ */
+
+#define RM_PLAY_BUFFERS         4       // Band ring: one on the wire, one queued, two decoding
+#define RM_PLAY_BAND_ROWS       16      // One 4:2:0 MCU row, two of 4:4:4
+#define RM_PLAY_CENTER          INT16_MIN
+#define RM_PLAY_PARTITION       "video"
+
+typedef struct {
+    uint16_t fps;           // Target rate, 0: as fast as frames decode
+    int16_t x, y;           // Frame position, RM_PLAY_CENTER: centered
+    bool drop;              // Skip frames to keep up with fps
+    uint16_t loops;         // Passes over the stream, 0: until stopped
+    uint8_t decode_core;    // Core of the decoder task, the other one from the display owner
+    uint8_t priority;       // Decoder task, 0: 5
+} rm690b0_play_config_t;
+
+typedef struct {
+    uint32_t frames;        // Shown
+    uint32_t dropped;       // Skipped to keep up with fps
+    uint32_t bad;           // Not decodable or larger than the screen, skipped
+    uint32_t errors;        // Shown with corrupt entropy data
+    uint32_t loops;         // Passes completed
+    uint16_t w, h;          // Last frame
+    // Means per frame shown
+    uint32_t decode_us;     // Finding, decoding and packing its bands
+    uint32_t transmit_us;   // Its bands on the wire
+    uint32_t wait_us;       // Sending task blocked on the decoder
+    float fps;              // Frames shown per second since the start
+} rm690b0_play_stats_t;
+
+/**
+ * @brief Play from memory: an embedded file, a buffer
+ */
+esp_err_t rm690b0_play_open_mem(const void *data, size_t size);
+
+/**
+ * @brief Map a data partition holding the stream; trailing erased flash is fine
+ * @param label Partition label, NULL for RM_PLAY_PARTITION
+ */
+esp_err_t rm690b0_play_open_partition(const char *label);
+
+/**
+ * @brief Unmap the stream. Not while playing.
+ */
+void rm690b0_play_close(void);
+
+/**
+ * @brief Play the stream, blocking until the last pass ends or
+ * rm690b0_play_stop(). Call from the task that owns the display; the decoder
+ * runs on its own task meanwhile.
+ * @return ESP_ERR_NOT_FOUND if no frame could be shown
+ */
+esp_err_t rm690b0_play_run(const rm690b0_play_config_t *config);
+
+/**
+ * @brief Make rm690b0_play_run() return, from any task. The frame being sent
+ * may be left incomplete.
+ */
+void rm690b0_play_stop(void);
+
+/**
+ * @brief Statistics of the current or last run, from any task
+ */
+void rm690b0_play_get_stats(rm690b0_play_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
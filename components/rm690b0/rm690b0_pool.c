@@ -0,0 +1,116 @@
+#include "rm690b0_pool.h"
+#include <string.h>
+
+void rm_pool_init(rm690b0_pool_t *pool, rm690b0_pipe_t *pipe, uint16_t **bufs, uint8_t count, size_t pixels) {
+    memset(pool, 0, sizeof(*pool));
+    if (count > RM_POOL_MAX_BUFS) count = RM_POOL_MAX_BUFS;
+
+    pool->pipe = pipe;
+    pool->count = count;
+    pool->pixels = pixels;
+    for (uint8_t i = 0; i < count; i++) {
+        pool->buf[i] = bufs[i];
+        pool->seq[i] = pipe->chunks;
+    }
+}
+
+// Chunks up to seq have left the wire (sequence numbers wrap)
+static bool pool_seq_done(const rm690b0_pool_t *pool, uint32_t seq) {
+    const rm690b0_pipe_t *p = pool->pipe;
+    return p->inflight == 0 || (int32_t)(p->reaped - seq) >= 0;
+}
+
+static void pool_hold(rm690b0_pool_t *pool, uint8_t i) {
+    if (pool->refs[i]++ == 0) {
+        pool->stats.in_use++;
+        if (pool->stats.in_use > pool->stats.high_water) {
+            pool->stats.high_water = pool->stats.in_use;
+        }
+    }
+    pool->stats.acquires++;
+}
+
+esp_err_t rm_pool_acquire(rm690b0_pool_t *pool, uint8_t *idx) {
+    uint8_t best = RM_POOL_MAX_BUFS;
+    int rank_best = 0;
+
+    // Prefer a completed plain buffer, then a completed solid one (keeps the
+    // color cache alive), then the one released longest ago.
+    for (uint8_t i = 0; i < pool->count; i++) {
+        if (pool->refs[i] > 0) continue;
+
+        int rank = pool_seq_done(pool, pool->seq[i]) ? (pool->solid[i] ? 2 : 3) : 1;
+        if (rank > rank_best ||
+            (rank == 1 && rank_best == 1 && (int32_t)(pool->seq[i] - pool->seq[best]) < 0)) {
+            best = i;
+            rank_best = rank;
+        }
+    }
+
+    if (best == RM_POOL_MAX_BUFS) {
+        pool->stats.exhausted++;
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if (rank_best == 1) {
+        pool->stats.waits++;
+        esp_err_t ret = rm_pipe_wait_seq(pool->pipe, pool->seq[best]);
+        if (ret != ESP_OK) return ret;
+    } else {
+        pool->stats.hits++;
+    }
+
+    pool->solid[best] = false;
+    pool_hold(pool, best);
+    *idx = best;
+    return ESP_OK;
+}
+
+esp_err_t rm_pool_acquire_solid(rm690b0_pool_t *pool, uint16_t color_be, size_t count, uint8_t *idx) {
+    if (count > pool->pixels) count = pool->pixels;
+
+    for (uint8_t i = 0; i < pool->count; i++) {
+        if (!pool->solid[i] || pool->color[i] != color_be) continue;
+
+        // Chunks in flight only read the first solid_len pixels, so growing
+        // the fill behind them is safe without waiting.
+        uint16_t *b = pool->buf[i];
+        for (size_t k = pool->solid_len[i]; k < count; k++) b[k] = color_be;
+        if (count > pool->solid_len[i]) pool->solid_len[i] = count;
+
+        pool->stats.solid_hits++;
+        pool->stats.hits++;
+        pool_hold(pool, i);
+        *idx = i;
+        return ESP_OK;
+    }
+
+    uint8_t i;
+    esp_err_t ret = rm_pool_acquire(pool, &i);
+    if (ret != ESP_OK) return ret;
+
+    uint16_t *b = pool->buf[i];
+    for (size_t k = 0; k < count; k++) b[k] = color_be;
+    pool->solid[i] = true;
+    pool->color[i] = color_be;
+    pool->solid_len[i] = count;
+    *idx = i;
+    return ESP_OK;
+}
+
+void rm_pool_release(rm690b0_pool_t *pool, uint8_t idx) {
+    if (idx >= pool->count || pool->refs[idx] == 0) return;
+
+    // Everything queued so far may reference the buffer
+    pool->seq[idx] = pool->pipe->chunks;
+    if (--pool->refs[idx] == 0) {
+        pool->stats.in_use--;
+    }
+}
+
+uint8_t rm_pool_index(const rm690b0_pool_t *pool, const uint16_t *buf) {
+    for (uint8_t i = 0; i < pool->count; i++) {
+        if (pool->buf[i] == buf) return i;
+    }
+    return RM_POOL_MAX_BUFS;
+}
@@ -0,0 +1,87 @@
+#ifndef RM690B0_POOL_H
+#define RM690B0_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "rm690b0_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Pool of persistent DMA scratch buffers.
+ *
+ * Buffers are allocated once by the owner and recycled through the pipeline
+ * sequence numbers: a released buffer becomes free again once the last chunk
+ * queued before its release has left the wire. Solid-color buffers are kept
+ * filled and shared read-only, so repeated fills of the same color never touch
+ * the buffer again.
+ */
+
+#define RM_POOL_MAX_BUFS    4
+
+typedef struct {
+    uint32_t acquires;      // Successful acquisitions
+    uint32_t hits;          // Buffer was free without waiting for the wire
+    uint32_t waits;         // Had to wait for an in-flight chunk
+    uint32_t solid_hits;    // Solid requests served by an already filled buffer
+    uint32_t exhausted;     // Requests failed because every buffer was held
+    uint8_t in_use;         // Buffers currently held
+    uint8_t high_water;     // Most buffers held at once
+} rm690b0_pool_stats_t;
+
+typedef struct {
+    rm690b0_pipe_t *pipe;
+    uint16_t *buf[RM_POOL_MAX_BUFS];
+    uint32_t seq[RM_POOL_MAX_BUFS];     // Pipe sequence at release, free once reaped
+    uint8_t refs[RM_POOL_MAX_BUFS];     // Holders; solid buffers can be shared
+    bool solid[RM_POOL_MAX_BUFS];       // Holds solid_len pixels of color
+    uint16_t color[RM_POOL_MAX_BUFS];   // Big-endian
+    size_t solid_len[RM_POOL_MAX_BUFS];
+    uint8_t count;
+    size_t pixels;                      // Capacity of each buffer
+    rm690b0_pool_stats_t stats;
+} rm690b0_pool_t;
+
+/**
+ * @brief Bind a pool to a pipeline and its buffers
+ * @param bufs DMA-capable buffers of `pixels` RGB565 pixels each
+ * @param count Number of buffers, at most RM_POOL_MAX_BUFS
+ */
+void rm_pool_init(rm690b0_pool_t *pool, rm690b0_pipe_t *pipe, uint16_t **bufs, uint8_t count, size_t pixels);
+
+/**
+ * @brief Take a buffer for writing. Waits for the wire if every free buffer
+ * is still referenced by queued chunks.
+ * @param[out] idx Buffer index
+ * @return ESP_ERR_NOT_FOUND when every buffer is held
+ */
+esp_err_t rm_pool_acquire(rm690b0_pool_t *pool, uint8_t *idx);
+
+/**
+ * @brief Take a read-only buffer holding at least `count` pixels of one color.
+ * @param color_be Big-endian RGB565
+ * @param count Pixels needed, clamped to the buffer capacity
+ * @param[out] idx Buffer index
+ */
+esp_err_t rm_pool_acquire_solid(rm690b0_pool_t *pool, uint16_t color_be, size_t count, uint8_t *idx);
+
+/**
+ * @brief Return a buffer. Chunks queued from it so far must complete before
+ * it is handed out for writing again.
+ */
+void rm_pool_release(rm690b0_pool_t *pool, uint8_t idx);
+
+/**
+ * @brief Index of a buffer pointer, RM_POOL_MAX_BUFS if it is not from the pool
+ */
+uint8_t rm_pool_index(const rm690b0_pool_t *pool, const uint16_t *buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
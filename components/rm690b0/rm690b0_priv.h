@@ -0,0 +1,52 @@
+#ifndef RM690B0_PRIV_H
+#define RM690B0_PRIV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "rm690b0_bus.h"
+#include "rm690b0_stream.h"
+#include "rm690b0_damage.h"
+
+/*
+ * Shared between the rm690b0 source files. Not part of the public API.
+ */
+
+/**
+ * @brief Streaming engine of the display (bound to the driver's bounce buffers)
+ */
+rm690b0_stream_t *rm_drv_stream(void);
+
+/**
+ * @brief Queued pixel pipeline of the display
+ */
+rm690b0_pipe_t *rm_drv_pipe(void);
+
+/**
+ * @brief Send a list of areas from a big-endian image in one pass and drain.
+ * @param copy Always go through the internal bounce buffers (PSRAM sources)
+ */
+esp_err_t rm_drv_flush_areas(const rm690b0_area_t *areas, uint8_t count,
+                             const uint16_t *img, size_t stride, bool copy);
+
+/**
+ * @brief Clip and stream a source sub-rectangle without draining.
+ * @param[out] zero_copy Set when source rows are still referenced by queued chunks
+ */
+esp_err_t rm_drv_blit(const uint16_t *src_be, size_t stride, uint16_t sx, uint16_t sy,
+                      uint16_t w, uint16_t h, int32_t dx, int32_t dy, bool *zero_copy);
+
+/**
+ * @brief CASET and RASET parameters of a window in the current rotation, as
+ * rm690b0_set_window() sends them (panel offsets applied, x widened to even)
+ */
+void rm_drv_window_params(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+                          uint8_t caset[4], uint8_t raset[4]);
+
+/**
+ * @brief Switch the format on the wire for the next bursts without changing the
+ * one selected by rm690b0_set_interface_format(). COLMOD is queued only on change.
+ */
+esp_err_t rm_drv_use_ifpf(rm690b0_ifpf_t fmt);
+
+#endif
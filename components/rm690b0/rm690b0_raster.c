@@ -0,0 +1,432 @@
+#include "rm690b0_raster.h"
+#include "rm690b0_color.h"
+#include <math.h>
+#include <string.h>
+
+#define PI_F        3.14159265f
+#define COV_FULL    (256 / RM_RASTER_SUBSAMPLES)   // Coverage of one sub-scanline across a pixel
+
+static inline float minf(float a, float b) { return a < b ? a : b; }
+static inline float maxf(float a, float b) { return a > b ? a : b; }
+
+// --- Shapes ---
+
+static void shape_bounds_of_points(rm_shape_t *s) {
+    const rm_pointf_t *p = s->u.poly.pts;
+    s->x0 = s->x1 = p[0].x;
+    s->y0 = s->y1 = p[0].y;
+    for (uint16_t i = 1; i < s->u.poly.n; i++) {
+        s->x0 = minf(s->x0, p[i].x);
+        s->x1 = maxf(s->x1, p[i].x);
+        s->y0 = minf(s->y0, p[i].y);
+        s->y1 = maxf(s->y1, p[i].y);
+    }
+}
+
+void rm_shape_line(rm_shape_t *s, float x0, float y0, float x1, float y1, float width) {
+    // Pixel centres, ends stretched by half a pixel so both end pixels are drawn
+    float dx = x1 - x0, dy = y1 - y0;
+    float len = sqrtf(dx * dx + dy * dy);
+    float ux = 1.0f, uy = 0.0f;
+    if (len > 0.0f) {
+        ux = dx / len;
+        uy = dy / len;
+    }
+    float hw = maxf(width, 1.0f) * 0.5f;
+    float ax = x0 + 0.5f - ux * 0.5f, ay = y0 + 0.5f - uy * 0.5f;
+    float bx = x1 + 0.5f + ux * 0.5f, by = y1 + 0.5f + uy * 0.5f;
+    float nx = -uy * hw, ny = ux * hw;
+
+    s->type = RM_SHAPE_POLYGON;
+    s->u.poly.n = 4;
+    s->u.poly.pts[0] = (rm_pointf_t){ ax + nx, ay + ny };
+    s->u.poly.pts[1] = (rm_pointf_t){ bx + nx, by + ny };
+    s->u.poly.pts[2] = (rm_pointf_t){ bx - nx, by - ny };
+    s->u.poly.pts[3] = (rm_pointf_t){ ax - nx, ay - ny };
+    shape_bounds_of_points(s);
+}
+
+// A radius of r covers 2r + 1 pixels across, like the integer circle algorithms
+static void shape_ring(rm_shape_t *s, float cx, float cy, float r, float thickness) {
+    float ro = maxf(r, 0.0f) + 0.5f;
+    s->type = RM_SHAPE_RING;
+    s->u.ring.cx = cx + 0.5f;
+    s->u.ring.cy = cy + 0.5f;
+    s->u.ring.r = ro;
+    s->u.ring.r_in = (thickness > 0.0f) ? maxf(ro - thickness, 0.0f) : 0.0f;
+    s->u.ring.arc = false;
+    s->x0 = s->u.ring.cx - ro;
+    s->x1 = s->u.ring.cx + ro;
+    s->y0 = s->u.ring.cy - ro;
+    s->y1 = s->u.ring.cy + ro;
+}
+
+void rm_shape_circle(rm_shape_t *s, float cx, float cy, float r, float thickness) {
+    shape_ring(s, cx, cy, r, thickness);
+}
+
+void rm_shape_arc(rm_shape_t *s, float cx, float cy, float r, float thickness,
+                  float start_deg, float end_deg) {
+    shape_ring(s, cx, cy, r, thickness);
+    float span = end_deg - start_deg;
+    if (span >= 360.0f || span <= -360.0f) return;
+    span = fmodf(span, 360.0f);
+    if (span < 0.0f) span += 360.0f;
+    float a0 = fmodf(start_deg, 360.0f);
+    if (a0 < 0.0f) a0 += 360.0f;
+    s->u.ring.arc = true;
+    s->u.ring.a0 = a0 * (PI_F / 180.0f);
+    s->u.ring.a1 = (a0 + span) * (PI_F / 180.0f);
+}
+
+void rm_shape_round_rect(rm_shape_t *s, float x, float y, float w, float h, float radius, float thickness) {
+    w = maxf(w, 0.0f);
+    h = maxf(h, 0.0f);
+    s->type = RM_SHAPE_RRECT;
+    s->u.rrect.x0 = x;
+    s->u.rrect.y0 = y;
+    s->u.rrect.x1 = x + w;
+    s->u.rrect.y1 = y + h;
+    s->u.rrect.r = minf(maxf(radius, 0.0f), minf(w, h) * 0.5f);
+    s->u.rrect.t = (thickness > 0.0f && thickness * 2.0f < minf(w, h)) ? thickness : 0.0f;
+    s->x0 = x;
+    s->y0 = y;
+    s->x1 = x + w;
+    s->y1 = y + h;
+}
+
+void rm_shape_polygon(rm_shape_t *s, const rm_pointf_t *pts, uint16_t n) {
+    if (n > RM_RASTER_MAX_POINTS) n = RM_RASTER_MAX_POINTS;
+    s->type = RM_SHAPE_POLYGON;
+    s->u.poly.n = n;
+    for (uint16_t i = 0; i < n; i++) {
+        s->u.poly.pts[i] = (rm_pointf_t){ pts[i].x + 0.5f, pts[i].y + 0.5f };
+    }
+    if (n == 0) {
+        s->x0 = s->x1 = s->y0 = s->y1 = 0.0f;
+        return;
+    }
+    shape_bounds_of_points(s);
+}
+
+// --- Scanline intervals ---
+// Each returns the number of [iv[2i], iv[2i+1]) pairs at height sy, sorted and disjoint
+
+typedef struct {
+    float x;
+    int8_t dir;
+} crossing_t;
+
+static int poly_intervals(const rm_shape_t *s, float sy, float *iv) {
+    crossing_t xs[RM_RASTER_MAX_POINTS];
+    const rm_pointf_t *p = s->u.poly.pts;
+    uint16_t n = s->u.poly.n;
+    int nx = 0;
+
+    for (uint16_t i = 0; i < n; i++) {
+        const rm_pointf_t *a = &p[i], *b = &p[(i + 1 == n) ? 0 : i + 1];
+        if (a->y == b->y) continue;
+        int8_t dir = 1;
+        if (a->y > b->y) {
+            const rm_pointf_t *t = a;
+            a = b;
+            b = t;
+            dir = -1;
+        }
+        if (sy < a->y || sy >= b->y) continue;
+        float x = a->x + (sy - a->y) * (b->x - a->x) / (b->y - a->y);
+        // Insertion sort, polygons are small
+        int j = nx++;
+        while (j > 0 && xs[j - 1].x > x) {
+            xs[j] = xs[j - 1];
+            j--;
+        }
+        xs[j] = (crossing_t){ x, dir };
+    }
+
+    // Non-zero winding
+    int count = 0, wind = 0;
+    for (int i = 0; i < nx && count < RM_RASTER_MAX_IV; i++) {
+        int before = wind;
+        wind += xs[i].dir;
+        if (before == 0 && wind != 0) {
+            iv[count * 2] = xs[i].x;
+        } else if (before != 0 && wind == 0) {
+            if (xs[i].x > iv[count * 2]) {
+                iv[count * 2 + 1] = xs[i].x;
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+static bool in_arc(const rm_shape_t *s, float x, float sy) {
+    float a = atan2f(sy - s->u.ring.cy, x - s->u.ring.cx);
+    float t = a - s->u.ring.a0;
+    while (t < 0.0f) t += 2.0f * PI_F;
+    while (t >= 2.0f * PI_F) t -= 2.0f * PI_F;
+    return t <= s->u.ring.a1 - s->u.ring.a0;
+}
+
+// Cut [a, b) at the arc's boundary rays and keep the pieces inside the sector
+static int arc_clip(const rm_shape_t *s, float sy, float a, float b, float *iv, int count) {
+    float cuts[4] = { a };
+    int nc = 1;
+    float dy = sy - s->u.ring.cy;
+    float ang[2] = { s->u.ring.a0, s->u.ring.a1 };
+    for (int i = 0; i < 2; i++) {
+        float sn = sinf(ang[i]);
+        if (fabsf(sn) < 1e-6f) continue;
+        float t = dy / sn;
+        if (t <= 0.0f) continue;
+        float x = s->u.ring.cx + t * cosf(ang[i]);
+        if (x > a && x < b) {
+            int j = nc++;
+            while (j > 1 && cuts[j - 1] > x) {
+                cuts[j] = cuts[j - 1];
+                j--;
+            }
+            cuts[j] = x;
+        }
+    }
+    cuts[nc] = b;
+
+    for (int i = 0; i < nc && count < RM_RASTER_MAX_IV; i++) {
+        float l = cuts[i], r = cuts[i + 1];
+        if (r <= l || !in_arc(s, (l + r) * 0.5f, sy)) continue;
+        if (count > 0 && iv[count * 2 - 1] == l) {
+            iv[count * 2 - 1] = r;
+        } else {
+            iv[count * 2] = l;
+            iv[count * 2 + 1] = r;
+            count++;
+        }
+    }
+    return count;
+}
+
+static int ring_intervals(const rm_shape_t *s, float sy, float *iv) {
+    float dy = sy - s->u.ring.cy;
+    float ro = s->u.ring.r, ri = s->u.ring.r_in;
+    if (dy * dy >= ro * ro) return 0;
+    float ho = sqrtf(ro * ro - dy * dy);
+    float cx = s->u.ring.cx;
+
+    float spans[4];
+    int n;
+    if (dy * dy < ri * ri) {
+        float hi = sqrtf(ri * ri - dy * dy);
+        spans[0] = cx - ho;
+        spans[1] = cx - hi;
+        spans[2] = cx + hi;
+        spans[3] = cx + ho;
+        n = 2;
+    } else {
+        spans[0] = cx - ho;
+        spans[1] = cx + ho;
+        n = 1;
+    }
+    if (!s->u.ring.arc) {
+        memcpy(iv, spans, n * 2 * sizeof(float));
+        return n;
+    }
+    int count = 0;
+    for (int i = 0; i < n; i++) count = arc_clip(s, sy, spans[i * 2], spans[i * 2 + 1], iv, count);
+    return count;
+}
+
+// Horizontal extent of a rounded rectangle at sy
+static bool rrect_extent(float x0, float y0, float x1, float y1, float r, float sy, float *a, float *b) {
+    if (sy < y0 || sy >= y1) return false;
+    float d = 0.0f;
+    if (sy < y0 + r) d = y0 + r - sy;
+    else if (sy > y1 - r) d = sy - (y1 - r);
+    float inset = r - sqrtf(maxf(r * r - d * d, 0.0f));
+    *a = x0 + inset;
+    *b = x1 - inset;
+    return *b > *a;
+}
+
+static int rrect_intervals(const rm_shape_t *s, float sy, float *iv) {
+    float x0 = s->u.rrect.x0, y0 = s->u.rrect.y0, x1 = s->u.rrect.x1, y1 = s->u.rrect.y1;
+    float r = s->u.rrect.r, t = s->u.rrect.t;
+    float a, b, c, d;
+    if (!rrect_extent(x0, y0, x1, y1, r, sy, &a, &b)) return 0;
+    if (t <= 0.0f || !rrect_extent(x0 + t, y0 + t, x1 - t, y1 - t, maxf(r - t, 0.0f), sy, &c, &d)) {
+        iv[0] = a;
+        iv[1] = b;
+        return 1;
+    }
+    iv[0] = a;
+    iv[1] = c;
+    iv[2] = d;
+    iv[3] = b;
+    return 2;
+}
+
+static int shape_intervals(const rm_shape_t *s, float sy, float *iv) {
+    switch (s->type) {
+    case RM_SHAPE_POLYGON:
+        return poly_intervals(s, sy, iv);
+    case RM_SHAPE_RING:
+        return ring_intervals(s, sy, iv);
+    case RM_SHAPE_RRECT:
+        return rrect_intervals(s, sy, iv);
+    default:
+        return 0;
+    }
+}
+
+// --- Rasterizer ---
+
+void rm_raster_init(rm_raster_t *r, int16_t w, int16_t h, bool aa) {
+    if (w > RM_RASTER_MAX_W) w = RM_RASTER_MAX_W;
+    r->clip_x0 = 0;
+    r->clip_y0 = 0;
+    r->clip_x1 = w;
+    r->clip_y1 = h;
+    r->aa = aa;
+    r->spans = 0;
+    memset(r->cov, 0, sizeof(r->cov));
+}
+
+void rm_raster_set_clip(rm_raster_t *r, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > RM_RASTER_MAX_W) x1 = RM_RASTER_MAX_W;
+    r->clip_x0 = x0;
+    r->clip_y0 = y0;
+    r->clip_x1 = (x1 > x0) ? x1 : x0;
+    r->clip_y1 = (y1 > y0) ? y1 : y0;
+}
+
+bool rm_raster_bounds(const rm_raster_t *r, const rm_shape_t *s,
+                      int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1) {
+    float fx0 = maxf(floorf(s->x0), r->clip_x0), fy0 = maxf(floorf(s->y0), r->clip_y0);
+    float fx1 = minf(ceilf(s->x1), r->clip_x1), fy1 = minf(ceilf(s->y1), r->clip_y1);
+    if (fx1 <= fx0 || fy1 <= fy0) return false;
+    *x0 = (int16_t)fx0;
+    *y0 = (int16_t)fy0;
+    *x1 = (int16_t)fx1;
+    *y1 = (int16_t)fy1;
+    return true;
+}
+
+// Without anti-aliasing a pixel is in when its centre is
+static void row_solid(rm_raster_t *r, const rm_shape_t *s, int16_t y, rm_span_fn_t fn, void *ctx) {
+    float iv[RM_RASTER_MAX_IV * 2];
+    int n = shape_intervals(s, y + 0.5f, iv);
+    int32_t run_x = 0, run_end = -1;
+
+    for (int i = 0; i < n; i++) {
+        int32_t xa = (int32_t)ceilf(iv[i * 2] - 0.5f);
+        int32_t xb = (int32_t)ceilf(iv[i * 2 + 1] - 0.5f);
+        if (xa < r->clip_x0) xa = r->clip_x0;
+        if (xb > r->clip_x1) xb = r->clip_x1;
+        if (xb <= xa) continue;
+        if (xa <= run_end) {
+            if (xb > run_end) run_end = xb;
+            continue;
+        }
+        if (run_end > run_x) {
+            fn(ctx, (int16_t)run_x, y, (uint16_t)(run_end - run_x), 255);
+            r->spans++;
+        }
+        run_x = xa;
+        run_end = xb;
+    }
+    if (run_end > run_x) {
+        fn(ctx, (int16_t)run_x, y, (uint16_t)(run_end - run_x), 255);
+        r->spans++;
+    }
+}
+
+static inline void cov_add(uint16_t *cov, int32_t x, float amount) {
+    cov[x] += (uint16_t)(amount * COV_FULL + 0.5f);
+}
+
+// Sub-scanlines with exact horizontal coverage, then runs of equal alpha
+static void row_aa(rm_raster_t *r, const rm_shape_t *s, int16_t y, rm_span_fn_t fn, void *ctx) {
+    float iv[RM_RASTER_MAX_IV * 2];
+    uint16_t *cov = r->cov;
+    int32_t lo = r->clip_x1, hi = r->clip_x0;
+
+    for (int k = 0; k < RM_RASTER_SUBSAMPLES; k++) {
+        float sy = y + (k + 0.5f) / RM_RASTER_SUBSAMPLES;
+        int n = shape_intervals(s, sy, iv);
+        for (int i = 0; i < n; i++) {
+            float a = maxf(iv[i * 2], r->clip_x0);
+            float b = minf(iv[i * 2 + 1], r->clip_x1);
+            if (b <= a) continue;
+            int32_t ia = (int32_t)a, ib = (int32_t)b;
+            if (ia < lo) lo = ia;
+            if (ia == ib) {
+                cov_add(cov, ia, b - a);
+                if (ia >= hi) hi = ia + 1;
+                continue;
+            }
+            cov_add(cov, ia, (ia + 1) - a);
+            for (int32_t x = ia + 1; x < ib; x++) cov[x] += COV_FULL;
+            if (ib < r->clip_x1 && b > ib) {
+                cov_add(cov, ib, b - ib);
+                ib++;
+            }
+            if (ib > hi) hi = ib;
+        }
+    }
+
+    int32_t x = lo;
+    while (x < hi) {
+        uint16_t c = cov[x];
+        uint8_t alpha = (c > 255) ? 255 : (uint8_t)c;
+        int32_t start = x;
+        while (x < hi) {
+            uint16_t d = cov[x];
+            if (((d > 255) ? 255 : d) != alpha) break;
+            cov[x++] = 0;
+        }
+        if (alpha) {
+            fn(ctx, (int16_t)start, y, (uint16_t)(x - start), alpha);
+            r->spans++;
+        }
+    }
+}
+
+void rm_raster_row(rm_raster_t *r, const rm_shape_t *s, int16_t y, rm_span_fn_t fn, void *ctx) {
+    if (y < r->clip_y0 || y >= r->clip_y1) return;
+    if (r->aa) row_aa(r, s, y, fn, ctx);
+    else row_solid(r, s, y, fn, ctx);
+}
+
+void rm_raster_fill(rm_raster_t *r, const rm_shape_t *s, rm_span_fn_t fn, void *ctx) {
+    int16_t x0, y0, x1, y1;
+    if (!rm_raster_bounds(r, s, &x0, &y0, &x1, &y1)) return;
+    for (int16_t y = y0; y < y1; y++) rm_raster_row(r, s, y, fn, ctx);
+}
+
+// --- Sinks ---
+
+uint16_t rm_raster_blend(uint16_t fg, uint16_t bg, uint8_t alpha) {
+    if (alpha >= 248) return fg;
+    if (alpha < 8) return bg;
+    // Green in the top half, red and blue below: all three channels in one multiply
+    uint32_t a = (alpha + 4) >> 3;
+    uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x07E0F81F;
+    uint32_t b = (bg | ((uint32_t)bg << 16)) & 0x07E0F81F;
+    uint32_t m = ((f * a + b * (32 - a)) >> 5) & 0x07E0F81F;
+    return (uint16_t)(m | (m >> 16));
+}
+
+void rm_raster_canvas_span(void *ctx, int16_t x, int16_t y, uint16_t len, uint8_t alpha) {
+    rm_raster_canvas_t *c = ctx;
+    uint16_t *p = c->px + (size_t)y * c->stride + x;
+    if (alpha == 255) {
+        uint16_t be = rm_color_be(c->color);
+        for (uint16_t i = 0; i < len; i++) p[i] = be;
+        return;
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        p[i] = rm_color_be(rm_raster_blend(c->color, rm_color_be(p[i]), alpha));
+    }
+}
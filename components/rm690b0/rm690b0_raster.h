@@ -0,0 +1,163 @@
+#ifndef RM690B0_RASTER_H
+#define RM690B0_RASTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Span rasterizer for lines, circles, arcs, rounded rectangles and polygons.
+ *
+ * Plain C without ESP-IDF dependencies. Shapes are reduced, one scanline at a
+ * time, to sorted disjoint x intervals; the rasterizer turns those into
+ * horizontal spans of constant coverage and hands them to a sink. Without
+ * anti-aliasing every span is opaque. With it, each row is sampled on four
+ * sub-scanlines with exact horizontal coverage, so edges come out as short
+ * spans of partial alpha next to opaque interior spans.
+ *
+ * Coordinates are pixels: integer points (line ends, circle centres, polygon
+ * vertices) sit on pixel centres; rectangles are given by their edges like
+ * rm690b0_fill_rect(), so (x, y, w, h) covers exactly w x h pixels.
+ * Angles are degrees, clockwise from 3 o'clock (screen Y points down).
+ *
+ * Sinks: rm_raster_canvas_span() blends into a big-endian RGB565 buffer;
+ * rm690b0_draw_shape() (rm690b0_shape.c) and rm690b0_fb_draw_shape() build on it.
+ */
+
+#define RM_RASTER_MAX_W         640     // Widest clip area (coverage row)
+#define RM_RASTER_MAX_IV        32      // Intervals per scanline
+#define RM_RASTER_MAX_POINTS    64      // Polygon vertices
+#define RM_RASTER_SUBSAMPLES    4       // Anti-aliasing sub-scanlines per row
+
+typedef struct {
+    float x, y;
+} rm_pointf_t;
+
+typedef enum {
+    RM_SHAPE_POLYGON,
+    RM_SHAPE_RING,          // Filled circle, ring or arc
+    RM_SHAPE_RRECT,         // Rounded rectangle, filled or outline
+} rm_shape_type_t;
+
+/**
+ * A shape in continuous pixel space. Build with the rm_shape_*() helpers.
+ */
+typedef struct {
+    uint8_t type;
+    float x0, y0, x1, y1;   // Bounds
+    union {
+        struct {
+            rm_pointf_t pts[RM_RASTER_MAX_POINTS];
+            uint16_t n;
+        } poly;
+        struct {
+            float cx, cy, r, r_in;
+            bool arc;
+            float a0, a1;   // Radians, a0 <= a1 < a0 + 2pi
+        } ring;
+        struct {
+            float x0, y0, x1, y1, r;
+            float t;        // Outline width, 0: filled
+        } rrect;
+    } u;
+} rm_shape_t;
+
+/**
+ * @brief Line of the given width with butt ends (width <= 1: one pixel, no gaps)
+ */
+void rm_shape_line(rm_shape_t *s, float x0, float y0, float x1, float y1, float width);
+
+/**
+ * @brief Circle around a pixel centre, 2r + 1 pixels across
+ * @param thickness Ring width towards the centre, 0: filled
+ */
+void rm_shape_circle(rm_shape_t *s, float cx, float cy, float r, float thickness);
+
+/**
+ * @brief Arc of a ring (or a pie slice with thickness 0) from start to end, clockwise
+ */
+void rm_shape_arc(rm_shape_t *s, float cx, float cy, float r, float thickness,
+                  float start_deg, float end_deg);
+
+/**
+ * @brief Rounded rectangle by its edges
+ * @param thickness Outline width, 0: filled. radius 0 gives square corners.
+ */
+void rm_shape_round_rect(rm_shape_t *s, float x, float y, float w, float h, float radius, float thickness);
+
+/**
+ * @brief Polygon through pixel centres, closed implicitly. Concave and
+ * self-intersecting outlines use the non-zero winding rule.
+ * @param n Up to RM_RASTER_MAX_POINTS, more are dropped
+ */
+void rm_shape_polygon(rm_shape_t *s, const rm_pointf_t *pts, uint16_t n);
+
+/**
+ * @brief Receive one span: len pixels from (x, y), coverage alpha (255: opaque).
+ * Spans of one row arrive left to right without overlap, rows top to bottom.
+ */
+typedef void (*rm_span_fn_t)(void *ctx, int16_t x, int16_t y, uint16_t len, uint8_t alpha);
+
+typedef struct {
+    int16_t clip_x0, clip_y0, clip_x1, clip_y1;     // x1, y1 exclusive
+    bool aa;
+    uint32_t spans;                                 // Spans emitted since init
+    uint16_t cov[RM_RASTER_MAX_W];                  // Coverage accumulator, 256 = full
+} rm_raster_t;
+
+/**
+ * @brief Clip to (0, 0, w, h)
+ * @param aa Anti-alias edges
+ */
+void rm_raster_init(rm_raster_t *r, int16_t w, int16_t h, bool aa);
+
+/**
+ * @brief Narrow the clip rectangle (x1, y1 exclusive), within the init size
+ */
+void rm_raster_set_clip(rm_raster_t *r, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+/**
+ * @brief Clipped pixel bounds of a shape
+ * @return false if nothing is visible
+ */
+bool rm_raster_bounds(const rm_raster_t *r, const rm_shape_t *s,
+                      int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1);
+
+/**
+ * @brief Rasterize one row of a shape
+ */
+void rm_raster_row(rm_raster_t *r, const rm_shape_t *s, int16_t y, rm_span_fn_t fn, void *ctx);
+
+/**
+ * @brief Rasterize a whole shape, rows top to bottom
+ */
+void rm_raster_fill(rm_raster_t *r, const rm_shape_t *s, rm_span_fn_t fn, void *ctx);
+
+/**
+ * @brief Blend two native RGB565 colors, alpha 255 gives fg
+ */
+uint16_t rm_raster_blend(uint16_t fg, uint16_t bg, uint8_t alpha);
+
+/**
+ * Canvas sink context: big-endian RGB565 pixels, (0, 0) at px
+ */
+typedef struct {
+    uint16_t *px;
+    size_t stride;          // Pixels
+    uint16_t color;         // Native RGB565
+} rm_raster_canvas_t;
+
+/**
+ * @brief rm_span_fn_t that blends ctx->color into a rm_raster_canvas_t
+ */
+void rm_raster_canvas_span(void *ctx, int16_t x, int16_t y, uint16_t len, uint8_t alpha);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,246 @@
+#include "rm690b0_sched.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "rm690b0_sched";
+
+#define SCHED_STACK     4096
+#define SCHED_CONSUMER  RM_SCHED_MAX_WORKERS
+
+// Jobs dealt to one worker, oldest at head. The owner takes from the head,
+// thieves and the consumer from wherever they need.
+typedef struct {
+    SemaphoreHandle_t lock;
+    uint32_t jobs[RM_SCHED_MAX_JOBS];
+    uint32_t head, tail;
+} sched_deque_t;
+
+typedef struct {
+    TaskHandle_t task;
+    atomic_uint jobs, steals, sleeps;   // Read by rm690b0_sched_get_stats()
+} sched_worker_t;
+
+static sched_deque_t s_deques[RM_SCHED_MAX_WORKERS];
+static sched_worker_t s_workers[RM_SCHED_MAX_WORKERS];
+static uint8_t s_count;
+static volatile bool s_running;
+static EventGroupHandle_t s_exited; // A bit per worker, set as it exits
+static EventBits_t s_started;       // Workers deinit waits for
+
+// Current batch, written by the consumer before it submits anything
+static rm690b0_sched_fn_t s_fn;
+static void *s_ctx;
+static TaskHandle_t s_consumer;
+static bool s_in_batch;
+static atomic_uint s_pending;
+static atomic_uint s_done[RM_SCHED_MAX_JOBS];   // job + 1 once done
+static rm690b0_sched_stats_t s_stats;           // Consumer side only
+
+// --- Deques ---
+
+static bool deque_push(sched_deque_t *d, uint32_t job) {
+    xSemaphoreTake(d->lock, portMAX_DELAY);
+    bool ok = d->tail - d->head < RM_SCHED_MAX_JOBS;
+    if (ok) d->jobs[d->tail++ % RM_SCHED_MAX_JOBS] = job;
+    xSemaphoreGive(d->lock);
+    return ok;
+}
+
+static bool deque_take_head(sched_deque_t *d, uint32_t *job) {
+    xSemaphoreTake(d->lock, portMAX_DELAY);
+    bool ok = d->head != d->tail;
+    if (ok) *job = d->jobs[d->head++ % RM_SCHED_MAX_JOBS];
+    xSemaphoreGive(d->lock);
+    return ok;
+}
+
+static bool deque_take_tail(sched_deque_t *d, uint32_t *job) {
+    xSemaphoreTake(d->lock, portMAX_DELAY);
+    bool ok = d->head != d->tail;
+    if (ok) *job = d->jobs[--d->tail % RM_SCHED_MAX_JOBS];
+    xSemaphoreGive(d->lock);
+    return ok;
+}
+
+// Take `job` if it is still at the head, i.e. nobody has started it
+static bool deque_take_job(sched_deque_t *d, uint32_t job) {
+    xSemaphoreTake(d->lock, portMAX_DELAY);
+    bool ok = d->head != d->tail && d->jobs[d->head % RM_SCHED_MAX_JOBS] == job;
+    if (ok) d->head++;
+    xSemaphoreGive(d->lock);
+    return ok;
+}
+
+// --- Running jobs ---
+
+static void job_run(uint32_t job, uint8_t worker) {
+    // The next batch may begin as soon as the last job is counted done
+    TaskHandle_t consumer = s_consumer;
+    s_fn(s_ctx, job, worker);
+    atomic_store_explicit(&s_done[job % RM_SCHED_MAX_JOBS], job + 1, memory_order_release);
+    atomic_fetch_sub_explicit(&s_pending, 1, memory_order_release);
+    if (worker != SCHED_CONSUMER) xTaskNotifyGive(consumer);
+}
+
+static bool job_is_done(uint32_t job) {
+    return atomic_load_explicit(&s_done[job % RM_SCHED_MAX_JOBS], memory_order_acquire) == job + 1;
+}
+
+static void worker_task(void *arg) {
+    uint8_t id = (uint8_t)(uintptr_t)arg;
+    sched_worker_t *w = &s_workers[id];
+
+    while (s_running) {
+        uint32_t job;
+        bool got = deque_take_head(&s_deques[id], &job);
+        // Steal the newest job of the next worker that has one
+        for (uint8_t i = 1; !got && i < s_count; i++) {
+            got = deque_take_tail(&s_deques[(id + i) % s_count], &job);
+            if (got) atomic_fetch_add_explicit(&w->steals, 1, memory_order_relaxed);
+        }
+        if (got) {
+            atomic_fetch_add_explicit(&w->jobs, 1, memory_order_relaxed);
+            job_run(job, id);
+        } else {
+            atomic_fetch_add_explicit(&w->sleeps, 1, memory_order_relaxed);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+
+    xEventGroupSetBits(s_exited, 1u << id);
+    vTaskDelete(NULL);
+}
+
+// --- API ---
+
+esp_err_t rm690b0_sched_init(const rm690b0_sched_config_t *config) {
+    if (!config || config->workers == 0 || config->workers > RM_SCHED_MAX_WORKERS) return ESP_ERR_INVALID_ARG;
+    if (s_running) return ESP_ERR_INVALID_STATE;
+
+    if (!s_exited) {
+        s_exited = xEventGroupCreate();
+        if (!s_exited) return ESP_ERR_NO_MEM;
+    }
+    xEventGroupClearBits(s_exited, (1u << RM_SCHED_MAX_WORKERS) - 1);
+    memset(s_workers, 0, sizeof(s_workers));
+    for (uint8_t i = 0; i < config->workers; i++) {
+        s_deques[i].head = s_deques[i].tail = 0;
+        s_deques[i].lock = xSemaphoreCreateMutex();
+        if (!s_deques[i].lock) {
+            s_count = i;
+            rm690b0_sched_deinit();
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    s_count = config->workers;
+    s_running = true;
+    for (uint8_t i = 0; i < config->workers; i++) {
+        BaseType_t ok;
+        if (config->pin) {
+            ok = xTaskCreatePinnedToCore(worker_task, "rm_sched", SCHED_STACK, (void *)(uintptr_t)i,
+                                         config->priority, &s_workers[i].task, i % portNUM_PROCESSORS);
+        } else {
+            ok = xTaskCreate(worker_task, "rm_sched", SCHED_STACK, (void *)(uintptr_t)i,
+                             config->priority, &s_workers[i].task);
+        }
+        if (ok != pdPASS) {
+            ESP_LOGE(TAG, "Cannot start worker %u", i);
+            rm690b0_sched_deinit();
+            return ESP_ERR_NO_MEM;
+        }
+        s_started |= 1u << i;
+    }
+    memset(&s_stats, 0, sizeof(s_stats));
+    ESP_LOGI(TAG, "%u render workers%s", config->workers, config->pin ? ", pinned" : "");
+    return ESP_OK;
+}
+
+void rm690b0_sched_deinit(void) {
+    s_running = false;
+    for (uint8_t i = 0; i < s_count; i++) {
+        if (s_workers[i].task) xTaskNotifyGive(s_workers[i].task);
+    }
+    if (s_started) xEventGroupWaitBits(s_exited, s_started, pdTRUE, pdTRUE, portMAX_DELAY);
+    s_started = 0;
+
+    for (uint8_t i = 0; i < s_count; i++) {
+        if (s_deques[i].lock) vSemaphoreDelete(s_deques[i].lock);
+        s_deques[i].lock = NULL;
+        s_workers[i].task = NULL;
+    }
+    s_count = 0;
+}
+
+uint8_t rm690b0_sched_workers(void) {
+    return s_running ? s_count : 0;
+}
+
+esp_err_t rm690b0_sched_begin(rm690b0_sched_fn_t fn, void *ctx) {
+    if (!s_running) return ESP_ERR_INVALID_STATE;
+    if (!fn || s_in_batch) return ESP_ERR_INVALID_ARG;
+    s_fn = fn;
+    s_ctx = ctx;
+    s_consumer = xTaskGetCurrentTaskHandle();
+    for (int i = 0; i < RM_SCHED_MAX_JOBS; i++) atomic_store_explicit(&s_done[i], 0, memory_order_relaxed);
+    s_in_batch = true;
+    s_stats.batches++;
+    return ESP_OK;
+}
+
+void rm690b0_sched_submit(uint32_t job) {
+    atomic_fetch_add_explicit(&s_pending, 1, memory_order_relaxed);
+    s_stats.jobs++;
+    if (!deque_push(&s_deques[job % s_count], job)) {
+        // Over RM_SCHED_MAX_JOBS outstanding: run it here rather than lose it
+        ESP_LOGW(TAG, "Job %u over the deque depth", (unsigned)job);
+        job_run(job, SCHED_CONSUMER);
+        s_stats.helped++;
+        s_stats.per_worker[SCHED_CONSUMER]++;
+        return;
+    }
+    // Any idle worker may steal it
+    for (uint8_t i = 0; i < s_count; i++) xTaskNotifyGive(s_workers[i].task);
+}
+
+void rm690b0_sched_wait(uint32_t job) {
+    if (job_is_done(job)) return;
+    if (deque_take_job(&s_deques[job % s_count], job)) {
+        job_run(job, SCHED_CONSUMER);
+        s_stats.helped++;
+        s_stats.per_worker[SCHED_CONSUMER]++;
+        return;
+    }
+    // Running on a worker, which notifies when done
+    while (!job_is_done(job)) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+void rm690b0_sched_end(void) {
+    if (!s_in_batch) return;
+    while (atomic_load_explicit(&s_pending, memory_order_acquire) > 0) {
+        uint32_t job;
+        bool got = false;
+        for (uint8_t i = 0; !got && i < s_count; i++) got = deque_take_head(&s_deques[i], &job);
+        if (got) {
+            job_run(job, SCHED_CONSUMER);
+            s_stats.helped++;
+            s_stats.per_worker[SCHED_CONSUMER]++;
+        } else {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+        }
+    }
+    s_in_batch = false;
+}
+
+void rm690b0_sched_get_stats(rm690b0_sched_stats_t *stats) {
+    *stats = s_stats;
+    for (uint8_t i = 0; i < s_count; i++) {
+        stats->steals += atomic_load_explicit(&s_workers[i].steals, memory_order_relaxed);
+        stats->sleeps += atomic_load_explicit(&s_workers[i].sleeps, memory_order_relaxed);
+        stats->per_worker[i] = atomic_load_explicit(&s_workers[i].jobs, memory_order_relaxed);
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef RM690B0_SCHED_H
+#define RM690B0_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Parallel render scheduler.
+ *
+ * A pool of worker tasks, optionally pinned one per core, runs numbered jobs
+ * (bands, tiles) for a single consumer: the task that owns the display, which
+ * submits jobs as their buffers free up and collects them in job order to
+ * send them, scanline order for bands.
+ *
+ * Every worker has a deque. Submitted jobs are dealt round-robin; a worker
+ * runs the oldest job of its own deque and, once that is empty, steals the
+ * newest job of another. A consumer waiting for a job that has not started
+ * yet runs it itself, so jobs never wait behind a busy worker and a pool of
+ * one still overlaps rendering with sending.
+ *
+ * Jobs of one batch must not depend on each other; whatever they share must
+ * be read-only or locked. The outcome then does not depend on which worker
+ * ran what.
+ */
+
+#define RM_SCHED_MAX_WORKERS    4
+#define RM_SCHED_MAX_JOBS       32      // Jobs submitted and not yet waited for
+
+/**
+ * @brief Run one job
+ * @param worker 0 .. workers - 1, or workers for the consumer
+ */
+typedef void (*rm690b0_sched_fn_t)(void *ctx, uint32_t job, uint8_t worker);
+
+typedef struct {
+    uint8_t workers;        // Worker tasks, 1 .. RM_SCHED_MAX_WORKERS
+    uint8_t priority;
+    bool pin;               // Pin worker i to core i % cores, else unpinned
+} rm690b0_sched_config_t;
+
+typedef struct {
+    uint32_t batches;
+    uint32_t jobs;
+    uint32_t steals;        // Jobs a worker took from another worker's deque
+    uint32_t helped;        // Jobs the waiting consumer ran itself
+    uint32_t sleeps;        // Times a worker found every deque empty
+    uint32_t per_worker[RM_SCHED_MAX_WORKERS + 1];  // Jobs run, the consumer last
+} rm690b0_sched_stats_t;
+
+/**
+ * @brief Start the worker tasks
+ */
+esp_err_t rm690b0_sched_init(const rm690b0_sched_config_t *config);
+
+/**
+ * @brief Stop the workers; waits for them to exit. Call between batches.
+ */
+void rm690b0_sched_deinit(void);
+
+/**
+ * @brief Worker tasks running, 0 when stopped
+ */
+uint8_t rm690b0_sched_workers(void);
+
+/**
+ * @brief Start a batch: job numbers restart at 0
+ */
+esp_err_t rm690b0_sched_begin(rm690b0_sched_fn_t fn, void *ctx);
+
+/**
+ * @brief Hand job `job` to the workers. At most RM_SCHED_MAX_JOBS submitted
+ * jobs may be waiting to be collected.
+ */
+void rm690b0_sched_submit(uint32_t job);
+
+/**
+ * @brief Wait until job `job` is done; runs it on the calling task if no
+ * worker has started it. Jobs are collected in order.
+ */
+void rm690b0_sched_wait(uint32_t job);
+
+/**
+ * @brief Wait for every submitted job and close the batch
+ */
+void rm690b0_sched_end(void);
+
+void rm690b0_sched_get_stats(rm690b0_sched_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
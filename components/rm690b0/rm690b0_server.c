@@ -0,0 +1,379 @@
+#include "rm690b0_server.h"
+#include "rm690b0_priv.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "rm690b0_srv";
+
+_Static_assert((RM_SERVER_QUEUE_LEN & (RM_SERVER_QUEUE_LEN - 1)) == 0, "ring length must be a power of two");
+
+/*
+ * Bounded MPSC ring (Vyukov). Each slot carries a sequence number: a slot at
+ * position p is free for a producer when seq == p and holds a command for the
+ * consumer when seq == p + 1. Producers claim positions with a CAS on head;
+ * the single consumer owns tail.
+ */
+typedef struct {
+    atomic_uint seq;
+    rm690b0_cmd_t cmd;
+} rm_ring_slot_t;
+
+static rm_ring_slot_t s_ring[RM_SERVER_QUEUE_LEN];
+static atomic_uint s_head;
+static uint32_t s_tail;
+static atomic_uint s_completed;     // Commands completed, in submission order
+static bool s_ring_ready = false;
+
+static TaskHandle_t s_task = NULL;     // Owned by start/stop
+static atomic_bool s_running;
+static SemaphoreHandle_t s_stopped;     // Given by the task once it has drained
+
+// Producer-side counters
+static atomic_uint s_submitted;
+static atomic_uint s_full;
+static atomic_uint s_timeouts;
+// Server-side counters
+static rm690b0_server_stats_t s_stats;
+
+static void ring_init(void) {
+    for (uint32_t i = 0; i < RM_SERVER_QUEUE_LEN; i++) {
+        atomic_store_explicit(&s_ring[i].seq, i, memory_order_relaxed);
+    }
+    atomic_store(&s_head, 0);
+    s_tail = 0;
+    atomic_store(&s_completed, 0);
+    s_ring_ready = true;
+}
+
+// ESP_ERR_NO_MEM when full. A claimed slot must be published, so a command
+// that loses the race with stop goes in as a no-op and fails: the server has
+// either seen the claim and drains it, or a later server pops the no-op.
+static esp_err_t ring_push(const rm690b0_cmd_t *cmd, uint32_t *pos_out) {
+    uint32_t pos = atomic_load_explicit(&s_head, memory_order_relaxed);
+    for (;;) {
+        rm_ring_slot_t *slot = &s_ring[pos & (RM_SERVER_QUEUE_LEN - 1)];
+        uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int32_t dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            // Sequentially consistent against the stop flag (see server_task)
+            if (atomic_compare_exchange_weak(&s_head, &pos, pos + 1)) {
+                bool running = atomic_load(&s_running);
+                if (running) {
+                    slot->cmd = *cmd;
+                } else {
+                    slot->cmd = (rm690b0_cmd_t){ .type = RM_CMD_FENCE };
+                }
+                atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+                *pos_out = pos;
+                return running ? ESP_OK : ESP_ERR_INVALID_STATE;
+            }
+            // pos was reloaded by the failed CAS
+        } else if (dif < 0) {
+            return ESP_ERR_NO_MEM; // Full: the consumer has not freed this slot yet
+        } else {
+            pos = atomic_load_explicit(&s_head, memory_order_relaxed);
+        }
+    }
+}
+
+static bool ring_pop(rm690b0_cmd_t *cmd) {
+    rm_ring_slot_t *slot = &s_ring[s_tail & (RM_SERVER_QUEUE_LEN - 1)];
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (seq != s_tail + 1) return false; // Empty, or claimed but not yet written
+    *cmd = slot->cmd;
+    atomic_store_explicit(&slot->seq, s_tail + RM_SERVER_QUEUE_LEN, memory_order_release);
+    s_tail++;
+    return true;
+}
+
+// --- Coalescing ---
+
+static bool is_barrier(const rm690b0_cmd_t *c) {
+    return c->type == RM_CMD_ROTATE || c->type == RM_CMD_CALL;
+}
+
+static bool is_draw(const rm690b0_cmd_t *c) {
+    return c->type == RM_CMD_FILL || c->type == RM_CMD_BITMAP ||
+           c->type == RM_CMD_FILL_SCREEN || c->type == RM_CMD_TEST_PATTERN;
+}
+
+// True when `a` overwrites every pixel `b` touches
+static bool covers(const rm690b0_cmd_t *a, const rm690b0_cmd_t *b) {
+    if (a->type == RM_CMD_FILL_SCREEN || a->type == RM_CMD_TEST_PATTERN) return true;
+    if (a->type != RM_CMD_FILL && a->type != RM_CMD_BITMAP) return false;
+    if (b->type != RM_CMD_FILL && b->type != RM_CMD_BITMAP) return false;
+    return a->x <= b->x && a->y <= b->y &&
+           (uint32_t)a->x + a->w >= (uint32_t)b->x + b->w &&
+           (uint32_t)a->y + a->h >= (uint32_t)b->y + b->h;
+}
+
+static void coalesce(const rm690b0_cmd_t *batch, bool *skip, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        skip[i] = false;
+        if (i + 1 == n) break;
+
+        if (batch[i].type == RM_CMD_ROTATE) {
+            skip[i] = (batch[i + 1].type == RM_CMD_ROTATE);
+        } else if (is_draw(&batch[i])) {
+            for (size_t j = i + 1; j < n && !is_barrier(&batch[j]); j++) {
+                if (covers(&batch[j], &batch[i])) {
+                    skip[i] = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// --- Server ---
+
+static esp_err_t execute(const rm690b0_cmd_t *c) {
+    if (c->type == RM_CMD_FENCE) return ESP_OK;
+
+    // Per-command interface format; COLMOD goes out only when it changes
+    esp_err_t ret = rm_drv_use_ifpf(c->ifpf ? (rm690b0_ifpf_t)c->ifpf : rm690b0_get_interface_format());
+    if (ret != ESP_OK) return ret;
+
+    rm690b0_source_t src;
+    switch (c->type) {
+        case RM_CMD_FILL:
+            rm690b0_source_solid(&src, c->color, (size_t)c->w * c->h);
+            return rm690b0_draw_source(c->x, c->y, c->w, c->h, &src);
+        case RM_CMD_FILL_SCREEN:
+            return rm690b0_fill_screen(c->color);
+        case RM_CMD_BITMAP:
+            // Clipped, and streamed without the per-call drain: the batch flush below covers it
+            return rm_drv_blit(c->data, c->stride, 0, 0, c->w, c->h, c->x, c->y, NULL);
+        case RM_CMD_ROTATE:
+            rm690b0_set_rotation(c->rotation);
+            return ESP_OK;
+        case RM_CMD_TEST_PATTERN:
+            rm690b0_run_test_pattern();
+            return ESP_OK;
+        case RM_CMD_CALL:
+            if (c->fn) c->fn(c->ctx);
+            return ESP_OK;
+        default:
+            return ESP_OK;
+    }
+}
+
+size_t rm690b0_server_pump(void) {
+    // Server task only, kept off its stack
+    static rm690b0_cmd_t batch[RM_SERVER_BATCH];
+    static bool skip[RM_SERVER_BATCH];
+    size_t total = 0;
+
+    if (!s_ring_ready) return 0;
+
+    for (;;) {
+        uint32_t depth = atomic_load_explicit(&s_head, memory_order_relaxed) - s_tail;
+        if (depth > s_stats.depth_max) s_stats.depth_max = (uint16_t)depth;
+
+        size_t n = 0;
+        while (n < RM_SERVER_BATCH && ring_pop(&batch[n])) n++;
+        if (n == 0) break;
+
+        coalesce(batch, skip, n);
+        for (size_t i = 0; i < n; i++) {
+            if (skip[i]) {
+                s_stats.coalesced++;
+                continue;
+            }
+            esp_err_t ret = execute(&batch[i]);
+            if (ret != ESP_OK) {
+                s_stats.errors++;
+                ESP_LOGW(TAG, "Command %d failed: %s", batch[i].type, esp_err_to_name(ret));
+            }
+            s_stats.executed++;
+        }
+
+        // Bitmaps are referenced zero-copy until here
+        rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+        s_stats.batches++;
+
+        for (size_t i = 0; i < n; i++) {
+            atomic_fetch_add_explicit(&s_completed, 1, memory_order_release);
+            if (batch[i].done_cb) batch[i].done_cb(batch[i].done_ctx);
+        }
+        total += n;
+    }
+    return total;
+}
+
+static void wake_server(void) {
+    TaskHandle_t task = s_task; // Cleared by stop once the task has exited
+    if (task) xTaskNotifyGive(task);
+}
+
+static void server_task(void *pvParameters) {
+    ESP_LOGI(TAG, "Display Server Started");
+
+    while (atomic_load(&s_running)) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+        rm690b0_server_pump();
+    }
+    // Drain what was queued before stop. A producer that claimed a slot
+    // before the flag cleared (its claim is then visible in head) may still
+    // be writing it; wait for it rather than leave its command behind.
+    rm690b0_server_pump();
+    while (atomic_load(&s_head) != s_tail) {
+        vTaskDelay(1);
+        rm690b0_server_pump();
+    }
+
+    // The last access to the ring: a new server may start once stop has this
+    xSemaphoreGive(s_stopped);
+    vTaskDelete(NULL);
+}
+
+esp_err_t rm690b0_server_start(uint8_t priority, int core) {
+    if (atomic_load(&s_running)) return ESP_OK;
+    if (!rm690b0_get_bus()) return ESP_ERR_INVALID_STATE;
+
+    if (!s_stopped) {
+        s_stopped = xSemaphoreCreateBinary();
+        if (!s_stopped) return ESP_ERR_NO_MEM;
+    }
+    if (!s_ring_ready) ring_init();
+
+    atomic_store(&s_running, true);
+    BaseType_t ok;
+    if (core < 0) {
+        ok = xTaskCreate(server_task, "rm_server", 4096, NULL, priority, &s_task);
+    } else {
+        ok = xTaskCreatePinnedToCore(server_task, "rm_server", 4096, NULL, priority, &s_task, core);
+    }
+    if (ok != pdPASS) {
+        atomic_store(&s_running, false);
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void rm690b0_server_stop(void) {
+    if (!atomic_load(&s_running)) return;
+    if (xTaskGetCurrentTaskHandle() == s_task) {
+        ESP_LOGE(TAG, "Stop from the server task would wait on itself");
+        return;
+    }
+    // The ring has one consumer: wait until the task has drained and exited,
+    // so a start right after cannot run next to it
+    atomic_store(&s_running, false);
+    wake_server();
+    xSemaphoreTake(s_stopped, portMAX_DELAY);
+    s_task = NULL;
+    ESP_LOGI(TAG, "Display Server Stopped");
+}
+
+bool rm690b0_server_is_running(void) {
+    return atomic_load(&s_running);
+}
+
+static esp_err_t submit(const rm690b0_cmd_t *cmd, uint32_t timeout_ms, uint32_t *pos) {
+    if (!atomic_load(&s_running)) return ESP_ERR_INVALID_STATE;
+
+    esp_err_t ret = ring_push(cmd, pos);
+    if (ret == ESP_ERR_NO_MEM) {
+        atomic_fetch_add_explicit(&s_full, 1, memory_order_relaxed);
+        wake_server();
+
+        TickType_t start = xTaskGetTickCount();
+        TickType_t wait = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+        while ((ret = ring_push(cmd, pos)) == ESP_ERR_NO_MEM) {
+            if (!atomic_load(&s_running)) return ESP_ERR_INVALID_STATE;
+            if (wait != portMAX_DELAY && (TickType_t)(xTaskGetTickCount() - start) >= wait) {
+                atomic_fetch_add_explicit(&s_timeouts, 1, memory_order_relaxed);
+                return ESP_ERR_TIMEOUT;
+            }
+            vTaskDelay(1);
+        }
+    }
+    if (ret != ESP_OK) return ret;
+    atomic_fetch_add_explicit(&s_submitted, 1, memory_order_relaxed);
+    wake_server();
+    return ESP_OK;
+}
+
+esp_err_t rm690b0_server_submit(const rm690b0_cmd_t *cmd, uint32_t timeout_ms) {
+    uint32_t pos;
+    return submit(cmd, timeout_ms, &pos);
+}
+
+static void sync_wake(void *ctx) {
+    xTaskNotifyGive((TaskHandle_t)ctx);
+}
+
+esp_err_t rm690b0_server_sync(uint32_t timeout_ms) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (self == s_task) return ESP_ERR_INVALID_STATE; // Would wait on itself
+
+    rm690b0_cmd_t cmd = { .type = RM_CMD_FENCE, .done_cb = sync_wake, .done_ctx = self };
+    uint32_t pos;
+    TickType_t start = xTaskGetTickCount();
+    esp_err_t ret = submit(&cmd, timeout_ms, &pos);
+    if (ret != ESP_OK) return ret;
+
+    // Completions are in order: the fence is done once `pos + 1` commands are.
+    // Other notifications may wake us early, so re-check the count.
+    TickType_t wait = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    while ((int32_t)(atomic_load_explicit(&s_completed, memory_order_acquire) - (pos + 1)) < 0) {
+        TickType_t left = portMAX_DELAY;
+        if (wait != portMAX_DELAY) {
+            TickType_t spent = xTaskGetTickCount() - start;
+            if (spent >= wait) return ESP_ERR_TIMEOUT;
+            left = wait - spent;
+        }
+        ulTaskNotifyTake(pdTRUE, left);
+    }
+    return ESP_OK;
+}
+
+void rm690b0_server_get_stats(rm690b0_server_stats_t *stats) {
+    *stats = s_stats;
+    stats->submitted = atomic_load_explicit(&s_submitted, memory_order_relaxed);
+    stats->full = atomic_load_explicit(&s_full, memory_order_relaxed);
+    stats->timeouts = atomic_load_explicit(&s_timeouts, memory_order_relaxed);
+}
+
+// --- Convenience wrappers ---
+
+esp_err_t rm690b0_server_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    rm690b0_cmd_t cmd = { .type = RM_CMD_FILL, .x = x, .y = y, .w = w, .h = h, .color = color };
+    return rm690b0_server_submit(&cmd, RM_SERVER_SUBMIT_TIMEOUT_MS);
+}
+
+esp_err_t rm690b0_server_fill_screen(uint16_t color) {
+    rm690b0_cmd_t cmd = { .type = RM_CMD_FILL_SCREEN, .color = color };
+    return rm690b0_server_submit(&cmd, RM_SERVER_SUBMIT_TIMEOUT_MS);
+}
+
+esp_err_t rm690b0_server_draw_bitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                                     const uint16_t *data_be, size_t stride,
+                                     rm690b0_done_cb_t done_cb, void *done_ctx) {
+    rm690b0_cmd_t cmd = {
+        .type = RM_CMD_BITMAP, .x = x, .y = y, .w = w, .h = h,
+        .data = data_be, .stride = stride, .done_cb = done_cb, .done_ctx = done_ctx,
+    };
+    return rm690b0_server_submit(&cmd, RM_SERVER_SUBMIT_TIMEOUT_MS);
+}
+
+esp_err_t rm690b0_server_set_rotation(uint8_t rotation) {
+    rm690b0_cmd_t cmd = { .type = RM_CMD_ROTATE, .rotation = rotation };
+    return rm690b0_server_submit(&cmd, RM_SERVER_SUBMIT_TIMEOUT_MS);
+}
+
+esp_err_t rm690b0_server_test_pattern(void) {
+    rm690b0_cmd_t cmd = { .type = RM_CMD_TEST_PATTERN };
+    return rm690b0_server_submit(&cmd, RM_SERVER_SUBMIT_TIMEOUT_MS);
+}
+
+esp_err_t rm690b0_server_call(rm690b0_server_fn_t fn, void *ctx) {
+    rm690b0_cmd_t cmd = { .type = RM_CMD_CALL, .fn = fn, .ctx = ctx };
+    return rm690b0_server_submit(&cmd, RM_SERVER_SUBMIT_TIMEOUT_MS);
+}
@@ -0,0 +1,146 @@
+#ifndef RM690B0_SERVER_H
+#define RM690B0_SERVER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "rm690b0.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Display server: one task owns the QSPI device.
+ *
+ * Clients in any task submit commands through a lock-free multi-producer ring
+ * and return immediately. The server drains the ring in batches, so a window
+ * and its pixel burst can no longer interleave with a rotation change from
+ * another task. Once the server is started, all drawing should go through it.
+ *
+ * When the ring backs up, a batch holds several commands and the server drops
+ * those whose area a later opaque command in the same batch covers completely,
+ * and back-to-back rotations. Rotations and calls are barriers: nothing is
+ * coalesced across them. Completion callbacks fire for dropped commands too.
+ *
+ * Each command may pick its interface format: a UI drawn in RGB332 can still
+ * send a photo at 16 bits by setting .ifpf = RM_IFPF_RGB565 on its bitmap.
+ */
+
+#define RM_SERVER_QUEUE_LEN     64  // Ring slots, power of two
+#define RM_SERVER_BATCH         32  // Commands coalesced and sent per bus batch
+
+typedef enum {
+    RM_CMD_FENCE,           // Nothing to draw, completion only
+    RM_CMD_FILL,            // x, y, w, h, color
+    RM_CMD_FILL_SCREEN,     // color
+    RM_CMD_BITMAP,          // x, y, w, h, data, stride
+    RM_CMD_ROTATE,          // rotation
+    RM_CMD_TEST_PATTERN,
+    RM_CMD_CALL,            // fn(ctx) on the server task, bus owned
+} rm690b0_cmd_type_t;
+
+typedef void (*rm690b0_server_fn_t)(void *ctx);
+
+typedef struct {
+    uint8_t type;                   // rm690b0_cmd_type_t
+    uint8_t rotation;
+    uint8_t ifpf;                   // rm690b0_ifpf_t for this command, 0: rm690b0_get_interface_format()
+    uint16_t x, y, w, h;
+    uint16_t color;                 // RGB565 (native endian)
+    const uint16_t *data;           // Big-endian RGB565, valid until done_cb
+    size_t stride;                  // Row pitch in pixels
+    rm690b0_server_fn_t fn;
+    void *ctx;
+    rm690b0_done_cb_t done_cb;      // Runs on the server task once the command is on the panel
+    void *done_ctx;
+} rm690b0_cmd_t;
+
+typedef struct {
+    uint32_t submitted;     // Commands accepted into the ring
+    uint32_t executed;      // Commands drawn
+    uint32_t coalesced;     // Commands dropped because a later one covered them
+    uint32_t batches;       // Bus batches (one flush each)
+    uint32_t errors;        // Commands the driver rejected
+    uint32_t full;          // Submissions that found the ring full
+    uint32_t timeouts;      // Submissions abandoned because the ring stayed full
+    uint16_t depth_max;     // Deepest ring seen by the server
+} rm690b0_server_stats_t;
+
+/**
+ * @brief Start the server task. rm690b0_init() must have been called.
+ * @param priority Task priority
+ * @param core Core to pin to, -1 for any
+ */
+esp_err_t rm690b0_server_start(uint8_t priority, int core);
+
+/**
+ * @brief Stop the server task after it drains the ring. Returns once the task
+ * has exited, so a start right after gets the only consumer. Not from the
+ * server task (done callbacks).
+ */
+void rm690b0_server_stop(void);
+
+/**
+ * @brief True while the server task is running
+ */
+bool rm690b0_server_is_running(void);
+
+/**
+ * @brief Queue a command. Safe from any task, not from ISRs.
+ * @param cmd Copied into the ring
+ * @param timeout_ms How long to wait for a free slot
+ * @return ESP_ERR_TIMEOUT if the ring stayed full
+ */
+esp_err_t rm690b0_server_submit(const rm690b0_cmd_t *cmd, uint32_t timeout_ms);
+
+/**
+ * @brief Submit a fence and wait for it: everything submitted before is on the panel.
+ * The calling task is woken through its task notification; must not be called
+ * from the server task.
+ */
+esp_err_t rm690b0_server_sync(uint32_t timeout_ms);
+
+/**
+ * @brief Drain the ring on the calling task: coalesce, draw, flush, complete.
+ *
+ * This is the server task body. It is exposed for hosts that run the consumer
+ * themselves (see tools/rm690b0_sim); only one task may call it at a time.
+ * @return Commands completed
+ */
+size_t rm690b0_server_pump(void);
+
+/**
+ * @brief Ring and coalescing counters
+ */
+void rm690b0_server_get_stats(rm690b0_server_stats_t *stats);
+
+// Convenience wrappers, waiting up to RM_SERVER_SUBMIT_TIMEOUT_MS for a slot
+
+#define RM_SERVER_SUBMIT_TIMEOUT_MS 100
+
+esp_err_t rm690b0_server_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+esp_err_t rm690b0_server_fill_screen(uint16_t color);
+
+/**
+ * @brief Queue a bitmap. `data` must stay valid until done_cb runs.
+ */
+esp_err_t rm690b0_server_draw_bitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                                     const uint16_t *data_be, size_t stride,
+                                     rm690b0_done_cb_t done_cb, void *done_ctx);
+esp_err_t rm690b0_server_set_rotation(uint8_t rotation);
+esp_err_t rm690b0_server_test_pattern(void);
+
+/**
+ * @brief Run fn(ctx) on the server task between batches, with the bus owned.
+ * For sequences that must not interleave with other clients (re-init, rotation
+ * plus redraw). fn may call the rm690b0 API directly but must not wait on the server.
+ */
+esp_err_t rm690b0_server_call(rm690b0_server_fn_t fn, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
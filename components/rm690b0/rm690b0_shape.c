@@ -0,0 +1,225 @@
+#include "rm690b0.h"
+#include "rm690b0_raster.h"
+#include "rm690b0_color.h"
+#include <string.h>
+
+/*
+ * Panel sink of the span rasterizer. Rows are rasterized into a line buffer;
+ * contiguous spans become one segment, widened to even columns. Segments made
+ * only of opaque spans are carried over to the next row as a pending rectangle
+ * as long as they keep the same columns, and go out as one solid window.
+ * Everything else (anti-aliased edges) goes out as a one-row window.
+ *
+ * Like the rest of the drawing API this is not reentrant: one static context.
+ */
+
+#define SHAPE_MAX_SEGS      RM_RASTER_MAX_IV
+#define SHAPE_MAX_PENDING   8
+
+typedef struct {
+    int16_t x, end;         // end exclusive
+    bool solid;             // Opaque spans only
+} shape_seg_t;
+
+// Solid rectangle growing row by row, columns even-aligned
+typedef struct {
+    int16_t x0, x1;         // x1 exclusive
+    int16_t y0, rows;
+    bool pad_l, pad_r;      // Edge column is bg padding
+} shape_rect_t;
+
+typedef struct {
+    rm_raster_t raster;
+    const rm_shape_t *shape;
+    uint16_t fg, bg;        // Native
+    uint16_t fg_be, bg_be;
+    int16_t bx0, bx1, by0;  // Opaque mode window
+    uint16_t row[RM_RASTER_MAX_W];
+    shape_seg_t segs[SHAPE_MAX_SEGS];
+    uint8_t nsegs;
+    shape_rect_t pending[SHAPE_MAX_PENDING];
+    uint8_t npending;
+    uint32_t windows;
+    esp_err_t err;
+} shape_ctx_t;
+
+static shape_ctx_t s_ctx;
+static rm690b0_shape_stats_t s_stats;
+
+static inline uint16_t shade_be(const shape_ctx_t *c, uint8_t alpha) {
+    return (alpha == 255) ? c->fg_be : rm_color_be(rm_raster_blend(c->fg, c->bg, alpha));
+}
+
+static void window(shape_ctx_t *c, int16_t x, int16_t y, int16_t w, int16_t h, rm690b0_source_t *src) {
+    if (c->err != ESP_OK) return;
+    c->err = rm690b0_draw_source((uint16_t)x, (uint16_t)y, (uint16_t)w, (uint16_t)h, src);
+    c->windows++;
+}
+
+// --- Segments ---
+
+typedef struct {
+    const shape_ctx_t *c;
+    const shape_rect_t *r;
+} rect_gen_t;
+
+static void rect_gen(void *ctx, uint16_t x, uint16_t y, uint16_t n, uint16_t *dst) {
+    const rect_gen_t *g = ctx;
+    uint16_t w = g->r->x1 - g->r->x0;
+    for (uint16_t i = 0; i < n; i++) {
+        uint16_t col = x + i;
+        bool pad = (col == 0 && g->r->pad_l) || (col == w - 1 && g->r->pad_r);
+        dst[i] = pad ? g->c->bg_be : g->c->fg_be;
+    }
+}
+
+static void rect_emit(shape_ctx_t *c, const shape_rect_t *r) {
+    rm690b0_source_t src;
+    int16_t w = r->x1 - r->x0;
+    if (!r->pad_l && !r->pad_r) {
+        rm690b0_source_solid(&src, c->fg, (size_t)w * r->rows);
+        window(c, r->x0, r->y0, w, r->rows, &src);
+        return;
+    }
+    rect_gen_t g = { c, r };
+    rm690b0_source_generator(&src, rect_gen, &g, (uint16_t)w, (uint16_t)r->rows);
+    window(c, r->x0, r->y0, w, r->rows, &src);
+}
+
+// Line buffer pixels, copied into the bounce buffers (the buffer is reused next row)
+static void row_gen(void *ctx, uint16_t x, uint16_t y, uint16_t n, uint16_t *dst) {
+    memcpy(dst, (const uint16_t *)ctx + x, (size_t)n * 2);
+}
+
+static void rect_pending(shape_ctx_t *c, const shape_rect_t *r, int16_t y) {
+    for (uint8_t i = 0; i < c->npending; i++) {
+        shape_rect_t *p = &c->pending[i];
+        if (p->x0 == r->x0 && p->x1 == r->x1 && p->pad_l == r->pad_l && p->pad_r == r->pad_r &&
+            p->y0 + p->rows == y) {
+            p->rows++;
+            return;
+        }
+    }
+    if (c->npending == SHAPE_MAX_PENDING) {
+        rect_emit(c, &c->pending[0]);
+        memmove(&c->pending[0], &c->pending[1], (SHAPE_MAX_PENDING - 1) * sizeof(shape_rect_t));
+        c->npending--;
+    }
+    c->pending[c->npending++] = *r;
+}
+
+// Emit pending rectangles that did not grow into row y (all of them for y < 0)
+static void pending_retire(shape_ctx_t *c, int16_t y) {
+    uint8_t keep = 0;
+    for (uint8_t i = 0; i < c->npending; i++) {
+        shape_rect_t *p = &c->pending[i];
+        if (y >= 0 && p->y0 + p->rows == y + 1) {
+            c->pending[keep++] = *p;
+        } else {
+            rect_emit(c, p);
+        }
+    }
+    c->npending = keep;
+}
+
+static void row_flush(shape_ctx_t *c, int16_t y) {
+    for (uint8_t i = 0; i < c->nsegs; i++) {
+        const shape_seg_t *s = &c->segs[i];
+        shape_rect_t r = {
+            .x0 = s->x & ~1, .x1 = (s->end + 1) & ~1, .y0 = y, .rows = 1,
+        };
+        r.pad_l = r.x0 < s->x;
+        r.pad_r = r.x1 > s->end;
+        if (r.pad_l) c->row[r.x0] = c->bg_be;
+        if (r.pad_r) c->row[r.x1 - 1] = c->bg_be;
+
+        if (s->solid) {
+            rect_pending(c, &r, y);
+        } else {
+            rm690b0_source_t src;
+            rm690b0_source_generator(&src, row_gen, c->row + r.x0, (uint16_t)(r.x1 - r.x0), 1);
+            window(c, r.x0, y, r.x1 - r.x0, 1, &src);
+        }
+    }
+    c->nsegs = 0;
+}
+
+static void seg_span(void *ctx, int16_t x, int16_t y, uint16_t len, uint8_t alpha) {
+    shape_ctx_t *c = ctx;
+    uint16_t be = shade_be(c, alpha);
+    for (uint16_t i = 0; i < len; i++) c->row[x + i] = be;
+
+    if (c->nsegs > 0 && c->segs[c->nsegs - 1].end == x) {
+        shape_seg_t *s = &c->segs[c->nsegs - 1];
+        s->end = x + len;
+        s->solid = s->solid && alpha == 255;
+        return;
+    }
+    // Disjoint segments never share a column pair after widening; a row with
+    // more segments than fit simply goes out in two passes
+    if (c->nsegs == SHAPE_MAX_SEGS) row_flush(c, y);
+    c->segs[c->nsegs++] = (shape_seg_t){ x, (int16_t)(x + len), alpha == 255 };
+}
+
+// --- Opaque bounding box ---
+
+static void opaque_span(void *ctx, int16_t x, int16_t y, uint16_t len, uint8_t alpha) {
+    shape_ctx_t *c = ctx;
+    uint16_t be = shade_be(c, alpha);
+    for (uint16_t i = 0; i < len; i++) c->row[x + i] = be;
+}
+
+static void opaque_gen(void *ctx, uint16_t x, uint16_t y, uint16_t n, uint16_t *dst) {
+    shape_ctx_t *c = ctx;
+    if (x == 0) {
+        for (int16_t i = c->bx0; i < c->bx1; i++) c->row[i] = c->bg_be;
+        rm_raster_row(&c->raster, c->shape, c->by0 + y, opaque_span, c);
+    }
+    memcpy(dst, c->row + c->bx0 + x, (size_t)n * 2);
+}
+
+esp_err_t rm690b0_draw_shape(const rm_shape_t *shape, const rm690b0_paint_t *paint) {
+    if (!shape || !paint) return ESP_ERR_INVALID_ARG;
+    shape_ctx_t *c = &s_ctx;
+    uint16_t width = rm690b0_get_width();
+
+    rm_raster_init(&c->raster, width, rm690b0_get_height(), paint->aa);
+    int16_t x0, y0, x1, y1;
+    if (!rm_raster_bounds(&c->raster, shape, &x0, &y0, &x1, &y1)) return ESP_OK;
+
+    c->shape = shape;
+    c->fg = paint->color;
+    c->bg = paint->bg;
+    c->fg_be = rm_color_be(paint->color);
+    c->bg_be = rm_color_be(paint->bg);
+    c->nsegs = 0;
+    c->npending = 0;
+    c->windows = 0;
+    c->err = ESP_OK;
+
+    if (paint->opaque) {
+        c->bx0 = x0 & ~1;
+        c->bx1 = (x1 + 1) & ~1;
+        if (c->bx1 > width) c->bx1 = width;
+        c->by0 = y0;
+        rm690b0_source_t src;
+        rm690b0_source_generator(&src, opaque_gen, c, (uint16_t)(c->bx1 - c->bx0), (uint16_t)(y1 - y0));
+        window(c, c->bx0, y0, c->bx1 - c->bx0, y1 - y0, &src);
+    } else {
+        for (int16_t y = y0; y < y1 && c->err == ESP_OK; y++) {
+            rm_raster_row(&c->raster, shape, y, seg_span, c);
+            row_flush(c, y);
+            pending_retire(c, y);
+        }
+        pending_retire(c, -1);
+    }
+
+    s_stats.shapes++;
+    s_stats.spans += c->raster.spans;
+    s_stats.windows += c->windows;
+    return c->err;
+}
+
+void rm690b0_get_shape_stats(rm690b0_shape_stats_t *stats) {
+    *stats = s_stats;
+}
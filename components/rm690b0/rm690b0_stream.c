@@ -0,0 +1,338 @@
+#include "rm690b0_stream.h"
+#include "esp_memory_utils.h"
+#include <stdint.h>
+#include <string.h>
+
+// --- Sources ---
+
+static size_t solid_read(rm690b0_source_t *src, uint16_t *dst, size_t max_pixels) {
+    size_t n = (src->remaining < max_pixels) ? src->remaining : max_pixels;
+    for (size_t i = 0; i < n; i++) dst[i] = src->u.solid.color_be;
+    src->remaining -= n;
+    return n;
+}
+
+void rm690b0_source_solid(rm690b0_source_t *src, uint16_t color, size_t count) {
+    memset(src, 0, sizeof(*src));
+    src->read = solid_read;
+    src->remaining = count;
+    src->solid = true;
+    src->u.solid.color_be = rm_color_be(color);
+}
+
+static size_t linear_read(rm690b0_source_t *src, uint16_t *dst, size_t max_pixels) {
+    size_t n = (src->remaining < max_pixels) ? src->remaining : max_pixels;
+    memcpy(dst, src->u.linear.data, n * 2);
+    src->u.linear.data += n;
+    src->remaining -= n;
+    return n;
+}
+
+static const uint16_t *linear_direct(rm690b0_source_t *src, size_t max_pixels, size_t *n) {
+    const uint16_t *p = src->u.linear.data;
+    *n = (src->remaining < max_pixels) ? src->remaining : max_pixels;
+    src->u.linear.data += *n;
+    src->remaining -= *n;
+    return p;
+}
+
+void rm690b0_source_linear(rm690b0_source_t *src, const uint16_t *data_be, size_t count) {
+    memset(src, 0, sizeof(*src));
+    src->read = linear_read;
+    src->direct = linear_direct;
+    src->remaining = count;
+    src->u.linear.data = data_be;
+}
+
+static size_t rect_read(rm690b0_source_t *src, uint16_t *dst, size_t max_pixels) {
+    size_t out = 0;
+    while (out < max_pixels && src->remaining > 0) {
+        size_t run = src->u.rect.w - src->u.rect.x;
+        if (run > max_pixels - out) run = max_pixels - out;
+
+        const uint16_t *row = src->u.rect.data + (size_t)src->u.rect.y * src->u.rect.stride;
+        memcpy(dst + out, row + src->u.rect.x, run * 2);
+        out += run;
+        src->remaining -= run;
+
+        src->u.rect.x += run;
+        if (src->u.rect.x >= src->u.rect.w) {
+            src->u.rect.x = 0;
+            src->u.rect.y++;
+        }
+    }
+    return out;
+}
+
+// One chunk per row, straight from the source
+static const uint16_t *rect_direct(rm690b0_source_t *src, size_t max_pixels, size_t *n) {
+    size_t run = src->u.rect.w - src->u.rect.x;
+    if (run > max_pixels) run = max_pixels;
+
+    const uint16_t *p = src->u.rect.data + (size_t)src->u.rect.y * src->u.rect.stride + src->u.rect.x;
+    *n = run;
+    src->remaining -= run;
+    src->u.rect.x += run;
+    if (src->u.rect.x >= src->u.rect.w) {
+        src->u.rect.x = 0;
+        src->u.rect.y++;
+    }
+    return p;
+}
+
+// Rows can go out zero-copy when every row start and length is word aligned in
+// DMA-capable RAM; anything else would get a per-transaction bounce in the SPI
+// driver. Short rows are still copied: a chunk per row costs more on the wire
+// than the memcpy into a pool buffer.
+static bool rect_rows_direct(const uint16_t *data_be, size_t stride, uint16_t w) {
+    if (w < RM_STREAM_ROW_DIRECT_MIN) return false;
+    if (((uintptr_t)data_be & 3) || (stride & 1) || (w & 1)) return false;
+    return esp_ptr_dma_capable(data_be);
+}
+
+void rm690b0_source_rect(rm690b0_source_t *src, const uint16_t *data_be, size_t stride, uint16_t w, uint16_t h) {
+    // Packed rows are just a linear buffer
+    if (stride == w) {
+        rm690b0_source_linear(src, data_be, (size_t)w * h);
+        return;
+    }
+    memset(src, 0, sizeof(*src));
+    src->read = rect_read;
+    if (rect_rows_direct(data_be, stride, w)) {
+        src->direct = rect_direct;
+    }
+    src->remaining = (size_t)w * h;
+    src->u.rect.data = data_be;
+    src->u.rect.stride = stride;
+    src->u.rect.w = w;
+}
+
+static size_t conv_read(rm690b0_source_t *src, uint16_t *dst, size_t max_pixels) {
+    size_t out = 0;
+    size_t bpp = rm_pixfmt_bpp(src->u.conv.fmt);
+    while (out < max_pixels && src->remaining > 0) {
+        size_t run = src->u.conv.w - src->u.conv.x;
+        if (run > max_pixels - out) run = max_pixels - out;
+
+        const uint8_t *row = src->u.conv.data + (size_t)src->u.conv.y * src->u.conv.stride;
+        rm_color_convert(src->u.conv.fmt, dst + out, row + (size_t)src->u.conv.x * bpp, run,
+                         src->u.conv.x, src->u.conv.y, src->u.conv.dither);
+        out += run;
+        src->remaining -= run;
+
+        src->u.conv.x += run;
+        if (src->u.conv.x >= src->u.conv.w) {
+            src->u.conv.x = 0;
+            src->u.conv.y++;
+        }
+    }
+    return out;
+}
+
+void rm690b0_source_convert(rm690b0_source_t *src, const void *data, size_t stride_bytes,
+                            uint16_t w, uint16_t h, rm690b0_pixfmt_t fmt, bool dither) {
+    if (fmt == RM_PIXFMT_RGB565_BE) {
+        rm690b0_source_rect(src, data, stride_bytes / 2, w, h);
+        return;
+    }
+    memset(src, 0, sizeof(*src));
+    src->read = conv_read;
+    src->remaining = (size_t)w * h;
+    src->u.conv.data = data;
+    src->u.conv.stride = stride_bytes;
+    src->u.conv.w = w;
+    src->u.conv.fmt = fmt;
+    src->u.conv.dither = dither;
+}
+
+static size_t gen_read(rm690b0_source_t *src, uint16_t *dst, size_t max_pixels) {
+    size_t out = 0;
+    while (out < max_pixels && src->remaining > 0) {
+        size_t run = src->u.gen.w - src->u.gen.x;
+        if (run > max_pixels - out) run = max_pixels - out;
+
+        src->u.gen.fn(src->u.gen.ctx, src->u.gen.x, src->u.gen.y, (uint16_t)run, dst + out);
+        out += run;
+        src->remaining -= run;
+
+        src->u.gen.x += run;
+        if (src->u.gen.x >= src->u.gen.w) {
+            src->u.gen.x = 0;
+            src->u.gen.y++;
+        }
+    }
+    return out;
+}
+
+void rm690b0_source_generator(rm690b0_source_t *src, rm690b0_gen_fn_t fn, void *ctx, uint16_t w, uint16_t h) {
+    memset(src, 0, sizeof(*src));
+    src->read = gen_read;
+    src->remaining = (size_t)w * h;
+    src->u.gen.fn = fn;
+    src->u.gen.ctx = ctx;
+    src->u.gen.w = w;
+}
+
+static size_t decode_read(rm690b0_source_t *src, uint16_t *dst, size_t max_pixels) {
+    size_t want = (src->remaining < max_pixels) ? src->remaining : max_pixels;
+    size_t n = src->u.decode.fn(src->u.decode.ctx, dst, want);
+    if (n > want) n = want;
+    src->remaining -= n;
+    return n;
+}
+
+void rm690b0_source_decoder(rm690b0_source_t *src, rm690b0_decode_fn_t fn, void *ctx, size_t count) {
+    memset(src, 0, sizeof(*src));
+    src->read = decode_read;
+    src->remaining = count;
+    src->u.decode.fn = fn;
+    src->u.decode.ctx = ctx;
+}
+
+// --- Engine ---
+
+void rm_stream_init(rm690b0_stream_t *s, rm690b0_pipe_t *pipe, rm690b0_pool_t *pool) {
+    memset(s, 0, sizeof(*s));
+    s->pipe = pipe;
+    s->pool = pool;
+    s->ifpf = RM_IFPF_RGB565;
+}
+
+static void stream_count_packed(rm690b0_stream_t *s, size_t n, size_t bytes) {
+    s->ifpf_stats.pixels_packed += n;
+    s->ifpf_stats.bytes_sent += bytes;
+    s->ifpf_stats.bytes_saved += n * 2 - bytes;
+}
+
+// Solid colors in a reduced format: one chunk packed once, queued for every chunk
+static esp_err_t stream_solid_packed(rm690b0_stream_t *s, rm690b0_source_t *src,
+                                     rm690b0_bus_done_cb_t done_cb, void *done_arg) {
+    rm690b0_pool_t *pool = s->pool;
+    uint8_t i;
+    esp_err_t ret = rm_pool_acquire(pool, &i);
+    if (ret != ESP_OK) return ret;
+
+    size_t fill = (src->remaining < pool->pixels) ? src->remaining : pool->pixels;
+    for (size_t k = 0; k < fill; k++) pool->buf[i][k] = src->u.solid.color_be;
+    rm_color_pack(s->ifpf, (uint8_t *)pool->buf[i], pool->buf[i], fill);
+
+    while (src->remaining > 0) {
+        size_t n = (src->remaining < pool->pixels) ? src->remaining : pool->pixels;
+        size_t bytes = rm_ifpf_bytes(s->ifpf, n);
+        src->remaining -= n;
+        bool last = (src->remaining == 0);
+
+        stream_count_packed(s, n, bytes);
+        ret = rm_pipe_push(s->pipe, pool->buf[i], bytes, last,
+                           last ? done_cb : NULL, done_arg, NULL);
+        if (ret != ESP_OK) break;
+    }
+    rm_pool_release(pool, i);
+    return ret;
+}
+
+// Reduced formats: fill a pool buffer as usual, pack it in place, send the bytes.
+// Chunks are whole pool buffers (an even pixel count), so RGB111 never splits a byte.
+static esp_err_t stream_packed(rm690b0_stream_t *s, rm690b0_source_t *src,
+                               rm690b0_bus_done_cb_t done_cb, void *done_arg) {
+    if (src->solid) {
+        return stream_solid_packed(s, src, done_cb, done_arg);
+    }
+
+    rm690b0_pool_t *pool = s->pool;
+    while (src->remaining > 0) {
+        uint8_t i;
+        esp_err_t ret = rm_pool_acquire(pool, &i);
+        if (ret != ESP_OK) return ret;
+
+        size_t want = (src->remaining < pool->pixels) ? src->remaining : pool->pixels;
+        size_t n = src->read(src, pool->buf[i], want);
+        if (n < want) {
+            memset(pool->buf[i] + n, 0, (want - n) * 2);
+            src->remaining -= (want - n);
+        }
+        size_t bytes = rm_color_pack(s->ifpf, (uint8_t *)pool->buf[i], pool->buf[i], want);
+        stream_count_packed(s, want, bytes);
+
+        bool last = (src->remaining == 0);
+        ret = rm_pipe_push(s->pipe, pool->buf[i], bytes, last,
+                           last ? done_cb : NULL, done_arg, NULL);
+        rm_pool_release(pool, i);
+        if (ret != ESP_OK) return ret;
+    }
+    return ESP_OK;
+}
+
+// Solid colors come from the pool's prefilled buffers, queued for every chunk
+static esp_err_t stream_solid(rm690b0_stream_t *s, rm690b0_source_t *src,
+                              rm690b0_bus_done_cb_t done_cb, void *done_arg) {
+    rm690b0_pool_t *pool = s->pool;
+    uint8_t i;
+    esp_err_t ret = rm_pool_acquire_solid(pool, src->u.solid.color_be, src->remaining, &i);
+    if (ret != ESP_OK) return ret;
+
+    while (src->remaining > 0) {
+        size_t n = (src->remaining < pool->pixels) ? src->remaining : pool->pixels;
+        src->remaining -= n;
+        bool last = (src->remaining == 0);
+
+        ret = rm_pipe_push(s->pipe, pool->buf[i], n * 2, last,
+                           last ? done_cb : NULL, done_arg, NULL);
+        if (ret != ESP_OK) break;
+    }
+    rm_pool_release(pool, i);
+    return ret;
+}
+
+esp_err_t rm_stream_run(rm690b0_stream_t *s, rm690b0_source_t *src,
+                        rm690b0_bus_done_cb_t done_cb, void *done_arg, bool *zero_copy) {
+    if (zero_copy) *zero_copy = false;
+
+    if (src->remaining == 0) {
+        if (done_cb) done_cb(done_arg);
+        return ESP_OK;
+    }
+
+    if (s->ifpf != RM_IFPF_RGB565) {
+        return stream_packed(s, src, done_cb, done_arg);
+    }
+
+    if (src->solid) {
+        return stream_solid(s, src, done_cb, done_arg);
+    }
+
+    rm690b0_pool_t *pool = s->pool;
+    while (src->remaining > 0) {
+        const uint16_t *data = NULL;
+        size_t n = 0;
+        uint8_t i = RM_POOL_MAX_BUFS;
+
+        if (src->direct) {
+            data = src->direct(src, RM_BUS_CHUNK_BYTES / 2, &n);
+            if (data && n > 0 && zero_copy) *zero_copy = true;
+        }
+
+        if (!data || n == 0) {
+            // Waits for the wire only when every free buffer is still queued
+            esp_err_t ret = rm_pool_acquire(pool, &i);
+            if (ret != ESP_OK) return ret;
+
+            size_t want = (src->remaining < pool->pixels) ? src->remaining : pool->pixels;
+            n = src->read(src, pool->buf[i], want);
+            if (n < want) {
+                // Source ran dry: pad with black so the burst matches the window
+                memset(pool->buf[i] + n, 0, (want - n) * 2);
+                src->remaining -= (want - n);
+                n = want;
+            }
+            data = pool->buf[i];
+        }
+
+        bool last = (src->remaining == 0);
+        esp_err_t ret = rm_pipe_push(s->pipe, data, n * 2, last,
+                                     last ? done_cb : NULL, done_arg, NULL);
+        if (i < RM_POOL_MAX_BUFS) rm_pool_release(pool, i);
+        if (ret != ESP_OK) return ret;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,165 @@
+#ifndef RM690B0_STREAM_H
+#define RM690B0_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "rm690b0_bus.h"
+#include "rm690b0_pool.h"
+#include "rm690b0_color.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Streaming transfer core.
+ *
+ * Every pixel burst goes through rm_stream_run(): a pixel source produces
+ * big-endian RGB565 into a DMA buffer from the driver pool while previously
+ * filled buffers are on the wire. Sources that already hold contiguous big-endian pixels
+ * are sent zero-copy. With a reduced interface format (rm690b0_ifpf_t) each
+ * buffer is packed in place before it is queued. Chunk sizing lives here and
+ * nowhere else.
+ */
+
+// Pixels per pool buffer (16KB)
+#define RM_STREAM_CHUNK_PIXELS  8192
+
+// Narrowest strided row sent zero-copy as its own chunk (see rm690b0_source_rect())
+#define RM_STREAM_ROW_DIRECT_MIN    256
+
+typedef struct rm690b0_source rm690b0_source_t;
+
+/**
+ * @brief Produce pixels for one row segment (procedural source).
+ * @param ctx User context
+ * @param x Column of the first pixel, relative to the drawn area
+ * @param y Row, relative to the drawn area
+ * @param n Number of pixels to produce
+ * @param[out] dst Big-endian RGB565 output
+ */
+typedef void (*rm690b0_gen_fn_t)(void *ctx, uint16_t x, uint16_t y, uint16_t n, uint16_t *dst);
+
+/**
+ * @brief Pull decoded pixels (decoder source).
+ * @param ctx User context
+ * @param[out] dst Big-endian RGB565 output
+ * @param max_pixels Space in dst
+ * @return Pixels written, 0 on end of data or error
+ */
+typedef size_t (*rm690b0_decode_fn_t)(void *ctx, uint16_t *dst, size_t max_pixels);
+
+/**
+ * Pixel source. Initialize with one of the rm690b0_source_*() helpers.
+ */
+struct rm690b0_source {
+    // Copy/produce up to max_pixels into dst, return the count
+    size_t (*read)(rm690b0_source_t *src, uint16_t *dst, size_t max_pixels);
+    // Optional zero-copy access: return a pointer to up to max_pixels contiguous pixels
+    const uint16_t *(*direct)(rm690b0_source_t *src, size_t max_pixels, size_t *n);
+    size_t remaining;   // Pixels left
+    bool solid;         // Every pixel is u.solid.color_be
+    union {
+        struct { uint16_t color_be; } solid;
+        struct { const uint16_t *data; } linear;
+        struct { const uint16_t *data; size_t stride; uint16_t w, x, y; } rect;
+        struct { rm690b0_gen_fn_t fn; void *ctx; uint16_t w, x, y; } gen;
+        struct { rm690b0_decode_fn_t fn; void *ctx; } decode;
+        struct { const uint8_t *data; size_t stride; uint16_t w, x, y; uint8_t fmt; bool dither; } conv;
+    } u;
+};
+
+/**
+ * @brief Solid color source
+ * @param color RGB565 (native endian)
+ * @param count Number of pixels
+ */
+void rm690b0_source_solid(rm690b0_source_t *src, uint16_t color, size_t count);
+
+/**
+ * @brief Contiguous pre-swapped (big-endian) buffer, sent zero-copy
+ */
+void rm690b0_source_linear(rm690b0_source_t *src, const uint16_t *data_be, size_t count);
+
+/**
+ * @brief w x h sub-rectangle of a larger big-endian image.
+ *
+ * Packed rows are sent as one linear buffer. Strided rows of at least
+ * RM_STREAM_ROW_DIRECT_MIN pixels, word aligned in DMA-capable RAM, are queued
+ * one chunk per row straight from the image; other rows are copied into the
+ * bounce buffers.
+ * @param data_be First pixel of the sub-rectangle
+ * @param stride Source row pitch in pixels
+ */
+void rm690b0_source_rect(rm690b0_source_t *src, const uint16_t *data_be, size_t stride, uint16_t w, uint16_t h);
+
+/**
+ * @brief w x h image in another pixel format, converted while it is copied
+ * into the bounce buffers. Big-endian RGB565 falls back to rm690b0_source_rect().
+ * @param data First pixel
+ * @param stride_bytes Source row pitch in bytes
+ * @param fmt Source format, see rm690b0_color.h
+ * @param dither Ordered dithering for 24/32-bit sources, phased to the area origin
+ */
+void rm690b0_source_convert(rm690b0_source_t *src, const void *data, size_t stride_bytes,
+                            uint16_t w, uint16_t h, rm690b0_pixfmt_t fmt, bool dither);
+
+/**
+ * @brief Procedural source, fn is called per row segment
+ */
+void rm690b0_source_generator(rm690b0_source_t *src, rm690b0_gen_fn_t fn, void *ctx, uint16_t w, uint16_t h);
+
+/**
+ * @brief Decoder callback source. Missing pixels are padded with black.
+ */
+void rm690b0_source_decoder(rm690b0_source_t *src, rm690b0_decode_fn_t fn, void *ctx, size_t count);
+
+/**
+ * Reduced interface format traffic. Bytes saved are counted against the same
+ * pixels sent as RGB565.
+ */
+typedef struct {
+    uint32_t pixels_packed;     // Pixels sent in a format other than RGB565
+    uint32_t bytes_sent;        // Wire bytes of those pixels
+    uint32_t bytes_saved;       // RGB565 bytes minus bytes_sent
+} rm690b0_ifpf_stats_t;
+
+/**
+ * Streaming engine state. Scratch buffers come from the pool, which must hold
+ * at least two buffers for filling to overlap the wire.
+ */
+typedef struct {
+    rm690b0_pipe_t *pipe;
+    rm690b0_pool_t *pool;
+    rm690b0_ifpf_t ifpf;        // Format the panel expects; set by the driver with COLMOD
+    rm690b0_ifpf_stats_t ifpf_stats;
+} rm690b0_stream_t;
+
+/**
+ * @brief Bind the engine to a pipeline and its buffer pool
+ */
+void rm_stream_init(rm690b0_stream_t *s, rm690b0_pipe_t *pipe, rm690b0_pool_t *pool);
+
+/**
+ * @brief Stream a source as one RAMWR burst into the window already set.
+ *
+ * Pixels are packed into s->ifpf on the way out. Packed bursts always go through
+ * the pool buffers (the packing runs in place), so nothing is sent zero-copy.
+ *
+ * Returns once every chunk is queued. Pool buffers are released after queuing;
+ * when the source was sent zero-copy the caller's memory is still referenced
+ * until the pipe is drained or done_cb fires.
+ *
+ * @param done_cb Optional, fired when the last chunk completes
+ * @param[out] zero_copy Optional, set when caller memory is referenced by queued chunks
+ */
+esp_err_t rm_stream_run(rm690b0_stream_t *s, rm690b0_source_t *src,
+                        rm690b0_bus_done_cb_t done_cb, void *done_arg, bool *zero_copy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,482 @@
+#include "rm690b0_text.h"
+#include "rm690b0.h"
+#include "rm690b0_fb.h"
+#include "rm690b0_font.h"
+#include "rm690b0_color.h"
+#include "rm690b0_raster.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "rm690b0_text";
+
+#define TEXT_ROW_MAX        640     // Widest line box, longest side of any rotation and then some
+#define TEXT_COV_LEVELS     16
+#define TEXT_TIER_HOT       0
+#define TEXT_TIER_PSRAM     1
+
+// A glyph expanded into the atlas: w * h coverage values 0..15
+typedef struct {
+    const void *key;        // Font data, NULL: free slot
+    uint16_t cp;
+    uint8_t w, h;
+    int8_t x_off, y_off;
+    uint8_t advance;
+    const uint8_t *cov;
+} text_glyph_t;
+
+typedef struct {
+    uint8_t *arena;
+    size_t size, used;
+    text_glyph_t *slots;    // RM_TEXT_CACHE_SLOTS, open addressing
+    uint16_t count;
+    uint32_t gen;           // Bumped when the tier is emptied
+} text_tier_t;
+
+typedef struct {
+    uint16_t fg, bg;
+    bool valid;
+    uint16_t be[TEXT_COV_LEVELS];
+} text_lut_t;
+
+typedef struct {
+    int16_t x;              // Screen column of the glyph's left edge
+    int8_t y;               // Rows below the top of the line
+    const text_glyph_t *g;
+} text_placed_t;
+
+// One laid out line
+typedef struct {
+    text_placed_t glyphs[RM_TEXT_MAX_RUN];
+    uint16_t n;
+    int16_t top;            // Screen row of the top of the line
+    int32_t pen_x0, pen_x1; // Advance box, screen columns
+    const uint16_t *lut;
+    uint8_t cov[TEXT_ROW_MAX];
+} text_run_t;
+
+static text_tier_t s_tiers[2];
+static size_t s_tier_size[2];       // Set by rm690b0_text_cache_init, allocated on the first draw
+static text_lut_t s_luts[RM_TEXT_LUTS];
+static uint8_t s_lut_next;
+static text_run_t s_run;
+static rm690b0_text_stats_t s_stats;
+
+// --- Fonts ---
+
+esp_err_t rm690b0_font_open(rm690b0_font_t *font, const void *data, size_t size) {
+    const uint8_t *d = data;
+    rm690b0_font_header_t hdr;
+    if (size < sizeof(hdr)) return ESP_ERR_INVALID_SIZE;
+    memcpy(&hdr, d, sizeof(hdr));
+    if (memcmp(hdr.magic, RM_FONT_MAGIC, 4) != 0) return ESP_ERR_INVALID_ARG;
+    if (hdr.bpp != 1 && hdr.bpp != 4 && hdr.bpp != 8) return ESP_ERR_NOT_SUPPORTED;
+
+    size_t tables = sizeof(hdr) + (size_t)hdr.count * sizeof(rm690b0_font_glyph_t) +
+                    (size_t)hdr.kern_count * sizeof(rm690b0_font_kern_t);
+    if (tables > size) return ESP_ERR_INVALID_SIZE;
+
+    const rm690b0_font_glyph_t *glyphs = (const rm690b0_font_glyph_t *)(d + sizeof(hdr));
+    for (uint16_t i = 0; i < hdr.count; i++) {
+        size_t bytes = (size_t)glyphs[i].h * ((glyphs[i].w * hdr.bpp + 7) / 8);
+        if (glyphs[i].offset > size || bytes > size - glyphs[i].offset) {
+            ESP_LOGE(TAG, "Glyph %u outside the font file", hdr.first + i);
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+
+    font->data = d;
+    font->glyphs = glyphs;
+    font->kern = (const rm690b0_font_kern_t *)(glyphs + hdr.count);
+    font->first = hdr.first;
+    font->count = hdr.count;
+    font->kern_count = hdr.kern_count;
+    font->bpp = hdr.bpp;
+    font->line_height = hdr.line_height;
+    font->ascent = hdr.ascent;
+    return ESP_OK;
+}
+
+esp_err_t rm690b0_font_open_asset(rm690b0_font_t *font, const rm690b0_asset_t *asset) {
+    if (asset->type != RM_ASSET_BLOB) return ESP_ERR_INVALID_ARG;
+    return rm690b0_font_open(font, asset->data, asset->size);
+}
+
+void rm690b0_font_builtin(rm690b0_font_t *font) {
+    *font = (rm690b0_font_t){
+        .first = RM_FONT8X16_FIRST,
+        .count = RM_FONT8X16_LAST - RM_FONT8X16_FIRST + 1,
+        .bpp = 1,
+        .line_height = RM_FONT8X16_H,
+        .ascent = 12,
+    };
+}
+
+static inline const void *font_key(const rm690b0_font_t *f) {
+    return f->data ? (const void *)f->data : (const void *)rm_font8x16;
+}
+
+static bool font_glyph(const rm690b0_font_t *f, uint32_t cp, rm690b0_font_glyph_t *g, const uint8_t **bits) {
+    if (cp < f->first || cp - f->first >= f->count) return false;
+    if (!f->data) {
+        *g = (rm690b0_font_glyph_t){ .w = RM_FONT8X16_W, .h = RM_FONT8X16_H, .advance = RM_FONT8X16_W };
+        *bits = rm_font8x16[cp - f->first];
+        return true;
+    }
+    *g = f->glyphs[cp - f->first];
+    *bits = f->data + g->offset;
+    return g->w != 0 || g->advance != 0;
+}
+
+static int8_t font_kern(const rm690b0_font_t *f, uint32_t left, uint32_t right) {
+    uint32_t key = (left << 16) | right;
+    int32_t lo = 0, hi = (int32_t)f->kern_count - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) / 2;
+        uint32_t k = ((uint32_t)f->kern[mid].left << 16) | f->kern[mid].right;
+        if (k == key) return f->kern[mid].adjust;
+        if (k < key) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return 0;
+}
+
+static uint32_t utf8_next(const char **s) {
+    const uint8_t *p = (const uint8_t *)*s;
+    uint32_t c = *p++;
+    int extra = 0;
+    if (c >= 0xF0) {
+        extra = 3;
+        c &= 0x07;
+    } else if (c >= 0xE0) {
+        extra = 2;
+        c &= 0x0F;
+    } else if (c >= 0xC0) {
+        extra = 1;
+        c &= 0x1F;
+    } else if (c >= 0x80) {
+        c = 0xFFFD;     // Stray continuation byte
+    }
+    while (extra-- > 0 && (*p & 0xC0) == 0x80) c = (c << 6) | (*p++ & 0x3F);
+    *s = (const char *)p;
+    return c;
+}
+
+int32_t rm690b0_text_width(const rm690b0_font_t *font, const char *utf8) {
+    int32_t w = 0;
+    uint32_t prev = 0;
+    while (*utf8 && *utf8 != '\n') {
+        uint32_t cp = utf8_next(&utf8);
+        rm690b0_font_glyph_t g;
+        const uint8_t *bits;
+        if (!font_glyph(font, cp, &g, &bits) && !font_glyph(font, '?', &g, &bits)) continue;
+        if (prev && font->kern_count) w += font_kern(font, prev, cp);
+        w += g.advance;
+        prev = cp;
+    }
+    return w;
+}
+
+// --- Glyph atlas ---
+
+esp_err_t rm690b0_text_cache_init(size_t internal_bytes, size_t psram_bytes) {
+    rm690b0_text_cache_deinit();
+    s_tier_size[TEXT_TIER_HOT] = internal_bytes;
+    s_tier_size[TEXT_TIER_PSRAM] = psram_bytes;
+    memset(s_luts, 0, sizeof(s_luts));
+    s_stats = (rm690b0_text_stats_t){ .internal_size = internal_bytes, .psram_size = psram_bytes };
+    return ESP_OK;
+}
+
+static void cache_free(void) {
+    for (int t = 0; t < 2; t++) {
+        heap_caps_free(s_tiers[t].slots);
+        heap_caps_free(s_tiers[t].arena);
+        s_tiers[t] = (text_tier_t){0};
+    }
+}
+
+// Allocate the atlas on the first draw, so boards that never draw text keep the RAM
+static esp_err_t cache_alloc(void) {
+    if (s_tiers[0].arena || s_tiers[1].arena) return ESP_OK;
+    if (!s_tier_size[0] && !s_tier_size[1]) return ESP_ERR_INVALID_STATE;
+
+    uint32_t caps[2] = { MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, MALLOC_CAP_SPIRAM };
+    for (int t = 0; t < 2; t++) {
+        if (s_tier_size[t] == 0) continue;
+        text_tier_t *tier = &s_tiers[t];
+        // Slot tables stay in internal RAM: they are probed for every glyph
+        tier->slots = heap_caps_malloc(RM_TEXT_CACHE_SLOTS * sizeof(text_glyph_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        tier->arena = heap_caps_malloc(s_tier_size[t], caps[t]);
+        if (!tier->slots || !tier->arena) {
+            ESP_LOGE(TAG, "OOM allocating %u KB glyph atlas", (unsigned)(s_tier_size[t] / 1024));
+            cache_free();
+            return ESP_ERR_NO_MEM;
+        }
+        memset(tier->slots, 0, RM_TEXT_CACHE_SLOTS * sizeof(text_glyph_t));
+        tier->size = s_tier_size[t];
+    }
+    ESP_LOGI(TAG, "Glyph atlas: %u KB internal, %u KB PSRAM",
+             (unsigned)(s_tier_size[0] / 1024), (unsigned)(s_tier_size[1] / 1024));
+    return ESP_OK;
+}
+
+void rm690b0_text_cache_deinit(void) {
+    cache_free();
+    s_tier_size[0] = s_tier_size[1] = 0;
+}
+
+void rm690b0_text_get_stats(rm690b0_text_stats_t *stats) {
+    *stats = s_stats;
+    stats->internal_used = s_tiers[TEXT_TIER_HOT].used;
+    stats->psram_used = s_tiers[TEXT_TIER_PSRAM].used;
+}
+
+static text_tier_t *tier_for(const rm690b0_font_t *f) {
+    bool hot = f->line_height <= RM_TEXT_HOT_HEIGHT;
+    text_tier_t *t = &s_tiers[hot ? TEXT_TIER_HOT : TEXT_TIER_PSRAM];
+    if (!t->arena) t = &s_tiers[hot ? TEXT_TIER_PSRAM : TEXT_TIER_HOT];
+    return t->arena ? t : NULL;
+}
+
+static void tier_flush(text_tier_t *t) {
+    memset(t->slots, 0, RM_TEXT_CACHE_SLOTS * sizeof(text_glyph_t));
+    t->used = 0;
+    t->count = 0;
+    t->gen++;
+    s_stats.flushes++;
+}
+
+static text_glyph_t *tier_probe(text_tier_t *t, const void *key, uint32_t cp) {
+    uint32_t h = ((uint32_t)(uintptr_t)key >> 4) ^ (cp * 2654435761u);
+    for (uint32_t i = 0; i < RM_TEXT_CACHE_SLOTS; i++) {
+        text_glyph_t *s = &t->slots[(h + i) & (RM_TEXT_CACHE_SLOTS - 1)];
+        if (!s->key || (s->key == key && s->cp == cp)) return s;
+    }
+    return NULL;
+}
+
+static void glyph_expand(const rm690b0_font_t *f, const rm690b0_font_glyph_t *g, const uint8_t *bits, uint8_t *out) {
+    size_t stride = (g->w * f->bpp + 7) / 8;
+    for (uint8_t y = 0; y < g->h; y++) {
+        const uint8_t *row = bits + y * stride;
+        for (uint8_t x = 0; x < g->w; x++) {
+            uint8_t v;
+            if (f->bpp == 1) v = ((row[x >> 3] >> (7 - (x & 7))) & 1) ? 15 : 0;
+            else if (f->bpp == 4) v = (row[x >> 1] >> ((x & 1) ? 0 : 4)) & 0x0F;
+            else v = row[x] >> 4;
+            *out++ = v;
+        }
+    }
+}
+
+static const text_glyph_t *glyph_get(const rm690b0_font_t *f, uint32_t cp) {
+    text_tier_t *t = tier_for(f);
+    if (!t || cp > 0xFFFF) return NULL;
+    const void *key = font_key(f);
+    s_stats.lookups++;
+
+    text_glyph_t *s = tier_probe(t, key, cp);
+    if (s && s->key) {
+        s_stats.hits++;
+        return s;
+    }
+
+    rm690b0_font_glyph_t g;
+    const uint8_t *bits;
+    if (!font_glyph(f, cp, &g, &bits)) return NULL;
+    size_t bytes = (size_t)g.w * g.h;
+    if (bytes > t->size) return NULL;
+    if (t->used + bytes > t->size || t->count >= RM_TEXT_CACHE_SLOTS * 3 / 4) {
+        tier_flush(t);
+        s = tier_probe(t, key, cp);
+    }
+
+    uint8_t *cov = t->arena + t->used;
+    glyph_expand(f, &g, bits, cov);
+    t->used += bytes;
+    t->count++;
+    *s = (text_glyph_t){
+        .key = key, .cp = (uint16_t)cp, .w = g.w, .h = g.h,
+        .x_off = g.x_off, .y_off = g.y_off, .advance = g.advance, .cov = cov,
+    };
+    s_stats.misses++;
+    return s;
+}
+
+static const uint16_t *lut_get(uint16_t fg, uint16_t bg) {
+    for (int i = 0; i < RM_TEXT_LUTS; i++) {
+        if (s_luts[i].valid && s_luts[i].fg == fg && s_luts[i].bg == bg) return s_luts[i].be;
+    }
+    text_lut_t *l = &s_luts[s_lut_next];
+    s_lut_next = (s_lut_next + 1) % RM_TEXT_LUTS;
+    l->fg = fg;
+    l->bg = bg;
+    l->valid = true;
+    for (int i = 0; i < TEXT_COV_LEVELS; i++) {
+        l->be[i] = rm_color_be(rm_raster_blend(fg, bg, (uint8_t)(i * 17)));
+    }
+    s_stats.lut_builds++;
+    return l->be;
+}
+
+// --- Runs ---
+
+// Lay out one line starting at *utf8, which is left on the '\n' or NUL ending it.
+// Glyphs entirely outside [clip_x0, clip_x1) are not placed.
+static esp_err_t run_layout(text_run_t *r, const rm690b0_font_t *f, int32_t x, const char **utf8,
+                            int32_t clip_x0, int32_t clip_x1) {
+    const char *start = *utf8;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        uint32_t gen0 = s_tiers[0].gen + s_tiers[1].gen;
+        const char *p = start;
+        int32_t pen = x;
+        uint32_t prev = 0;
+        r->n = 0;
+        r->pen_x0 = x;
+
+        while (*p && *p != '\n') {
+            uint32_t cp = utf8_next(&p);
+            if (pen >= clip_x1) continue;   // Consume the rest of the line
+            const text_glyph_t *g = glyph_get(f, cp);
+            if (!g) g = glyph_get(f, '?');
+            if (!g) continue;
+            if (prev && f->kern_count) pen += font_kern(f, prev, cp);
+            prev = cp;
+            int32_t gx = pen + g->x_off;
+            if (g->w && gx < clip_x1 && gx + g->w > clip_x0 && r->n < RM_TEXT_MAX_RUN) {
+                r->glyphs[r->n++] = (text_placed_t){ (int16_t)gx, g->y_off, g };
+            }
+            pen += g->advance;
+        }
+        r->pen_x1 = pen;
+        *utf8 = p;
+        // An atlas tier was emptied under this line: the earlier glyphs are gone
+        if (s_tiers[0].gen + s_tiers[1].gen == gen0) return ESP_OK;
+    }
+    ESP_LOGW(TAG, "Line does not fit the glyph atlas");
+    return ESP_ERR_NO_MEM;
+}
+
+// Compose n pixels of screen row sy from column sx
+static void run_row(text_run_t *r, int32_t sx, int32_t sy, uint16_t n, uint16_t *dst_be) {
+    uint8_t *cov = r->cov;
+    memset(cov, 0, n);
+    int32_t ly = sy - r->top;
+    for (uint16_t i = 0; i < r->n; i++) {
+        const text_placed_t *pl = &r->glyphs[i];
+        const text_glyph_t *g = pl->g;
+        if (ly < pl->y || ly >= pl->y + g->h) continue;
+        int32_t a = (pl->x > sx) ? pl->x : sx;
+        int32_t b = (pl->x + g->w < sx + n) ? pl->x + g->w : sx + n;
+        const uint8_t *src = g->cov + (ly - pl->y) * g->w + (a - pl->x);
+        for (int32_t c = a; c < b; c++, src++) {
+            if (*src > cov[c - sx]) cov[c - sx] = *src;
+        }
+    }
+    for (uint16_t i = 0; i < n; i++) dst_be[i] = r->lut[cov[i]];
+}
+
+typedef struct {
+    text_run_t *run;
+    int32_t x0, y0;         // Window origin
+} text_gen_t;
+
+static void text_gen(void *ctx, uint16_t x, uint16_t y, uint16_t n, uint16_t *dst) {
+    text_gen_t *g = ctx;
+    run_row(g->run, g->x0 + x, g->y0 + y, n, dst);
+}
+
+// Memory target: screen rows y0 .. y0 + rows - 1 starting at px
+typedef struct {
+    uint16_t *px;
+    size_t stride;
+    int32_t y0, rows;
+    bool fb;                // The framebuffer: mark what was drawn dirty
+} text_canvas_t;
+
+// cv NULL: straight to the panel
+static esp_err_t text_lines(const rm690b0_text_style_t *st, int16_t x, int16_t y, const char *utf8,
+                            const text_canvas_t *cv) {
+    if (!st || !st->font || !utf8) return ESP_ERR_INVALID_ARG;
+    esp_err_t ret = cache_alloc();
+    if (ret != ESP_OK) return ret;
+
+    int32_t cx0 = 0, cy0 = 0, cx1 = rm690b0_get_width(), cy1 = rm690b0_get_height();
+    if (cv) {
+        if (cv->y0 > cy0) cy0 = cv->y0;
+        if (cv->y0 + cv->rows < cy1) cy1 = cv->y0 + cv->rows;
+    }
+    if (st->clip_w) {
+        if (st->clip_x > cx0) cx0 = st->clip_x;
+        if (st->clip_y > cy0) cy0 = st->clip_y;
+        if (st->clip_x + st->clip_w < cx1) cx1 = st->clip_x + st->clip_w;
+        if (st->clip_y + st->clip_h < cy1) cy1 = st->clip_y + st->clip_h;
+    }
+    if (cx1 > TEXT_ROW_MAX) cx1 = TEXT_ROW_MAX;
+
+    const rm690b0_font_t *f = st->font;
+    text_run_t *r = &s_run;
+    r->lut = lut_get(st->fg, st->bg);
+
+    for (int32_t top = y;; top += f->line_height) {
+        if (top >= cy1) break;
+        bool visible = top + f->line_height > cy0;
+        if (visible) {
+            ret = run_layout(r, f, x, &utf8, cx0, cx1);
+            if (ret != ESP_OK) break;
+        } else {
+            while (*utf8 && *utf8 != '\n') utf8++;
+        }
+
+        int32_t bx0 = (r->pen_x0 > cx0) ? r->pen_x0 : cx0;
+        int32_t bx1 = (r->pen_x1 < cx1) ? r->pen_x1 : cx1;
+        int32_t by0 = (top > cy0) ? top : cy0;
+        int32_t by1 = (top + f->line_height < cy1) ? top + f->line_height : cy1;
+        if (visible && bx1 > bx0 && by1 > by0) {
+            r->top = (int16_t)top;
+            if (cv) {
+                for (int32_t sy = by0; sy < by1; sy++) {
+                    run_row(r, bx0, sy, (uint16_t)(bx1 - bx0), cv->px + (size_t)(sy - cv->y0) * cv->stride + bx0);
+                }
+                if (cv->fb) {
+                    rm690b0_fb_mark_dirty((uint16_t)bx0, (uint16_t)by0, (uint16_t)(bx1 - bx0), (uint16_t)(by1 - by0));
+                }
+            } else {
+                // Column pairs for the window, the extra column composed like the rest
+                bx0 &= ~1;
+                if (bx1 & 1) bx1++;
+                if (bx1 > rm690b0_get_width()) bx1 = rm690b0_get_width();
+                text_gen_t g = { r, bx0, by0 };
+                rm690b0_source_t src;
+                rm690b0_source_generator(&src, text_gen, &g, (uint16_t)(bx1 - bx0), (uint16_t)(by1 - by0));
+                ret = rm690b0_draw_source((uint16_t)bx0, (uint16_t)by0, (uint16_t)(bx1 - bx0), (uint16_t)(by1 - by0), &src);
+                if (ret != ESP_OK) break;
+            }
+            s_stats.lines++;
+        }
+
+        if (*utf8 != '\n') break;
+        utf8++;
+    }
+    return ret;
+}
+
+esp_err_t rm690b0_draw_text(const rm690b0_text_style_t *style, int16_t x, int16_t y, const char *utf8) {
+    return text_lines(style, x, y, utf8, NULL);
+}
+
+esp_err_t rm690b0_fb_draw_text(const rm690b0_text_style_t *style, int16_t x, int16_t y, const char *utf8) {
+    text_canvas_t cv = { .fb = true };
+    cv.px = rm690b0_fb_get(&cv.stride);
+    if (!cv.px) return ESP_ERR_INVALID_STATE;
+    cv.rows = rm690b0_get_height();
+    return text_lines(style, x, y, utf8, &cv);
+}
+
+esp_err_t rm690b0_text_draw_rows(const rm690b0_text_style_t *style, int16_t x, int16_t y, const char *utf8,
+                                 uint16_t *canvas_be, size_t stride, int16_t y0, uint16_t rows) {
+    if (!canvas_be) return ESP_ERR_INVALID_ARG;
+    text_canvas_t cv = { .px = canvas_be, .stride = stride, .y0 = y0, .rows = rows };
+    return text_lines(style, x, y, utf8, &cv);
+}
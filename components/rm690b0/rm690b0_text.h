@@ -0,0 +1,155 @@
+#ifndef RM690B0_TEXT_H
+#define RM690B0_TEXT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "rm690b0_asset.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Fonts and text runs.
+ *
+ * Fonts are RMF1 files, usually a blob in the asset pack (tools/rm690b0_img
+ * font converts BDF, optionally supersampled into anti-aliased 4-bit glyphs),
+ * plus the built-in 8x16 console font. Glyphs are expanded once into a glyph
+ * atlas of 4-bit coverage: small fonts (line height up to RM_TEXT_HOT_HEIGHT)
+ * in internal RAM, larger ones in PSRAM. A full atlas tier is emptied and
+ * refilled rather than evicted glyph by glyph.
+ *
+ * A line of text is laid out once (advances, kerning, clipping) and sent as a
+ * single window over its box: every row is composed from the atlas and mapped
+ * through a 16-entry coverage-to-RGB565 table built per fg/bg pair. The box is
+ * opaque, filled with bg.
+ *
+ * Like the other draw calls, use from the task that owns the display.
+ */
+
+#define RM_FONT_MAGIC           "RMF1"
+#define RM_TEXT_HOT_HEIGHT      32      // Fonts up to this line height go to internal RAM
+#define RM_TEXT_MAX_RUN         160     // Glyphs per line, the rest is cut
+#define RM_TEXT_CACHE_SLOTS     256     // Glyphs per atlas tier
+#define RM_TEXT_LUTS            8       // Cached fg/bg tables
+
+// On-flash layout, little-endian
+typedef struct {
+    char magic[4];
+    uint8_t bpp;            // 1, 4 or 8 bits per glyph pixel, rows byte-aligned
+    uint8_t line_height;
+    uint8_t ascent;         // Baseline, from the top of the line
+    uint8_t flags;
+    uint16_t first;         // First code point
+    uint16_t count;         // Glyph entries, code points first .. first + count - 1
+    uint16_t kern_count;
+    uint16_t reserved;
+} rm690b0_font_header_t;
+
+typedef struct {
+    uint32_t offset;        // Bitmap, from the start of the file
+    uint8_t w, h;           // 0 x 0 with advance 0: no glyph for this code point
+    int8_t x_off;           // From the pen position
+    int8_t y_off;           // From the top of the line
+    uint8_t advance;
+    uint8_t reserved[3];
+} rm690b0_font_glyph_t;
+
+// Sorted by (left, right)
+typedef struct {
+    uint16_t left, right;   // Code points
+    int8_t adjust;          // Added to the advance of left
+    uint8_t reserved[3];
+} rm690b0_font_kern_t;
+
+_Static_assert(sizeof(rm690b0_font_header_t) == 16, "font header layout");
+_Static_assert(sizeof(rm690b0_font_glyph_t) == 12, "font glyph layout");
+_Static_assert(sizeof(rm690b0_font_kern_t) == 8, "font kerning layout");
+
+typedef struct {
+    const uint8_t *data;            // NULL for the built-in font
+    const rm690b0_font_glyph_t *glyphs;
+    const rm690b0_font_kern_t *kern;
+    uint16_t first, count, kern_count;
+    uint8_t bpp, line_height, ascent;
+} rm690b0_font_t;
+
+typedef struct {
+    uint32_t lookups;       // Glyphs laid out
+    uint32_t hits;          // Found in the atlas
+    uint32_t misses;        // Expanded into the atlas
+    uint32_t flushes;       // Atlas tiers emptied because they were full
+    uint32_t lut_builds;    // Coverage tables computed
+    uint32_t lines;         // Lines drawn (one window each on the panel)
+    size_t internal_used, internal_size;
+    size_t psram_used, psram_size;
+} rm690b0_text_stats_t;
+
+typedef struct {
+    const rm690b0_font_t *font;
+    uint16_t fg, bg;        // RGB565
+    int16_t clip_x, clip_y; // Clip rectangle, clip_w == 0: whole screen
+    uint16_t clip_w, clip_h;
+} rm690b0_text_style_t;
+
+/**
+ * @brief Size the glyph atlas. Nothing is allocated until the first text is
+ * drawn, which then fails with ESP_ERR_NO_MEM if the atlas does not fit.
+ * @param internal_bytes Atlas for fonts up to RM_TEXT_HOT_HEIGHT, 0: use PSRAM for all
+ * @param psram_bytes Atlas for larger fonts
+ */
+esp_err_t rm690b0_text_cache_init(size_t internal_bytes, size_t psram_bytes);
+
+void rm690b0_text_cache_deinit(void);
+
+void rm690b0_text_get_stats(rm690b0_text_stats_t *stats);
+
+/**
+ * @brief Use an RMF1 file in memory or mapped flash (kept referenced)
+ */
+esp_err_t rm690b0_font_open(rm690b0_font_t *font, const void *data, size_t size);
+
+/**
+ * @brief Use a font blob from an asset pack
+ */
+esp_err_t rm690b0_font_open_asset(rm690b0_font_t *font, const rm690b0_asset_t *asset);
+
+/**
+ * @brief The 8x16 console font (rm690b0_font.h)
+ */
+void rm690b0_font_builtin(rm690b0_font_t *font);
+
+/**
+ * @brief Advance width of the first line of a string, kerning included
+ */
+int32_t rm690b0_text_width(const rm690b0_font_t *font, const char *utf8);
+
+/**
+ * @brief Draw UTF-8 text with its top-left at (x, y), one window per line.
+ *
+ * '\n' starts a new line. Boxes are widened to the even columns the panel
+ * window needs, so up to one column of bg may land outside the clip rectangle.
+ * @return ESP_ERR_NO_MEM if the atlas cannot hold one line's glyphs
+ */
+esp_err_t rm690b0_draw_text(const rm690b0_text_style_t *style, int16_t x, int16_t y, const char *utf8);
+
+/**
+ * @brief Same as rm690b0_draw_text() into the framebuffer (rm690b0_fb.h)
+ */
+esp_err_t rm690b0_fb_draw_text(const rm690b0_text_style_t *style, int16_t x, int16_t y, const char *utf8);
+
+/**
+ * @brief Same into a big-endian canvas as wide as the screen that holds screen
+ * rows y0 .. y0 + rows - 1 (a band buffer, rm690b0_band.h). Other rows are cut.
+ * @param stride Canvas row pitch in pixels
+ */
+esp_err_t rm690b0_text_draw_rows(const rm690b0_text_style_t *style, int16_t x, int16_t y, const char *utf8,
+                                 uint16_t *canvas_be, size_t stride, int16_t y0, uint16_t rows);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,87 @@
+#include "rm690b0_vsync.h"
+
+// Filter gains as right shifts: period 1/8, phase 1/4, jitter 1/16
+#define PERIOD_SHIFT    3
+#define PHASE_SHIFT     2
+#define JITTER_SHIFT    4
+
+// Gaps longer than this many periods restart the estimate (panel off, sleep)
+#define RESYNC_PERIODS  16
+
+void rm_vsync_init(rm690b0_vsync_est_t *e, uint32_t nominal_us) {
+    if (nominal_us == 0) nominal_us = RM_VSYNC_NOMINAL_US;
+
+    *e = (rm690b0_vsync_est_t){0};
+    e->period_q8 = nominal_us << 8;
+}
+
+uint32_t rm_vsync_period_us(const rm690b0_vsync_est_t *e) {
+    return (e->period_q8 + 128) >> 8;
+}
+
+uint32_t rm_vsync_jitter_us(const rm690b0_vsync_est_t *e) {
+    return (e->jitter_q8 + 128) >> 8;
+}
+
+bool rm_vsync_edge(rm690b0_vsync_est_t *e, int64_t t_us) {
+    if (e->edges == 0) {
+        e->last_us = t_us;
+        e->phase_us = t_us;
+        e->edges = 1;
+        return true;
+    }
+
+    int64_t period = rm_vsync_period_us(e);
+    int64_t dt = t_us - e->last_us;
+
+    if (dt < period / 2) {
+        e->spurious++;
+        return false;
+    }
+
+    // Periods elapsed since the last accepted edge
+    int64_t n = (dt + period / 2) / period;
+
+    if (n > RESYNC_PERIODS) {
+        e->resyncs++;
+        e->last_us = t_us;
+        e->phase_us = t_us;
+        e->edges = 1;
+        e->locked = false;
+        return true;
+    }
+
+    e->missed += (uint32_t)(n - 1);
+
+    // Period: filter the measured interval toward the estimate
+    int64_t measured_q8 = (dt << 8) / n;
+    e->period_q8 = (uint32_t)((int64_t)e->period_q8 + (measured_q8 - (int64_t)e->period_q8) / (1 << PERIOD_SHIFT));
+
+    // Phase: move the prediction part of the way toward the observed edge
+    int64_t predicted = e->phase_us + n * period;
+    int64_t err = t_us - predicted;
+    e->phase_us = predicted + err / (1 << PHASE_SHIFT);
+
+    uint32_t abs_err = (uint32_t)(err < 0 ? -err : err);
+    e->jitter_q8 = (uint32_t)((int64_t)e->jitter_q8 + (((int64_t)abs_err << 8) - (int64_t)e->jitter_q8) / (1 << JITTER_SHIFT));
+
+    e->last_us = t_us;
+    e->edges++;
+
+    if (!e->locked && e->edges >= RM_VSYNC_LOCK_EDGES) {
+        e->locked = true;
+        e->max_jitter_us = 0;
+    } else if (e->locked && abs_err > e->max_jitter_us) {
+        e->max_jitter_us = abs_err;
+    }
+    return true;
+}
+
+int64_t rm_vsync_next(const rm690b0_vsync_est_t *e, int64_t now_us) {
+    int64_t period = rm_vsync_period_us(e);
+    if (e->edges == 0 || period == 0) return now_us;
+
+    if (now_us <= e->phase_us) return e->phase_us;
+    int64_t n = (now_us - e->phase_us + period - 1) / period;
+    return e->phase_us + n * period;
+}
@@ -0,0 +1,70 @@
+#ifndef RM690B0_VSYNC_H
+#define RM690B0_VSYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Refresh period and phase estimator for the panel TE signal.
+ *
+ * Fed with TE edge timestamps (microseconds), it tracks the refresh period
+ * with a first-order filter, predicts the next edge, and counts edges that
+ * were missed (gaps of several periods) or spurious (edges far inside one
+ * period). Pure C so it can be driven with synthetic timestamps on a host.
+ */
+
+// 60Hz nominal refresh
+#define RM_VSYNC_NOMINAL_US         16667
+
+// Edges needed before the estimate is considered locked
+#define RM_VSYNC_LOCK_EDGES         8
+
+typedef struct {
+    int64_t last_us;        // Last accepted edge
+    int64_t phase_us;       // Filtered edge time the predictions are anchored to
+    uint32_t period_q8;     // Period estimate, microseconds << 8
+    uint32_t jitter_q8;     // Mean absolute prediction error, microseconds << 8
+    uint32_t max_jitter_us; // Largest prediction error since lock
+    uint32_t edges;         // Accepted edges
+    uint32_t missed;        // Periods without an edge
+    uint32_t spurious;      // Rejected edges (less than half a period apart)
+    uint32_t resyncs;       // Restarts after long gaps
+    bool locked;
+} rm690b0_vsync_est_t;
+
+/**
+ * @brief Reset the estimator
+ * @param nominal_us Initial period guess, 0 for RM_VSYNC_NOMINAL_US
+ */
+void rm_vsync_init(rm690b0_vsync_est_t *e, uint32_t nominal_us);
+
+/**
+ * @brief Feed one TE edge timestamp
+ * @return true when the edge was accepted
+ */
+bool rm_vsync_edge(rm690b0_vsync_est_t *e, int64_t t_us);
+
+/**
+ * @brief Predicted time of the first edge at or after now_us
+ */
+int64_t rm_vsync_next(const rm690b0_vsync_est_t *e, int64_t now_us);
+
+/**
+ * @brief Estimated refresh period in microseconds
+ */
+uint32_t rm_vsync_period_us(const rm690b0_vsync_est_t *e);
+
+/**
+ * @brief Mean absolute edge jitter in microseconds
+ */
+uint32_t rm_vsync_jitter_us(const rm690b0_vsync_est_t *e);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
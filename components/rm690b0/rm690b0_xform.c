@@ -0,0 +1,122 @@
+#include "rm690b0_xform.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define XFORM_BLOCK     16      // Block side in pixels: 512 bytes each of source and destination
+
+// native = M * screen + t, checked against the panel in the simulator
+static const rm690b0_xform_t s_xforms[4] = {
+    // 0: Landscape (USB Bottom) - Default; MV, MY
+    { .rotation = 0, .madctl = 0xA0, .turns = 3, .width = 600, .height = 450,
+      .offset_x = 0, .offset_y = 16, .xx = 0, .xy = 1, .yx = -1, .yy = 0, .tx = 0, .ty = 599 },
+    // 1: Portrait (USB Right) - CCW 90; MY, MX
+    { .rotation = 1, .madctl = 0xC0, .turns = 2, .width = 450, .height = 600,
+      .offset_x = 14, .offset_y = 0, .xx = -1, .xy = 0, .yx = 0, .yy = -1, .tx = 449, .ty = 599 },
+    // 2: Landscape (USB Top) - CCW 180; MV, MX
+    { .rotation = 2, .madctl = 0x60, .turns = 1, .width = 600, .height = 450,
+      .offset_x = 0, .offset_y = 14, .xx = 0, .xy = -1, .yx = 1, .yy = 0, .tx = 449, .ty = 0 },
+    // 3: Portrait (USB Left) - Native
+    { .rotation = 3, .madctl = 0x00, .turns = 0, .width = 450, .height = 600,
+      .offset_x = 16, .offset_y = 0, .xx = 1, .xy = 0, .yx = 0, .yy = 1, .tx = 0, .ty = 0 },
+};
+
+const rm690b0_xform_t *rm690b0_xform_get(uint8_t rotation) {
+    return &s_xforms[rotation & 3];
+}
+
+void rm690b0_xform_map_rect(const rm690b0_xform_t *from, const rm690b0_xform_t *to,
+                            int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1) {
+    // Map the corner pixels, then order them
+    int32_t ax, ay, bx, by;
+    rm690b0_xform_to_native(from, *x0, *y0, &ax, &ay);
+    rm690b0_xform_from_native(to, ax, ay, &ax, &ay);
+    rm690b0_xform_to_native(from, *x1 - 1, *y1 - 1, &bx, &by);
+    rm690b0_xform_from_native(to, bx, by, &bx, &by);
+    *x0 = (ax < bx) ? ax : bx;
+    *x1 = ((ax > bx) ? ax : bx) + 1;
+    *y0 = (ay < by) ? ay : by;
+    *y1 = ((ay > by) ? ay : by) + 1;
+}
+
+// One block, a pixel at a time: odd sizes, strides or alignment
+static void rotate_block(uint16_t *dst, size_t dst_stride, const uint16_t *src, size_t src_stride,
+                         uint16_t w, uint16_t h, uint8_t turns,
+                         uint16_t bx, uint16_t by, uint16_t bw, uint16_t bh) {
+    for (uint16_t y = by; y < by + bh; y++) {
+        const uint16_t *s = src + (size_t)y * src_stride;
+        for (uint16_t x = bx; x < bx + bw; x++) {
+            switch (turns) {
+                case 1: dst[(size_t)x * dst_stride + (h - 1 - y)] = s[x]; break;
+                case 2: dst[(size_t)(h - 1 - y) * dst_stride + (w - 1 - x)] = s[x]; break;
+                default: dst[(size_t)(w - 1 - x) * dst_stride + y] = s[x]; break;
+            }
+        }
+    }
+}
+
+// Pixel pairs are moved as 32-bit words through memcpy, which compiles to one
+// load or store once the compiler knows the address is word aligned
+static inline uint32_t pair_load(const uint16_t *p) {
+    uint32_t v;
+    memcpy(&v, __builtin_assume_aligned(p, 4), 4);
+    return v;
+}
+
+static inline void pair_store(uint16_t *p, uint32_t v) {
+    memcpy(__builtin_assume_aligned(p, 4), &v, 4);
+}
+
+// Two source rows by two columns per step: two 32-bit loads, two stores.
+// Pixel pairs are little-endian in a word (lower address, low half), as on
+// the ESP32-S3 and the host. Only called with even sizes and strides on word
+// aligned buffers, so every pair starts on a word.
+static void rotate_block_pairs(uint16_t *dst, size_t dst_stride, const uint16_t *src, size_t src_stride,
+                               uint16_t w, uint16_t h, uint8_t turns,
+                               uint16_t bx, uint16_t by, uint16_t bw, uint16_t bh) {
+    for (uint16_t y = by; y < by + bh; y += 2) {
+        const uint16_t *s0 = src + (size_t)y * src_stride + bx;
+        const uint16_t *s1 = src + (size_t)(y + 1) * src_stride + bx;
+        for (uint16_t i = 0; i < bw / 2; i++) {
+            uint32_t a = pair_load(s0 + 2 * i), b = pair_load(s1 + 2 * i);   // (x, y) (x+1, y) and (x, y+1) (x+1, y+1)
+            uint16_t x = bx + 2 * i;
+            if (turns == 1) {
+                // Row x gets (x, y+1) (x, y) at column h-2-y, row x+1 the x+1 pair
+                pair_store(dst + (size_t)x * dst_stride + (h - 2 - y), (b & 0xFFFF) | (a << 16));
+                pair_store(dst + (size_t)(x + 1) * dst_stride + (h - 2 - y), (b >> 16) | (a & 0xFFFF0000u));
+            } else if (turns == 2) {
+                // Both rows mirrored: each pair swapped and placed from the right
+                pair_store(dst + (size_t)(h - 1 - y) * dst_stride + (w - 2 - x), (a >> 16) | (a << 16));
+                pair_store(dst + (size_t)(h - 2 - y) * dst_stride + (w - 2 - x), (b >> 16) | (b << 16));
+            } else {
+                // Row w-1-x gets (x, y) (x, y+1) at column y, row w-2-x the x+1 pair
+                pair_store(dst + (size_t)(w - 1 - x) * dst_stride + y, (a & 0xFFFF) | (b << 16));
+                pair_store(dst + (size_t)(w - 2 - x) * dst_stride + y, (a >> 16) | (b & 0xFFFF0000u));
+            }
+        }
+    }
+}
+
+void rm_xform_rotate(uint16_t *dst, size_t dst_stride, const uint16_t *src, size_t src_stride,
+                     uint16_t w, uint16_t h, uint8_t turns) {
+    turns &= 3;
+    if (turns == 0) {
+        for (uint16_t y = 0; y < h; y++) {
+            memcpy(dst + (size_t)y * dst_stride, src + (size_t)y * src_stride, (size_t)w * 2);
+        }
+        return;
+    }
+
+    bool pairs = !((w | h | src_stride | dst_stride) & 1) &&
+                 !(((uintptr_t)src | (uintptr_t)dst) & 3);
+    for (uint16_t by = 0; by < h; by += XFORM_BLOCK) {
+        uint16_t bh = (h - by < XFORM_BLOCK) ? h - by : XFORM_BLOCK;
+        for (uint16_t bx = 0; bx < w; bx += XFORM_BLOCK) {
+            uint16_t bw = (w - bx < XFORM_BLOCK) ? w - bx : XFORM_BLOCK;
+            if (pairs) {
+                rotate_block_pairs(dst, dst_stride, src, src_stride, w, h, turns, bx, by, bw, bh);
+            } else {
+                rotate_block(dst, dst_stride, src, src_stride, w, h, turns, bx, by, bw, bh);
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef RM690B0_XFORM_H
+#define RM690B0_XFORM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Screen transforms of the four rotations.
+ *
+ * Native coordinates are the visible panel area in its own scan order: 450 x
+ * 600, rotation 3 (MADCTL 0), which is also the frame the FT6336U reports
+ * touches in. Each rotation maps its screen coordinates onto native ones with
+ * a signed permutation matrix plus an offset, and carries what the driver
+ * sends for it (MADCTL, CASET/RASET offsets into the 480-column GRAM). The
+ * display and the touch controller both take their mapping from this table,
+ * so they cannot disagree.
+ *
+ * rm_xform_rotate() turns pixel blocks by quarter turns: retained content laid
+ * out for one rotation is re-laid for another without redrawing it. This file
+ * and rm690b0_xform.c do not depend on the driver.
+ */
+
+#define RM_XFORM_NATIVE_W   450
+#define RM_XFORM_NATIVE_H   600
+
+typedef struct {
+    uint8_t rotation;
+    uint8_t madctl;
+    uint8_t turns;              // Clockwise quarter turns from screen to native
+    uint16_t width, height;     // Screen
+    uint16_t offset_x, offset_y; // Added to CASET and RASET
+    int8_t xx, xy, yx, yy;      // native x = xx * x + xy * y + tx
+    int16_t tx, ty;             // native y = yx * x + yy * y + ty
+} rm690b0_xform_t;
+
+/**
+ * @brief Transform of a rotation (0-3, higher values wrap)
+ */
+const rm690b0_xform_t *rm690b0_xform_get(uint8_t rotation);
+
+static inline void rm690b0_xform_to_native(const rm690b0_xform_t *xf, int32_t x, int32_t y,
+                                           int32_t *nx, int32_t *ny) {
+    *nx = xf->xx * x + xf->xy * y + xf->tx;
+    *ny = xf->yx * x + xf->yy * y + xf->ty;
+}
+
+// The matrix is orthogonal: its inverse is its transpose
+static inline void rm690b0_xform_from_native(const rm690b0_xform_t *xf, int32_t nx, int32_t ny,
+                                             int32_t *x, int32_t *y) {
+    *x = xf->xx * (nx - xf->tx) + xf->yx * (ny - xf->ty);
+    *y = xf->xy * (nx - xf->tx) + xf->yy * (ny - xf->ty);
+}
+
+/**
+ * @brief The same panel area in the screen coordinates of another rotation
+ * @param x0, y0, x1, y1 Rectangle in from's coordinates, x1 and y1 exclusive; replaced
+ */
+void rm690b0_xform_map_rect(const rm690b0_xform_t *from, const rm690b0_xform_t *to,
+                            int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1);
+
+/**
+ * @brief Clockwise quarter turns that re-lay content drawn in from's
+ * coordinates for to, keeping it where it is on the panel
+ */
+static inline uint8_t rm690b0_xform_turns(const rm690b0_xform_t *from, const rm690b0_xform_t *to) {
+    return (uint8_t)((from->turns - to->turns) & 3);
+}
+
+/**
+ * @brief Turn a w x h block of 16-bit pixels clockwise by quarter turns into
+ * dst, which is h x w for odd turns. Works through 16 x 16 blocks so both
+ * sides stay in cache, two pixels per 32-bit access when the sizes, strides
+ * and pointers are even. dst must not overlap src.
+ */
+void rm_xform_rotate(uint16_t *dst, size_t dst_stride, const uint16_t *src, size_t src_stride,
+                     uint16_t w, uint16_t h, uint8_t turns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -76,3 +76,7 @@ esp_err_t tca9554_get_level(uint8_t pin_mask, int *level) {
     *level = (in_reg & pin_mask) ? 1 : 0;
     return ESP_OK;
 }
+
+esp_err_t tca9554_read_inputs(uint8_t *value) {
+    return read_reg(REG_INPUT, value);
+}
@@ -48,6 +48,14 @@ esp_err_t tca9554_set_level(uint8_t pin_mask, uint8_t level);
  */
 esp_err_t tca9554_get_level(uint8_t pin_mask, int *level);
 
+/**
+ * Read the whole Input Port register.
+ * Reading also releases the INT output.
+ * @param value Pointer to store the 8 input levels (bit n = pin n).
+ * @return ESP_OK on success.
+ */
+esp_err_t tca9554_read_inputs(uint8_t *value);
+
 #ifdef __cplusplus
 }
 #endif
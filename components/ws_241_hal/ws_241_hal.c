@@ -1,5 +1,9 @@
 #include "ws_241_hal.h"
+#include "ws_241_vsync.h"
 #include "rm690b0.h"
+#include "rm690b0_server.h"
+#include "rm690b0_asset.h"
+#include "rm690b0_text.h"
 #include "ft6336u.h"
 #include "tca9554.h"
 #include "qmi8658c.h" // Local component
@@ -18,6 +22,18 @@
 
 #define BOOT_BUTTON_GPIO    0
 
+// Display server task: owns the QSPI device, every HAL task draws through it
+#define DISP_SERVER_PRIO    6
+#define DISP_SERVER_CORE    1
+
+// PSRAM budget for hot assets (rm690b0_asset.h), four full-screen images
+#define ASSET_CACHE_BYTES   (4 * 600 * 450 * 2)
+
+// Glyph atlas (rm690b0_text.h): UI-sized fonts in internal RAM, large ones in
+// PSRAM. Allocated by the first text drawn, not here.
+#define TEXT_ATLAS_INTERNAL (16 * 1024)
+#define TEXT_ATLAS_PSRAM    (128 * 1024)
+
 /*
  * Note on Power Management:
  * The ETA6098 Power Management IC used on this board is passive to the programmer.
@@ -54,6 +70,11 @@ static rm690b0_config_t g_disp_conf = {
     .host_id = WS_241_QSPI_HOST,
 };
 
+// Runs on the display server: re-init after light sleep must not interleave with draws
+static void display_reinit(void *arg) {
+    rm690b0_init(&g_disp_conf);
+}
+
 static void power_button_task(void *pvParameters) {
     const TickType_t POLL_DELAY = pdMS_TO_TICKS(100);
     const int LONG_PRESS_MS = 1500; // 1.5 Seconds
@@ -75,7 +96,8 @@ static void power_button_task(void *pvParameters) {
                     
                     // VISUAL FEEDBACK: Turn screen BLACK and OFF immediately
                     ESP_LOGI(TAG, "Turning off Display...");
-                    rm690b0_fill_screen(0x0000); // Write Black
+                    rm690b0_server_fill_screen(0x0000); // Write Black
+                    rm690b0_server_sync(1000);           // On the panel before power goes
                     ws_241_hal_set_display_power(false); // Cut Power
                     
                     // Wait for release so we don't wake up immediately
@@ -108,15 +130,16 @@ static void power_button_task(void *pvParameters) {
                     // Re-Enable Display Power
                     ws_241_hal_set_display_power(true);
                     vTaskDelay(pdMS_TO_TICKS(100)); // Wait for power stable
-                    rm690b0_init(&g_disp_conf);     // Re-Init Display Driver
+                    rm690b0_server_call(display_reinit, NULL); // Re-Init Display Driver
 
                     // VISUAL CONFIRMATION: Fill screen Green to indicate Wake
-                    rm690b0_fill_screen(0x07E0); // Bright Green
+                    rm690b0_server_fill_screen(0x07E0); // Bright Green
+                    rm690b0_server_sync(1000);
                     vTaskDelay(pdMS_TO_TICKS(1500)); // Hold for 1.5 seconds
 
                     // Restore Test Pattern (Boxes)
                     ESP_LOGI(TAG, "Restoring Test Pattern...");
-                    rm690b0_run_test_pattern();
+                    rm690b0_server_test_pattern();
 
                     // Debounce after wake
 
@@ -129,7 +152,13 @@ static void power_button_task(void *pvParameters) {
     }
 }
 
-static void boot_button_click_cb(void *arg, void *usr_data) {
+// Runs wherever the rotation changed: touch maps with the display's transform
+static void touch_follow_rotation(const rm690b0_xform_t *xf, void *ctx) {
+    ft6336u_set_transform(xf);
+}
+
+// Runs on the display server, so the rotation read and the redraw are one step
+static void rotate_next(void *arg) {
     uint8_t r = rm690b0_get_rotation();
 
     // User confirmed Rotation 1 is CCW.
@@ -138,13 +167,17 @@ static void boot_button_click_cb(void *arg, void *usr_data) {
     r = (r + 1) % 4;
 
     ESP_LOGI(TAG, "Boot Button Pressed: Rotating Screen to %d", r);
-    rm690b0_set_rotation(r);
-    ft6336u_set_rotation(r);
-    // Explicitly clear screen to remove artifacts from previous orientation
-    rm690b0_fill_screen(RM_COLOR_BLACK);
+    rm690b0_set_rotation(r); // Touch follows via touch_follow_rotation()
+    // The pattern covers the whole screen, which removes artifacts from the
+    // previous orientation without a separate clear
     rm690b0_run_test_pattern();
 }
 
+// esp_button timer context: hand the work to the display server
+static void boot_button_click_cb(void *arg, void *usr_data) {
+    rm690b0_server_call(rotate_next, NULL);
+}
+
 static adc_oneshot_unit_handle_t g_adc_handle = NULL;
 static const adc_channel_t g_adc_channel = ADC_CHANNEL_7; // GPIO18 is ADC2_CH7
 
@@ -195,6 +228,17 @@ static esp_err_t spi_bus_init(void) {
 esp_err_t ws_241_hal_get_battery_voltage(uint32_t *voltage_mv) {
     int adc_raw;
     if (g_adc_handle == NULL) return ESP_ERR_INVALID_STATE;
+
+    // GPIO18 is shared with the TCA9554 INT line used by the vsync service
+    if (ws_241_vsync_is_running()) return ESP_ERR_INVALID_STATE;
+
+    // Re-apply the channel config: it puts the pad back into analog mode if
+    // the vsync service had claimed it as a digital input
+    adc_oneshot_chan_cfg_t chan_cfg = {
+        .bitwidth = ADC_BITWIDTH_DEFAULT,
+        .atten = ADC_ATTEN_DB_12,
+    };
+    adc_oneshot_config_channel(g_adc_handle, g_adc_channel, &chan_cfg);
     
     // Attempt ADC Read
     if (adc_oneshot_read(g_adc_handle, g_adc_channel, &adc_raw) != ESP_OK) {
@@ -348,13 +392,22 @@ esp_err_t ws_241_hal_init(void) {
         return ret;
     }
 
-    // 5. Initialize Display Driver (RM690B0)
+    // 5. Initialize Display Driver (RM690B0). Touch follows every rotation
+    // change, including the reset to 0 on (re-)init.
     ESP_LOGI(TAG, "Initializing RM690B0 Display...");
+    rm690b0_set_rotation_cb(touch_follow_rotation, NULL);
     ret = rm690b0_init(&g_disp_conf);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Display Init Failed");
         return ret;
     }
+    ret = rm690b0_server_start(DISP_SERVER_PRIO, DISP_SERVER_CORE);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Display Server Start Failed");
+        return ret;
+    }
+    rm690b0_asset_cache_init(ASSET_CACHE_BYTES);
+    rm690b0_text_cache_init(TEXT_ATLAS_INTERNAL, TEXT_ATLAS_PSRAM);
 
     // 6. Initialize ADC for Battery Monitoring
     ESP_LOGI(TAG, "Initializing ADC...");
@@ -403,8 +456,8 @@ void ws_241_hal_touch_test_task(void *pvParameters) {
             uint16_t px = (x > BRUSH_SIZE/2) ? (x - BRUSH_SIZE/2) : 0;
             uint16_t py = (y > BRUSH_SIZE/2) ? (y - BRUSH_SIZE/2) : 0;
             
-            // Draw
-            rm690b0_draw_rect(px, py, BRUSH_SIZE, BRUSH_SIZE, RM_COLOR_CYAN);
+            // Queue to the display server (coalesced when it falls behind)
+            rm690b0_server_fill_rect(px, py, BRUSH_SIZE, BRUSH_SIZE, RM_COLOR_CYAN);
             
             // Log occasionally to avoid spam, or just remove for performance
             // ESP_LOGI(TAG, "Touch: %d, %d", x, y);
@@ -0,0 +1,213 @@
+#include "ws_241_vsync.h"
+#include "ws_241_hal.h"
+#include "rm690b0_vsync.h"
+#include "rm690b0_server.h"
+#include "tca9554.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "WS_241_VSYNC";
+
+// EXIO0 -> OLED_TE (see ws_241_hal.c)
+#define TCA_PIN_TE          (1 << 0)
+
+static TaskHandle_t s_task = NULL;     // Owned by start/stop
+static SemaphoreHandle_t s_stopped = NULL;  // Given by the task as it exits
+static SemaphoreHandle_t s_edge_sem = NULL;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static rm690b0_vsync_est_t s_est;
+static volatile int64_t s_isr_us;
+static volatile bool s_running = false;
+static volatile bool s_frame_busy = false;
+static uint8_t s_last_inputs;
+static uint32_t s_presented;
+static uint32_t s_late;
+
+// TCA9554 INT went low: some expander input changed
+static void IRAM_ATTR exio_int_isr(void *arg) {
+    BaseType_t woken = pdFALSE;
+    s_isr_us = esp_timer_get_time();
+    if (s_task) vTaskNotifyGiveFromISR(s_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static void vsync_task(void *pvParameters) {
+    ESP_LOGI(TAG, "Vsync Task Started");
+
+    while (s_running) {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100)) == 0 || !s_running) continue;
+        int64_t t = s_isr_us;
+
+        // Reading the input port also releases INT
+        uint8_t inputs;
+        if (tca9554_read_inputs(&inputs) != ESP_OK) continue;
+
+        bool te = (inputs & TCA_PIN_TE) != 0;
+        bool was_te = (s_last_inputs & TCA_PIN_TE) != 0;
+        uint8_t others = (inputs ^ s_last_inputs) & ~TCA_PIN_TE;
+        s_last_inputs = inputs;
+
+        // TE still high: rising edge. TE low again with nothing else changed:
+        // a short TE pulse that ended before the I2C read (INT self-clears).
+        bool rising = !was_te && (te || others == 0);
+        if (!rising) continue;
+
+        portENTER_CRITICAL(&s_lock);
+        bool accepted = rm_vsync_edge(&s_est, t);
+        portEXIT_CRITICAL(&s_lock);
+
+        if (accepted) {
+            xSemaphoreGive(s_edge_sem);
+        }
+    }
+
+    xSemaphoreGive(s_stopped);
+    vTaskDelete(NULL);
+}
+
+// Stop the task and wait until it has exited, so a start right after cannot
+// meet it (it would take the new task's notifications)
+static void vsync_task_stop(void) {
+    s_running = false;
+    xTaskNotifyGive(s_task);
+    xSemaphoreTake(s_stopped, portMAX_DELAY);
+    s_task = NULL;
+}
+
+// Runs on the display server
+static void set_scanline(void *arg) {
+    rm690b0_set_tear_scanline((uint16_t)(uintptr_t)arg);
+}
+
+esp_err_t ws_241_vsync_start(uint16_t scanline) {
+    if (s_running) return ESP_OK;
+
+    if (!s_edge_sem) {
+        s_edge_sem = xSemaphoreCreateBinary();
+        if (!s_edge_sem) return ESP_ERR_NO_MEM;
+    }
+    if (!s_stopped) {
+        s_stopped = xSemaphoreCreateBinary();
+        if (!s_stopped) return ESP_ERR_NO_MEM;
+    }
+
+    rm_vsync_init(&s_est, 0);
+    s_presented = 0;
+    s_late = 0;
+
+    // TE pin as input and a baseline read so INT starts released
+    tca9554_set_direction(TCA_PIN_TE, TCA_INPUT);
+    tca9554_read_inputs(&s_last_inputs);
+
+    rm690b0_server_call(set_scanline, (void *)(uintptr_t)scanline);
+
+    s_running = true;
+    if (xTaskCreate(vsync_task, "vsync", 3072, NULL, 10, &s_task) != pdPASS) {
+        s_running = false;
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    // INT is open-drain active low, GPIO18 is shared with the battery ADC
+    gpio_config_t int_conf = {
+        .pin_bit_mask = (1ULL << WS_241_IO_EXP_INT),
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE,
+    };
+    gpio_config(&int_conf);
+
+    esp_err_t ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) { // Already installed is fine
+        ESP_LOGE(TAG, "Failed to install GPIO ISR service");
+        vsync_task_stop();
+        return ret;
+    }
+    ret = gpio_isr_handler_add(WS_241_IO_EXP_INT, exio_int_isr, NULL);
+    if (ret != ESP_OK) {
+        vsync_task_stop();
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Vsync Service Started (TE scanline %d)", scanline);
+    return ESP_OK;
+}
+
+void ws_241_vsync_stop(void) {
+    if (!s_running) return;
+
+    gpio_isr_handler_remove(WS_241_IO_EXP_INT);
+    gpio_reset_pin(WS_241_IO_EXP_INT);
+    vsync_task_stop();
+    ESP_LOGI(TAG, "Vsync Service Stopped");
+}
+
+bool ws_241_vsync_is_running(void) {
+    return s_running;
+}
+
+esp_err_t ws_241_vsync_wait(uint32_t timeout_ms) {
+    if (!s_running) return ESP_ERR_INVALID_STATE;
+
+    // Drop an edge that was signalled before we started waiting
+    xSemaphoreTake(s_edge_sem, 0);
+    if (xSemaphoreTake(s_edge_sem, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+int64_t ws_241_vsync_next_us(void) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    int64_t next = rm_vsync_next(&s_est, now);
+    portEXIT_CRITICAL(&s_lock);
+    return next;
+}
+
+// Runs on the display server once the frame is on the panel
+static void frame_done_cb(void *user_ctx) {
+    s_frame_busy = false;
+}
+
+esp_err_t ws_241_vsync_present(const uint16_t *frame_be) {
+    esp_err_t ret = ws_241_vsync_wait(100);
+    if (ret != ESP_OK) return ret;
+
+    if (s_frame_busy) {
+        s_late++;
+    }
+
+    uint16_t w = rm690b0_get_width();
+    uint16_t h = rm690b0_get_height();
+
+    s_frame_busy = true;
+    ret = rm690b0_server_draw_bitmap(0, 0, w, h, frame_be, w, frame_done_cb, NULL);
+    if (ret != ESP_OK) {
+        s_frame_busy = false;
+        return ret;
+    }
+    s_presented++;
+    return ESP_OK;
+}
+
+void ws_241_vsync_get_stats(ws_241_vsync_stats_t *stats) {
+    portENTER_CRITICAL(&s_lock);
+    stats->period_us = rm_vsync_period_us(&s_est);
+    stats->jitter_us = rm_vsync_jitter_us(&s_est);
+    stats->max_jitter_us = s_est.max_jitter_us;
+    stats->edges = s_est.edges;
+    stats->missed = s_est.missed;
+    stats->spurious = s_est.spurious;
+    stats->locked = s_est.locked;
+    portEXIT_CRITICAL(&s_lock);
+    stats->presented = s_presented;
+    stats->late = s_late;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "rm690b0.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Vsync service. The panel TE output is wired to TCA9554 EXIO0; the expander
+ * pulls its INT line (GPIO18) low on every input change. Edges are timestamped
+ * in the GPIO ISR, classified over I2C by a service task and fed to the
+ * rm690b0_vsync estimator.
+ *
+ * GPIO18 doubles as the battery ADC input on this board, so battery readings
+ * are unavailable while the service runs.
+ */
+
+typedef struct {
+    uint32_t period_us;     // Estimated refresh period
+    uint32_t jitter_us;     // Mean absolute TE edge error
+    uint32_t max_jitter_us; // Worst edge error since lock
+    uint32_t edges;         // TE edges seen
+    uint32_t missed;        // Refresh periods without a detected edge
+    uint32_t spurious;      // Rejected edges
+    uint32_t presented;     // Frames started by ws_241_vsync_present()
+    uint32_t late;          // Presents whose previous frame was still on the wire at the edge
+    bool locked;
+} ws_241_vsync_stats_t;
+
+/**
+ * @brief Start the vsync service
+ * @param scanline TE line (STESL); flushes released by the service start when
+ *                 the panel scan reaches it. 0 = start of the frame.
+ * @return ESP_OK on success
+ */
+esp_err_t ws_241_vsync_start(uint16_t scanline);
+
+/**
+ * @brief Stop the service and release GPIO18. Returns once the edge task has
+ * exited, so the service can be started again right away.
+ */
+void ws_241_vsync_stop(void);
+
+/**
+ * @brief True while the service owns GPIO18
+ */
+bool ws_241_vsync_is_running(void);
+
+/**
+ * @brief Block until the next TE edge
+ * @param timeout_ms Maximum wait
+ * @return ESP_OK on an edge, ESP_ERR_TIMEOUT otherwise
+ */
+esp_err_t ws_241_vsync_wait(uint32_t timeout_ms);
+
+/**
+ * @brief Predicted esp_timer time (us) of the next TE edge
+ */
+int64_t ws_241_vsync_next_us(void);
+
+/**
+ * @brief Tear-free full-frame present.
+ *
+ * Waits for the next TE edge and queues the whole frame for the current
+ * rotation; returns as soon as the transfer is queued. The frame buffer must
+ * stay valid until the next present or rm690b0_flush_wait().
+ *
+ * @param frame_be Big-endian RGB565, current rotation width x height
+ */
+esp_err_t ws_241_vsync_present(const uint16_t *frame_be);
+
+/**
+ * @brief Frame pacing statistics
+ */
+void ws_241_vsync_get_stats(ws_241_vsync_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
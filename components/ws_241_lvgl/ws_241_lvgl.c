@@ -0,0 +1,237 @@
+#include "ws_241_lvgl.h"
+#include "rm690b0.h"
+#include "rm690b0_server.h"
+#include "rm690b0_color.h"
+#include "ft6336u.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "WS_241_LVGL";
+
+#define LVGL_BUF_ALIGN      64  // Cache line; also lets the swap kernel take the SIMD path
+#define LVGL_TASK_STACK     6144
+#define LVGL_MAX_SLEEP_MS   33
+
+static lv_display_t *s_disp = NULL;
+static lv_indev_t *s_indev = NULL;
+static SemaphoreHandle_t s_lock = NULL;
+static uint16_t *s_buf[2];
+static int64_t s_flush_start_us;
+static ws_241_lvgl_stats_t s_stats;
+
+static uint32_t tick_cb(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+// The panel takes CASET/RASET on even column pairs only
+static void invalidate_area_cb(lv_event_t *e) {
+    lv_area_t *area = lv_event_get_param(e);
+    if ((area->x1 & 1) || !(area->x2 & 1)) {
+        s_stats.rounded++;
+    }
+    area->x1 &= ~1;
+    area->x2 |= 1;  // Both rotation widths are even, so this stays on screen
+}
+
+// Runs on the display server once the burst has left the wire
+static void flush_done_cb(void *ctx) {
+    uint32_t us = (uint32_t)(esp_timer_get_time() - s_flush_start_us);
+    s_stats.flush_us_last = us;
+    s_stats.flush_us_avg = (s_stats.flush_us_avg == 0) ? us : s_stats.flush_us_avg + ((int32_t)(us - s_stats.flush_us_avg) >> 4);
+    if (us > s_stats.flush_us_max) s_stats.flush_us_max = us;
+
+    lv_display_flush_ready((lv_display_t *)ctx);
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    uint16_t w = lv_area_get_width(area);
+    uint16_t h = lv_area_get_height(area);
+    size_t count = (size_t)w * h;
+
+    s_flush_start_us = esp_timer_get_time();
+    s_stats.flushes++;
+    s_stats.pixels += count;
+    if (lv_display_flush_is_last(disp)) {
+        s_stats.frames++;
+    }
+
+    // LVGL renders native RGB565, the panel wants big-endian
+    uint16_t *px = (uint16_t *)px_map;
+    rm_color_swap16(px, px, count);
+
+    esp_err_t ret = rm690b0_server_draw_bitmap(area->x1, area->y1, w, h, px, w, flush_done_cb, disp);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Flush dropped: %s", esp_err_to_name(ret));
+        lv_display_flush_ready(disp);
+    }
+}
+
+static void touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+    uint16_t x, y;
+    // The HAL keeps touch in the display's coordinates (rm690b0_set_rotation_cb)
+    if (ft6336u_get_touch(&x, &y)) {
+        data->point.x = x;
+        data->point.y = y;
+        data->state = LV_INDEV_STATE_PRESSED;
+    } else {
+        data->state = LV_INDEV_STATE_RELEASED;
+    }
+}
+
+static void lvgl_task(void *pvParameters) {
+    ESP_LOGI(TAG, "LVGL Task Started");
+
+    while (1) {
+        uint32_t sleep_ms = LVGL_MAX_SLEEP_MS;
+        if (ws_241_lvgl_lock(UINT32_MAX)) {
+            sleep_ms = lv_timer_handler();
+            ws_241_lvgl_unlock();
+        }
+        if (sleep_ms > LVGL_MAX_SLEEP_MS) sleep_ms = LVGL_MAX_SLEEP_MS;
+        TickType_t ticks = pdMS_TO_TICKS(sleep_ms);
+        vTaskDelay(ticks ? ticks : 1);
+    }
+}
+
+// Runs on the display server so no burst is in flight across the MADCTL change
+static void rotate_cb(void *arg) {
+    uint8_t r = (uint8_t)(uintptr_t)arg;
+    rm690b0_set_rotation(r); // The HAL's rotation callback moves touch along
+}
+
+static esp_err_t apply_rotation(uint8_t rotation) {
+    esp_err_t ret = rm690b0_server_call(rotate_cb, (void *)(uintptr_t)rotation);
+    if (ret == ESP_OK) ret = rm690b0_server_sync(1000);
+    if (ret != ESP_OK) return ret;
+
+    lv_display_set_resolution(s_disp, rm690b0_get_width(), rm690b0_get_height());
+    return ESP_OK;
+}
+
+// Undo a failed init in reverse order, so a later init starts over
+static void lvgl_release(void) {
+    if (s_indev) {
+        lv_indev_delete(s_indev);
+        s_indev = NULL;
+    }
+    if (s_disp) {
+        lv_display_delete(s_disp);
+        s_disp = NULL;
+    }
+    for (int i = 1; i >= 0; i--) {
+        heap_caps_free(s_buf[i]);
+        s_buf[i] = NULL;
+    }
+    if (s_lock) {
+        vSemaphoreDelete(s_lock);
+        s_lock = NULL;
+    }
+}
+
+esp_err_t ws_241_lvgl_init(const ws_241_lvgl_config_t *config) {
+    ws_241_lvgl_config_t def = WS_241_LVGL_DEFAULT_CONFIG();
+    if (!config) config = &def;
+    if (s_disp) return ESP_OK;
+    if (!rm690b0_server_is_running()) {
+        ESP_LOGE(TAG, "Display server not running (ws_241_hal_init first)");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_lock = xSemaphoreCreateRecursiveMutex();
+    if (!s_lock) return ESP_ERR_NO_MEM;
+
+    // Sized for the longest side, so any rotation fits the same line count
+    uint16_t lines = config->buf_lines ? config->buf_lines : WS_241_LVGL_BUF_LINES;
+    size_t buf_bytes = (size_t)RM690B0_HEIGHT * lines * sizeof(uint16_t);
+    for (int i = 0; i < 2; i++) {
+        s_buf[i] = heap_caps_aligned_alloc(LVGL_BUF_ALIGN, buf_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!s_buf[i]) {
+            ESP_LOGE(TAG, "OOM allocating draw buffer %d (%u bytes)", i, (unsigned)buf_bytes);
+            lvgl_release();
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+
+    s_disp = lv_display_create(rm690b0_get_width(), rm690b0_get_height());
+    if (!s_disp) {
+        lvgl_release();
+        return ESP_ERR_NO_MEM;
+    }
+    lv_display_set_color_format(s_disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(s_disp, s_buf[0], s_buf[1], buf_bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(s_disp, flush_cb);
+    lv_display_add_event_cb(s_disp, invalidate_area_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+
+    s_indev = lv_indev_create();
+    if (!s_indev) {
+        lvgl_release();
+        return ESP_ERR_NO_MEM;
+    }
+    lv_indev_set_type(s_indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(s_indev, touch_read_cb);
+    lv_indev_set_display(s_indev, s_disp);
+
+    esp_err_t ret = apply_rotation(config->rotation & 3);
+    if (ret != ESP_OK) {
+        lvgl_release();
+        return ret;
+    }
+
+    BaseType_t ok;
+    if (config->task_core < 0) {
+        ok = xTaskCreate(lvgl_task, "lvgl", LVGL_TASK_STACK, NULL, config->task_priority, NULL);
+    } else {
+        ok = xTaskCreatePinnedToCore(lvgl_task, "lvgl", LVGL_TASK_STACK, NULL,
+                                     config->task_priority, NULL, config->task_core);
+    }
+    if (ok != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create LVGL task");
+        lvgl_release();
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "LVGL Initialized (%dx%d, 2 x %u line buffers)",
+             rm690b0_get_width(), rm690b0_get_height(), lines);
+    return ESP_OK;
+}
+
+bool ws_241_lvgl_lock(uint32_t timeout_ms) {
+    if (!s_lock) return false;
+    TickType_t ticks = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return xSemaphoreTakeRecursive(s_lock, ticks) == pdTRUE;
+}
+
+void ws_241_lvgl_unlock(void) {
+    xSemaphoreGiveRecursive(s_lock);
+}
+
+lv_display_t *ws_241_lvgl_get_display(void) {
+    return s_disp;
+}
+
+lv_indev_t *ws_241_lvgl_get_indev(void) {
+    return s_indev;
+}
+
+esp_err_t ws_241_lvgl_set_rotation(uint8_t rotation) {
+    if (!s_disp) return ESP_ERR_INVALID_STATE;
+    if (!ws_241_lvgl_lock(UINT32_MAX)) return ESP_ERR_TIMEOUT;
+
+    // Under the lock the LVGL task cannot start a flush; one already queued
+    // reaches the server ahead of the rotation
+    esp_err_t ret = apply_rotation(rotation & 3);
+    ws_241_lvgl_unlock();
+    return ret;
+}
+
+void ws_241_lvgl_get_stats(ws_241_lvgl_stats_t *stats) {
+    *stats = s_stats;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * LVGL port for the Waveshare 2.41 board.
+ *
+ * The display renders into two partial buffers in internal DMA RAM. Each flush
+ * is byte-swapped to the panel order in place and queued to the rm690b0
+ * display server as a zero-copy bitmap; the server signals
+ * lv_display_flush_ready() once the burst is on the panel, so LVGL renders the
+ * next area into the other buffer meanwhile. Invalidated areas are widened to
+ * even X bounds, as required by rm690b0_set_window(). The FT6336U feeds a
+ * pointer indev. Rotation uses the panel MADCTL, not LVGL software rotation.
+ *
+ * Requires ws_241_hal_init() (display server running, touch initialised).
+ */
+
+#define WS_241_LVGL_BUF_LINES   40  // Lines of the longest side per draw buffer
+
+typedef struct {
+    uint16_t buf_lines;     // Draw buffer height, 0 = WS_241_LVGL_BUF_LINES
+    uint8_t task_priority;
+    int task_core;          // -1 for any
+    uint8_t rotation;       // Initial rotation, see rm690b0_set_rotation()
+} ws_241_lvgl_config_t;
+
+#define WS_241_LVGL_DEFAULT_CONFIG() { \
+    .buf_lines = WS_241_LVGL_BUF_LINES, \
+    .task_priority = 4,                 \
+    .task_core = 0,                     \
+    .rotation = 0,                      \
+}
+
+typedef struct {
+    uint32_t frames;        // Refreshes that flushed at least one area
+    uint32_t flushes;       // Areas flushed
+    uint64_t pixels;        // Pixels flushed
+    uint32_t flush_us_last; // flush_cb to flush_ready of the last area
+    uint32_t flush_us_avg;  // Running average (1/16 weight)
+    uint32_t flush_us_max;
+    uint32_t rounded;       // Invalidated areas widened to even X
+} ws_241_lvgl_stats_t;
+
+/**
+ * @brief Initialise LVGL, register the display and touch input, start the LVGL task
+ * @param config NULL for WS_241_LVGL_DEFAULT_CONFIG()
+ */
+esp_err_t ws_241_lvgl_init(const ws_241_lvgl_config_t *config);
+
+/**
+ * @brief Take the LVGL lock. Required for any lv_* call outside the LVGL task.
+ * @param timeout_ms UINT32_MAX to wait forever
+ */
+bool ws_241_lvgl_lock(uint32_t timeout_ms);
+void ws_241_lvgl_unlock(void);
+
+/**
+ * @brief The registered display and touch input
+ */
+lv_display_t *ws_241_lvgl_get_display(void);
+lv_indev_t *ws_241_lvgl_get_indev(void);
+
+/**
+ * @brief Rotate panel, touch and LVGL resolution together (0-3) and redraw.
+ * Takes the LVGL lock.
+ */
+esp_err_t ws_241_lvgl_set_rotation(uint8_t rotation);
+
+/**
+ * @brief Flush and frame counters
+ */
+void ws_241_lvgl_get_stats(ws_241_lvgl_stats_t *stats);
+
+/**
+ * @brief Load a benchmark screen: animated objects plus a label with FPS,
+ * flush time and throughput, refreshed every second. Takes the LVGL lock.
+ */
+void ws_241_lvgl_bench_start(void);
+
+#ifdef __cplusplus
+}
+#endif
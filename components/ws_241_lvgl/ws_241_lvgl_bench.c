@@ -0,0 +1,109 @@
+#include "ws_241_lvgl.h"
+#include "rm690b0_server.h"
+#include "esp_log.h"
+
+static const char *TAG = "WS_241_LVGL_BENCH";
+
+#define BENCH_BOXES         6
+#define BENCH_BOX_SIZE      60
+#define BENCH_REPORT_MS     1000
+
+static lv_obj_t *s_label = NULL;
+static ws_241_lvgl_stats_t s_prev;
+static uint32_t s_prev_ms;
+
+static void anim_x_cb(void *obj, int32_t v) {
+    lv_obj_set_x(obj, v);
+}
+
+static void anim_y_cb(void *obj, int32_t v) {
+    lv_obj_set_y(obj, v);
+}
+
+static void report_cb(lv_timer_t *timer) {
+    ws_241_lvgl_stats_t st;
+    ws_241_lvgl_get_stats(&st);
+    rm690b0_server_stats_t srv;
+    rm690b0_server_get_stats(&srv);
+
+    uint32_t now = lv_tick_get();
+    uint32_t ms = now - s_prev_ms;
+    if (ms == 0) return;
+
+    uint32_t frames = st.frames - s_prev.frames;
+    uint32_t flushes = st.flushes - s_prev.flushes;
+    uint64_t bytes = (st.pixels - s_prev.pixels) * 2;
+    uint32_t fps_x10 = frames * 10000 / ms;
+    uint32_t kbps = (uint32_t)(bytes * 1000 / ms / 1024);
+
+    lv_label_set_text_fmt(s_label,
+                          "FPS %lu.%lu  areas/frame %lu\n"
+                          "flush avg %lu us  max %lu us\n"
+                          "%lu KB/s  coalesced %lu",
+                          (unsigned long)(fps_x10 / 10), (unsigned long)(fps_x10 % 10),
+                          (unsigned long)(frames ? flushes / frames : 0),
+                          (unsigned long)st.flush_us_avg, (unsigned long)st.flush_us_max,
+                          (unsigned long)kbps, (unsigned long)srv.coalesced);
+    ESP_LOGI(TAG, "FPS %lu.%lu, flush avg %lu us max %lu us, %lu KB/s",
+             (unsigned long)(fps_x10 / 10), (unsigned long)(fps_x10 % 10),
+             (unsigned long)st.flush_us_avg, (unsigned long)st.flush_us_max, (unsigned long)kbps);
+
+    s_prev = st;
+    s_prev_ms = now;
+}
+
+static void start_anim(lv_obj_t *obj, lv_anim_exec_xcb_t cb, int32_t to, uint32_t ms) {
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, obj);
+    lv_anim_set_exec_cb(&a, cb);
+    lv_anim_set_values(&a, 0, to);
+    lv_anim_set_duration(&a, ms);
+    lv_anim_set_playback_duration(&a, ms);
+    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_start(&a);
+}
+
+void ws_241_lvgl_bench_start(void) {
+    static const uint32_t colors[BENCH_BOXES] = {
+        0xFF0000, 0x00FF00, 0x0000FF, 0xFFFF00, 0x00FFFF, 0xFF00FF,
+    };
+
+    if (!ws_241_lvgl_lock(UINT32_MAX)) return;
+
+    lv_obj_t *scr = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+    lv_obj_remove_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
+
+    int32_t w = lv_display_get_horizontal_resolution(ws_241_lvgl_get_display());
+    int32_t h = lv_display_get_vertical_resolution(ws_241_lvgl_get_display());
+
+    // Boxes bouncing at different rates: many small, overlapping invalid areas
+    for (int i = 0; i < BENCH_BOXES; i++) {
+        lv_obj_t *box = lv_obj_create(scr);
+        lv_obj_set_size(box, BENCH_BOX_SIZE, BENCH_BOX_SIZE);
+        lv_obj_set_style_bg_color(box, lv_color_hex(colors[i]), 0);
+        lv_obj_set_style_radius(box, 8, 0);
+        lv_obj_set_style_border_width(box, 0, 0);
+        start_anim(box, anim_x_cb, w - BENCH_BOX_SIZE, 1100 + i * 270);
+        start_anim(box, anim_y_cb, h - BENCH_BOX_SIZE, 1700 + i * 190);
+    }
+
+    lv_obj_t *spinner = lv_spinner_create(scr);
+    lv_obj_set_size(spinner, 120, 120);
+    lv_obj_center(spinner);
+
+    s_label = lv_label_create(scr);
+    lv_obj_set_style_text_color(s_label, lv_color_white(), 0);
+    lv_obj_set_style_bg_color(s_label, lv_color_hex(0x202020), 0);
+    lv_obj_set_style_bg_opa(s_label, LV_OPA_COVER, 0);
+    lv_obj_align(s_label, LV_ALIGN_TOP_LEFT, 4, 4);
+    lv_label_set_text(s_label, "measuring...");
+
+    ws_241_lvgl_get_stats(&s_prev);
+    s_prev_ms = lv_tick_get();
+    lv_timer_create(report_cb, BENCH_REPORT_MS, NULL);
+
+    lv_screen_load(scr);
+    ws_241_lvgl_unlock();
+}
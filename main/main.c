@@ -3,6 +3,7 @@
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "rm690b0.h"
+#include "rm690b0_server.h"
 #include "ws_241_hal.h"
 
 static const char *TAG = "APP_MAIN";
@@ -17,7 +18,7 @@ void app_main(void)
     }
     ESP_LOGI(TAG, "Display Initialized. Using rm690b0 driver.");
     // Run Test Pattern (Initial Screen)
-    rm690b0_run_test_pattern();
+    rm690b0_server_test_pattern();
     // Start Touch Task
     ws_241_hal_start_touch_test();
 }
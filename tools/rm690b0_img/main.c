@@ -0,0 +1,854 @@
+/*
+ * Host tool for the R5Q image codec.
+ *
+ *   rm690b0_img encode [-c] [-d] in.ppm out     Encode a binary PPM (P6); -c writes a
+ *                                               C source with a const array, -d dithers
+ *   rm690b0_img decode in.r5q out.ppm           Decode back to PPM
+ *   rm690b0_img bench [in.ppm ...]              Ratio and decode speed; without files
+ *                                               runs the built-in 600x450 corpus
+ *   rm690b0_img pack out.bin name=file ...      Asset pack (rm690b0_asset.h): *.ppm become
+ *                                               RGB565 images (name=file.ppm:r5q compressed),
+ *                                               anything else a blob
+ *   rm690b0_img font [-x S] [-a N] [-k kern.txt] out.rmf in.bdf|builtin
+ *                                               RMF1 font (rm690b0_text.h): -x scales up,
+ *                                               -a N averages N x N cells into 4-bit
+ *                                               anti-aliased glyphs, -k adds kerning pairs
+ *   rm690b0_img dlist out.rmd script.txt        Retained display list (rm690b0_dlist.h) from
+ *                                               lines of: size W H, screen RRGGBB,
+ *                                               fill x y w h RRGGBB, image x y file.ppm
+ *
+ * Odd widths are padded with a copy of the last column: rm690b0_draw_image()
+ * needs an even width.
+ */
+#include "rm690b0_img.h"
+#include "rm690b0_asset.h"
+#include "rm690b0_text.h"
+#include "rm690b0_color.h"
+#include "rm690b0_font.h"
+#include "rm690b0_dlist.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Decode chunk of the benchmark, the size of a driver bounce buffer (RM_STREAM_CHUNK_PIXELS)
+#define BENCH_CHUNK_PIXELS  8192
+#define BENCH_MIN_SECONDS   0.2
+
+#define CORPUS_W    600
+#define CORPUS_H    450
+
+typedef struct {
+    uint16_t w, h;
+    uint16_t *px;   // Big-endian RGB565
+} image_t;
+
+static void image_alloc(image_t *img, uint16_t w, uint16_t h) {
+    img->w = w;
+    img->h = h;
+    img->px = calloc((size_t)w * h, 2);
+}
+
+// --- PPM ---
+
+static int ppm_token(FILE *f) {
+    int c, v = 0;
+    do {
+        c = fgetc(f);
+        if (c == '#') {
+            while (c != '\n' && c != EOF) c = fgetc(f);
+        }
+    } while (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '#');
+    if (c < '0' || c > '9') return -1;
+    while (c >= '0' && c <= '9') {
+        v = v * 10 + (c - '0');
+        c = fgetc(f);
+    }
+    return v;
+}
+
+static int ppm_read(const char *path, image_t *img, bool dither) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+    char magic[2];
+    int w, h, maxval;
+    if (fread(magic, 1, 2, f) != 2 || magic[0] != 'P' || magic[1] != '6' ||
+        (w = ppm_token(f)) <= 0 || (h = ppm_token(f)) <= 0 || (maxval = ppm_token(f)) != 255 ||
+        w > 0xFFFE || h > 0xFFFF) {
+        fclose(f);
+        return -1;
+    }
+
+    size_t row_bytes = (size_t)w * 3;
+    uint8_t *row = malloc(row_bytes + 3);
+    image_alloc(img, (uint16_t)((w + 1) & ~1), (uint16_t)h);
+    for (int y = 0; y < h; y++) {
+        if (fread(row, 1, row_bytes, f) != row_bytes) {
+            fclose(f);
+            free(row);
+            return -1;
+        }
+        if (w & 1) memcpy(row + row_bytes, row + row_bytes - 3, 3);
+        rm_color_rgb888_to_be565(img->px + (size_t)y * img->w, row, img->w, 0, y, dither);
+    }
+    free(row);
+    fclose(f);
+    return 0;
+}
+
+static int ppm_write(const char *path, const image_t *img) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+    fprintf(f, "P6\n%u %u\n255\n", img->w, img->h);
+    for (size_t i = 0; i < (size_t)img->w * img->h; i++) {
+        uint16_t c = rm_color_be(img->px[i]);
+        uint8_t r = c >> 11, g = (c >> 5) & 0x3F, b = c & 0x1F;
+        uint8_t rgb[3] = { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+        fwrite(rgb, 1, 3, f);
+    }
+    return fclose(f);
+}
+
+// --- Commands ---
+
+static uint8_t *encode(const image_t *img, size_t *size) {
+    size_t cap = RM_IMG_MAX_SIZE(img->w, img->h);
+    uint8_t *out = malloc(cap);
+    *size = rm690b0_img_encode(img->px, img->w, img->w, img->h, out, cap);
+    return out;
+}
+
+static int write_c(FILE *f, const char *path, const uint8_t *data, size_t size) {
+    // Array name from the file name: logo_r5q.c -> logo_r5q
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    char name[128];
+    size_t n = 0;
+    for (; base[n] && base[n] != '.' && n < sizeof(name) - 1; n++) {
+        char c = base[n];
+        name[n] = ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) ? c : '_';
+    }
+    name[n] = 0;
+
+    fprintf(f, "// R5Q image, see rm690b0_img.h. Generated by tools/rm690b0_img.\n");
+    fprintf(f, "#include <stdint.h>\n#include <stddef.h>\n\n");
+    fprintf(f, "const uint8_t %s[%zu] = {", name, size);
+    for (size_t i = 0; i < size; i++) {
+        fprintf(f, "%s0x%02X,", (i % 16) ? " " : "\n    ", data[i]);
+    }
+    fprintf(f, "\n};\nconst size_t %s_size = sizeof(%s);\n", name, name);
+    return 0;
+}
+
+static int cmd_encode(int argc, char **argv) {
+    bool c_array = false, dither = false;
+    int i = 0;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (!strcmp(argv[i], "-c")) c_array = true;
+        else if (!strcmp(argv[i], "-d")) dither = true;
+        else return 2;
+    }
+    if (argc - i != 2) return 2;
+
+    image_t img;
+    if (ppm_read(argv[i], &img, dither) != 0) {
+        fprintf(stderr, "cannot read %s (binary PPM, maxval 255)\n", argv[i]);
+        return 1;
+    }
+    size_t size;
+    uint8_t *data = encode(&img, &size);
+
+    FILE *f = fopen(argv[i + 1], c_array ? "w" : "wb");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", argv[i + 1]);
+        return 1;
+    }
+    if (c_array) write_c(f, argv[i + 1], data, size);
+    else fwrite(data, 1, size, f);
+    fclose(f);
+
+    printf("%ux%u: %zu -> %zu bytes (%.2f:1)\n", img.w, img.h, (size_t)img.w * img.h * 2, size,
+           (double)img.w * img.h * 2 / size);
+    free(data);
+    free(img.px);
+    return 0;
+}
+
+static int cmd_decode(int argc, char **argv) {
+    if (argc != 2) return 2;
+    FILE *f = fopen(argv[0], "rb");
+    if (!f) {
+        fprintf(stderr, "cannot read %s\n", argv[0]);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    size_t size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *file = malloc(size);
+    size_t got = fread(file, 1, size, f);
+    fclose(f);
+
+    rm690b0_img_t img;
+    if (got != size || rm690b0_img_open(&img, file, size) != ESP_OK) {
+        fprintf(stderr, "%s: not an R5Q file\n", argv[0]);
+        return 1;
+    }
+    image_t out;
+    image_alloc(&out, img.w, img.h);
+    rm690b0_img_dec_t dec;
+    rm690b0_img_dec_init(&dec, &img);
+    size_t n = rm690b0_img_decode(&dec, out.px, (size_t)img.w * img.h);
+    if (n != (size_t)img.w * img.h) fprintf(stderr, "%s: truncated, %zu pixels\n", argv[0], n);
+
+    int ret = ppm_write(argv[1], &out) ? 1 : 0;
+    free(out.px);
+    free(file);
+    return ret;
+}
+
+// --- Asset pack ---
+
+typedef struct {
+    rm690b0_asset_entry_t e;
+    uint8_t *data;
+} pack_item_t;
+
+static int pack_item_cmp(const void *a, const void *b) {
+    return strncmp(((const pack_item_t *)a)->e.name, ((const pack_item_t *)b)->e.name, RM_ASSET_NAME_LEN);
+}
+
+static uint8_t *read_file(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(*size ? *size : 1);
+    if (fread(data, 1, *size, f) != *size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+static int pack_item(pack_item_t *it, const char *spec) {
+    char path[512];
+    const char *eq = strchr(spec, '=');
+    if (!eq || eq == spec || eq - spec >= RM_ASSET_NAME_LEN) {
+        fprintf(stderr, "%s: expected name=file, name up to %d characters\n", spec, RM_ASSET_NAME_LEN - 1);
+        return -1;
+    }
+    memset(it, 0, sizeof(*it));
+    memcpy(it->e.name, spec, eq - spec);
+    snprintf(path, sizeof(path), "%s", eq + 1);
+
+    bool r5q = false;
+    char *opt = strrchr(path, ':');
+    if (opt && !strcmp(opt, ":r5q")) {
+        r5q = true;
+        *opt = 0;
+    }
+    const char *ext = strrchr(path, '.');
+    size_t size = 0;
+
+    if (ext && !strcmp(ext, ".ppm")) {
+        image_t img;
+        if (ppm_read(path, &img, false) != 0) {
+            fprintf(stderr, "cannot read %s (binary PPM, maxval 255)\n", path);
+            return -1;
+        }
+        it->e.w = img.w;
+        it->e.h = img.h;
+        if (r5q) {
+            it->e.type = RM_ASSET_R5Q;
+            it->data = encode(&img, &size);
+            free(img.px);
+        } else {
+            it->e.type = RM_ASSET_RGB565;
+            it->data = (uint8_t *)img.px;
+            size = (size_t)img.w * img.h * 2;
+        }
+    } else {
+        it->e.type = RM_ASSET_BLOB;
+        it->data = read_file(path, &size);
+        if (!it->data) {
+            fprintf(stderr, "cannot read %s\n", path);
+            return -1;
+        }
+    }
+    it->e.size = (uint32_t)size;
+    return 0;
+}
+
+static int cmd_pack(int argc, char **argv) {
+    if (argc < 2) return 2;
+    int count = argc - 1;
+    pack_item_t *items = calloc(count, sizeof(*items));
+    for (int i = 0; i < count; i++) {
+        if (pack_item(&items[i], argv[i + 1]) != 0) return 1;
+    }
+    qsort(items, count, sizeof(*items), pack_item_cmp);
+
+    // Payloads follow the index, each on its own RM_ASSET_ALIGN boundary
+    size_t pos = sizeof(rm690b0_asset_header_t) + count * sizeof(rm690b0_asset_entry_t);
+    for (int i = 0; i < count; i++) {
+        if (i > 0 && !pack_item_cmp(&items[i - 1], &items[i])) {
+            fprintf(stderr, "duplicate asset name %s\n", items[i].e.name);
+            return 1;
+        }
+        pos = (pos + RM_ASSET_ALIGN - 1) & ~(size_t)(RM_ASSET_ALIGN - 1);
+        items[i].e.offset = (uint32_t)pos;
+        pos += items[i].e.size;
+    }
+
+    // The host is little-endian like the ESP32-S3: structs are written as they are
+    uint8_t *out = calloc(pos, 1);
+    rm690b0_asset_header_t hdr = { .version = 1, .count = (uint16_t)count, .size = (uint32_t)pos };
+    memcpy(hdr.magic, RM_ASSET_MAGIC, 4);
+    memcpy(out, &hdr, sizeof(hdr));
+    static const char *types[] = { "?", "rgb565", "r5q", "blob" };
+    for (int i = 0; i < count; i++) {
+        const rm690b0_asset_entry_t *e = &items[i].e;
+        memcpy(out + sizeof(hdr) + i * sizeof(*e), e, sizeof(*e));
+        memcpy(out + e->offset, items[i].data, e->size);
+        printf("%-16s %-6s %5ux%-4u %8u @ 0x%06X\n", e->name, types[e->type], e->w, e->h, e->size, e->offset);
+        free(items[i].data);
+    }
+
+    FILE *f = fopen(argv[0], "wb");
+    if (!f || fwrite(out, 1, pos, f) != pos) {
+        fprintf(stderr, "cannot write %s\n", argv[0]);
+        return 1;
+    }
+    fclose(f);
+    printf("%s: %d assets, %zu bytes\n", argv[0], count, pos);
+    free(out);
+    free(items);
+    return 0;
+}
+
+// --- Fonts ---
+
+typedef struct {
+    uint32_t cp;
+    int w, h;
+    int x_off, top;         // From the pen and from the top of the line
+    int adv;
+    uint8_t *px;            // w * h coverage 0..255
+} font_glyph_t;
+
+typedef struct {
+    font_glyph_t *g;
+    int n, cap;
+    int ascent, descent;
+    rm690b0_font_kern_t *kern;
+    int kern_n, kern_cap;
+} font_src_t;
+
+static font_glyph_t *font_add(font_src_t *f) {
+    if (f->n == f->cap) {
+        f->cap = f->cap ? f->cap * 2 : 128;
+        f->g = realloc(f->g, f->cap * sizeof(*f->g));
+    }
+    memset(&f->g[f->n], 0, sizeof(*f->g));
+    return &f->g[f->n++];
+}
+
+static void font_builtin_src(font_src_t *f) {
+    f->ascent = 12;
+    f->descent = RM_FONT8X16_H - 12;
+    for (int c = RM_FONT8X16_FIRST; c <= RM_FONT8X16_LAST; c++) {
+        font_glyph_t *g = font_add(f);
+        *g = (font_glyph_t){ .cp = c, .w = RM_FONT8X16_W, .h = RM_FONT8X16_H, .adv = RM_FONT8X16_W };
+        g->px = calloc(RM_FONT8X16_W * RM_FONT8X16_H, 1);
+        for (int y = 0; y < RM_FONT8X16_H; y++) {
+            for (int x = 0; x < RM_FONT8X16_W; x++) {
+                if (rm_font8x16[c - RM_FONT8X16_FIRST][y] & (0x80 >> x)) g->px[y * RM_FONT8X16_W + x] = 255;
+            }
+        }
+    }
+}
+
+// BDF: the FONT_ASCENT/FONT_DESCENT properties and per glyph ENCODING, DWIDTH, BBX, BITMAP
+static int font_read_bdf(font_src_t *f, const char *path) {
+    FILE *in = fopen(path, "r");
+    if (!in) return -1;
+    char line[512];
+    font_glyph_t cur = {0};
+    int bbx_yo = 0, row = -1;
+    while (fgets(line, sizeof(line), in)) {
+        int a, b, c, d;
+        if (sscanf(line, "FONT_ASCENT %d", &a) == 1) f->ascent = a;
+        else if (sscanf(line, "FONT_DESCENT %d", &a) == 1) f->descent = a;
+        else if (!strncmp(line, "STARTCHAR", 9)) cur = (font_glyph_t){ .cp = UINT32_MAX };
+        else if (sscanf(line, "ENCODING %d", &a) == 1) cur.cp = (a >= 0) ? (uint32_t)a : UINT32_MAX;
+        else if (sscanf(line, "DWIDTH %d", &a) == 1) cur.adv = a;
+        else if (sscanf(line, "BBX %d %d %d %d", &a, &b, &c, &d) == 4) {
+            cur.w = a;
+            cur.h = b;
+            cur.x_off = c;
+            bbx_yo = d;
+        } else if (!strncmp(line, "BITMAP", 6)) {
+            cur.px = calloc(cur.w * cur.h + 1, 1);
+            row = 0;
+        } else if (!strncmp(line, "ENDCHAR", 7)) {
+            cur.top = f->ascent - (bbx_yo + cur.h);
+            if (cur.cp <= 0xFFFF) *font_add(f) = cur;
+            else free(cur.px);
+            row = -1;
+        } else if (row >= 0 && row < cur.h) {
+            for (int x = 0; x < cur.w; x++) {
+                char hex[2] = { line[x / 4], 0 };
+                if (strtol(hex, NULL, 16) & (8 >> (x % 4))) cur.px[row * cur.w + x] = 255;
+            }
+            row++;
+        }
+    }
+    fclose(in);
+    return f->n ? 0 : -1;
+}
+
+static int floor_div(int a, int n) {
+    return (a >= 0) ? a / n : -((-a + n - 1) / n);
+}
+
+// Nearest-neighbour upscale by s, then average n x n cells: glyph boxes snap to the n grid
+static void font_resample(font_src_t *f, int s, int n) {
+    for (int i = 0; i < f->n; i++) {
+        font_glyph_t *g = &f->g[i];
+        int x0 = g->x_off * s, y0 = g->top * s, w = g->w * s, h = g->h * s;
+        int nx0 = floor_div(x0, n), ny0 = floor_div(y0, n);
+        int nw = floor_div(x0 + w + n - 1, n) - nx0, nh = floor_div(y0 + h + n - 1, n) - ny0;
+        uint8_t *px = calloc(nw * nh + 1, 1);
+        for (int y = 0; y < nh; y++) {
+            for (int x = 0; x < nw; x++) {
+                int sum = 0;
+                for (int sy = 0; sy < n; sy++) {
+                    for (int sx = 0; sx < n; sx++) {
+                        int u = (nx0 + x) * n + sx - x0, v = (ny0 + y) * n + sy - y0;
+                        if (u >= 0 && u < w && v >= 0 && v < h) sum += g->px[(v / s) * g->w + u / s];
+                    }
+                }
+                px[y * nw + x] = (uint8_t)(sum / (n * n));
+            }
+        }
+        free(g->px);
+        g->px = px;
+        g->x_off = nx0;
+        g->top = ny0;
+        g->w = nw;
+        g->h = nh;
+        g->adv = (g->adv * s + n / 2) / n;
+    }
+    f->ascent = (f->ascent * s + n / 2) / n;
+    f->descent = (f->descent * s + n - 1) / n;
+}
+
+static uint32_t kern_char(const char *s) {
+    if (!strncmp(s, "U+", 2)) return (uint32_t)strtoul(s + 2, NULL, 16);
+    return (uint8_t)s[0];
+}
+
+static int kern_cmp(const void *a, const void *b) {
+    const rm690b0_font_kern_t *x = a, *y = b;
+    uint32_t kx = ((uint32_t)x->left << 16) | x->right, ky = ((uint32_t)y->left << 16) | y->right;
+    return (kx > ky) - (kx < ky);
+}
+
+// One pair per line: "A V -2" or "U+0041 U+0056 -2", in output pixels
+static int font_read_kern(font_src_t *f, const char *path) {
+    FILE *in = fopen(path, "r");
+    if (!in) return -1;
+    char a[16], b[16];
+    int adj;
+    while (fscanf(in, "%15s %15s %d", a, b, &adj) == 3) {
+        if (f->kern_n == f->kern_cap) {
+            f->kern_cap = f->kern_cap ? f->kern_cap * 2 : 64;
+            f->kern = realloc(f->kern, f->kern_cap * sizeof(*f->kern));
+        }
+        f->kern[f->kern_n++] = (rm690b0_font_kern_t){ (uint16_t)kern_char(a), (uint16_t)kern_char(b), (int8_t)adj };
+    }
+    fclose(in);
+    qsort(f->kern, f->kern_n, sizeof(*f->kern), kern_cmp);
+    return 0;
+}
+
+static int font_write(const font_src_t *f, int bpp, const char *path) {
+    uint32_t first = UINT32_MAX, last = 0;
+    for (int i = 0; i < f->n; i++) {
+        if (f->g[i].cp < first) first = f->g[i].cp;
+        if (f->g[i].cp > last) last = f->g[i].cp;
+    }
+    uint32_t count = last - first + 1;
+    size_t table = sizeof(rm690b0_font_header_t) + count * sizeof(rm690b0_font_glyph_t) +
+                   f->kern_n * sizeof(rm690b0_font_kern_t);
+    size_t size = table;
+    for (int i = 0; i < f->n; i++) size += (size_t)f->g[i].h * ((f->g[i].w * bpp + 7) / 8);
+
+    uint8_t *out = calloc(size, 1);
+    rm690b0_font_header_t hdr = {
+        .bpp = (uint8_t)bpp, .line_height = (uint8_t)(f->ascent + f->descent), .ascent = (uint8_t)f->ascent,
+        .first = (uint16_t)first, .count = (uint16_t)count, .kern_count = (uint16_t)f->kern_n,
+    };
+    memcpy(hdr.magic, RM_FONT_MAGIC, 4);
+    memcpy(out, &hdr, sizeof(hdr));
+    rm690b0_font_glyph_t *table_out = (rm690b0_font_glyph_t *)(out + sizeof(hdr));
+    memcpy(table_out + count, f->kern, f->kern_n * sizeof(*f->kern));
+
+    size_t pos = table;
+    for (int i = 0; i < f->n; i++) {
+        const font_glyph_t *g = &f->g[i];
+        if (g->w > 255 || g->h > 255 || g->adv > 255 || g->x_off < -128 || g->x_off > 127 ||
+            g->top < -128 || g->top > 127) {
+            fprintf(stderr, "glyph U+%04X too large\n", g->cp);
+            free(out);
+            return -1;
+        }
+        table_out[g->cp - first] = (rm690b0_font_glyph_t){
+            .offset = (uint32_t)pos, .w = (uint8_t)g->w, .h = (uint8_t)g->h,
+            .x_off = (int8_t)g->x_off, .y_off = (int8_t)g->top, .advance = (uint8_t)g->adv,
+        };
+        size_t stride = (g->w * bpp + 7) / 8;
+        for (int y = 0; y < g->h; y++) {
+            uint8_t *row = out + pos + y * stride;
+            for (int x = 0; x < g->w; x++) {
+                uint8_t v = g->px[y * g->w + x];
+                if (bpp == 1) row[x >> 3] |= (v >= 128) ? (0x80 >> (x & 7)) : 0;
+                else row[x >> 1] |= ((v * 15 + 127) / 255) << ((x & 1) ? 0 : 4);
+            }
+        }
+        pos += (size_t)g->h * stride;
+    }
+
+    FILE *fo = fopen(path, "wb");
+    if (!fo || fwrite(out, 1, size, fo) != size) {
+        fprintf(stderr, "cannot write %s\n", path);
+        free(out);
+        return -1;
+    }
+    fclose(fo);
+    printf("%s: %d glyphs U+%04X..U+%04X, %d kerning pairs, line %u, %d bpp, %zu bytes\n", path, f->n,
+           first, last, f->kern_n, hdr.line_height, bpp, size);
+    free(out);
+    return 0;
+}
+
+static int cmd_font(int argc, char **argv) {
+    int scale = 1, aa = 1;
+    const char *kern = NULL;
+    int i = 0;
+    for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+        if (!strcmp(argv[i], "-x")) scale = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-a")) aa = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-k")) kern = argv[i + 1];
+        else return 2;
+    }
+    if (argc - i != 2 || scale < 1 || aa < 1) return 2;
+
+    font_src_t f = {0};
+    if (!strcmp(argv[i + 1], "builtin")) {
+        font_builtin_src(&f);
+    } else if (font_read_bdf(&f, argv[i + 1]) != 0) {
+        fprintf(stderr, "cannot read %s (BDF)\n", argv[i + 1]);
+        return 1;
+    }
+    if (scale > 1 || aa > 1) font_resample(&f, scale, aa);
+    if (kern && font_read_kern(&f, kern) != 0) {
+        fprintf(stderr, "cannot read %s\n", kern);
+        return 1;
+    }
+    int ret = font_write(&f, (aa > 1) ? 4 : 1, argv[i]) ? 1 : 0;
+    for (int g = 0; g < f.n; g++) free(f.g[g].px);
+    free(f.g);
+    free(f.kern);
+    return ret;
+}
+
+// --- Display lists ---
+
+static uint16_t hex565(const char *s) {
+    uint32_t rgb = (uint32_t)strtoul(s, NULL, 16);
+    uint32_t r = rgb >> 16, g = (rgb >> 8) & 0xFF, b = rgb & 0xFF;
+    return (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+// One op per line: size W H, screen RRGGBB, fill x y w h RRGGBB, image x y file.ppm
+static int cmd_dlist(int argc, char **argv) {
+    if (argc != 2) return 2;
+    FILE *in = fopen(argv[1], "r");
+    if (!in) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    rm690b0_dlist_t dl = { 0 };
+    char line[512], op[16], arg[400];
+    int lineno = 0, ret = 0, x, y, w, h;
+    bool sized = false;
+    while (ret == 0 && fgets(line, sizeof(line), in)) {
+        lineno++;
+        if (sscanf(line, "%15s", op) != 1 || op[0] == '#') continue;
+        esp_err_t err = ESP_OK;
+        if (!strcmp(op, "size") && !sized && sscanf(line, "%*s %d %d", &w, &h) == 2) {
+            err = rm690b0_dlist_begin(&dl, (uint16_t)w, (uint16_t)h);
+            sized = true;
+        } else if (!sized) {
+            ret = 1;
+        } else if (!strcmp(op, "screen") && sscanf(line, "%*s %399s", arg) == 1) {
+            err = rm690b0_dlist_fill_screen(&dl, hex565(arg));
+        } else if (!strcmp(op, "fill") && sscanf(line, "%*s %d %d %d %d %399s", &x, &y, &w, &h, arg) == 5) {
+            err = rm690b0_dlist_fill(&dl, (int16_t)x, (int16_t)y, (uint16_t)w, (uint16_t)h, hex565(arg));
+        } else if (!strcmp(op, "image") && sscanf(line, "%*s %d %d %399s", &x, &y, arg) == 3) {
+            image_t img;
+            if (ppm_read(arg, &img, true) != 0) {
+                fprintf(stderr, "cannot read %s (binary PPM, maxval 255)\n", arg);
+                ret = 1;
+                break;
+            }
+            err = rm690b0_dlist_bitmap(&dl, (int16_t)x, (int16_t)y, img.w, img.h, img.px, img.w);
+            free(img.px);
+        } else {
+            ret = 1;
+        }
+        if (err != ESP_OK) ret = 1;
+        if (ret) fprintf(stderr, "%s:%d: bad line (size first, then screen, fill, image)\n", argv[1], lineno);
+    }
+    fclose(in);
+    if (ret == 0 && !sized) {
+        fprintf(stderr, "%s: no size line\n", argv[1]);
+        ret = 1;
+    }
+    if (ret == 0 && rm690b0_dlist_end(&dl) != ESP_OK) ret = 1;
+    if (ret != 0) {
+        rm690b0_dlist_free(&dl);
+        return ret;
+    }
+
+    size_t size;
+    const void *data = rm690b0_dlist_data(&dl, &size);
+    FILE *f = fopen(argv[0], "wb");
+    if (!f || fwrite(data, 1, size, f) != size) {
+        fprintf(stderr, "cannot write %s\n", argv[0]);
+        if (f) fclose(f);
+        rm690b0_dlist_free(&dl);
+        return 1;
+    }
+    fclose(f);
+
+    rm690b0_dlist_stats_t st;
+    rm690b0_dlist_get_stats(&dl, &st);
+    printf("%s: %u ops recorded, %u in the list (%u dropped, %u cut, %u merged), "
+           "%u of %u pixels sent, %zu bytes\n",
+           argv[0], st.recorded, st.ops, st.dropped, st.split, st.merged,
+           (unsigned)st.pixels, (unsigned)st.pixels_recorded, size);
+    rm690b0_dlist_free(&dl);
+    return 0;
+}
+
+// --- Built-in corpus ---
+
+static inline uint16_t rgb565(uint32_t r, uint32_t g, uint32_t b) {
+    return rm_color_be((uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)));
+}
+
+static void fill(image_t *img, int x0, int y0, int w, int h, uint16_t be) {
+    for (int y = y0; y < y0 + h; y++) {
+        for (int x = x0; x < x0 + w; x++) img->px[(size_t)y * img->w + x] = be;
+    }
+}
+
+static void text(image_t *img, int x0, int y0, const char *s, uint16_t fg) {
+    for (; *s; s++, x0 += RM_FONT8X16_W) {
+        if (*s < RM_FONT8X16_FIRST || *s > RM_FONT8X16_LAST) continue;
+        const uint8_t *glyph = rm_font8x16[*s - RM_FONT8X16_FIRST];
+        for (int y = 0; y < RM_FONT8X16_H; y++) {
+            for (int x = 0; x < RM_FONT8X16_W; x++) {
+                if (glyph[y] & (0x80 >> x)) img->px[(size_t)(y0 + y) * img->w + x0 + x] = fg;
+            }
+        }
+    }
+}
+
+static void corpus_black(image_t *img) {
+    (void)img;
+}
+
+static void corpus_test_pattern(image_t *img) {
+    int w = img->w, h = img->h;
+    fill(img, 0, 0, 50, 50, rgb565(255, 0, 0));
+    fill(img, w - 50, 0, 50, 50, rgb565(0, 255, 0));
+    fill(img, w - 50, h - 50, 50, 50, rgb565(0, 0, 255));
+    fill(img, 0, h - 50, 50, 50, rgb565(255, 255, 255));
+    fill(img, w / 2 - 25, h / 2 - 25, 50, 50, rgb565(255, 255, 0));
+}
+
+// Dark dashboard: header, cards with labels, a gradient progress bar
+static void corpus_ui(image_t *img) {
+    fill(img, 0, 0, img->w, img->h, rgb565(24, 28, 36));
+    fill(img, 0, 0, img->w, 40, rgb565(40, 90, 160));
+    text(img, 12, 12, "Waveshare 2.41 AMOLED  12:34  87%", rgb565(255, 255, 255));
+    static const char *labels[] = { "Temperature", "Humidity", "Pressure", "Battery", "Wi-Fi", "Uptime" };
+    for (int i = 0; i < 6; i++) {
+        int x = 16 + (i % 3) * 192, y = 60 + (i / 3) * 150;
+        fill(img, x, y, 176, 134, rgb565(48, 54, 68));
+        fill(img, x, y, 176, 2, rgb565(90, 200, 250));
+        text(img, x + 10, y + 14, labels[i], rgb565(170, 178, 190));
+        text(img, x + 10, y + 60, "42.0", rgb565(255, 255, 255));
+    }
+    for (int x = 0; x < 568; x++) {
+        fill(img, 16 + x, 380, 1, 20, rgb565(40 + x * 200 / 568, 200 - x * 120 / 568, 120));
+    }
+    text(img, 16, 416, "Syncing 3 of 7 ...", rgb565(170, 178, 190));
+}
+
+static void corpus_gradient(image_t *img) {
+    for (uint32_t y = 0; y < img->h; y++) {
+        for (uint32_t x = 0; x < img->w; x++) {
+            uint16_t c = (uint16_t)(((x * 31 / img->w) << 11) | ((y * 63 / img->h) << 5) | 0x0F);
+            img->px[y * img->w + x] = rm_color_be(c);
+        }
+    }
+}
+
+static uint32_t s_rng = 12345;
+static uint32_t rnd(void) {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng >> 8;
+}
+
+// Smooth shapes plus sensor noise, dithered down like a real photo would be
+static void corpus_photo(image_t *img) {
+    uint8_t *row = malloc((size_t)img->w * 3);
+    for (int y = 0; y < img->h; y++) {
+        for (int x = 0; x < img->w; x++) {
+            double u = x / 600.0, v = y / 450.0;
+            double r = 120 + 80 * sin(u * 5.1 + v * 2.3) + 30 * cos(v * 9.7);
+            double g = 110 + 70 * sin(u * 3.3 - v * 4.1 + 1.0) + 25 * sin(u * v * 20);
+            double b = 100 + 90 * cos(u * 2.2 + v * 6.4) + 20 * sin(u * 13);
+            int n = (int)(rnd() % 7) - 3;
+            uint8_t *p = row + x * 3;
+            p[0] = (uint8_t)fmin(255, fmax(0, r + n));
+            p[1] = (uint8_t)fmin(255, fmax(0, g + n));
+            p[2] = (uint8_t)fmin(255, fmax(0, b + n));
+        }
+        rm_color_rgb888_to_be565(img->px + (size_t)y * img->w, row, img->w, 0, y, true);
+    }
+    free(row);
+}
+
+static void corpus_noise(image_t *img) {
+    for (size_t i = 0; i < (size_t)img->w * img->h; i++) img->px[i] = (uint16_t)rnd();
+}
+
+static const struct {
+    const char *name;
+    void (*make)(image_t *img);
+} s_corpus[] = {
+    { "black", corpus_black },
+    { "test_pattern", corpus_test_pattern },
+    { "ui", corpus_ui },
+    { "gradient", corpus_gradient },
+    { "photo", corpus_photo },
+    { "noise", corpus_noise },
+};
+
+// --- Benchmark ---
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int bench_one(const char *name, const image_t *img) {
+    size_t raw = (size_t)img->w * img->h * 2;
+    size_t size;
+    uint8_t *file = encode(img, &size);
+    rm690b0_img_t ri;
+    if (size == 0 || rm690b0_img_open(&ri, file, size) != ESP_OK) {
+        fprintf(stderr, "%s: encode failed\n", name);
+        free(file);
+        return 1;
+    }
+
+    // Round trip, in bounce-buffer sized pieces like the driver pulls them
+    static uint16_t chunk[BENCH_CHUNK_PIXELS];
+    rm690b0_img_dec_t dec;
+    rm690b0_img_dec_init(&dec, &ri);
+    size_t pos = 0, n;
+    int mismatch = 0;
+    while ((n = rm690b0_img_decode(&dec, chunk, BENCH_CHUNK_PIXELS)) > 0) {
+        if (memcmp(chunk, img->px + pos, n * 2) != 0) mismatch = 1;
+        pos += n;
+    }
+    if (mismatch || pos != (size_t)img->w * img->h) {
+        fprintf(stderr, "%s: round trip mismatch\n", name);
+        free(file);
+        return 1;
+    }
+
+    uint32_t runs = 0;
+    double t0 = now(), t;
+    do {
+        rm690b0_img_dec_init(&dec, &ri);
+        while (rm690b0_img_decode(&dec, chunk, BENCH_CHUNK_PIXELS) > 0) {
+        }
+        runs++;
+        t = now() - t0;
+    } while (t < BENCH_MIN_SECONDS);
+
+    printf("%-22s %5ux%-4u %9zu %9zu %7.2f:1 %9.1f\n", name, img->w, img->h, raw, size,
+           (double)raw / size, raw * runs / t / 1e6);
+    free(file);
+    return 0;
+}
+
+static int cmd_bench(int argc, char **argv) {
+    int failures = 0;
+    printf("decoder state %zu bytes, chunk %u pixels\n", sizeof(rm690b0_img_dec_t), BENCH_CHUNK_PIXELS);
+    printf("%-22s %10s %9s %9s %9s %9s\n", "image", "size", "raw", "r5q", "ratio", "MB/s");
+    if (argc == 0) {
+        for (size_t i = 0; i < sizeof(s_corpus) / sizeof(s_corpus[0]); i++) {
+            image_t img;
+            image_alloc(&img, CORPUS_W, CORPUS_H);
+            s_corpus[i].make(&img);
+            failures += bench_one(s_corpus[i].name, &img);
+            free(img.px);
+        }
+    }
+    for (int i = 0; i < argc; i++) {
+        image_t img;
+        if (ppm_read(argv[i], &img, false) != 0) {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            failures++;
+            continue;
+        }
+        const char *base = strrchr(argv[i], '/');
+        failures += bench_one(base ? base + 1 : argv[i], &img);
+        free(img.px);
+    }
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    int ret = 2;
+    if (argc >= 2 && !strcmp(argv[1], "encode")) ret = cmd_encode(argc - 2, argv + 2);
+    else if (argc >= 2 && !strcmp(argv[1], "decode")) ret = cmd_decode(argc - 2, argv + 2);
+    else if (argc >= 2 && !strcmp(argv[1], "bench")) ret = cmd_bench(argc - 2, argv + 2);
+    else if (argc >= 2 && !strcmp(argv[1], "pack")) ret = cmd_pack(argc - 2, argv + 2);
+    else if (argc >= 2 && !strcmp(argv[1], "font")) ret = cmd_font(argc - 2, argv + 2);
+    else if (argc >= 2 && !strcmp(argv[1], "dlist")) ret = cmd_dlist(argc - 2, argv + 2);
+
+    if (ret == 2) {
+        fprintf(stderr, "usage: %s encode [-c] [-d] in.ppm out\n"
+                        "       %s decode in.r5q out.ppm\n"
+                        "       %s bench [in.ppm ...]\n"
+                        "       %s pack out.bin name=file[.ppm[:r5q]] ...\n"
+                        "       %s font [-x scale] [-a supersample] [-k kern.txt] out.rmf in.bdf|builtin\n"
+                        "       %s dlist out.rmd script.txt\n",
+                argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+    }
+    return ret;
+}
@@ -0,0 +1,2732 @@
+/*
+ * Host harness for the rm690b0 driver.
+ *
+ * Runs the drawing APIs against the simulated panel, dumps what the panel
+ * shows as PPM files and prints bytes on the wire and estimated wire time per
+ * scenario. Exits non-zero on protocol violations or wrong pixels.
+ *
+ * bus_record drives the transfer pipeline into the recording backend and
+ * checks chunk sizes, CS kept across a burst, command/burst order and
+ * completion order, and that draining closes a burst left open by an error.
+ *
+ * damage checks the damage tracker's merges directly: overlap, adjacency,
+ * even-X alignment, cost-model rejection, the forced merge at a full list and
+ * identical lists for identical input.
+ *
+ * color checks the pixel format conversion kernels against their references,
+ * with every head and tail alignment and dithered.
+ *
+ * vsync_est feeds the TE estimator synthetic edges with jitter, dropouts and
+ * glitches and checks period, phase, missed and spurious counts.
+ *
+ * The server_stress scenario hammers the display server from many threads and
+ * checks per-producer completion order and the final pixels, then stops and
+ * restarts it back to back, also with producers still submitting (everything
+ * accepted must complete before stop returns).
+ *
+ * The shapes* scenarios draw one scene of rasterized primitives into the
+ * framebuffer and then straight to the panel, and compare the two.
+ *
+ * text draws with the built-in and an anti-aliased font; text_bench reports
+ * glyphs per second into the framebuffer and the glyph atlas hit rate.
+ *
+ * layers composes a stack of opaque, translucent and masked layers and compares
+ * it with a host composition; layers_move moves one and fades another, and
+ * checks that only their bounds go out again.
+ *
+ * The full_frame_* scenarios repeat full_frame in the reduced interface
+ * formats; compare their bytes and wire time with full_frame.
+ *
+ * delta_replay replays frame sequences (built-in, plus a captured one with -f)
+ * through the framebuffer in row mode and in tile-hash delta mode.
+ *
+ * bands sends a display list band by band without a framebuffer and compares
+ * it with the same list drawn into one; bands_rot1_rgb332 repeats it in
+ * portrait, packed to RGB332, and bands_small_rows with too short buffers.
+ * bands_parallel renders a heavier list with 0 to 4 worker threads, checks
+ * every frame and reports the scaling.
+ *
+ * mjpeg checks the JPEG decoder against an encoder here (4:2:0, 4:4:4, gray,
+ * restart markers, default tables), rejects over-subscribed and truncated
+ * Huffman tables and reports its speed, then plays an
+ * encoded stream unpaced, paced and overloaded, plus a captured one with -m.
+ *
+ * dlist records a static screen with overdraw as a retained display list and
+ * compares its replay with a host painting and its bytes with drawing the same
+ * calls immediately, then replays it serialized, rotated and in RGB332.
+ *
+ * xform checks each rotation's transform against where the panel puts pixels,
+ * and the block rotation kernel against a plain loop (with its speed).
+ * rotate_delta turns the test pattern through all rotations sending only what
+ * differs, and compares GRAM with a full replay, which scrolling or a raw
+ * command in between forces; rotate_fb turns a framebuffer kept on the panel
+ * and upright, and checks what each sends.
+ *
+ *   rm690b0_sim [-c clock_mhz] [-s setup_ns] [-o out_dir] [-f frames.raw] [-m video.mjpeg]
+ */
+#include "rm690b0.h"
+#include "rm690b0_bus_sim.h"
+#include "rm690b0_bus_record.h"
+#include "rm690b0_fb.h"
+#include "rm690b0_console.h"
+#include "rm690b0_server.h"
+#include "rm690b0_img.h"
+#include "rm690b0_asset.h"
+#include "rm690b0_text.h"
+#include "rm690b0_font.h"
+#include "rm690b0_layer.h"
+#include "rm690b0_band.h"
+#include "rm690b0_sched.h"
+#include "rm690b0_jpeg.h"
+#include "rm690b0_play.h"
+#include "rm690b0_dlist.h"
+#include "rm690b0_vsync.h"
+#include "rm690b0_color.h"
+#include "sim_port.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static rm690b0_bus_sim_t s_sim;
+static const char *s_out_dir = ".";
+static int s_failures;
+
+typedef void (*scenario_fn_t)(void);
+
+static void dump(const char *name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.ppm", s_out_dir, name);
+    FILE *f = fopen(path, "wb");
+    if (!f || rm690b0_bus_sim_write_ppm(&s_sim, f) != 0) {
+        fprintf(stderr, "cannot write %s\n", path);
+        s_failures++;
+    }
+    if (f) fclose(f);
+}
+
+static void expect_pixel(const char *what, uint16_t x, uint16_t y, uint16_t color) {
+    uint16_t got = rm690b0_bus_sim_pixel(&s_sim, x, y);
+    if (got != color) {
+        fprintf(stderr, "%s: pixel (%u,%u) = %04X, expected %04X\n", what, x, y, got, color);
+        s_failures++;
+    }
+}
+
+static void run(const char *name, scenario_fn_t fn) {
+    rm690b0_bus_sim_clear_stats(&s_sim);
+    uint64_t delay0 = sim_port_delay_us();
+
+    fn();
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+
+    const rm690b0_sim_stats_t *st = &s_sim.stats;
+    uint64_t delay = sim_port_delay_us() - delay0;
+    printf("%-22s %8u %10llu %10llu %9.3f %9.3f %9.3f %4u\n", name, st->transactions,
+           (unsigned long long)st->bytes, (unsigned long long)st->pixels,
+           st->wire_ns / 1e6, st->busy_ns / 1e6, delay / 1e3, st->violations);
+    if (st->violations) s_failures++;
+    dump(name);
+}
+
+// --- Scenarios ---
+
+static void sc_init(void) {
+    rm690b0_config_t cfg = { .cs_io = -1, .rst_io = -1, .te_io = -1, .host_id = SPI2_HOST };
+    if (rm690b0_init(&cfg) != ESP_OK) s_failures++;
+}
+
+static void sc_fill(void) {
+    rm690b0_fill_screen(RM_COLOR_BLUE);
+    expect_pixel("fill", 0, 0, RM_COLOR_BLUE);
+    expect_pixel("fill", rm690b0_get_width() - 1, rm690b0_get_height() - 1, RM_COLOR_BLUE);
+}
+
+static void sc_pattern(void) {
+    rm690b0_run_test_pattern();
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    expect_pixel("pattern", 0, 0, RM_COLOR_RED);
+    expect_pixel("pattern", w - 1, 0, RM_COLOR_GREEN);
+    expect_pixel("pattern", w - 1, h - 1, RM_COLOR_BLUE);
+    expect_pixel("pattern", 0, h - 1, RM_COLOR_WHITE);
+    expect_pixel("pattern", w / 2, h / 2, RM_COLOR_YELLOW);
+}
+
+static void sc_brush(void) {
+    // Touch-test brush: 100 4x4 dots
+    for (int i = 0; i < 100; i++) {
+        rm690b0_draw_rect(100 + i * 3, 200 + (i % 10) * 6, 4, 4, RM_COLOR_MAGENTA);
+    }
+}
+
+static void sc_full_frame(void) {
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    uint16_t *frame = malloc((size_t)w * h * 2);
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            uint16_t c = (uint16_t)(((x * 31 / w) << 11) | ((y * 63 / h) << 5) | 0x0F);
+            frame[y * w + x] = (uint16_t)((c >> 8) | (c << 8));
+        }
+    }
+    rm690b0_set_window(0, 0, w - 1, h - 1);
+    rm690b0_write_pixels(frame, (size_t)w * h);
+    expect_pixel("frame", w - 1, h - 1, (uint16_t)((frame[(size_t)w * h - 1] >> 8) | (frame[(size_t)w * h - 1] << 8)));
+    free(frame);
+}
+
+static void sc_fb(void) {
+    rm690b0_fb_init();
+    rm690b0_fb_flush();
+    for (int i = 0; i < 20; i++) {
+        rm690b0_fb_fill_rect(20 + i * 25, 40 + i * 15, 20, 20, RM_COLOR_CYAN);
+    }
+    rm690b0_fb_flush();
+    expect_pixel("fb", 20, 40, RM_COLOR_CYAN);
+    rm690b0_fb_deinit();
+}
+
+// Reduced interface formats: the gradient frame again, plus pure colors that
+// survive every format exactly
+static rm690b0_ifpf_t s_frame_ifpf;
+
+static void sc_frame_packed(void) {
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    rm690b0_ifpf_stats_t st0, st1;
+    rm690b0_get_ifpf_stats(&st0);
+
+    if (rm690b0_set_interface_format(s_frame_ifpf) != ESP_OK) s_failures++;
+    uint16_t *frame = malloc((size_t)w * h * 2);
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            uint16_t c = (uint16_t)(((x * 31 / w) << 11) | ((y * 63 / h) << 5) | 0x0F);
+            frame[y * w + x] = (uint16_t)((c >> 8) | (c << 8));
+        }
+    }
+    rm690b0_set_window(0, 0, w - 1, h - 1);
+    rm690b0_write_pixels(frame, (size_t)w * h);
+    free(frame);
+
+    bool color = (s_frame_ifpf != RM_IFPF_GRAY8);
+    rm690b0_draw_rect(0, 0, 50, 50, color ? RM_COLOR_RED : RM_COLOR_WHITE);
+    rm690b0_draw_rect(w - 50, h - 50, 50, 50, color ? RM_COLOR_BLUE : RM_COLOR_BLACK);
+    rm690b0_set_interface_format(RM_IFPF_RGB565);
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+
+    expect_pixel("ifpf", 0, 0, color ? RM_COLOR_RED : RM_COLOR_WHITE);
+    expect_pixel("ifpf", w - 1, h - 1, color ? RM_COLOR_BLUE : RM_COLOR_BLACK);
+
+    rm690b0_get_ifpf_stats(&st1);
+    printf("  ifpf %02X: %u pixels in %u bytes, %u bytes saved\n", s_frame_ifpf,
+           st1.pixels_packed - st0.pixels_packed, st1.bytes_sent - st0.bytes_sent,
+           st1.bytes_saved - st0.bytes_saved);
+    if (st1.bytes_saved == st0.bytes_saved) s_failures++;
+}
+
+// Atlas pixel (x, y) in native RGB565
+static uint16_t atlas_color(uint32_t x, uint32_t y) {
+    return (uint16_t)(((x & 31) << 11) | ((y & 63) << 5) | ((x ^ y) & 31));
+}
+
+static void expect_blit(uint32_t sx, uint32_t sy, int32_t dx, int32_t dy,
+                        int32_t px, int32_t py) {
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER); // Copied rows may still be queued
+    expect_pixel("blit", px, py, atlas_color(sx + (px - dx), sy + (py - dy)));
+}
+
+static void sc_blit(void) {
+    const uint32_t aw = 640, ah = 128;
+    uint16_t *atlas = malloc(aw * ah * 2);
+    for (uint32_t y = 0; y < ah; y++) {
+        for (uint32_t x = 0; x < aw; x++) {
+            uint16_t c = atlas_color(x, y);
+            atlas[y * aw + x] = (uint16_t)((c >> 8) | (c << 8));
+        }
+    }
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+
+    // Wide strided rows: zero-copy, one chunk per row
+    rm690b0_blit(atlas, aw, 40, 10, 300, 60, 100, 20);
+    expect_blit(40, 10, 100, 20, 100, 20);
+    expect_blit(40, 10, 100, 20, 399, 79);
+
+    // Sprite hanging off the top-left corner, odd destination
+    rm690b0_blit(atlas, aw, 64, 32, 48, 48, -13, -7);
+    expect_blit(64, 32, -13, -7, 0, 0);
+    expect_blit(64, 32, -13, -7, 34, 40);
+
+    // Odd X on both edges, neighbour columns exist in the atlas but are not sent
+    rm690b0_blit(atlas, aw, 200, 40, 33, 20, 201, 200);
+    expect_blit(200, 40, 201, 200, 201, 200);
+    expect_blit(200, 40, 201, 200, 233, 219);
+    // The widened column repeats the edge pixel, not the sheet's neighbour
+    if (atlas_color(199, 40) == atlas_color(200, 40)) s_failures++;
+    expect_pixel("blit edge", 200, 200, atlas_color(200, 40));
+
+    // Packed bitmap clipped at the bottom-right corner
+    uint16_t *sprite = malloc(32 * 32 * 2);
+    for (int i = 0; i < 32 * 32; i++) sprite[i] = atlas[(i / 32) * aw + (i % 32)];
+    rm690b0_draw_bitmap(w - 17, h - 9, 32, 32, sprite);
+    expect_blit(0, 0, w - 17, h - 9, w - 17, h - 9);
+    expect_blit(0, 0, w - 17, h - 9, w - 2, h - 1);
+
+    free(sprite);
+    free(atlas);
+}
+
+// Compressed image: encoded on the host, decoded chunk by chunk into the pool
+static void sc_image(void) {
+    const uint16_t iw = 320, ih = 240, x0 = 140, y0 = 100;
+    uint16_t *img = malloc((size_t)iw * ih * 2);
+    for (uint32_t y = 0; y < ih; y++) {
+        for (uint32_t x = 0; x < iw; x++) {
+            // Flat panels with a gradient strip and some noise
+            uint16_t c = (y < 60) ? 0x2945 : (y < 120) ? (uint16_t)((x * 31 / iw) << 11 | 0x07E0)
+                       : (uint16_t)((x * 7 + y * 13) ^ (x * y));
+            img[y * iw + x] = (uint16_t)((c >> 8) | (c << 8));
+        }
+    }
+    size_t cap = RM_IMG_MAX_SIZE(iw, ih);
+    uint8_t *file = malloc(cap);
+    size_t size = rm690b0_img_encode(img, iw, iw, ih, file, cap);
+
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    if (rm690b0_draw_image(x0, y0, file, size) != ESP_OK) s_failures++;
+    if (rm690b0_draw_image(x0 + 1, y0, file, size) != ESP_ERR_INVALID_ARG) s_failures++;
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+
+    uint32_t bad = 0;
+    for (uint32_t y = 0; y < ih; y++) {
+        for (uint32_t x = 0; x < iw; x++) {
+            uint16_t be = img[y * iw + x];
+            if (rm690b0_bus_sim_pixel(&s_sim, x0 + x, y0 + y) != (uint16_t)((be >> 8) | (be << 8))) bad++;
+        }
+    }
+    if (bad) {
+        fprintf(stderr, "image: %u pixels differ\n", bad);
+        s_failures++;
+    }
+    printf("  image: %ux%u, %u bytes raw, %zu bytes R5Q\n", iw, ih, iw * ih * 2, size);
+    free(file);
+    free(img);
+}
+
+// Asset pack built in memory, laid out as tools/rm690b0_img pack writes it
+typedef struct {
+    const char *name;
+    uint8_t type;
+    uint16_t w, h;
+    const void *data;
+    size_t size;
+} pack_src_t;
+
+static uint8_t *pack_build(const pack_src_t *src, int count, size_t *size) {
+    size_t pos = sizeof(rm690b0_asset_header_t) + count * sizeof(rm690b0_asset_entry_t);
+    uint32_t offset[8];
+    for (int i = 0; i < count; i++) {
+        pos = (pos + RM_ASSET_ALIGN - 1) & ~(size_t)(RM_ASSET_ALIGN - 1);
+        offset[i] = pos;
+        pos += src[i].size;
+    }
+    uint8_t *pack = aligned_alloc(RM_ASSET_ALIGN, (pos + RM_ASSET_ALIGN - 1) & ~(size_t)(RM_ASSET_ALIGN - 1));
+    memset(pack, 0, pos);
+    rm690b0_asset_header_t *hdr = (rm690b0_asset_header_t *)pack;
+    memcpy(hdr->magic, RM_ASSET_MAGIC, 4);
+    hdr->version = 1;
+    hdr->count = count;
+    hdr->size = pos;
+    rm690b0_asset_entry_t *index = (rm690b0_asset_entry_t *)(hdr + 1);
+    for (int i = 0; i < count; i++) { // src is sorted by name
+        strncpy(index[i].name, src[i].name, RM_ASSET_NAME_LEN - 1);
+        index[i].type = src[i].type;
+        index[i].w = src[i].w;
+        index[i].h = src[i].h;
+        index[i].offset = offset[i];
+        index[i].size = src[i].size;
+        memcpy(pack + offset[i], src[i].data, src[i].size);
+    }
+    *size = pos;
+    return pack;
+}
+
+static uint16_t asset_color(uint32_t id, uint32_t x, uint32_t y) {
+    return (uint16_t)((((x / 8) ^ (y / 8) ^ id) & 1) ? 0xFFE0 >> id : (x * 3 + y * 5 + id * 1000));
+}
+
+static uint16_t *asset_image(uint32_t id, uint16_t w, uint16_t h) {
+    uint16_t *px = malloc((size_t)w * h * 2);
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            uint16_t c = asset_color(id, x, y);
+            px[y * w + x] = (uint16_t)((c >> 8) | (c << 8));
+        }
+    }
+    return px;
+}
+
+static void expect_asset(uint32_t id, int32_t dx, int32_t dy, int32_t px, int32_t py) {
+    expect_pixel("asset", px, py, asset_color(id, px - dx, py - dy));
+}
+
+static void sc_assets(void) {
+    const uint16_t bw = 200, bh = 100, iw = 32, ih = 32;
+    uint16_t *bg1 = asset_image(1, bw, bh), *bg2 = asset_image(2, bw, bh), *icon = asset_image(3, iw, ih);
+    size_t cap = RM_IMG_MAX_SIZE(bw, bh);
+    uint8_t *r5q1 = malloc(cap), *r5q2 = malloc(cap);
+    size_t n1 = rm690b0_img_encode(bg1, bw, bw, bh, r5q1, cap);
+    size_t n2 = rm690b0_img_encode(bg2, bw, bw, bh, r5q2, cap);
+    static const char font[] = "not really a font";
+
+    const pack_src_t src[] = {
+        { "bg1", RM_ASSET_R5Q, bw, bh, r5q1, n1 },
+        { "bg2", RM_ASSET_R5Q, bw, bh, r5q2, n2 },
+        { "font", RM_ASSET_BLOB, 0, 0, font, sizeof(font) },
+        { "icon", RM_ASSET_RGB565, iw, ih, icon, (size_t)iw * ih * 2 },
+    };
+    size_t size;
+    uint8_t *file = pack_build(src, 4, &size);
+
+    // Room for one background and the icon: the second background evicts
+    rm690b0_asset_cache_init((size_t)bw * bh * 2 + iw * ih * 2);
+    rm690b0_asset_pack_t pack;
+    rm690b0_asset_t a_bg1, a_bg2, a_icon, a_font, a_none;
+    if (rm690b0_asset_pack_open_mem(&pack, file, size) != ESP_OK ||
+        rm690b0_asset_find(&pack, "bg1", &a_bg1) != ESP_OK ||
+        rm690b0_asset_find(&pack, "bg2", &a_bg2) != ESP_OK ||
+        rm690b0_asset_find(&pack, "icon", &a_icon) != ESP_OK ||
+        rm690b0_asset_find(&pack, "font", &a_font) != ESP_OK ||
+        rm690b0_asset_find(&pack, "nope", &a_none) != ESP_ERR_NOT_FOUND) {
+        s_failures++;
+        return;
+    }
+
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    for (int i = 0; i < 3; i++) rm690b0_draw_asset(&a_icon, 10 + i * 40, 10); // Flash, flash + promote, PSRAM
+    rm690b0_draw_asset(&a_bg1, 100, 100);                   // Decoded once into PSRAM
+    rm690b0_blit_asset(&a_bg1, 50, 20, 60, 40, 401, 301);   // Sub-rectangle, no decode
+    rm690b0_draw_asset(&a_bg2, -50, 300);                   // Evicts, clipped
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+
+    for (int i = 0; i < 3; i++) {
+        expect_asset(3, 10 + i * 40, 10, 10 + i * 40, 10);
+        expect_asset(3, 10 + i * 40, 10, 41 + i * 40, 41);
+    }
+    expect_asset(1, 100, 100, 100, 100);
+    expect_asset(1, 100, 100, 299, 199);
+    expect_asset(1, 401 - 50, 301 - 20, 401, 301);
+    expect_asset(1, 401 - 50, 301 - 20, 460, 340);
+    expect_asset(2, -50, 300, 0, 300);
+    expect_asset(2, -50, 300, 149, 399);
+
+    const char *blob = rm690b0_asset_acquire(&a_font);
+    if (!blob || strcmp(blob, font) != 0) s_failures++;
+    rm690b0_asset_release(&a_font, blob);
+
+    rm690b0_asset_cache_stats_t st;
+    rm690b0_asset_cache_get_stats(&st);
+    printf("  assets: %u hits, %u misses, %u promoted, %u evicted, %u rejected, %zu/%zu bytes\n",
+           st.hits, st.misses, st.promotions, st.evictions, st.rejected, st.bytes_used, st.budget);
+    if (st.hits != 2 || st.misses != 4 || st.promotions != 3 || st.evictions != 2) s_failures++;
+
+    rm690b0_asset_pack_close(&pack);
+    rm690b0_asset_cache_get_stats(&st);
+    if (st.bytes_used != 0) s_failures++;
+    rm690b0_asset_cache_deinit();
+
+    free(file);
+    free(r5q1);
+    free(r5q2);
+    free(bg1);
+    free(bg2);
+    free(icon);
+}
+
+// Span rasterizer: one scene of every primitive, drawn through the canvas
+// (the golden image) and straight to the panel, which must match it exactly:
+// every shape sits on SHAPE_BG, so blending towards bg equals blending with
+// the canvas and the even-column padding only rewrites background
+#define SHAPE_BG        0x18E3
+#define SHAPE_COUNT     9
+#define BENCH_ROUNDS    200
+
+static uint16_t *s_golden;
+
+static void shape_scene(rm_shape_t *s, int i) {
+    static const rm_pointf_t star[10] = {
+        { 520, 340 }, { 532, 375 }, { 568, 375 }, { 539, 397 }, { 550, 432 },
+        { 520, 410 }, { 490, 432 }, { 501, 397 }, { 472, 375 }, { 508, 375 },
+    };
+    switch (i) {
+    case 0: rm_shape_circle(s, 100, 100, 60, 0); break;
+    case 1: rm_shape_circle(s, 260, 100, 60, 12); break;
+    case 2: rm_shape_arc(s, 420, 100, 60, 16, -90, 135); break;
+    case 3: rm_shape_round_rect(s, 40, 200, 200, 120, 24, 0); break;
+    case 4: rm_shape_round_rect(s, 280, 200, 160, 120, 30, 6); break;
+    case 5: rm_shape_line(s, 470, 190, 570, 320, 9); break;
+    case 6: rm_shape_line(s, 170, 350, 440, 335, 1); break;
+    case 7: rm_shape_polygon(s, star, 10); break;
+    default: rm_shape_arc(s, 100, 390, 50, 0, 200, 340); break;
+    }
+}
+
+static uint16_t shape_color(int i) {
+    static const uint16_t colors[] = { RM_COLOR_RED, RM_COLOR_GREEN, RM_COLOR_CYAN, RM_COLOR_YELLOW,
+                                       RM_COLOR_MAGENTA, RM_COLOR_WHITE, RM_COLOR_WHITE, RM_COLOR_YELLOW,
+                                       RM_COLOR_BLUE };
+    return colors[i];
+}
+
+static bool s_shape_aa;
+
+static void sc_shapes_fb(void) {
+    rm_shape_t s;
+    rm690b0_fb_init();
+    rm690b0_fb_clear(SHAPE_BG);
+    for (int i = 0; i < SHAPE_COUNT; i++) {
+        shape_scene(&s, i);
+        rm690b0_fb_draw_shape(&s, shape_color(i), s_shape_aa);
+    }
+    rm690b0_fb_flush();
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    rm690b0_fb_deinit();
+
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    free(s_golden);
+    s_golden = malloc((size_t)w * h * 2);
+    for (uint16_t y = 0; y < h; y++) {
+        for (uint16_t x = 0; x < w; x++) s_golden[(size_t)y * w + x] = rm690b0_bus_sim_pixel(&s_sim, x, y);
+    }
+}
+
+static void expect_golden(const char *what) {
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    uint32_t bad = 0;
+    for (uint16_t y = 0; y < h; y++) {
+        for (uint16_t x = 0; x < w; x++) {
+            uint16_t want = s_golden[(size_t)y * w + x];
+            if (rm690b0_bus_sim_pixel(&s_sim, x, y) != want && bad++ == 0) {
+                expect_pixel(what, x, y, want);
+            }
+        }
+    }
+    if (bad) fprintf(stderr, "%s: %u pixels differ from the canvas\n", what, bad);
+}
+
+static void shapes_panel(const char *what, bool opaque) {
+    rm690b0_fill_screen(SHAPE_BG);
+    rm690b0_shape_stats_t st0, st1;
+    rm690b0_get_shape_stats(&st0);
+    rm_shape_t s;
+    for (int i = 0; i < SHAPE_COUNT; i++) {
+        shape_scene(&s, i);
+        rm690b0_paint_t paint = { .color = shape_color(i), .bg = SHAPE_BG, .aa = s_shape_aa, .opaque = opaque };
+        if (rm690b0_draw_shape(&s, &paint) != ESP_OK) s_failures++;
+    }
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    rm690b0_get_shape_stats(&st1);
+    printf("  %s: %u shapes, %u spans, %u windows\n", what, st1.shapes - st0.shapes,
+           st1.spans - st0.spans, st1.windows - st0.windows);
+    expect_golden(what);
+}
+
+static void bench_span(void *ctx, int16_t x, int16_t y, uint16_t len, uint8_t alpha) {
+    *(uint32_t *)ctx += len;
+}
+
+static void sc_shapes(void) {
+    shapes_panel(s_shape_aa ? "shapes_aa" : "shapes", false);
+    if (s_shape_aa) return;
+
+    expect_pixel("shapes", 100, 100, RM_COLOR_RED);         // Filled circle: 121 pixels across
+    expect_pixel("shapes", 100, 40, RM_COLOR_RED);
+    expect_pixel("shapes", 100, 39, SHAPE_BG);
+    expect_pixel("shapes", 260, 100, SHAPE_BG);             // Ring hole
+    expect_pixel("shapes", 315, 100, RM_COLOR_GREEN);
+    expect_pixel("shapes", 472, 100, RM_COLOR_CYAN);        // Arc covers 3 o'clock...
+    expect_pixel("shapes", 368, 100, SHAPE_BG);             // ...not 9 o'clock
+    expect_pixel("shapes", 41, 260, RM_COLOR_YELLOW);       // Rounded rect edge, corner cut
+    expect_pixel("shapes", 40, 200, SHAPE_BG);
+    expect_pixel("shapes", 360, 260, SHAPE_BG);             // Outline only
+    expect_pixel("shapes", 282, 260, RM_COLOR_MAGENTA);
+    expect_pixel("shapes", 520, 390, RM_COLOR_YELLOW);      // Star centre and a notch
+    expect_pixel("shapes", 520, 420, SHAPE_BG);
+    expect_pixel("shapes", 170, 350, RM_COLOR_WHITE);       // Both ends of the thin line
+    expect_pixel("shapes", 440, 335, RM_COLOR_WHITE);
+
+    // Host rasterizer throughput, no panel involved
+    static rm_raster_t r;
+    rm_shape_t s;
+    for (int aa = 0; aa < 2; aa++) {
+        uint32_t pixels = 0;
+        rm_raster_init(&r, rm690b0_get_width(), rm690b0_get_height(), aa);
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int n = 0; n < BENCH_ROUNDS; n++) {
+            for (int i = 0; i < SHAPE_COUNT; i++) {
+                shape_scene(&s, i);
+                rm_raster_fill(&r, &s, bench_span, &pixels);
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double t = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+        printf("  raster %s: %.0f shapes/s, %.1f Mspans/s, %.1f Mpixels/s\n", aa ? "aa" : "solid",
+               BENCH_ROUNDS * SHAPE_COUNT / t, r.spans / t / 1e6, pixels / t / 1e6);
+    }
+}
+
+static void sc_shapes_opaque(void) {
+    shapes_panel("shapes_opaque", true);
+}
+
+// Text: the built-in 1-bit font and a 12x24 anti-aliased font made from it
+// (3x nearest, 2x2 average, what "rm690b0_img font -x 3 -a 2" produces), with
+// two kerning pairs
+#define TEXT_BG         0x0010
+#define TEXT_LINES      2000
+
+static uint8_t *font_make_aa(size_t *size) {
+    const int w = 12, h = 24, count = RM_FONT8X16_LAST - RM_FONT8X16_FIRST + 1, stride = w / 2;
+    size_t table = sizeof(rm690b0_font_header_t) + count * sizeof(rm690b0_font_glyph_t) + 2 * sizeof(rm690b0_font_kern_t);
+    *size = table + (size_t)count * h * stride;
+    uint8_t *out = calloc(*size, 1);
+    rm690b0_font_header_t hdr = { .bpp = 4, .line_height = h, .ascent = 18,
+                                  .first = RM_FONT8X16_FIRST, .count = count, .kern_count = 2 };
+    memcpy(hdr.magic, RM_FONT_MAGIC, 4);
+    memcpy(out, &hdr, sizeof(hdr));
+    rm690b0_font_glyph_t *glyphs = (rm690b0_font_glyph_t *)(out + sizeof(hdr));
+    rm690b0_font_kern_t *kern = (rm690b0_font_kern_t *)(glyphs + count);
+    kern[0] = (rm690b0_font_kern_t){ 'A', 'V', -2 };
+    kern[1] = (rm690b0_font_kern_t){ 'T', 'o', -2 };
+    for (int c = 0; c < count; c++) {
+        size_t pos = table + (size_t)c * h * stride;
+        glyphs[c] = (rm690b0_font_glyph_t){ .offset = pos, .w = w, .h = h, .advance = w };
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                int sum = 0;
+                for (int s = 0; s < 4; s++) {
+                    int u = (2 * x + (s & 1)) / 3, v = (2 * y + (s >> 1)) / 3;
+                    sum += (rm_font8x16[c][v] >> (7 - u)) & 1;
+                }
+                out[pos + y * stride + x / 2] |= (sum * 15 / 4) << ((x & 1) ? 0 : 4);
+            }
+        }
+    }
+    return out;
+}
+
+static rm690b0_font_t s_mono, s_ui;
+static uint8_t *s_ui_data;
+
+static void sc_text(void) {
+    size_t size;
+    s_ui_data = font_make_aa(&size);
+    rm690b0_font_builtin(&s_mono);
+    if (rm690b0_text_cache_init(16 * 1024, 64 * 1024) != ESP_OK ||
+        rm690b0_font_open(&s_ui, s_ui_data, size) != ESP_OK) {
+        s_failures++;
+        return;
+    }
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    rm690b0_text_stats_t st0, st1;
+    rm690b0_text_get_stats(&st0);
+
+    // Odd x: the window starts a column early, filled with bg
+    rm690b0_text_style_t mono = { .font = &s_mono, .fg = RM_COLOR_WHITE, .bg = TEXT_BG };
+    if (rm690b0_draw_text(&mono, 21, 10, "Hello, RM690B0!\nsecond line") != ESP_OK) s_failures++;
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    const uint8_t *glyph = rm_font8x16['H' - RM_FONT8X16_FIRST];
+    for (int y = 0; y < RM_FONT8X16_H; y++) {
+        if (glyph[y] & 0x80) {
+            expect_pixel("text", 21, 10 + y, RM_COLOR_WHITE);
+            break;
+        }
+    }
+    expect_pixel("text", 20, 10, TEXT_BG);
+    expect_pixel("text", 19, 10, RM_COLOR_BLACK);
+    expect_pixel("text", 21 + 15 * 8 - 1, 10, TEXT_BG);
+    expect_pixel("text", 21 + 15 * 8 + 1, 10, RM_COLOR_BLACK);
+    expect_pixel("text", 21, 10 + 2 * RM_FONT8X16_H, RM_COLOR_BLACK);
+
+    rm690b0_text_style_t ui = { .font = &s_ui, .fg = RM_COLOR_YELLOW, .bg = TEXT_BG };
+    if (rm690b0_text_width(&s_ui, "AVATAR") != 6 * 12 - 2) {
+        fprintf(stderr, "text: kerning not applied\n");
+        s_failures++;
+    }
+    rm690b0_draw_text(&ui, 40, 60, "AVATAR Toast 12:34 caf\xc3\xa9");
+
+    // Clipped to a 50x24 box: nothing outside it
+    rm690b0_text_style_t clip = ui;
+    clip.clip_x = 100;
+    clip.clip_y = 120;
+    clip.clip_w = 50;
+    clip.clip_h = 24;
+    rm690b0_draw_text(&clip, 80, 110, "clipped clipped\nclipped clipped");
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    expect_pixel("text", 99, 125, RM_COLOR_BLACK);
+    expect_pixel("text", 150, 125, RM_COLOR_BLACK);
+    expect_pixel("text", 120, 119, RM_COLOR_BLACK);
+    expect_pixel("text", 120, 144, RM_COLOR_BLACK);
+
+    rm690b0_text_get_stats(&st1);
+    printf("  text: %u lines, %u glyphs, %u hits, %u LUTs, atlas %zu/%zu + %zu/%zu bytes\n",
+           st1.lines - st0.lines, st1.lookups - st0.lookups, st1.hits - st0.hits,
+           st1.lut_builds - st0.lut_builds, st1.internal_used, st1.internal_size, st1.psram_used, st1.psram_size);
+    if (st1.lines - st0.lines != 5) {
+        fprintf(stderr, "text: %u lines drawn, expected 5\n", st1.lines - st0.lines);
+        s_failures++;
+    }
+}
+
+// Host throughput of composing text into the framebuffer, no wire involved
+static void sc_text_bench(void) {
+    static const char line[] = "The quick brown fox jumps over the lazy dog 0123456789 +-*/";
+    rm690b0_fb_init();
+    const rm690b0_font_t *fonts[2] = { &s_mono, &s_ui };
+    for (int f = 0; f < 2; f++) {
+        rm690b0_text_style_t st = { .font = fonts[f], .fg = RM_COLOR_WHITE, .bg = TEXT_BG };
+        rm690b0_text_stats_t s0, s1;
+        rm690b0_text_get_stats(&s0);
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int i = 0; i < TEXT_LINES; i++) {
+            st.fg = (i & 1) ? RM_COLOR_WHITE : RM_COLOR_CYAN;
+            rm690b0_fb_draw_text(&st, 0, (i * fonts[f]->line_height) % 400, line);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        rm690b0_text_get_stats(&s1);
+        double t = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+        uint32_t lookups = s1.lookups - s0.lookups;
+        printf("  text %s: %.2f Mglyphs/s, atlas hit rate %.2f%%\n", f ? "aa 12x24" : "mono 8x16",
+               lookups / t / 1e6, 100.0 * (s1.hits - s0.hits) / lookups);
+    }
+    rm690b0_fb_flush();
+    rm690b0_fb_deinit();
+    rm690b0_text_cache_deinit();
+    if (rm690b0_draw_text(&(rm690b0_text_style_t){ .font = &s_mono }, 0, 0, "x") != ESP_ERR_INVALID_STATE) s_failures++;
+    free(s_ui_data);
+}
+
+// Layers: a wallpaper, an opaque graph over its lower part, a translucent HUD,
+// a masked toast and a masked round cursor. The golden image is composed on
+// the host with the reference blend kernels. Moving the cursor and fading the
+// toast must only resend the bounds they touch.
+#define LAYER_BG        0x0841
+#define LAYER_COUNT     5
+#define LAYER_MOVES     20
+#define BLEND_N         1024
+#define BLEND_ROUNDS    2000
+
+typedef struct {
+    rm690b0_layer_config_t cfg;
+    rm690b0_layer_t *layer;
+} sim_layer_t;
+
+static sim_layer_t s_layers[LAYER_COUNT] = {
+    { .cfg = { .x = 0, .y = 0, .w = 600, .h = 450, .alpha = 255, .z = 0 } },      // Wallpaper
+    { .cfg = { .x = 0, .y = 150, .w = 600, .h = 300, .alpha = 255, .z = 1 } },    // Graph
+    { .cfg = { .x = 20, .y = 170, .w = 240, .h = 120, .alpha = 160, .z = 2 } },   // HUD
+    { .cfg = { .x = 200, .y = 60, .w = 200, .h = 48, .alpha = 255, .mask = true, .z = 3 } },   // Toast
+    { .cfg = { .x = 301, .y = 201, .w = 17, .h = 17, .alpha = 255, .mask = true, .z = 4 } },   // Cursor
+};
+
+// Fast kernels against the references: every alpha, misaligned runs, masks
+// with runs of 0 and 255 between random values
+static void blend_check(void) {
+    static uint16_t src[BLEND_N], dst0[BLEND_N], a[BLEND_N], b[BLEND_N];
+    static uint8_t mask[BLEND_N];
+    srand(19);
+    for (int i = 0; i < BLEND_N; i++) {
+        src[i] = (uint16_t)rand();
+        dst0[i] = (uint16_t)rand();
+        int run = (i / 16) % 3;
+        mask[i] = run == 0 ? 0 : run == 1 ? 255 : (uint8_t)rand();
+    }
+    uint32_t bad = 0;
+    for (int alpha = 0; alpha < 256; alpha++) {
+        for (int off = 0; off < 4; off++) {
+            size_t n = BLEND_N - 8 + off;
+            memcpy(a, dst0, sizeof(a));
+            memcpy(b, dst0, sizeof(b));
+            rm_color_blend_be565(a + off, src, n, (uint8_t)alpha);
+            rm_color_blend_be565_ref(b + off, src, n, (uint8_t)alpha);
+            bad += memcmp(a, b, sizeof(a)) != 0;
+            memcpy(a, dst0, sizeof(a));
+            memcpy(b, dst0, sizeof(b));
+            rm_color_blend_be565_a8(a, src + off, mask + off, n, (uint8_t)alpha);
+            rm_color_blend_be565_a8_ref(b, src + off, mask + off, n, (uint8_t)alpha);
+            bad += memcmp(a, b, sizeof(a)) != 0;
+        }
+    }
+    if (bad) {
+        fprintf(stderr, "layers: %u blend runs differ from the reference\n", bad);
+        s_failures++;
+    }
+
+    struct timespec t0, t1;
+    for (int k = 0; k < 2; k++) {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int r = 0; r < BLEND_ROUNDS; r++) {
+            if (k) {
+                rm_color_blend_be565_a8(a, src, mask, BLEND_N, 200);
+            } else {
+                rm_color_blend_be565(a, src, BLEND_N, (uint8_t)(64 + (r & 127)));
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double t = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+        printf("  blend %s: %.0f Mpixels/s\n", k ? "a8 mask" : "constant", (double)BLEND_ROUNDS * BLEND_N / t / 1e6);
+    }
+}
+
+static void layers_paint(void) {
+    size_t stride;
+    uint16_t *px = rm690b0_layer_pixels(s_layers[0].layer, &stride);
+    for (uint32_t y = 0; y < 450; y++) {
+        for (uint32_t x = 0; x < 600; x++) px[y * stride + x] = rm_color_be((uint16_t)((x / 4) << 11 | (y / 8) << 5 | 8));
+    }
+    rm690b0_layer_mark_dirty(s_layers[0].layer, 0, 0, 600, 450);
+
+    // Graph: grid and a sine-ish trace
+    rm690b0_layer_t *graph = s_layers[1].layer;
+    rm690b0_layer_fill(graph, 0, 0, 600, 300, 0x0000, 255);
+    for (uint16_t x = 0; x < 600; x += 50) rm690b0_layer_fill(graph, x, 0, 1, 300, RM_COLOR_DARK_GREY, 255);
+    for (uint16_t x = 0; x < 600; x++) {
+        int32_t v = (int32_t)((x * 37) % 200) - 100;
+        uint16_t y = (uint16_t)(150 + (v * (100 - (v < 0 ? -v : v))) / 40);
+        rm690b0_layer_fill(graph, x, y, 1, 3, RM_COLOR_GREEN, 255);
+    }
+
+    rm690b0_layer_t *hud = s_layers[2].layer;
+    rm690b0_layer_fill(hud, 0, 0, 240, 120, RM_COLOR_BLUE, 255);
+    rm690b0_layer_fill(hud, 10, 50, 220, 20, RM_COLOR_WHITE, 255);
+
+    // Toast: soft 4-pixel border around an opaque body
+    rm690b0_layer_t *toast = s_layers[3].layer;
+    rm690b0_layer_fill(toast, 0, 0, 200, 48, RM_COLOR_YELLOW, 96);
+    rm690b0_layer_fill(toast, 4, 4, 192, 40, RM_COLOR_YELLOW, 255);
+    rm690b0_layer_fill(toast, 20, 20, 160, 8, RM_COLOR_BLACK, 255);
+
+    rm690b0_layer_t *cursor = s_layers[4].layer;
+    rm690b0_layer_fill(cursor, 0, 0, 17, 17, RM_COLOR_WHITE, 0);
+    uint8_t *m = rm690b0_layer_mask(cursor);
+    for (int y = 0; y < 17; y++) {
+        for (int x = 0; x < 17; x++) {
+            int d2 = (x - 8) * (x - 8) + (y - 8) * (y - 8);
+            m[y * 17 + x] = d2 <= 49 ? 255 : d2 <= 72 ? 128 : 0;
+        }
+    }
+    rm690b0_layer_mark_dirty(cursor, 0, 0, 17, 17);
+}
+
+// Whole-screen composition with the reference kernels
+static void layers_golden(void) {
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    free(s_golden);
+    s_golden = malloc((size_t)w * h * 2);
+    for (int32_t y = 0; y < h; y++) {
+        uint16_t *row = s_golden + (size_t)y * w;
+        for (int32_t x = 0; x < w; x++) row[x] = rm_color_be(LAYER_BG);
+        for (int i = 0; i < LAYER_COUNT; i++) {
+            const rm690b0_layer_config_t *c = &s_layers[i].cfg;
+            if (y < c->y || y >= c->y + c->h) continue;
+            int32_t x0 = c->x < 0 ? 0 : c->x;
+            int32_t x1 = c->x + c->w > w ? w : c->x + c->w;
+            if (x0 >= x1) continue;
+            size_t off = (size_t)(y - c->y) * c->w + (size_t)(x0 - c->x);
+            const uint16_t *px = rm690b0_layer_pixels(s_layers[i].layer, NULL) + off;
+            if (c->mask) {
+                rm_color_blend_be565_a8_ref(row + x0, px, rm690b0_layer_mask(s_layers[i].layer) + off, x1 - x0, c->alpha);
+            } else {
+                rm_color_blend_be565_ref(row + x0, px, x1 - x0, c->alpha);
+            }
+        }
+        for (int32_t x = 0; x < w; x++) row[x] = rm_color_be(row[x]);
+    }
+}
+
+static void sc_layers(void) {
+    blend_check();
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    rm690b0_layers_init(LAYER_BG);
+    for (int i = 0; i < LAYER_COUNT; i++) {
+        if (rm690b0_layer_create(&s_layers[i].cfg, &s_layers[i].layer) != ESP_OK) {
+            s_failures++;
+            return;
+        }
+    }
+    layers_paint();
+    if (rm690b0_layers_compose() != ESP_OK) s_failures++;
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+
+    rm690b0_layer_stats_t st;
+    rm690b0_layers_get_stats(&st);
+    printf("  layers: %u windows, %u pixels, %u tiles, %u layers culled, %u layer pixels\n",
+           st.areas, st.pixels, st.tiles, st.culled, st.layer_pixels);
+    if (st.culled == 0) {
+        fprintf(stderr, "layers: wallpaper under the graph not culled\n");
+        s_failures++;
+    }
+    layers_golden();
+    expect_golden("layers");
+    expect_pixel("layers", 300, 70, RM_COLOR_YELLOW);    // Toast body
+    expect_pixel("layers", 309, 209, RM_COLOR_WHITE);    // Cursor centre
+}
+
+static void sc_layers_move(void) {
+    rm690b0_layer_stats_t st0, st1;
+    rm690b0_layers_get_stats(&st0);
+    sim_layer_t *cursor = &s_layers[4], *toast = &s_layers[3];
+    for (int i = 0; i < LAYER_MOVES; i++) {
+        cursor->cfg.x += 13;
+        cursor->cfg.y += 7;
+        rm690b0_layer_move(cursor->layer, cursor->cfg.x, cursor->cfg.y);
+        toast->cfg.alpha = (uint8_t)(255 - i * 12);
+        rm690b0_layer_set_alpha(toast->layer, toast->cfg.alpha);
+        if (rm690b0_layers_compose() != ESP_OK) s_failures++;
+    }
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    rm690b0_layers_get_stats(&st1);
+
+    uint32_t composes = st1.composes - st0.composes;
+    uint32_t pixels = st1.pixels - st0.pixels;
+    printf("  layers_move: %u composes, %u pixels each (screen %u), %u windows\n", composes,
+           pixels / composes, 600 * 450, st1.areas - st0.areas);
+    // Toast (200x48) plus the cursor's old and new bounds, merged or not
+    if (pixels / composes > 200 * 48 + 4 * 18 * 17) {
+        fprintf(stderr, "layers_move: recomposed more than the touched bounds\n");
+        s_failures++;
+    }
+    layers_golden();
+    expect_golden("layers_move");
+    rm690b0_layers_deinit();
+}
+
+// Tile-hash delta flushes: each frame sequence is replayed through the
+// framebuffer once in row mode and once in delta mode, every frame fully
+// redrawn and marked dirty, as apps that repaint the whole screen do. -f adds
+// a captured sequence: raw big-endian RGB565 frames of the current size, e.g.
+//   ffmpeg -i ui.mp4 -s 600x450 -f rawvideo -pix_fmt rgb565be ui.raw
+#define DELTA_FRAMES    60
+#define DELTA_BG        0x10A2
+
+static const char *s_frames_path;
+static FILE *s_frames;
+
+typedef bool (*delta_frame_fn_t)(uint32_t i);
+
+// Dashboard: static panels, a rotating spinner and a bar graph whose newest
+// bar changes every frame
+static bool delta_dashboard(uint32_t i) {
+    rm690b0_fb_clear(DELTA_BG);
+    rm690b0_fb_fill_rect(0, 0, 600, 40, RM_COLOR_DARK_GREY);
+    rm690b0_fb_fill_rect(20, 60, 260, 160, RM_COLOR_BLUE);
+    rm690b0_fb_fill_rect(320, 60, 260, 160, RM_COLOR_BLUE);
+    for (uint32_t b = 0; b < 16; b++) {
+        uint32_t v = (b == 15) ? (i * 37) % 140 : (b * 53) % 140;
+        rm690b0_fb_fill_rect(30 + b * 34, 420 - v, 24, v, RM_COLOR_GREEN);
+    }
+    rm_shape_t s;
+    float a = (float)(i * 24 % 360);
+    rm_shape_arc(&s, 450, 140, 50, 10, a, a + 90);
+    rm690b0_fb_draw_shape(&s, RM_COLOR_YELLOW, true);
+    return true;
+}
+
+// List scrolling 3 pixels a frame: almost every tile changes
+static bool delta_scroll(uint32_t i) {
+    rm690b0_fb_clear(DELTA_BG);
+    for (int32_t r = -1; r < 12; r++) {
+        int32_t y = r * 40 - (int32_t)(i * 3 % 40);
+        if (y < 0) continue;
+        rm690b0_fb_fill_rect(10, y, 580, 34, (r + i * 3 / 40) & 1 ? RM_COLOR_DARK_GREY : RM_COLOR_BLUE);
+    }
+    return true;
+}
+
+static bool delta_captured(uint32_t i) {
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    size_t stride;
+    uint16_t *fb = rm690b0_fb_get(&stride);
+    if (fread(fb, (size_t)w * h * 2, 1, s_frames) != 1) return false;
+    rm690b0_fb_mark_all();
+    return true;
+}
+
+typedef struct {
+    uint64_t bytes;
+    double wire_ms;
+    uint32_t frames;
+} delta_run_t;
+
+static delta_run_t delta_replay(delta_frame_fn_t fn, bool delta) {
+    delta_run_t run = {0};
+    rm690b0_fb_init();
+    rm690b0_fb_set_delta(delta);
+    if (s_frames) rewind(s_frames);
+    uint64_t bytes0 = s_sim.stats.bytes, wire0 = s_sim.stats.wire_ns;
+    for (uint32_t i = 0; (s_frames && fn == delta_captured) || i < DELTA_FRAMES; i++) {
+        if (!fn(i)) break;
+        rm690b0_fb_flush();
+        run.frames++;
+    }
+    run.bytes = s_sim.stats.bytes - bytes0;
+    run.wire_ms = (s_sim.stats.wire_ns - wire0) / 1e6;
+    return run;
+}
+
+static void delta_sequence(const char *name, delta_frame_fn_t fn) {
+    delta_run_t rows = delta_replay(fn, false);
+    rm690b0_fb_deinit();
+    delta_run_t delta = delta_replay(fn, true);
+    rm690b0_fb_stats_t st;
+    rm690b0_fb_get_stats(&st);
+    if (delta.frames == 0) {
+        rm690b0_fb_deinit();
+        return;
+    }
+    printf("  delta %s: %u frames, row mode %.1f KB/frame %.1f ms, delta %.1f KB/frame %.1f ms, "
+           "%.1f%% tiles skipped, %u windows\n", name, delta.frames,
+           rows.bytes / 1024.0 / rows.frames, rows.wire_ms / rows.frames,
+           delta.bytes / 1024.0 / delta.frames, delta.wire_ms / delta.frames,
+           100.0 * st.tiles_skipped / st.tiles_hashed, st.areas_sent);
+
+    // The panel must show the last frame
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    size_t stride;
+    const uint16_t *fb = rm690b0_fb_get(&stride);
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    uint32_t bad = 0;
+    for (uint16_t y = 0; y < h; y++) {
+        for (uint16_t x = 0; x < w; x++) {
+            uint16_t want = rm_color_be(fb[(size_t)y * stride + x]);
+            if (rm690b0_bus_sim_pixel(&s_sim, x, y) != want && bad++ == 0) expect_pixel(name, x, y, want);
+        }
+    }
+    if (bad) fprintf(stderr, "delta %s: %u pixels differ from the last frame\n", name, bad);
+
+    // Host cost of hashing a full unchanged frame
+    struct timespec t0, t1;
+    rm690b0_fb_mark_all();
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    rm690b0_fb_flush();
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    rm690b0_fb_stats_t st1;
+    rm690b0_fb_get_stats(&st1);
+    if (st1.areas_sent != st.areas_sent) {
+        fprintf(stderr, "delta %s: unchanged frame sent\n", name);
+        s_failures++;
+    }
+    printf("  delta %s: unchanged frame hashed in %.3f ms on the host\n", name,
+           ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 1e6);
+    rm690b0_fb_deinit();
+}
+
+static void sc_delta_replay(void) {
+    delta_sequence("dashboard", delta_dashboard);
+    delta_sequence("scroll", delta_scroll);
+    if (s_frames_path) {
+        s_frames = fopen(s_frames_path, "rb");
+        if (!s_frames) {
+            fprintf(stderr, "cannot read %s\n", s_frames_path);
+            s_failures++;
+            return;
+        }
+        delta_sequence("captured", delta_captured);
+        fclose(s_frames);
+        s_frames = NULL;
+    }
+}
+
+// Band renderer: the dashboard as a display list, sent band by band without a
+// framebuffer. The golden image is the same list drawn into the framebuffer.
+// Host render time against virtual wire time drives the band height here, so
+// the adaptation only shows the mechanics, not device numbers.
+#define BAND_BG         0x0843
+#define BAND_FRAMES     8
+#define BAND_ITEMS      7
+#define BAND_BMP_W      96
+#define BAND_BMP_H      64
+
+static rm690b0_band_item_t s_band_items[BAND_ITEMS];
+static rm_shape_t s_band_shapes[2];
+static uint16_t s_band_bmp[BAND_BMP_W * BAND_BMP_H];
+static rm690b0_font_t s_band_font;
+static rm690b0_text_style_t s_band_text;
+
+static void band_list(void) {
+    for (uint32_t y = 0; y < BAND_BMP_H; y++) {
+        for (uint32_t x = 0; x < BAND_BMP_W; x++) {
+            uint16_t c = (uint16_t)(((x * 31 / BAND_BMP_W) << 11) | ((y * 63 / BAND_BMP_H) << 5) | 0x10);
+            s_band_bmp[y * BAND_BMP_W + x] = (uint16_t)((c >> 8) | (c << 8));
+        }
+    }
+    rm_shape_circle(&s_band_shapes[0], 470, 140, 90, 14);
+    rm_shape_round_rect(&s_band_shapes[1], 30, 250, 260, 150, 20, 0);
+    rm690b0_font_builtin(&s_band_font);
+    s_band_text = (rm690b0_text_style_t){ .font = &s_band_font, .fg = RM_COLOR_WHITE, .bg = BAND_BG };
+
+    rm690b0_band_item_t items[BAND_ITEMS] = {
+        { .op = RM_BAND_FILL, .x = 0, .y = 0, .w = 600, .h = 40, .color = 0x2945 },         // Title bar
+        { .op = RM_BAND_TEXT, .x = 12, .y = 12, .data = "Bands 12:34\nno framebuffer", .style = &s_band_text },
+        { .op = RM_BAND_SHAPE, .aa = true, .color = RM_COLOR_CYAN, .data = &s_band_shapes[0] },
+        { .op = RM_BAND_SHAPE, .aa = true, .color = 0x3186, .data = &s_band_shapes[1] },
+        { .op = RM_BAND_BITMAP, .x = 110, .y = 290, .w = BAND_BMP_W, .h = BAND_BMP_H,
+          .data = s_band_bmp, .stride = BAND_BMP_W },
+        { .op = RM_BAND_FILL, .x = 330, .y = 300, .w = 240, .h = 18, .color = RM_COLOR_GREEN },
+        { .op = RM_BAND_BITMAP, .x = 540, .y = 420, .w = BAND_BMP_W, .h = BAND_BMP_H,        // Partly off screen
+          .data = s_band_bmp, .stride = BAND_BMP_W },
+    };
+    memcpy(s_band_items, items, sizeof(items));
+}
+
+static void band_golden(const rm690b0_band_item_t *items, size_t count) {
+    rm690b0_fb_init();
+    rm690b0_fb_clear(BAND_BG);
+    for (size_t i = 0; i < count; i++) {
+        const rm690b0_band_item_t *it = &items[i];
+        int32_t w = rm690b0_get_width(), h = rm690b0_get_height();
+        int32_t x0 = it->x > 0 ? it->x : 0, y0 = it->y > 0 ? it->y : 0;
+        int32_t x1 = it->x + it->w < w ? it->x + it->w : w, y1 = it->y + it->h < h ? it->y + it->h : h;
+        switch (it->op) {
+        case RM_BAND_FILL:
+            if (x0 < x1 && y0 < y1) rm690b0_fb_fill_rect(x0, y0, x1 - x0, y1 - y0, it->color);
+            break;
+        case RM_BAND_BITMAP:
+            if (x0 < x1 && y0 < y1) {
+                const uint16_t *src = (const uint16_t *)it->data + (y0 - it->y) * it->stride + (x0 - it->x);
+                rm690b0_fb_write(x0, y0, x1 - x0, y1 - y0, src, it->stride);
+            }
+            break;
+        case RM_BAND_SHAPE:
+            rm690b0_fb_draw_shape(it->data, it->color, it->aa);
+            break;
+        default:
+            rm690b0_fb_draw_text(it->style, it->x, it->y, it->data);
+            break;
+        }
+    }
+    rm690b0_fb_flush();
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    rm690b0_fb_deinit();
+
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    free(s_golden);
+    s_golden = malloc((size_t)w * h * 2);
+    for (uint16_t y = 0; y < h; y++) {
+        for (uint16_t x = 0; x < w; x++) s_golden[(size_t)y * w + x] = rm690b0_bus_sim_pixel(&s_sim, x, y);
+    }
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+}
+
+static void bands_run(const char *what, uint16_t max_rows) {
+    rm690b0_band_config_t cfg = { .bg = BAND_BG, .max_rows = max_rows };
+    if (rm690b0_text_cache_init(16 * 1024, 0) != ESP_OK || rm690b0_band_init(&cfg) != ESP_OK) {
+        s_failures++;
+        return;
+    }
+    band_list();
+    band_golden(s_band_items, BAND_ITEMS);
+    rm690b0_band_set_list(s_band_items, BAND_ITEMS);
+
+    rm690b0_band_stats_t st;
+    for (int f = 0; f < BAND_FRAMES; f++) {
+        if (rm690b0_band_frame() != ESP_OK) s_failures++;
+        rm690b0_band_get_stats(&st);
+        if (f == 0 || f == BAND_FRAMES - 1) {
+            size_t n;
+            rm690b0_band_get_timings(&n);
+            printf("  %s frame %d: %zu bands, next %u rows (buffers %u), render %u us, wait %u us, frame %u us\n",
+                   what, f, n, st.rows, st.buffer_rows, st.render_us, st.wait_us, st.frame_us);
+        }
+        expect_golden(what);
+    }
+    size_t n;
+    const rm690b0_band_timing_t *t = rm690b0_band_get_timings(&n);
+    printf("  %s: %zu bands last frame, first y %u rows %u render %u us, %u grows, %u shrinks, %u idle\n",
+           what, n, t[0].y, t[0].rows, t[0].render_us, st.grows, st.shrinks, st.dma_idle);
+    if (n == 0 || n > RM_BAND_MAX_BANDS || t[n - 1].y + t[n - 1].rows != rm690b0_get_height()) {
+        fprintf(stderr, "%s: bands do not cover the screen\n", what);
+        s_failures++;
+    }
+
+    // A partial draw only sends its rows
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    rm690b0_band_draw(250, 40);
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    expect_pixel(what, 0, 249, RM_COLOR_BLACK);
+    expect_pixel(what, 0, 250, s_golden[250 * rm690b0_get_width()]);
+    expect_pixel(what, 0, 290, RM_COLOR_BLACK);
+    rm690b0_band_draw(0, rm690b0_get_height());
+
+    rm690b0_band_deinit();
+    rm690b0_text_cache_deinit();
+}
+
+static void sc_bands(void) {
+    bands_run("bands", 0);
+}
+
+// Buffers too short for the timing table are raised to fit it
+static void sc_bands_small(void) {
+    bands_run("bands_small_rows", 4);
+}
+
+// Portrait, and packed to RGB332 band by band
+static void sc_bands_rot1(void) {
+    rm690b0_ifpf_stats_t st0, st1;
+    rm690b0_set_rotation(1);
+    rm690b0_set_interface_format(RM_IFPF_RGB332);
+    rm690b0_get_ifpf_stats(&st0);
+    bands_run("bands_rot1_rgb332", 0);
+    rm690b0_get_ifpf_stats(&st1);
+    rm690b0_set_interface_format(RM_IFPF_RGB565);
+    rm690b0_set_rotation(0);
+    printf("  ifpf: %u bytes saved\n", st1.bytes_saved - st0.bytes_saved);
+    if (st1.bytes_saved == st0.bytes_saved) s_failures++;
+}
+
+// Parallel bands: the dashboard under a field of anti-aliased rings, rendered
+// by 0, 1, 2 and 4 workers. Every run must match the golden image, i.e. bands
+// reach the panel in scanline order whoever rendered them; host frame times
+// show the scaling (the simulated wire runs on the sending thread).
+#define PAR_RINGS       48
+#define PAR_FRAMES      10
+
+static rm690b0_band_item_t s_par_items[BAND_ITEMS + PAR_RINGS];
+static rm_shape_t s_par_rings[PAR_RINGS];
+
+static void sc_bands_parallel(void) {
+    if (rm690b0_text_cache_init(16 * 1024, 0) != ESP_OK) {
+        s_failures++;
+        return;
+    }
+    band_list();
+    memcpy(s_par_items, s_band_items, sizeof(s_band_items));
+    for (int i = 0; i < PAR_RINGS; i++) {
+        rm_shape_circle(&s_par_rings[i], 37 + (i % 8) * 75, 37 + (i / 8) * 75, 34, 5 + i % 4);
+        s_par_items[BAND_ITEMS + i] = (rm690b0_band_item_t){
+            .op = RM_BAND_SHAPE, .aa = true, .color = shape_color(i % SHAPE_COUNT), .data = &s_par_rings[i],
+        };
+    }
+    size_t count = BAND_ITEMS + PAR_RINGS;
+    band_golden(s_par_items, count);
+
+    printf("  host: %ld CPUs online\n", sysconf(_SC_NPROCESSORS_ONLN));
+    double base = 0;
+    for (uint8_t workers = 0; workers <= RM_SCHED_MAX_WORKERS; workers = workers ? workers * 2 : 1) {
+        rm690b0_sched_config_t sc = { .workers = workers, .priority = 5, .pin = true };
+        if (workers && rm690b0_sched_init(&sc) != ESP_OK) {
+            s_failures++;
+            break;
+        }
+        rm690b0_band_config_t cfg = { .bg = BAND_BG, .fixed = true };
+        if (rm690b0_band_init(&cfg) != ESP_OK) {
+            s_failures++;
+            rm690b0_sched_deinit();
+            break;
+        }
+        rm690b0_band_set_list(s_par_items, count);
+
+        double ms = 0;
+        for (int f = 0; f < PAR_FRAMES; f++) {
+            rm690b0_fill_screen(RM_COLOR_BLACK);
+            struct timespec t0, t1;
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            if (rm690b0_band_frame() != ESP_OK) s_failures++;
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            ms += ((t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6) / PAR_FRAMES;
+            expect_golden("bands_parallel");
+        }
+        if (workers == 0) base = ms;
+
+        rm690b0_band_stats_t st;
+        rm690b0_sched_stats_t ss = {0};
+        rm690b0_band_get_stats(&st);
+        rm690b0_sched_get_stats(&ss);
+        printf("  %u workers: %.2f ms/frame, x%.2f, render %u us/frame, %u stolen, %u by the sender\n",
+               workers, ms, base / ms, st.render_us, ss.steals, ss.helped);
+        if (st.parallel != workers) s_failures++;
+        rm690b0_band_deinit();
+        if (workers) rm690b0_sched_deinit();
+    }
+    rm690b0_text_cache_deinit();
+}
+
+// --- MJPEG ---
+
+// Baseline encoder for the test streams: standard tables, 4:2:0, 4:4:4 or gray
+typedef struct {
+    uint8_t *buf;
+    size_t len, cap;
+    uint32_t acc;
+    int nbits;
+} jenc_t;
+
+typedef struct {
+    uint16_t code[256];
+    uint8_t size[256];
+} jenc_huff_t;
+
+static const uint8_t s_jq_lum[64] = {
+    16, 11, 10, 16, 24, 40, 51, 61, 12, 12, 14, 19, 26, 58, 60, 55,
+    14, 13, 16, 24, 40, 57, 69, 56, 14, 17, 22, 29, 51, 87, 80, 62,
+    18, 22, 37, 56, 68, 109, 103, 77, 24, 35, 55, 64, 81, 104, 113, 92,
+    49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99,
+};
+static const uint8_t s_jq_chr[64] = {
+    17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+    24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+};
+static const uint8_t s_jzz[64] = {
+     0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+};
+// Annex K.3: counts per code length, then values
+static const uint8_t s_jh_dc_lum[16 + 12] = {
+    0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+};
+static const uint8_t s_jh_dc_chr[16 + 12] = {
+    0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+};
+static uint8_t s_jh_ac_lum[16 + 162], s_jh_ac_chr[16 + 162];
+
+// AC tables from their Annex K.3 value order, generated rather than typed out twice
+static void jenc_ac_tables(void) {
+    static const uint8_t lum_counts[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+    static const uint8_t lum_head[] = { 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06,
+                                        0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08,
+                                        0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72,
+                                        0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+                                        0x29, 0x2a };
+    static const uint8_t chr_counts[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+    static const uint8_t chr_head[] = { 0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41,
+                                        0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91,
+                                        0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1,
+                                        0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+                                        0x27, 0x28, 0x29, 0x2a };
+    struct { uint8_t *dst; const uint8_t *counts, *head; size_t nhead; } t[2] = {
+        { s_jh_ac_lum, lum_counts, lum_head, sizeof(lum_head) },
+        { s_jh_ac_chr, chr_counts, chr_head, sizeof(chr_head) },
+    };
+    for (int k = 0; k < 2; k++) {
+        memcpy(t[k].dst, t[k].counts, 16);
+        memcpy(t[k].dst + 16, t[k].head, t[k].nhead);
+        // Then every remaining run/size with size 1..10 in run, size order
+        size_t n = 16 + t[k].nhead;
+        for (int run = 0; run < 16; run++) {
+            for (int size = 1; size <= 10; size++) {
+                uint8_t v = (uint8_t)(run << 4 | size);
+                if (!memchr(t[k].head, v, t[k].nhead)) t[k].dst[n++] = v;
+            }
+        }
+    }
+}
+
+static void jenc_huff(jenc_huff_t *h, const uint8_t *table) {
+    uint16_t code = 0;
+    const uint8_t *v = table + 16;
+    for (int len = 1; len <= 16; len++) {
+        for (int i = 0; i < table[len - 1]; i++) {
+            h->code[*v] = code++;
+            h->size[*v++] = (uint8_t)len;
+        }
+        code <<= 1;
+    }
+}
+
+static void jenc_byte(jenc_t *e, uint8_t b) {
+    if (e->len == e->cap) {
+        e->cap = e->cap ? e->cap * 2 : 65536;
+        e->buf = realloc(e->buf, e->cap);
+    }
+    e->buf[e->len++] = b;
+}
+
+static void jenc_word(jenc_t *e, uint16_t v) {
+    jenc_byte(e, v >> 8);
+    jenc_byte(e, v & 0xff);
+}
+
+static void jenc_bits(jenc_t *e, uint32_t v, int n) {
+    e->acc = (e->acc << n) | (v & ((1u << n) - 1));
+    e->nbits += n;
+    while (e->nbits >= 8) {
+        uint8_t b = (uint8_t)(e->acc >> (e->nbits - 8));
+        jenc_byte(e, b);
+        if (b == 0xff) jenc_byte(e, 0);
+        e->nbits -= 8;
+    }
+}
+
+static void jenc_flush(jenc_t *e) {
+    if (e->nbits) jenc_bits(e, 0x7f, 8 - e->nbits);
+    e->acc = 0;
+    e->nbits = 0;
+}
+
+static void jenc_value(jenc_t *e, const jenc_huff_t *h, int sym, int32_t v) {
+    jenc_bits(e, h->code[sym], h->size[sym]);
+    int size = sym & 15;
+    if (size) jenc_bits(e, (uint32_t)(v < 0 ? v - 1 : v), size);
+}
+
+static int jenc_size(int32_t v) {
+    int n = 0;
+    for (uint32_t a = (uint32_t)(v < 0 ? -v : v); a; a >>= 1) n++;
+    return n;
+}
+
+static void jenc_block(jenc_t *e, const float *px, const uint8_t *q, int32_t *dc,
+                       const jenc_huff_t *hdc, const jenc_huff_t *hac) {
+    static float cosines[8][8];
+    if (cosines[0][0] == 0) {
+        for (int x = 0; x < 8; x++) {
+            for (int u = 0; u < 8; u++) cosines[x][u] = cosf((2 * x + 1) * u * 3.14159265f / 16) * (u ? 0.5f : 0.35355339f);
+        }
+    }
+    int32_t coef[64];
+    for (int v = 0; v < 8; v++) {
+        for (int u = 0; u < 8; u++) {
+            float s = 0;
+            for (int y = 0; y < 8; y++) {
+                for (int x = 0; x < 8; x++) s += (px[y * 8 + x] - 128) * cosines[x][u] * cosines[y][v];
+            }
+            coef[v * 8 + u] = (int32_t)lroundf(s / q[v * 8 + u]);
+        }
+    }
+    int32_t diff = coef[0] - *dc;
+    *dc = coef[0];
+    jenc_value(e, hdc, jenc_size(diff), diff);
+    int run = 0;
+    for (int k = 1; k < 64; k++) {
+        int32_t c = coef[s_jzz[k]];
+        if (c == 0) {
+            run++;
+            continue;
+        }
+        for (; run > 15; run -= 16) jenc_value(e, hac, 0xf0, 0);
+        jenc_value(e, hac, run << 4 | jenc_size(c), c);
+        run = 0;
+    }
+    if (run) jenc_value(e, hac, 0x00, 0);
+}
+
+typedef struct {
+    uint8_t sub;            // 2: 4:2:0, 1: 4:4:4, 0: gray
+    uint8_t quality;
+    uint16_t restart;       // MCUs per interval, 0: none
+    bool no_dht;            // Leave the tables out, as AVI MJPEG does
+} jenc_opts_t;
+
+// Append one JPEG of rgb (w x h, RGB888) to e
+static void jenc_encode(jenc_t *e, const uint8_t *rgb, uint16_t w, uint16_t h, const jenc_opts_t *o) {
+    if (!s_jh_ac_lum[0] && !s_jh_ac_lum[1]) jenc_ac_tables();
+    uint8_t q[2][64];
+    int scale = o->quality < 50 ? 5000 / o->quality : 200 - 2 * o->quality;
+    for (int i = 0; i < 64; i++) {
+        int l = (s_jq_lum[i] * scale + 50) / 100, c = (s_jq_chr[i] * scale + 50) / 100;
+        q[0][i] = (uint8_t)(l < 1 ? 1 : l > 255 ? 255 : l);
+        q[1][i] = (uint8_t)(c < 1 ? 1 : c > 255 ? 255 : c);
+    }
+    int ncomp = o->sub ? 3 : 1;
+    int f = (o->sub == 2) ? 2 : 1;
+
+    jenc_word(e, 0xffd8);
+    for (int t = 0; t < (ncomp == 3 ? 2 : 1); t++) {
+        jenc_word(e, 0xffdb);
+        jenc_word(e, 67);
+        jenc_byte(e, (uint8_t)t);
+        for (int k = 0; k < 64; k++) jenc_byte(e, q[t][s_jzz[k]]);
+    }
+    jenc_word(e, 0xffc0);
+    jenc_word(e, (uint16_t)(8 + 3 * ncomp));
+    jenc_byte(e, 8);
+    jenc_word(e, h);
+    jenc_word(e, w);
+    jenc_byte(e, (uint8_t)ncomp);
+    for (int c = 0; c < ncomp; c++) {
+        jenc_byte(e, (uint8_t)(c + 1));
+        jenc_byte(e, c ? 0x11 : (uint8_t)(f << 4 | f));
+        jenc_byte(e, c ? 1 : 0);
+    }
+    const uint8_t *tables[4] = { s_jh_dc_lum, s_jh_ac_lum, s_jh_dc_chr, s_jh_ac_chr };
+    if (!o->no_dht) {
+        for (int t = 0; t < (ncomp == 3 ? 4 : 2); t++) {
+            size_t n = 0;
+            for (int i = 0; i < 16; i++) n += tables[t][i];
+            jenc_word(e, 0xffc4);
+            jenc_word(e, (uint16_t)(19 + n));
+            jenc_byte(e, (uint8_t)((t & 1) << 4 | t >> 1));
+            for (size_t i = 0; i < 16 + n; i++) jenc_byte(e, tables[t][i]);
+        }
+    }
+    if (o->restart) {
+        jenc_word(e, 0xffdd);
+        jenc_word(e, 4);
+        jenc_word(e, o->restart);
+    }
+    jenc_word(e, 0xffda);
+    jenc_word(e, (uint16_t)(6 + 2 * ncomp));
+    jenc_byte(e, (uint8_t)ncomp);
+    for (int c = 0; c < ncomp; c++) {
+        jenc_byte(e, (uint8_t)(c + 1));
+        jenc_byte(e, c ? 0x11 : 0x00);
+    }
+    jenc_byte(e, 0);
+    jenc_byte(e, 63);
+    jenc_byte(e, 0);
+
+    jenc_huff_t hdc[2], hac[2];
+    for (int t = 0; t < 2; t++) {
+        jenc_huff(&hdc[t], tables[2 * t]);
+        jenc_huff(&hac[t], tables[2 * t + 1]);
+    }
+    int32_t dc[3] = { 0 };
+    int mcu = 8 * f;
+    uint32_t mcus = 0, rst = 0;
+    for (int my = 0; my < (h + mcu - 1) / mcu; my++) {
+        for (int mx = 0; mx < (w + mcu - 1) / mcu; mx++) {
+            if (o->restart && mcus && mcus % o->restart == 0) {
+                jenc_flush(e);
+                jenc_word(e, (uint16_t)(0xffd0 + (rst++ & 7)));
+                memset(dc, 0, sizeof(dc));
+            }
+            mcus++;
+            // Y, Cb, Cr of the MCU, edges replicated, chroma averaged over f x f
+            float ycc[3][16 * 16];
+            for (int y = 0; y < mcu; y++) {
+                for (int x = 0; x < mcu; x++) {
+                    int sx = mx * mcu + x, sy = my * mcu + y;
+                    const uint8_t *p = rgb + ((size_t)(sy < h ? sy : h - 1) * w + (sx < w ? sx : w - 1)) * 3;
+                    ycc[0][y * mcu + x] = 0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2];
+                    ycc[1][y * mcu + x] = -0.168736f * p[0] - 0.331264f * p[1] + 0.5f * p[2] + 128;
+                    ycc[2][y * mcu + x] = 0.5f * p[0] - 0.418688f * p[1] - 0.081312f * p[2] + 128;
+                }
+            }
+            float blk[64];
+            for (int by = 0; by < f; by++) {
+                for (int bx = 0; bx < f; bx++) {
+                    for (int i = 0; i < 64; i++) blk[i] = ycc[0][(by * 8 + i / 8) * mcu + bx * 8 + i % 8];
+                    jenc_block(e, blk, q[0], &dc[0], &hdc[0], &hac[0]);
+                }
+            }
+            for (int c = 1; c < ncomp; c++) {
+                for (int i = 0; i < 64; i++) {
+                    float s = 0;
+                    for (int dy = 0; dy < f; dy++) {
+                        for (int dx = 0; dx < f; dx++) s += ycc[c][((i / 8) * f + dy) * mcu + (i % 8) * f + dx];
+                    }
+                    blk[i] = s / (f * f);
+                }
+                jenc_block(e, blk, q[1], &dc[c], &hdc[1], &hac[1]);
+            }
+        }
+    }
+    jenc_flush(e);
+    jenc_word(e, 0xffd9);
+}
+
+// Frame i of the test video: drifting gradients, a bouncing box, a gray ramp
+static void mjpeg_frame(uint8_t *rgb, uint16_t w, uint16_t h, int i) {
+    int bx = (i * 23) % (w - 80), by = (i * 17) % (h - 60);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint8_t *p = rgb + ((size_t)y * w + x) * 3;
+            p[0] = (uint8_t)((x + 4 * i) * 255 / (w + 4 * i));
+            p[1] = (uint8_t)(y * 255 / h);
+            p[2] = (uint8_t)(128 + 127 * sinf((x + y + 8 * i) * 0.03f));
+            if (x >= bx && x < bx + 80 && y >= by && y < by + 60) {
+                p[0] = 240;
+                p[1] = 200;
+                p[2] = 40;
+            }
+            if (y >= h - 24) p[0] = p[1] = p[2] = (uint8_t)(x * 255 / w);
+        }
+    }
+}
+
+// PSNR of big-endian RGB565 against the RGB888 source, in dB
+static double mjpeg_psnr(const uint16_t *be, const uint8_t *rgb, size_t px) {
+    double se = 0;
+    for (size_t i = 0; i < px; i++) {
+        uint16_t c = rm_color_be(be[i]);
+        int r = (c >> 11) << 3, g = ((c >> 5) & 63) << 2, b = (c & 31) << 3;
+        int d0 = r - rgb[3 * i], d1 = g - rgb[3 * i + 1], d2 = b - rgb[3 * i + 2];
+        se += d0 * d0 + d1 * d1 + d2 * d2;
+    }
+    return se ? 10 * log10(255.0 * 255 * 3 * px / se) : 99;
+}
+
+static rm690b0_jpeg_t s_jpeg;
+static const char *s_mjpeg_path;
+
+#define MJPEG_W         600
+#define MJPEG_H         450
+#define MJPEG_FRAMES    12
+
+static void mjpeg_decode_check(const char *what, uint16_t w, uint16_t h, const jenc_opts_t *o, double min_db) {
+    uint8_t *rgb = malloc((size_t)w * h * 3);
+    uint16_t *out = malloc((size_t)w * h * 2);
+    mjpeg_frame(rgb, w, h, 3);
+    if (!o->sub) {
+        for (size_t i = 0; i < (size_t)w * h; i++) {
+            uint8_t *p = rgb + 3 * i;
+            p[0] = p[1] = p[2] = (uint8_t)((p[0] * 299 + p[1] * 587 + p[2] * 114 + 500) / 1000);
+        }
+    }
+    jenc_t e = { 0 };
+    jenc_encode(&e, rgb, w, h, o);
+
+    int reps = (w == MJPEG_W) ? 20 : 1;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    esp_err_t ret = ESP_OK;
+    for (int r = 0; r < reps && ret == ESP_OK; r++) {
+        ret = rm690b0_jpeg_open(&s_jpeg, e.buf, e.len);
+        if (ret == ESP_OK) ret = rm690b0_jpeg_decode(&s_jpeg, out, w);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ms = ((t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6) / reps;
+    double db = (ret == ESP_OK) ? mjpeg_psnr(out, rgb, (size_t)w * h) : 0;
+    printf("  %s %ux%u: %zu bytes, %.1f dB, decode %.2f ms (%.1f Mpx/s)\n",
+           what, w, h, e.len, db, ms, w * h / ms / 1e3);
+    if (ret != ESP_OK || db < min_db) {
+        fprintf(stderr, "%s: decode %s, %.1f dB\n", what, esp_err_to_name(ret), db);
+        s_failures++;
+    }
+    free(e.buf);
+    free(out);
+    free(rgb);
+}
+
+static void mjpeg_play(const char *what, const rm690b0_play_config_t *cfg, rm690b0_play_stats_t *st) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (rm690b0_play_run(cfg) != ESP_OK) s_failures++;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    rm690b0_play_get_stats(st);
+    printf("  %s: %u shown, %u dropped, %u bad in %.0f ms: decode %u us, transmit %u us, wait %u us, %.1f fps\n",
+           what, st->frames, st->dropped, st->bad,
+           (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6,
+           st->decode_us, st->transmit_us, st->wait_us, st->fps);
+}
+
+// Malformed DHT segments are rejected before any table is filled. The decoder
+// is on the heap so a sanitizer build sees writes past its tables.
+static void mjpeg_bad_dht(const char *what, const uint8_t *counts, size_t nvals, size_t tail) {
+    size_t seg = 2 + 17 + nvals + tail;
+    uint8_t *f = calloc(1, 4 + seg + 2);
+    f[0] = 0xFF; f[1] = 0xD8; f[2] = 0xFF; f[3] = 0xC4;
+    f[4] = (uint8_t)(seg >> 8); f[5] = (uint8_t)seg;
+    f[6] = 0x00;                        // DC table 0
+    memcpy(f + 7, counts, 16);
+    f[4 + seg] = 0xFF; f[4 + seg + 1] = 0xD9;
+    rm690b0_jpeg_t *j = malloc(sizeof(*j));
+    esp_err_t ret = rm690b0_jpeg_open(j, f, 4 + seg + 2);
+    if (ret != ESP_ERR_INVALID_ARG) {
+        fprintf(stderr, "mjpeg: %s DHT opened with %s\n", what, esp_err_to_name(ret));
+        s_failures++;
+    }
+    free(j);
+    free(f);
+}
+
+static void sc_mjpeg(void) {
+    // 200 codes of length 1, five of length 2; 12 codes with 5 values sent;
+    // a valid table followed by a partial second table header
+    mjpeg_bad_dht("over-subscribed", (const uint8_t[16]){ 200 }, 200, 0);
+    mjpeg_bad_dht("over-subscribed", (const uint8_t[16]){ 0, 5 }, 5, 0);
+    mjpeg_bad_dht("truncated", (const uint8_t[16]){ 0, 1, 5, 1, 1, 1, 1, 1, 1 }, 5, 0);
+    mjpeg_bad_dht("truncated", (const uint8_t[16]){ 0, 1, 1 }, 2, 6);
+
+    mjpeg_decode_check("4:2:0", MJPEG_W, MJPEG_H, &(jenc_opts_t){ .sub = 2, .quality = 85 }, 30);
+    mjpeg_decode_check("4:4:4", MJPEG_W, MJPEG_H, &(jenc_opts_t){ .sub = 1, .quality = 90 }, 32);
+    mjpeg_decode_check("gray", MJPEG_W, MJPEG_H, &(jenc_opts_t){ .sub = 0, .quality = 85 }, 32);
+    mjpeg_decode_check("4:2:0 restarts, no DHT", 301, 203,
+                       &(jenc_opts_t){ .sub = 2, .quality = 75, .restart = 7, .no_dht = true }, 28);
+
+    // The stream: frames 0 .. N - 1 and a progressive header the player skips
+    jenc_t e = { 0 };
+    uint8_t *rgb = malloc((size_t)MJPEG_W * MJPEG_H * 3);
+    size_t last = 0;
+    for (int i = 0; i < MJPEG_FRAMES; i++) {
+        if (i == MJPEG_FRAMES / 2) {
+            static const uint8_t progressive[] = { 0xff, 0xd8, 0xff, 0xc2, 0x00, 0x0b, 0x08, 0x00, 0x10,
+                                                   0x00, 0x10, 0x01, 0x01, 0x11, 0x00, 0xff, 0xd9 };
+            for (size_t k = 0; k < sizeof(progressive); k++) jenc_byte(&e, progressive[k]);
+        }
+        mjpeg_frame(rgb, MJPEG_W, MJPEG_H, i);
+        last = e.len;
+        jenc_encode(&e, rgb, MJPEG_W, MJPEG_H, &(jenc_opts_t){ .sub = 2, .quality = 80 });
+    }
+    free(rgb);
+
+    // What the last frame must look like
+    uint16_t *want = malloc((size_t)MJPEG_W * MJPEG_H * 2);
+    if (rm690b0_jpeg_open(&s_jpeg, e.buf + last, e.len - last) != ESP_OK ||
+        rm690b0_jpeg_decode(&s_jpeg, want, MJPEG_W) != ESP_OK) {
+        s_failures++;
+    }
+    free(s_golden);
+    s_golden = malloc((size_t)MJPEG_W * MJPEG_H * 2);
+    for (size_t i = 0; i < (size_t)MJPEG_W * MJPEG_H; i++) s_golden[i] = rm_color_be(want[i]);
+    free(want);
+
+    rm690b0_play_stats_t st;
+    rm690b0_play_open_mem(e.buf, e.len);
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    mjpeg_play("unpaced", &(rm690b0_play_config_t){ .x = RM_PLAY_CENTER, .y = RM_PLAY_CENTER, .loops = 1 }, &st);
+    if (st.frames != MJPEG_FRAMES || st.bad != 1 || st.loops != 1) {
+        fprintf(stderr, "mjpeg: %u frames, %u bad, %u loops\n", st.frames, st.bad, st.loops);
+        s_failures++;
+    }
+    expect_golden("mjpeg");
+
+    // 30 fps takes its time; 2000 fps cannot be kept up with and drops
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    mjpeg_play("30 fps", &(rm690b0_play_config_t){ .fps = 30, .drop = true, .loops = 1 }, &st);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+    if (ms < (MJPEG_FRAMES - 1) * 1000.0 / 30 || st.frames + st.dropped + st.bad != MJPEG_FRAMES + 1) {
+        fprintf(stderr, "mjpeg: 30 fps run took %.0f ms, %u shown, %u dropped\n", ms, st.frames, st.dropped);
+        s_failures++;
+    }
+    mjpeg_play("2000 fps, 3 loops", &(rm690b0_play_config_t){ .fps = 2000, .drop = true, .loops = 3 }, &st);
+    if (st.dropped == 0 || st.frames + st.dropped + st.bad != 3 * (MJPEG_FRAMES + 1) || st.loops != 3) {
+        fprintf(stderr, "mjpeg: %u shown, %u dropped, %u loops at 2000 fps\n", st.frames, st.dropped, st.loops);
+        s_failures++;
+    }
+
+    // An odd-sized frame, centered on even columns (148 .. 449, rows 123 .. 325), in RGB332
+    e.len = 0;
+    rgb = malloc(301 * 203 * 3);
+    mjpeg_frame(rgb, 301, 203, 5);
+    jenc_encode(&e, rgb, 301, 203, &(jenc_opts_t){ .sub = 1, .quality = 90, .restart = 5 });
+    free(rgb);
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    rm690b0_set_interface_format(RM_IFPF_RGB332);
+    rm690b0_play_open_mem(e.buf, e.len);
+    mjpeg_play("301x203 rgb332", &(rm690b0_play_config_t){ .x = RM_PLAY_CENTER, .y = RM_PLAY_CENTER, .loops = 1 }, &st);
+    rm690b0_set_interface_format(RM_IFPF_RGB565);
+    expect_pixel("mjpeg odd", 147, 200, RM_COLOR_BLACK);
+    expect_pixel("mjpeg odd", 450, 200, RM_COLOR_BLACK);
+    expect_pixel("mjpeg odd", 300, 122, RM_COLOR_BLACK);
+    expect_pixel("mjpeg odd", 300, 326, RM_COLOR_BLACK);
+    if (rm690b0_bus_sim_pixel(&s_sim, 148, 123) == RM_COLOR_BLACK ||
+        rm690b0_bus_sim_pixel(&s_sim, 449, 325) == RM_COLOR_BLACK) {
+        fprintf(stderr, "mjpeg odd: frame not where expected\n");
+        s_failures++;
+    }
+    rm690b0_play_close();
+    free(e.buf);
+
+    // A captured stream, e.g. ffmpeg -i in.mp4 -vf scale=600:450 -c:v mjpeg -q:v 5 -f mjpeg out.mjpeg
+    FILE *f = s_mjpeg_path ? fopen(s_mjpeg_path, "rb") : NULL;
+    if (s_mjpeg_path && !f) fprintf(stderr, "cannot read %s\n", s_mjpeg_path);
+    if (f) {
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        uint8_t *data = malloc(size);
+        if (fread(data, 1, size, f) == (size_t)size && rm690b0_play_open_mem(data, size) == ESP_OK) {
+            mjpeg_play(s_mjpeg_path, &(rm690b0_play_config_t){ .x = RM_PLAY_CENTER, .y = RM_PLAY_CENTER, .loops = 1 }, &st);
+            rm690b0_play_close();
+        }
+        free(data);
+        fclose(f);
+    }
+}
+
+// Retained display list: a static screen with overdraw, replayed and compared
+// with a host painting under the same even-column rules, then against the
+// same calls drawn immediately, serialized and reloaded, across rotations and
+// packed to RGB332
+#define DLIST_BG        0x2104
+#define DLIST_SCREEN    0xFF    // fill_screen
+#define DLIST_BMP_W     61
+#define DLIST_BMP_H     40
+
+typedef struct {
+    uint8_t op;
+    int16_t x, y;
+    uint16_t w, h, color;
+} dlist_op_t;
+
+static const dlist_op_t s_dlist_ops[] = {
+    { DLIST_SCREEN, 0, 0, 0, 0, DLIST_BG },
+    { RM_DLIST_OP_FILL, 40, 40, 200, 120, RM_COLOR_GREEN },     // Covered by the next: dropped
+    { RM_DLIST_OP_FILL, 30, 30, 220, 140, RM_COLOR_BLUE },      // Cut around the bitmap and bar
+    { RM_DLIST_OP_BITMAP, 101, 61, DLIST_BMP_W, DLIST_BMP_H, 0 },
+    { RM_DLIST_OP_FILL, 0, 100, 600, 20, RM_COLOR_WHITE },      // Bar across both
+    { RM_DLIST_OP_FILL, 275, 200, 50, 50, RM_COLOR_YELLOW },    // Odd x: widened to 274..325
+    { RM_DLIST_OP_FILL, 400, 300, 60, 30, RM_COLOR_RED },       // Two halves: merged
+    { RM_DLIST_OP_FILL, 460, 300, 60, 30, RM_COLOR_RED },
+    { RM_DLIST_OP_FILL, 590, 440, 40, 40, RM_COLOR_GREEN },     // Clipped
+};
+
+static uint16_t *s_dlist_bmp;   // Big-endian
+
+static void dlist_record(rm690b0_dlist_t *dl, uint16_t w, uint16_t h) {
+    if (rm690b0_dlist_begin(dl, w, h) != ESP_OK) s_failures++;
+    for (size_t i = 0; i < sizeof(s_dlist_ops) / sizeof(s_dlist_ops[0]); i++) {
+        const dlist_op_t *o = &s_dlist_ops[i];
+        if (o->op == DLIST_SCREEN) rm690b0_dlist_fill_screen(dl, o->color);
+        else if (o->op == RM_DLIST_OP_FILL) rm690b0_dlist_fill(dl, o->x, o->y, o->w, o->h, o->color);
+        else rm690b0_dlist_bitmap(dl, o->x, o->y, o->w, o->h, s_dlist_bmp, o->w);
+    }
+    if (rm690b0_dlist_end(dl) != ESP_OK) s_failures++;
+}
+
+// The same calls, drawn as they are made
+static void dlist_immediate(void) {
+    for (size_t i = 0; i < sizeof(s_dlist_ops) / sizeof(s_dlist_ops[0]); i++) {
+        const dlist_op_t *o = &s_dlist_ops[i];
+        if (o->op == DLIST_SCREEN) {
+            rm690b0_fill_screen(o->color);
+        } else if (o->op == RM_DLIST_OP_FILL) {
+            uint16_t w = (o->x + o->w > rm690b0_get_width()) ? rm690b0_get_width() - o->x : o->w;
+            uint16_t h = (o->y + o->h > rm690b0_get_height()) ? rm690b0_get_height() - o->y : o->h;
+            rm690b0_draw_rect(o->x, o->y, w, h, o->color);
+        } else {
+            rm690b0_draw_bitmap(o->x, o->y, o->w, o->h, s_dlist_bmp);
+        }
+    }
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+}
+
+// Host painting: clipped, x0 down and x1 up to even, bitmaps repeat their edge column
+static void dlist_golden(uint16_t w, uint16_t h) {
+    free(s_golden);
+    s_golden = malloc((size_t)w * h * 2);
+    for (size_t i = 0; i < sizeof(s_dlist_ops) / sizeof(s_dlist_ops[0]); i++) {
+        const dlist_op_t *o = &s_dlist_ops[i];
+        int32_t x0 = o->x, y0 = o->y, x1 = o->x + o->w, y1 = o->y + o->h;
+        if (o->op == DLIST_SCREEN) x0 = y0 = 0, x1 = w, y1 = h;
+        if (x1 > w) x1 = w;
+        if (y1 > h) y1 = h;
+        x0 &= ~1;
+        x1 = (x1 + 1) & ~1;
+        for (int32_t y = y0; y < y1; y++) {
+            for (int32_t x = x0; x < x1; x++) {
+                uint16_t c = o->color;
+                if (o->op == RM_DLIST_OP_BITMAP) {
+                    int32_t bx = x - o->x;
+                    bx = (bx < 0) ? 0 : (bx >= o->w) ? o->w - 1 : bx;
+                    c = rm_color_be(s_dlist_bmp[(y - o->y) * o->w + bx]);
+                }
+                s_golden[(size_t)y * w + x] = c;
+            }
+        }
+    }
+}
+
+static uint64_t dlist_bytes(void) {
+    return s_sim.stats.bytes;
+}
+
+static void dlist_play(const char *what, rm690b0_dlist_t *dl, esp_err_t want) {
+    esp_err_t ret = rm690b0_dlist_play(dl);
+    if (ret != want) {
+        fprintf(stderr, "%s: replay returned %s, expected %s\n", what, esp_err_to_name(ret), esp_err_to_name(want));
+        s_failures++;
+    }
+}
+
+static void sc_dlist(void) {
+    s_dlist_bmp = malloc(DLIST_BMP_W * DLIST_BMP_H * 2);
+    for (uint32_t y = 0; y < DLIST_BMP_H; y++) {
+        for (uint32_t x = 0; x < DLIST_BMP_W; x++) {
+            s_dlist_bmp[y * DLIST_BMP_W + x] = rm_color_be((uint16_t)((x / 2) << 11 | (y + 10) << 5 | ((x ^ y) & 31)));
+        }
+    }
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    rm690b0_dlist_t dl = { 0 }, loaded = { 0 };
+    dlist_record(&dl, w, h);
+    dlist_golden(w, h);
+
+    rm690b0_dlist_stats_t st;
+    rm690b0_dlist_get_stats(&dl, &st);
+    size_t size;
+    const void *data = rm690b0_dlist_data(&dl, &size);
+    printf("  recorded %u ops, %u in the list: %u dropped, %u cut, %u merged; %u of %u pixels, %zu bytes\n",
+           st.recorded, st.ops, st.dropped, st.split, st.merged, (unsigned)st.pixels,
+           (unsigned)st.pixels_recorded, size);
+    if (st.dropped == 0 || st.split == 0 || st.merged == 0) s_failures++;
+    if (st.pixels != (uint32_t)w * h) {
+        fprintf(stderr, "dlist: replay sends %u pixels, screen is %u\n", (unsigned)st.pixels, (unsigned)w * h);
+        s_failures++;
+    }
+
+    // Replays against immediate drawing; the second replay is prepared already
+    uint64_t b0 = dlist_bytes();
+    dlist_immediate();
+    uint64_t b1 = dlist_bytes();
+    dlist_play("dlist", &dl, ESP_OK);
+    uint64_t b2 = dlist_bytes();
+    expect_golden("dlist");
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    uint64_t b3 = dlist_bytes();
+    dlist_play("dlist again", &dl, ESP_OK);
+    uint64_t b4 = dlist_bytes();
+    expect_golden("dlist again");
+    rm690b0_dlist_get_stats(&dl, &st);
+    printf("  immediate %llu bytes, replay %llu bytes (%u us), %u prepares in %u replays\n",
+           (unsigned long long)(b1 - b0), (unsigned long long)(b2 - b1), (unsigned)st.play_us,
+           (unsigned)st.prepares, (unsigned)st.plays);
+    if (b2 - b1 >= b1 - b0 || b4 - b3 != b2 - b1 || st.prepares != 1) s_failures++;
+
+    // Serialized, loaded from a copy, replayed
+    uint8_t *copy = malloc(size);
+    memcpy(copy, data, size);
+    if (rm690b0_dlist_load(&loaded, copy, size) != ESP_OK) s_failures++;
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    dlist_play("dlist loaded", &loaded, ESP_OK);
+    expect_golden("dlist loaded");
+    if (rm690b0_dlist_load(&loaded, copy, size - 2) == ESP_OK) {
+        fprintf(stderr, "dlist: truncated list loaded\n");
+        s_failures++;
+    }
+
+    // Portrait is another size; rotation 2 is the same size at another offset
+    rm690b0_set_rotation(1);
+    dlist_play("dlist rot1", &dl, ESP_ERR_INVALID_SIZE);
+    rm690b0_set_rotation(2);
+    rm690b0_fill_screen(RM_COLOR_BLACK);
+    dlist_play("dlist rot2", &dl, ESP_OK);
+    expect_golden("dlist rot2");
+
+    // Packed: fill buffers are prepared again in RGB332
+    rm690b0_set_rotation(0);
+    rm690b0_set_interface_format(RM_IFPF_RGB332);
+    dlist_play("dlist rgb332", &dl, ESP_OK);
+    rm690b0_set_interface_format(RM_IFPF_RGB565);
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    expect_pixel("dlist rgb332", 130, 50, RM_COLOR_BLUE);
+    expect_pixel("dlist rgb332", 274, 200, RM_COLOR_YELLOW);
+    expect_pixel("dlist rgb332", 519, 329, RM_COLOR_RED);
+    rm690b0_dlist_get_stats(&dl, &st);
+    if (st.prepares != 3) {
+        fprintf(stderr, "dlist: %u prepares, expected 3\n", (unsigned)st.prepares);
+        s_failures++;
+    }
+
+    // The test pattern is a retained list too: its centre is widened, not skewed
+    rm690b0_run_test_pattern();
+    rm690b0_run_test_pattern();
+    expect_pixel("dlist pattern", 274, 200, RM_COLOR_YELLOW);
+    expect_pixel("dlist pattern", 325, 249, RM_COLOR_YELLOW);
+    expect_pixel("dlist pattern", 326, 249, RM_COLOR_BLACK);
+
+    rm690b0_dlist_free(&loaded);
+    rm690b0_dlist_free(&dl);
+    free(copy);
+    free(s_dlist_bmp);
+}
+
+// Native GRAM pixel of a screen pixel, by the transform rather than the panel model
+static uint16_t xform_gram(const rm690b0_xform_t *xf, int32_t x, int32_t y) {
+    int32_t nx, ny;
+    rm690b0_xform_to_native(xf, x, y, &nx, &ny);
+    return s_sim.gram[(size_t)ny * RM_SIM_GRAM_W + RM_SIM_VISIBLE_X + nx];
+}
+
+static void sc_xform(void) {
+    for (uint8_t r = 0; r < 4; r++) {
+        rm690b0_set_rotation(r);
+        const rm690b0_xform_t *xf = rm690b0_get_xform();
+        uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+        const uint16_t pts[][2] = { { 0, 0 }, { w - 2, 0 }, { 0, h - 1 }, { w - 2, h - 1 }, { 100, 37 } };
+        for (size_t i = 0; i < sizeof(pts) / sizeof(pts[0]); i++) {
+            uint16_t color = (uint16_t)(0x1234 + r * 0x0841 + i * 0x2000);
+            rm690b0_draw_rect(pts[i][0], pts[i][1], 2, 1, color);
+            rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+            for (int k = 0; k < 2; k++) {
+                int32_t x = pts[i][0] + k, y = pts[i][1], nx, ny, bx, by;
+                if (xform_gram(xf, x, y) != color) {
+                    fprintf(stderr, "xform: rotation %u (%d, %d) not where the transform puts it\n", r, (int)x, (int)y);
+                    s_failures++;
+                }
+                rm690b0_xform_to_native(xf, x, y, &nx, &ny);
+                rm690b0_xform_from_native(xf, nx, ny, &bx, &by);
+                if (bx != x || by != y || nx < 0 || ny < 0 || nx >= RM_XFORM_NATIVE_W || ny >= RM_XFORM_NATIVE_H) {
+                    fprintf(stderr, "xform: rotation %u (%d, %d) does not map back\n", r, (int)x, (int)y);
+                    s_failures++;
+                }
+            }
+        }
+    }
+    rm690b0_set_rotation(0);
+
+    // Kernel against a plain loop: even and odd sizes, a misaligned source
+    static const uint16_t sizes[][3] = { { 600, 450, 0 }, { 450, 600, 0 }, { 37, 23, 0 }, { 64, 30, 1 } };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint16_t w = sizes[i][0], h = sizes[i][1], skew = sizes[i][2];
+        uint16_t *buf = malloc(((size_t)w * h + skew) * 2), *src = buf + skew;
+        uint16_t *dst = malloc((size_t)w * h * 2), *ref = malloc((size_t)w * h * 2);
+        for (uint32_t k = 0; k < (uint32_t)w * h; k++) src[k] = (uint16_t)(k * 2654435761u >> 16);
+        for (uint8_t t = 1; t < 4; t++) {
+            uint16_t dw = (t & 1) ? h : w;
+            for (uint32_t y = 0; y < h; y++) {
+                for (uint32_t x = 0; x < w; x++) {
+                    uint32_t dx = (t == 1) ? h - 1 - y : (t == 2) ? w - 1 - x : y;
+                    uint32_t dy = (t == 1) ? x : (t == 2) ? h - 1 - y : w - 1 - x;
+                    ref[dy * dw + dx] = src[y * w + x];
+                }
+            }
+            struct timespec t0, t1;
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            rm_xform_rotate(dst, dw, src, w, w, h, t);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            if (memcmp(dst, ref, (size_t)w * h * 2) != 0) {
+                fprintf(stderr, "xform: %ux%u%s turned %u differs from the plain loop\n", w, h, skew ? " (misaligned)" : "", t);
+                s_failures++;
+            }
+            if (i == 0) {
+                double us = (t1.tv_sec - t0.tv_sec) * 1e6 + (t1.tv_nsec - t0.tv_nsec) / 1e3;
+                printf("  rotate %ux%u by %u: %.0f us, %.0f Mpixels/s\n", w, h, t * 90, us, w * h / us);
+            }
+        }
+        free(buf);
+        free(dst);
+        free(ref);
+    }
+}
+
+static void sc_rotate_delta(void) {
+    static uint16_t delta_gram[RM_SIM_GRAM_W * RM_SIM_GRAM_H];
+    rm690b0_set_rotation(0);
+    rm690b0_fill_screen(RM_COLOR_MAGENTA);
+    rm690b0_run_test_pattern();
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+
+    const uint8_t order[] = { 1, 2, 3, 0, 2 };
+    for (size_t i = 0; i < sizeof(order); i++) {
+        uint8_t r = order[i];
+        rm690b0_set_rotation(r);
+        uint64_t b0 = s_sim.stats.bytes;
+        rm690b0_run_test_pattern();
+        rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+        uint64_t b1 = s_sim.stats.bytes;
+        memcpy(delta_gram, s_sim.gram, sizeof(delta_gram));
+
+        // The same pattern replayed whole over a cleared panel
+        rm690b0_fill_screen(RM_COLOR_MAGENTA);
+        uint64_t b2 = s_sim.stats.bytes;
+        rm690b0_run_test_pattern();
+        rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+        uint64_t b3 = s_sim.stats.bytes;
+        printf("  to rotation %u: %llu bytes, full replay %llu\n", r,
+               (unsigned long long)(b1 - b0), (unsigned long long)(b3 - b2));
+        if (memcmp(delta_gram, s_sim.gram, sizeof(delta_gram)) != 0) {
+            fprintf(stderr, "rotate_delta: rotation %u differs from a full replay\n", r);
+            s_failures++;
+        }
+        if ((b1 - b0) * 4 > b3 - b2) {
+            fprintf(stderr, "rotate_delta: rotation %u sent more than a quarter of a replay\n", r);
+            s_failures++;
+        }
+    }
+
+    // Anything else drawn in between: the pattern goes out whole
+    rm690b0_set_rotation(0);
+    rm690b0_draw_rect(100, 100, 10, 10, RM_COLOR_CYAN);
+    uint64_t b0 = s_sim.stats.bytes;
+    rm690b0_run_test_pattern();
+    rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+    if (s_sim.stats.bytes - b0 < (uint64_t)rm690b0_get_width() * rm690b0_get_height() * 2) {
+        fprintf(stderr, "rotate_delta: pattern not replayed over other drawing\n");
+        s_failures++;
+    }
+    expect_pixel("rotate_delta", 104, 104, RM_COLOR_BLACK);
+
+    // Scrolling or a raw command in between: no burst, still replayed whole
+    for (int k = 0; k < 2; k++) {
+        if (k == 0) {
+            rm690b0_scroll_reset();
+        } else {
+            rm690b0_queue_cmd(0x29, NULL, 0); // DISPON
+        }
+        b0 = s_sim.stats.bytes;
+        rm690b0_run_test_pattern();
+        rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+        if (s_sim.stats.bytes - b0 < (uint64_t)rm690b0_get_width() * rm690b0_get_height() * 2) {
+            fprintf(stderr, "rotate_delta: pattern not replayed after %s\n", k ? "a raw command" : "scrolling");
+            s_failures++;
+        }
+    }
+}
+
+// Canvas against what the panel shows
+static void expect_fb_panel(const char *what) {
+    size_t stride;
+    const uint16_t *fb = rm690b0_fb_get(&stride);
+    uint32_t bad = 0;
+    for (uint16_t y = 0; y < rm690b0_get_height(); y++) {
+        for (uint16_t x = 0; x < rm690b0_get_width(); x++) {
+            uint16_t want = rm_color_be(fb[(size_t)y * stride + x]);
+            if (rm690b0_bus_sim_pixel(&s_sim, x, y) != want && bad++ == 0) expect_pixel(what, x, y, want);
+        }
+    }
+    if (bad > 1) s_failures++;
+}
+
+static void sc_rotate_fb(void) {
+    rm690b0_set_rotation(0);
+    rm690b0_fb_init();
+    rm690b0_fb_set_delta(true);
+    rm690b0_fb_clear(RM_COLOR_BLUE);
+    size_t stride;
+    uint16_t *fb = rm690b0_fb_get(&stride);
+    for (uint16_t y = 100; y < 220; y++) {
+        for (uint16_t x = 60; x < 300; x++) fb[(size_t)y * stride + x] = rm_color_be((uint16_t)(x * 97 + y * 31));
+    }
+    rm690b0_fb_mark_dirty(60, 100, 240, 120);
+    rm690b0_fb_fill_rect(400, 300, 90, 60, RM_COLOR_YELLOW);
+    rm690b0_fb_flush();
+
+    // Kept on the panel: GRAM already holds it, only MADCTL goes out
+    uint64_t b0 = s_sim.stats.pixels;
+    if (rm690b0_fb_rotate(1, false) != ESP_OK) s_failures++;
+    rm690b0_fb_flush();
+    uint64_t b1 = s_sim.stats.pixels;
+    expect_fb_panel("rotate_fb kept");
+    rm690b0_fb_fill_rect(10, 10, 20, 20, RM_COLOR_RED);
+    rm690b0_fb_flush();
+    uint64_t b2 = s_sim.stats.pixels;
+    expect_fb_panel("rotate_fb kept, drawn");
+    printf("  kept: %llu pixels to turn, %llu for a 20x20 redraw\n",
+           (unsigned long long)(b1 - b0), (unsigned long long)(b2 - b1));
+    if (b1 != b0 || b2 - b1 > RM_FB_TILE * RM_FB_TILE) s_failures++;
+
+    // Upright by 180 degrees: only the tiles the turn changes go out
+    if (rm690b0_fb_rotate(3, true) != ESP_OK) s_failures++;
+    rm690b0_fb_flush();
+    uint64_t b3 = s_sim.stats.pixels;
+    expect_fb_panel("rotate_fb upright");
+    printf("  upright: %llu pixels, whole canvas %u\n", (unsigned long long)(b3 - b2),
+           (unsigned)(rm690b0_get_width() * rm690b0_get_height()));
+    if (b3 - b2 >= (uint64_t)rm690b0_get_width() * rm690b0_get_height() / 2) s_failures++;
+    if (rm690b0_fb_rotate(0, true) != ESP_ERR_INVALID_SIZE) s_failures++;
+
+    if (rm690b0_fb_rotate(0, false) != ESP_OK) s_failures++;
+    rm690b0_fb_flush();
+    expect_fb_panel("rotate_fb back");
+    if (rm690b0_fb_rotate(2, false) != ESP_OK) s_failures++;
+    rm690b0_fb_flush();
+    expect_fb_panel("rotate_fb kept 180");
+    if (rm690b0_fb_rotate(0, false) != ESP_OK) s_failures++;
+    rm690b0_fb_set_delta(false);
+    rm690b0_fb_deinit();
+}
+
+// TE estimator on synthetic edges: a panel slower than nominal, jittered,
+// with single and double dropouts and glitches inside a period
+#define VSYNC_PERIOD_US     16900
+#define VSYNC_PHASE_US      1234
+#define VSYNC_JITTER_US     150
+#define VSYNC_EDGES         600
+
+static void sc_vsync_est(void) {
+    rm690b0_vsync_est_t e;
+    rm_vsync_init(&e, 0);
+    uint32_t seed = 12345, missed = 0, spurious = 0, worst = 0;
+    for (int64_t k = 0; k < VSYNC_EDGES; k++) {
+        seed = seed * 1103515245u + 12345u;
+        int64_t jitter = (int64_t)(seed >> 16) % (2 * VSYNC_JITTER_US + 1) - VSYNC_JITTER_US;
+        int64_t t = VSYNC_PHASE_US + k * VSYNC_PERIOD_US + jitter;
+        if (k > 0 && (k % 37 == 0 || k % 101 == 50 || k % 101 == 51)) {
+            missed++;
+            continue;
+        }
+        if (!rm_vsync_edge(&e, t)) {
+            fprintf(stderr, "vsync: edge %d rejected\n", (int)k);
+            s_failures++;
+        }
+        if (k % 53 == 7) {
+            spurious++;
+            if (rm_vsync_edge(&e, t + VSYNC_PERIOD_US / 5)) s_failures++;
+        }
+
+        // Prediction against the true next edge, once locked
+        if (e.locked && k > 100) {
+            int64_t now = t + VSYNC_PERIOD_US / 3;
+            int64_t err = rm_vsync_next(&e, now) - (VSYNC_PHASE_US + (k + 1) * VSYNC_PERIOD_US);
+            uint32_t a = (uint32_t)(err < 0 ? -err : err);
+            if (a > worst) worst = a;
+        }
+    }
+    uint32_t period = rm_vsync_period_us(&e);
+    printf("  vsync: period %u us (true %u), jitter %u us, worst prediction %u us, %u missed, %u spurious\n",
+           period, VSYNC_PERIOD_US, rm_vsync_jitter_us(&e), worst, e.missed, e.spurious);
+    if (!e.locked || period + 50 < VSYNC_PERIOD_US || period > VSYNC_PERIOD_US + 50 ||
+        e.missed != missed || e.spurious != spurious || worst > 2 * VSYNC_JITTER_US ||
+        rm_vsync_jitter_us(&e) > VSYNC_JITTER_US) {
+        fprintf(stderr, "vsync: estimate off (expected %u missed, %u spurious)\n", missed, spurious);
+        s_failures++;
+    }
+
+    // A long gap (panel off) starts over instead of counting missed edges
+    int64_t t = VSYNC_PHASE_US + (VSYNC_EDGES + 40) * (int64_t)VSYNC_PERIOD_US;
+    rm_vsync_edge(&e, t);
+    if (e.resyncs != 1 || e.locked || e.missed != missed) s_failures++;
+    for (int k = 1; k < RM_VSYNC_LOCK_EDGES; k++) rm_vsync_edge(&e, t + k * VSYNC_PERIOD_US);
+    int64_t last = t + (RM_VSYNC_LOCK_EDGES - 1) * (int64_t)VSYNC_PERIOD_US;
+    int64_t err = rm_vsync_next(&e, last + VSYNC_PERIOD_US / 3) - (last + VSYNC_PERIOD_US);
+    if (!e.locked || err < -50 || err > 50) {
+        fprintf(stderr, "vsync: no lock or phase after resync\n");
+        s_failures++;
+    }
+}
+
+// Conversion kernels against their per-pixel references: every head and tail
+// misalignment of source and destination, lengths around the unrolled blocks,
+// dithered at every phase of the matrix. Whole buffers are compared, so a
+// write past either end counts too.
+#define COLOR_N         300
+
+static void sc_color(void) {
+    static uint8_t src8[COLOR_N * 4 + 8];
+    static uint32_t src32[COLOR_N + 4];
+    static uint16_t src16[COLOR_N + 4], a[COLOR_N + 8], b[COLOR_N + 8];
+    srand(8);
+    for (size_t i = 0; i < sizeof(src8); i++) src8[i] = (uint8_t)rand();
+    for (size_t i = 0; i < COLOR_N + 4; i++) {
+        src16[i] = (uint16_t)rand();
+        src32[i] = (uint32_t)rand() << 16 ^ (uint32_t)rand();
+    }
+
+    uint32_t bad[4] = { 0 }, cases = 0;
+    static const char *names[4] = { "swap16", "rgb888", "argb8888", "gray8" };
+    const size_t lens[] = { 0, 1, 2, 3, 5, 7, 8, 15, 16, 17, 31, 33, 64, 255, COLOR_N - 4 };
+    for (size_t li = 0; li < sizeof(lens) / sizeof(lens[0]); li++) {
+        size_t n = lens[li];
+        for (int doff = 0; doff < 4; doff++) {
+            for (int soff = 0; soff < 4; soff++) {
+                cases++;
+                memset(a, 0xA5, sizeof(a));
+                memset(b, 0xA5, sizeof(b));
+                rm_color_swap16(a + doff, src16 + soff, n);
+                rm_color_swap16_ref(b + doff, src16 + soff, n);
+                bad[0] += memcmp(a, b, sizeof(a)) != 0;
+
+                memset(a, 0xA5, sizeof(a));
+                memset(b, 0xA5, sizeof(b));
+                rm_color_gray8_to_be565(a + doff, src8 + soff, n);
+                rm_color_gray8_to_be565_ref(b + doff, src8 + soff, n);
+                bad[3] += memcmp(a, b, sizeof(a)) != 0;
+
+                for (int dither = 0; dither < 2; dither++) {
+                    for (uint16_t phase = 0; phase < (dither ? 4 : 1); phase++) {
+                        uint16_t x = (uint16_t)(phase + soff), y = (uint16_t)(phase * 3 + doff);
+                        memset(a, 0xA5, sizeof(a));
+                        memset(b, 0xA5, sizeof(b));
+                        rm_color_rgb888_to_be565(a + doff, src8 + soff, n, x, y, dither);
+                        rm_color_rgb888_to_be565_ref(b + doff, src8 + soff, n, x, y, dither);
+                        bad[1] += memcmp(a, b, sizeof(a)) != 0;
+
+                        memset(a, 0xA5, sizeof(a));
+                        memset(b, 0xA5, sizeof(b));
+                        rm_color_argb8888_to_be565(a + doff, src32 + soff, n, x, y, dither);
+                        rm_color_argb8888_to_be565_ref(b + doff, src32 + soff, n, x, y, dither);
+                        bad[2] += memcmp(a, b, sizeof(a)) != 0;
+                    }
+                }
+            }
+        }
+    }
+    printf("  color: %u length/alignment cases per kernel\n", cases);
+    for (int k = 0; k < 4; k++) {
+        if (bad[k]) {
+            fprintf(stderr, "color: %s differs from its reference in %u cases\n", names[k], bad[k]);
+            s_failures++;
+        }
+    }
+}
+
+// Transaction stream of the pipeline, through the recording backend: chunk
+// sizes, CS kept across the chunks of a burst but not after its last one,
+// commands between bursts, completion order. Runs on its own pipe.
+#define REC_BURST       (3 * RM_BUS_CHUNK_BYTES + 100)
+
+typedef struct {
+    uint8_t event;      // rm690b0_rec_event_t of the QUEUE entry
+    uint8_t opcode;     // RM_BUS_OP_* when a header goes first, else 0
+    uint8_t cmd;
+    size_t length;
+    bool keep_cs;
+    bool cb;
+} rec_expect_t;
+
+static void rec_done(void *arg) {
+    (*(uint32_t *)arg)++;
+}
+
+static void sc_bus_record(void) {
+    static rm690b0_rec_entry_t log[64];
+    static uint8_t burst[REC_BURST];
+    rm690b0_bus_record_t rec;
+    rm690b0_pipe_t pipe;
+    rm_pipe_init(&pipe, rm690b0_bus_record_init(&rec, log, 64), 2);
+
+    const uint8_t caset[4] = { 0, 16, 1, 0xD1 }, raset[4] = { 0, 0, 2, 0x57 };
+    uint32_t done = 0;
+    esp_err_t ret = rm_pipe_cmd(&pipe, 0x2A, caset, 4);
+    if (ret == ESP_OK) ret = rm_pipe_cmd(&pipe, 0x2B, raset, 4);
+    if (ret == ESP_OK) ret = rm_pipe_write(&pipe, burst, REC_BURST, rec_done, &done);
+    if (ret == ESP_OK) ret = rm_pipe_cmd(&pipe, 0x2A, caset, 4);
+    if (ret == ESP_OK) ret = rm_pipe_write(&pipe, burst, 64, rec_done, &done);
+    if (ret == ESP_OK) ret = rm_pipe_drain(&pipe, RM_BUS_WAIT_FOREVER);
+
+    const rec_expect_t want[] = {
+        { RM_REC_QUEUE, RM_BUS_OP_CMD, 0x2A, 4, false, false },
+        { RM_REC_QUEUE, RM_BUS_OP_CMD, 0x2B, 4, false, false },
+        { RM_REC_QUEUE, RM_BUS_OP_PIXELS, RM_CMD_RAMWR, RM_BUS_CHUNK_BYTES, true, false },
+        { RM_REC_QUEUE, 0, 0, RM_BUS_CHUNK_BYTES, true, false },
+        { RM_REC_QUEUE, 0, 0, RM_BUS_CHUNK_BYTES, true, false },
+        { RM_REC_QUEUE, 0, 0, 100, false, true },
+        { RM_REC_QUEUE, RM_BUS_OP_CMD, 0x2A, 4, false, false },
+        { RM_REC_QUEUE, RM_BUS_OP_PIXELS, RM_CMD_RAMWR, 64, false, true },
+    };
+    size_t nq = 0, nreap = 0, bad = 0;
+    for (size_t i = 0; i < rec.count; i++) {
+        const rm690b0_rec_entry_t *e = &log[i];
+        if (e->event == RM_REC_REAP) {
+            // FIFO: the n-th completion is the n-th queued transfer
+            const rm690b0_rec_entry_t *q = NULL;
+            for (size_t j = 0, k = 0; j < rec.count; j++) {
+                if (log[j].event == RM_REC_QUEUE && k++ == nreap) {
+                    q = &log[j];
+                    break;
+                }
+            }
+            if (!q || q->trans.length != e->trans.length || q->trans.flags != e->trans.flags) bad++;
+            nreap++;
+            continue;
+        }
+        if (e->event != RM_REC_QUEUE) continue;
+        if (nq >= sizeof(want) / sizeof(want[0])) {
+            bad++;
+            continue;
+        }
+        const rec_expect_t *w = &want[nq++];
+        const rm690b0_bus_trans_t *t = &e->trans;
+        bool header = (t->flags & RM_BUS_FLAG_HEADER) != 0;
+        if (header != (w->opcode != 0) || (header && (t->opcode != w->opcode || t->cmd != w->cmd)) ||
+            t->length != w->length || ((t->flags & RM_BUS_FLAG_KEEP_CS) != 0) != w->keep_cs ||
+            (t->done_cb != NULL) != w->cb) {
+            fprintf(stderr, "bus_record: transfer %zu: flags %x op %02x cmd %02x %zu bytes%s\n", nq - 1,
+                    (unsigned)t->flags, t->opcode, t->cmd, t->length, t->done_cb ? ", callback" : "");
+            bad++;
+        }
+        // Short parameters travel in the descriptor
+        const uint8_t *params = (w->cmd == 0x2B) ? raset : caset;
+        if (header && w->opcode == RM_BUS_OP_CMD &&
+            (!(t->flags & RM_BUS_FLAG_INLINE) || memcmp(t->inline_data, params, 4) != 0)) {
+            bad++;
+        }
+    }
+    bool bracketed = rec.count > 0 && log[0].event == RM_REC_ACQUIRE && log[rec.count - 1].event == RM_REC_RELEASE;
+    printf("  recorded %zu events: %zu transfers, %zu completions, %u in flight at most, %u stalls, %u violations\n",
+           rec.count, nq, nreap, rec.max_inflight, pipe.stalls, rec.violations);
+    if (ret != ESP_OK || bad || nq != sizeof(want) / sizeof(want[0]) || nreap != nq || !bracketed ||
+        rec.violations || rec.max_inflight > 2 || pipe.stalls == 0 || done != 2 || pipe.bursts != 2) {
+        s_failures++;
+    }
+
+    // A burst cut short, as on an error path: draining ends it with an empty
+    // transfer that drops CS, so the next command starts clean
+    rm690b0_bus_record_clear(&rec);
+    ret = rm_pipe_push(&pipe, burst, 64, false, NULL, NULL, NULL);
+    if (ret == ESP_OK) ret = rm_pipe_drain(&pipe, RM_BUS_WAIT_FOREVER);
+    if (ret == ESP_OK) ret = rm_pipe_cmd(&pipe, 0x2A, caset, 4);
+    if (ret == ESP_OK) ret = rm_pipe_drain(&pipe, RM_BUS_WAIT_FOREVER);
+    const rm690b0_bus_trans_t *close = NULL;
+    for (size_t i = 0, k = 0; i < rec.count; i++) {
+        if (log[i].event == RM_REC_QUEUE && k++ == 1) close = &log[i].trans;
+    }
+    if (ret != ESP_OK || rec.violations || pipe.in_burst || !close || close->length != 0 ||
+        (close->flags & (RM_BUS_FLAG_HEADER | RM_BUS_FLAG_KEEP_CS))) {
+        fprintf(stderr, "bus_record: open burst not closed by drain (%u violations)\n", rec.violations);
+        s_failures++;
+    }
+}
+
+// Damage tracker on its own: merge decisions against the cost model
+static bool damage_is(const char *what, const rm690b0_damage_t *d, uint8_t count, const rm690b0_area_t *first) {
+    bool ok = d->count == count && (!first || memcmp(&d->areas[0], first, sizeof(*first)) == 0);
+    if (!ok) {
+        const rm690b0_area_t *a = &d->areas[0];
+        fprintf(stderr, "damage %s: %u areas, first (%u, %u)-(%u, %u)\n", what, d->count, a->x1, a->y1, a->x2, a->y2);
+        s_failures++;
+    }
+    return ok;
+}
+
+static void damage_random(rm690b0_damage_t *d, uint32_t seed, uint16_t (*rects)[4], int n) {
+    rm_damage_init(d, 600, 450, 0);
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        uint16_t x = (seed >> 8) % 600, y = (seed >> 18) % 450;
+        seed = seed * 1103515245u + 12345u;
+        uint16_t w = 1 + (seed >> 8) % 60, h = 1 + (seed >> 18) % 40;
+        if (rects) {
+            rects[i][0] = x; rects[i][1] = y; rects[i][2] = w; rects[i][3] = h;
+        }
+        rm_damage_add(d, x, y, w, h);
+    }
+}
+
+static void sc_damage(void) {
+    rm690b0_damage_t d;
+
+    // Overlapping: the bounding box is cheaper than two windows
+    rm_damage_init(&d, 600, 450, 0);
+    rm_damage_add(&d, 10, 10, 20, 20);
+    rm_damage_add(&d, 20, 20, 20, 20);
+    damage_is("overlap", &d, 1, &(rm690b0_area_t){ 10, 10, 39, 39 });
+
+    // Touching side by side: one window, nothing extra sent
+    rm_damage_reset(&d);
+    rm_damage_add(&d, 0, 0, 100, 10);
+    rm_damage_add(&d, 100, 0, 100, 10);
+    damage_is("adjacent", &d, 1, &(rm690b0_area_t){ 0, 0, 199, 9 });
+    if (rm_damage_pixels(&d) != 2000) s_failures++;
+
+    // Odd edges widen to column pairs; the right edge clips to the frame
+    rm_damage_reset(&d);
+    rm_damage_add(&d, 5, 3, 4, 2);
+    damage_is("even x", &d, 1, &(rm690b0_area_t){ 4, 3, 9, 4 });
+    rm_damage_reset(&d);
+    rm_damage_add(&d, 595, 440, 20, 20);
+    damage_is("clipped", &d, 1, &(rm690b0_area_t){ 594, 440, 599, 449 });
+
+    // Far apart: the box would send far more than a second window costs
+    rm_damage_reset(&d);
+    rm_damage_add(&d, 0, 0, 10, 10);
+    rm_damage_add(&d, 400, 300, 10, 10);
+    damage_is("far apart", &d, 2, &(rm690b0_area_t){ 0, 0, 9, 9 });
+    uint32_t merges = d.merges;
+    rm_damage_add(&d, 2, 2, 4, 4);  // Inside an area already
+    if (d.count != 2 || d.merges != merges) s_failures++;
+
+    // 33 areas that never pay off merging: the last one forces one merge
+    rm_damage_init(&d, 600, 450, 1);
+    for (int i = 0; i < RM_DAMAGE_MAX_AREAS + 1; i++) rm_damage_add(&d, (i % 11) * 40, (i / 11) * 40, 2, 2);
+    damage_is("forced", &d, RM_DAMAGE_MAX_AREAS, NULL);
+    if (d.forced != 1 || d.merges != 1) s_failures++;
+
+    // Same input, same list; and every dirty pixel stays covered
+    static uint16_t rects[400][4];
+    static uint8_t covered[450][600];
+    rm690b0_damage_t d2;
+    damage_random(&d, 77, rects, 400);
+    damage_random(&d2, 77, NULL, 400);
+    if (d.count != d2.count || memcmp(d.areas, d2.areas, d.count * sizeof(d.areas[0])) != 0) {
+        fprintf(stderr, "damage: same adds, different lists\n");
+        s_failures++;
+    }
+    memset(covered, 0, sizeof(covered));
+    for (uint8_t k = 0; k < d.count; k++) {
+        for (uint16_t y = d.areas[k].y1; y <= d.areas[k].y2; y++) {
+            memset(&covered[y][d.areas[k].x1], 1, d.areas[k].x2 - d.areas[k].x1 + 1);
+        }
+    }
+    uint32_t lost = 0;
+    for (int i = 0; i < 400; i++) {
+        for (uint32_t y = rects[i][1]; y < rects[i][1] + rects[i][3] && y < 450; y++) {
+            for (uint32_t x = rects[i][0]; x < rects[i][0] + rects[i][2] && x < 600; x++) lost += !covered[y][x];
+        }
+    }
+    printf("  damage: 400 random rects -> %u areas, %zu pixels, %u merges, %u forced\n",
+           d.count, rm_damage_pixels(&d), d.merges, d.forced);
+    if (lost) {
+        fprintf(stderr, "damage: %u dirty pixels not covered\n", lost);
+        s_failures++;
+    }
+}
+
+static void sc_console(void) {
+    rm690b0_console_config_t con = { .top = 0, .height = 0, .fg = RM_COLOR_GREEN, .bg = RM_COLOR_BLACK };
+    rm690b0_fill_screen(RM_COLOR_BLACK); // Rows below the last whole text line are not console
+    rm690b0_console_init(&con);
+    for (int i = 0; i < 60; i++) {
+        rm690b0_console_printf("line %02d: the quick brown fox\n", i);
+    }
+}
+
+static void sc_rotations(void) {
+    for (uint8_t r = 0; r < 4; r++) {
+        char name[32];
+        rm690b0_set_rotation(r);
+        rm690b0_fill_screen(RM_COLOR_BLACK);
+        sc_pattern();
+        rm690b0_flush_wait(RM_BUS_WAIT_FOREVER);
+        snprintf(name, sizeof(name), "rotation_%u", r);
+        dump(name);
+    }
+    rm690b0_set_rotation(0);
+}
+
+// Display server: producers own one vertical stripe each, so the final
+// contents are deterministic whatever the interleaving
+#define STRESS_PRODUCERS    8
+#define STRESS_CMDS         3000
+
+typedef struct stress_prod stress_prod_t;
+
+typedef struct {
+    stress_prod_t *prod;
+    uint32_t k;
+} stress_token_t;
+
+struct stress_prod {
+    uint8_t id;
+    uint16_t x, w, h;
+    uint16_t last_color;
+    atomic_uint done;
+    atomic_uint order_errors;
+    stress_token_t tokens[STRESS_CMDS];
+};
+
+static stress_prod_t s_prods[STRESS_PRODUCERS];
+
+// Runs on the server task
+static void stress_done(void *ctx) {
+    stress_token_t *t = ctx;
+    uint32_t done = atomic_fetch_add(&t->prod->done, 1);
+    if (done != t->k) atomic_fetch_add(&t->prod->order_errors, 1);
+}
+
+static void *stress_producer(void *arg) {
+    stress_prod_t *p = arg;
+    uint32_t rng = 0x9E3779B9u * (p->id + 1);
+    for (uint32_t k = 0; k < STRESS_CMDS; k++) {
+        rng = rng * 1664525u + 1013904223u;
+        rm690b0_cmd_t cmd = { .type = RM_CMD_FILL, .done_cb = stress_done, .done_ctx = &p->tokens[k] };
+        p->tokens[k] = (stress_token_t){ .prod = p, .k = k };
+        cmd.color = (uint16_t)(rng >> 16);
+
+        if (k == STRESS_CMDS - 1 || (rng >> 8) % 8 == 0) {
+            // Whole stripe: covers everything this producer queued before
+            cmd.x = p->x; cmd.y = 0; cmd.w = p->w; cmd.h = p->h;
+        } else {
+            cmd.w = 4; cmd.h = 4;
+            cmd.x = p->x + (rng >> 4) % (p->w - 4);
+            cmd.y = (rng >> 12) % (p->h - 4);
+        }
+        if (k == STRESS_CMDS - 1) p->last_color = cmd.color;
+
+        if (rm690b0_server_submit(&cmd, UINT32_MAX) != ESP_OK) {
+            atomic_fetch_add(&p->order_errors, 1);
+        }
+        // A rotation barrier now and then, same rotation so stripes stay put
+        if (p->id == 0 && k % 500 == 0) rm690b0_server_set_rotation(rm690b0_get_rotation());
+    }
+    return NULL;
+}
+
+// Producers still submitting while the server stops: whatever was accepted
+// completes before stop returns, the rest fails
+static atomic_bool s_race_go;
+static atomic_uint s_race_ok, s_race_done;
+
+static void race_done(void *ctx) {
+    atomic_fetch_add(&s_race_done, 1);
+}
+
+static void *race_producer(void *arg) {
+    rm690b0_cmd_t cmd = { .type = RM_CMD_FILL, .w = 2, .h = 2, .color = RM_COLOR_WHITE, .done_cb = race_done };
+    while (atomic_load(&s_race_go)) {
+        if (rm690b0_server_submit(&cmd, 0) == ESP_OK) atomic_fetch_add(&s_race_ok, 1);
+    }
+    return NULL;
+}
+
+static void server_stop_race(void) {
+    for (int i = 0; i < 50; i++) {
+        if (rm690b0_server_start(5, -1) != ESP_OK) s_failures++;
+        atomic_store(&s_race_go, true);
+        pthread_t th[2];
+        for (int k = 0; k < 2; k++) pthread_create(&th[k], NULL, race_producer, NULL);
+        usleep(200);
+        rm690b0_server_stop();
+        atomic_store(&s_race_go, false);
+        for (int k = 0; k < 2; k++) pthread_join(th[k], NULL);
+    }
+    uint32_t ok = atomic_load(&s_race_ok), done = atomic_load(&s_race_done);
+    printf("  stop race: %u accepted, %u completed\n", ok, done);
+    if (ok != done) s_failures++;
+}
+
+static void sc_server_stress(void) {
+    uint16_t w = rm690b0_get_width(), h = rm690b0_get_height();
+    uint16_t stripe = (w / STRESS_PRODUCERS) & ~1;
+
+    if (rm690b0_server_start(5, -1) != ESP_OK) {
+        s_failures++;
+        return;
+    }
+
+    pthread_t th[STRESS_PRODUCERS];
+    for (int i = 0; i < STRESS_PRODUCERS; i++) {
+        stress_prod_t *p = &s_prods[i];
+        p->id = i;
+        p->x = i * stripe;
+        p->w = stripe;
+        p->h = h;
+        pthread_create(&th[i], NULL, stress_producer, p);
+    }
+    for (int i = 0; i < STRESS_PRODUCERS; i++) pthread_join(th[i], NULL);
+
+    if (rm690b0_server_sync(UINT32_MAX) != ESP_OK) s_failures++;
+    rm690b0_server_stop();
+
+    for (int i = 0; i < STRESS_PRODUCERS; i++) {
+        stress_prod_t *p = &s_prods[i];
+        uint32_t done = atomic_load(&p->done), errors = atomic_load(&p->order_errors);
+        if (done != STRESS_CMDS || errors) {
+            fprintf(stderr, "producer %d: %u/%u completed, %u out of order\n", i, done, STRESS_CMDS, errors);
+            s_failures++;
+        }
+        expect_pixel("server", p->x, 0, p->last_color);
+        expect_pixel("server", p->x + p->w - 1, h - 1, p->last_color);
+    }
+
+    rm690b0_server_stats_t st;
+    rm690b0_server_get_stats(&st);
+    printf("  server: %u submitted, %u executed, %u coalesced, %u batches, %u ring full, depth %u\n",
+           st.submitted, st.executed, st.coalesced, st.batches, st.full, st.depth_max);
+    if (st.errors || st.timeouts) s_failures++;
+
+    // Restarted right after each stop: one consumer at a time, nothing lost
+    uint16_t last = 0;
+    for (int i = 0; i < 50; i++) {
+        if (rm690b0_server_start(5, -1) != ESP_OK) s_failures++;
+        last = (uint16_t)(0x0841 * i);
+        rm690b0_server_fill_rect(0, 0, 16, 16, last);
+        rm690b0_server_stop();
+        if (rm690b0_server_is_running()) s_failures++;
+    }
+    expect_pixel("server restart", 15, 15, last);
+
+    server_stop_race();
+}
+
+// UI in RGB332 through the server, one photo at full depth on the same screen
+static void sc_server_ifpf(void) {
+    static uint16_t photo[64 * 64];
+    const uint16_t c = 0x1234; // Not representable in RGB332
+    for (int i = 0; i < 64 * 64; i++) photo[i] = (uint16_t)((c >> 8) | (c << 8));
+
+    rm690b0_set_interface_format(RM_IFPF_RGB332);
+    if (rm690b0_server_start(5, -1) != ESP_OK) {
+        s_failures++;
+        return;
+    }
+    rm690b0_server_fill_screen(RM_COLOR_RED);
+    rm690b0_cmd_t cmd = {
+        .type = RM_CMD_BITMAP, .ifpf = RM_IFPF_RGB565,
+        .x = 100, .y = 100, .w = 64, .h = 64, .data = photo, .stride = 64,
+    };
+    if (rm690b0_server_submit(&cmd, UINT32_MAX) != ESP_OK) s_failures++;
+    rm690b0_server_fill_rect(300, 100, 64, 64, RM_COLOR_GREEN);
+    if (rm690b0_server_sync(UINT32_MAX) != ESP_OK) s_failures++;
+    rm690b0_server_stop();
+    rm690b0_set_interface_format(RM_IFPF_RGB565);
+
+    expect_pixel("server_ifpf", 0, 0, RM_COLOR_RED);
+    expect_pixel("server_ifpf", 163, 163, c);
+    expect_pixel("server_ifpf", 300, 100, RM_COLOR_GREEN);
+}
+
+int main(int argc, char **argv) {
+    uint32_t clock_mhz = 40;
+    uint32_t setup_ns = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:s:o:f:m:")) != -1) {
+        switch (opt) {
+            case 'c': clock_mhz = (uint32_t)atoi(optarg); break;
+            case 's': setup_ns = (uint32_t)atoi(optarg); break;
+            case 'o': s_out_dir = optarg; break;
+            case 'f': s_frames_path = optarg; break;
+            case 'm': s_mjpeg_path = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-c clock_mhz] [-s setup_ns] [-o out_dir] [-f frames.raw] [-m video.mjpeg]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    static uint16_t gram[RM_SIM_GRAM_W * RM_SIM_GRAM_H];
+    rm690b0_set_bus(rm690b0_bus_sim_init(&s_sim, gram, clock_mhz * 1000000));
+    s_sim.setup_ns = setup_ns;
+
+    printf("SPI clock %u MHz, setup %u ns per transaction\n", clock_mhz, setup_ns);
+    printf("%-22s %8s %10s %10s %9s %9s %9s %4s\n", "scenario", "trans", "bytes", "pixels",
+           "wire_ms", "busy_ms", "sleep_ms", "viol");
+
+    run("init", sc_init);
+    run("bus_record", sc_bus_record);
+    run("damage", sc_damage);
+    run("vsync_est", sc_vsync_est);
+    run("color", sc_color);
+    run("fill_screen", sc_fill);
+    run("test_pattern", sc_pattern);
+    run("brush_4x4_x100", sc_brush);
+    run("full_frame", sc_full_frame);
+    run("fb_partial", sc_fb);
+    run("blit", sc_blit);
+    run("image_r5q", sc_image);
+    run("assets", sc_assets);
+    run("shapes_fb", sc_shapes_fb);
+    run("shapes", sc_shapes);
+    s_shape_aa = true;
+    run("shapes_fb_aa", sc_shapes_fb);
+    run("shapes_aa", sc_shapes);
+    run("shapes_opaque", sc_shapes_opaque);
+    run("text", sc_text);
+    run("text_bench", sc_text_bench);
+    run("layers", sc_layers);
+    run("layers_move", sc_layers_move);
+    run("delta_replay", sc_delta_replay);
+    run("bands", sc_bands);
+    run("bands_small_rows", sc_bands_small);
+    run("bands_rot1_rgb332", sc_bands_rot1);
+    run("bands_parallel", sc_bands_parallel);
+    run("mjpeg", sc_mjpeg);
+    run("dlist", sc_dlist);
+    run("xform", sc_xform);
+    run("rotate_delta", sc_rotate_delta);
+    run("rotate_fb", sc_rotate_fb);
+    s_frame_ifpf = RM_IFPF_RGB332;
+    run("full_frame_rgb332", sc_frame_packed);
+    s_frame_ifpf = RM_IFPF_GRAY8;
+    run("full_frame_gray8", sc_frame_packed);
+    s_frame_ifpf = RM_IFPF_RGB111;
+    run("full_frame_rgb111", sc_frame_packed);
+    // Portrait rotations scroll in hardware, rotation 1 with mirrored rows
+    rm690b0_set_rotation(3);
+    run("console_rot3", sc_console);
+    rm690b0_set_rotation(1);
+    run("console_rot1", sc_console);
+    rm690b0_set_rotation(0);
+    run("console_rot0_wrap", sc_console);
+    run("rotations", sc_rotations);
+    run("server_stress", sc_server_stress);
+    run("server_ifpf", sc_server_ifpf);
+
+    if (s_failures) {
+        printf("%d failure(s)\n", s_failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,298 @@
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "rm690b0_bus_spi.h"
+#include "sim_port.h"
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+// Advanced by every task, hence atomic
+static _Atomic uint64_t s_delay_us;
+
+const char *esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:                return "ESP_OK";
+        case ESP_FAIL:              return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+        default:                    return "UNKNOWN";
+    }
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+    (void)caps;
+    return malloc(size);
+}
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps) {
+    (void)caps;
+    // aligned_alloc wants a multiple of the alignment
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void heap_caps_free(void *ptr) {
+    free(ptr);
+}
+
+void esp_rom_delay_us(uint32_t us) {
+    s_delay_us += us;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    s_delay_us += (uint64_t)ticks * 1000;
+    sched_yield(); // Polling loops still let the other threads run
+}
+
+int64_t esp_timer_get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(s_delay_us / 1000);
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio) { (void)gpio; return ESP_OK; }
+esp_err_t gpio_set_direction(gpio_num_t gpio, gpio_mode_t mode) { (void)gpio; (void)mode; return ESP_OK; }
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level) { (void)gpio; (void)level; return ESP_OK; }
+
+esp_err_t rm690b0_bus_spi_create(spi_host_device_t host_id, int cs_io, int clock_hz, rm690b0_bus_t **out) {
+    (void)host_id; (void)cs_io; (void)clock_hz; (void)out;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+// Absolute CLOCK_REALTIME deadline ticks (milliseconds) from now
+static void deadline(TickType_t ticks, struct timespec *until) {
+    clock_gettime(CLOCK_REALTIME, until);
+    until->tv_sec += ticks / 1000;
+    until->tv_nsec += (long)(ticks % 1000) * 1000000;
+    if (until->tv_nsec >= 1000000000) {
+        until->tv_sec++;
+        until->tv_nsec -= 1000000000;
+    }
+}
+
+// --- Mutexes and binary semaphores ---
+
+struct sim_mutex {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;    // Binary only
+    bool binary;
+    bool given;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    SemaphoreHandle_t m = calloc(1, sizeof(*m));
+    if (m) pthread_mutex_init(&m->lock, NULL);
+    return m;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    SemaphoreHandle_t m = xSemaphoreCreateMutex();
+    if (m) {
+        pthread_cond_init(&m->cond, NULL);
+        m->binary = true;
+    }
+    return m;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    if (!sem->binary) {
+        // Mutexes are only taken with portMAX_DELAY
+        pthread_mutex_lock(&sem->lock);
+        return pdTRUE;
+    }
+    struct timespec until;
+    deadline(ticks, &until);
+    pthread_mutex_lock(&sem->lock);
+    while (!sem->given && ticks > 0) {
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(&sem->cond, &sem->lock);
+        } else if (pthread_cond_timedwait(&sem->cond, &sem->lock, &until) != 0) {
+            break;
+        }
+    }
+    BaseType_t ok = sem->given ? pdTRUE : pdFALSE;
+    sem->given = false;
+    pthread_mutex_unlock(&sem->lock);
+    return ok;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    if (!sem->binary) {
+        pthread_mutex_unlock(&sem->lock);
+        return pdTRUE;
+    }
+    pthread_mutex_lock(&sem->lock);
+    sem->given = true;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->lock);
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) {
+    if (sem->binary) pthread_cond_destroy(&sem->cond);
+    pthread_mutex_destroy(&sem->lock);
+    free(sem);
+}
+
+// --- Event groups ---
+
+struct sim_events {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    EventBits_t bits;
+};
+
+EventGroupHandle_t xEventGroupCreate(void) {
+    EventGroupHandle_t g = calloc(1, sizeof(*g));
+    if (g) {
+        pthread_mutex_init(&g->lock, NULL);
+        pthread_cond_init(&g->cond, NULL);
+    }
+    return g;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    pthread_mutex_lock(&group->lock);
+    group->bits |= bits;
+    EventBits_t now = group->bits;
+    pthread_cond_broadcast(&group->cond);
+    pthread_mutex_unlock(&group->lock);
+    return now;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    pthread_mutex_lock(&group->lock);
+    EventBits_t was = group->bits;
+    group->bits &= ~bits;
+    pthread_mutex_unlock(&group->lock);
+    return was;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear,
+                                BaseType_t all, TickType_t ticks) {
+    struct timespec until;
+    deadline(ticks, &until);
+    pthread_mutex_lock(&group->lock);
+    for (;;) {
+        EventBits_t got = group->bits & bits;
+        if ((all ? got == bits : got != 0) || ticks == 0) break;
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(&group->cond, &group->lock);
+        } else if (pthread_cond_timedwait(&group->cond, &group->lock, &until) != 0) {
+            break;
+        }
+    }
+    EventBits_t now = group->bits;
+    if (clear && (all ? (now & bits) == bits : (now & bits) != 0)) group->bits &= ~bits;
+    pthread_mutex_unlock(&group->lock);
+    return now;
+}
+
+void vEventGroupDelete(EventGroupHandle_t group) {
+    pthread_cond_destroy(&group->cond);
+    pthread_mutex_destroy(&group->lock);
+    free(group);
+}
+
+// --- Tasks ---
+
+struct sim_task {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify;
+    TaskFunction_t fn;
+    void *arg;
+};
+
+static __thread struct sim_task *t_self;
+
+static struct sim_task *task_new(void) {
+    struct sim_task *t = calloc(1, sizeof(*t));
+    pthread_mutex_init(&t->lock, NULL);
+    pthread_cond_init(&t->cond, NULL);
+    return t;
+}
+
+static void *task_entry(void *p) {
+    struct sim_task *t = p;
+    t_self = t;
+    t->fn(t->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t prio, TaskHandle_t *out) {
+    (void)name; (void)stack; (void)prio;
+    struct sim_task *t = task_new();
+    t->fn = fn;
+    t->arg = arg;
+    if (out) *out = t;
+    pthread_t th;
+    if (pthread_create(&th, NULL, task_entry, t) != 0) return pdFALSE;
+    pthread_detach(th);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *out, BaseType_t core) {
+    (void)core;
+    return xTaskCreate(fn, name, stack, arg, prio, out);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    // Handles stay valid: a late notification must not touch freed memory
+    if (task == NULL || task == t_self) pthread_exit(NULL);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    // Threads not started through xTaskCreate (main, harness threads) get one lazily
+    if (!t_self) t_self = task_new();
+    return t_self;
+}
+
+void xTaskNotifyGive(TaskHandle_t task) {
+    pthread_mutex_lock(&task->lock);
+    task->notify++;
+    pthread_cond_signal(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+    struct sim_task *t = xTaskGetCurrentTaskHandle();
+    struct timespec until;
+    deadline(ticks, &until);
+
+    pthread_mutex_lock(&t->lock);
+    while (t->notify == 0 && ticks > 0) {
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(&t->cond, &t->lock);
+        } else if (pthread_cond_timedwait(&t->cond, &t->lock, &until) != 0) {
+            break;
+        }
+    }
+    uint32_t n = t->notify;
+    if (n) t->notify = clear ? 0 : n - 1;
+    pthread_mutex_unlock(&t->lock);
+    return n;
+}
+
+uint64_t sim_port_delay_us(void) {
+    return s_delay_us;
+}
@@ -0,0 +1,8 @@
+#pragma once
+// Host port: only the types rm690b0.h exposes. There is no SPI backend on the
+// host; attach rm690b0_bus_sim with rm690b0_set_bus() before rm690b0_init().
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef int spi_host_device_t;
+#define SPI2_HOST 1
@@ -0,0 +1,5 @@
+#pragma once
+// Host port: microseconds of the host monotonic clock
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
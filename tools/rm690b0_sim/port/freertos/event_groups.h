@@ -0,0 +1,13 @@
+#pragma once
+// Host port: event groups backed by pthreads (port.c)
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_events *EventGroupHandle_t;
+typedef uint32_t EventBits_t;
+
+EventGroupHandle_t xEventGroupCreate(void);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear,
+                                BaseType_t all, TickType_t ticks);
+void vEventGroupDelete(EventGroupHandle_t group);
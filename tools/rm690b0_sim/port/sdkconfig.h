@@ -0,0 +1,3 @@
+#pragma once
+// Host build: no target, portable kernels only
+#define CONFIG_FREERTOS_HZ 1000
@@ -0,0 +1,7 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @brief Total time the driver asked to sleep (vTaskDelay, esp_rom_delay_us)
+ */
+uint64_t sim_port_delay_us(void);